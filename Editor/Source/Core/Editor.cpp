@@ -832,6 +832,8 @@ void Editor::SceneInfo(const std::shared_ptr<Scene>& scene)
 				scene->SetWindSettings(windSettings);
 			}
 
+			PhysicsSettingsInfo(scene);
+
 			GraphicsSettingsInfo(scene->GetGraphicsSettings());
 		}
 
@@ -864,8 +866,7 @@ void Editor::DrawScene(const std::shared_ptr<Scene>& scene, Window& window)
 					}
 				};
 
-				std::shared_ptr<NextFrameEvent> event = std::make_shared<NextFrameEvent>(callback, Event::Type::OnNextFrame, this);
-				EventSystem::GetInstance().SendEvent(event);
+				EventSystem::GetInstance().SendEvent(NextFrameEvent{ std::move(callback), this });
 			}
 			ImGui::EndDragDropTarget();
 		}
@@ -950,8 +951,7 @@ void Editor::DrawNode(const std::shared_ptr<Entity>& entity, ImGuiTreeNodeFlags
 				}
 			};
 
-			std::shared_ptr<NextFrameEvent> event = std::make_shared<NextFrameEvent>(callback, Event::Type::OnNextFrame, this);
-			EventSystem::GetInstance().SendEvent(event);
+			EventSystem::GetInstance().SendEvent(NextFrameEvent{ std::move(callback), this });
 		}
 		ImGui::EndDragDropTarget();
 	}
@@ -1087,8 +1087,7 @@ void Editor::Properties(const std::shared_ptr<Scene>& scene, Window& window)
 								}
 							};
 
-							std::shared_ptr<NextFrameEvent> event = std::make_shared<NextFrameEvent>(callback, Event::Type::OnNextFrame, this);
-							EventSystem::GetInstance().SendEvent(event);
+							EventSystem::GetInstance().SendEvent(NextFrameEvent{ std::move(callback), this });
 						}
 						ImGui::PopID();
 					}
@@ -1135,6 +1134,87 @@ void Editor::Properties(const std::shared_ptr<Scene>& scene, Window& window)
 	}
 }
 
+void Editor::PhysicsSettingsInfo(const std::shared_ptr<Scene>& scene)
+{
+	if (ImGui::CollapsingHeader("Physics settings"))
+	{
+		Indent indent;
+
+		const std::shared_ptr<PhysicsSystem> physicsSystem = scene->GetPhysicsSystem();
+		PhysicsSystem::Settings settings = physicsSystem->GetSettings();
+
+		ImGui::Text("Bodies: %u / %u", physicsSystem->GetBodyCount(), settings.maxBodyCount);
+
+		// Capacities need the world to be rebuilt, so they are applied only when editing is finished.
+		bool rebuild = false;
+		auto inputCapacity = [&rebuild](const char* label, uint32_t& value)
+		{
+			int intValue = static_cast<int>(value);
+			ImGui::InputInt(label, &intValue);
+			if (ImGui::IsItemDeactivatedAfterEdit() && intValue > 0)
+			{
+				value = static_cast<uint32_t>(intValue);
+				rebuild = true;
+			}
+		};
+
+		inputCapacity("Max Bodies", settings.maxBodyCount);
+		inputCapacity("Max Body Pairs", settings.maxBodyPairCount);
+		inputCapacity("Max Contact Constraints", settings.maxContactConstraintCount);
+		inputCapacity("Temp Allocator Size", settings.tempAllocatorSize);
+
+		rebuild |= ImGui::Checkbox("Allow Growth", &settings.allowGrowth);
+
+		if (ImGui::TreeNode("Collision Layers"))
+		{
+			const char* broadPhaseLayers[] = { "Static", "Dynamic", "Debris", "Sensor" };
+			for (size_t layer = 0; layer < settings.collisionLayers.size(); layer++)
+			{
+				PhysicsSystem::CollisionLayer& collisionLayer = settings.collisionLayers[layer];
+
+				ImGui::PushID(static_cast<int>(layer));
+				int broadPhaseLayer = (JPH::BroadPhaseLayer::Type)collisionLayer.broadPhaseLayer;
+				if (ImGui::Combo(collisionLayer.name.c_str(), &broadPhaseLayer, broadPhaseLayers, BroadPhaseLayers::NUM_LAYERS))
+				{
+					collisionLayer.broadPhaseLayer = JPH::BroadPhaseLayer(broadPhaseLayer);
+					rebuild = true;
+				}
+				ImGui::PopID();
+			}
+
+			if (settings.collisionLayers.size() < ObjectLayers::MAX_LAYERS && ImGui::Button("Add Layer"))
+			{
+				PhysicsSystem::CollisionLayer& collisionLayer = settings.collisionLayers.emplace_back();
+				collisionLayer.name = "Layer " + std::to_string(settings.collisionLayers.size() - 1);
+				collisionLayer.collisionMask = 1u << ObjectLayers::DYNAMIC;
+				rebuild = true;
+			}
+
+			// Upper triangle of the symmetric collision matrix, changing it doesn't require a rebuild.
+			ImGui::Text("Collision Matrix");
+			for (size_t layerA = 0; layerA < settings.collisionLayers.size(); layerA++)
+			{
+				for (size_t layerB = layerA; layerB < settings.collisionLayers.size(); layerB++)
+				{
+					const std::string label = std::format("{} - {}##{}_{}", settings.collisionLayers[layerA].name, settings.collisionLayers[layerB].name, layerA, layerB);
+					bool collide = physicsSystem->GetLayersCollide(layerA, layerB);
+					if (ImGui::Checkbox(label.c_str(), &collide))
+					{
+						physicsSystem->SetLayersCollide(layerA, layerB, collide);
+					}
+				}
+			}
+
+			ImGui::TreePop();
+		}
+
+		if (rebuild)
+		{
+			physicsSystem->SetSettings(settings, scene);
+		}
+	}
+}
+
 void Editor::GraphicsSettingsInfo(GraphicsSettings& graphicsSettings)
 {
 	if (ImGui::CollapsingHeader("Graphics settings"))
@@ -1500,8 +1580,7 @@ void Editor::CameraComponent(const std::shared_ptr<Entity>& entity, Window& wind
 						viewport.second->SetCamera(entity);
 					};
 
-					std::shared_ptr<NextFrameEvent> event = std::make_shared<NextFrameEvent>(callback, Event::Type::OnNextFrame, this);
-					EventSystem::GetInstance().SendEvent(event);
+					EventSystem::GetInstance().SendEvent(NextFrameEvent{ std::move(callback), this });
 				}
 			}
 			
@@ -1680,8 +1759,7 @@ void Editor::GameObjectPopUpMenu(const std::shared_ptr<Scene>& scene)
 					}
 				};
 
-				std::shared_ptr<NextFrameEvent> event = std::make_shared<NextFrameEvent>(callback, Event::Type::OnNextFrame, this);
-				EventSystem::GetInstance().SendEvent(event);
+				EventSystem::GetInstance().SendEvent(NextFrameEvent{ std::move(callback), this });
 			}
 		}
 
@@ -1853,8 +1931,7 @@ void Editor::AssetBrowser(const std::shared_ptr<Scene>& scene)
 							Serializer::DeserializeScene(path);
 						};
 
-						std::shared_ptr<NextFrameEvent> event = std::make_shared<NextFrameEvent>(callback, Event::Type::OnNextFrame, this);
-						EventSystem::GetInstance().SendEvent(event);
+						EventSystem::GetInstance().SendEvent(NextFrameEvent{ std::move(callback), this });
 					}
 				}
 				else if (format == FileFormats::BaseMat())
@@ -2466,6 +2543,11 @@ void Editor::ComponentsPopUpMenu(const std::shared_ptr<Entity>& entity)
 		ReflectionSystem& reflectionSystem = ReflectionSystem::GetInstance();
 		for (auto& [id, registeredClass] : reflectionSystem.m_ClassesByType)
 		{
+			if (!registeredClass.m_CreateCallback)
+			{
+				continue;
+			}
+
 			if (ImGui::MenuItem(registeredClass.m_TypeInfo.name().data()))
 			{
 				registeredClass.m_CreateCallback(entity->GetRegistry(), entity->GetHandle());
@@ -2695,6 +2777,7 @@ void Editor::Renderer3DComponent(const std::shared_ptr<Entity>& entity)
 
 		DrawBitMask("Object Visibility Mask", &r3d.objectVisibilityMask, 8, 2);
 		DrawBitMask("Shadow Visibility Mask", &r3d.shadowVisibilityMask, 8, 2);
+		DrawBitMask("Raycast Mask", &r3d.raycastMask, 8, 2);
 	}
 }
 
@@ -2892,6 +2975,20 @@ void Editor::SkeletalAnimatorComponent(const std::shared_ptr<Entity>& entity)
 		{
 			skeletalAnimator.SetDrawDebugSkeleton(drawDebugSkeleton);
 		}
+
+		bool lodEnabled = skeletalAnimator.GetLodEnabled();
+		if (ImGui::Checkbox("Lod Enabled", &lodEnabled))
+		{
+			skeletalAnimator.SetLodEnabled(lodEnabled);
+		}
+
+		ImGui::Text("Update Interval: %u", skeletalAnimator.GetUpdateInterval());
+
+		int maxBones = skeletalAnimator.GetMaxBones();
+		if (ImGui::InputInt("Max Bones", &maxBones) && maxBones > 0)
+		{
+			skeletalAnimator.SetMaxBones(maxBones);
+		}
 	}
 }
 
@@ -3035,17 +3132,52 @@ void Editor::PhysicsBoxComponent(const std::shared_ptr<Entity>& entity)
 	{
 		Indent indent;
 
-		ImGui::Checkbox("Is Static", &rigidBody.isStatic);
+		if (ImGui::Checkbox("Is Static", &rigidBody.isStatic))
+		{
+			rigidBody.isValid = false;
+		}
 		ImGui::Checkbox("Is Valid", &rigidBody.isValid);
 
+		const std::vector<PhysicsSystem::CollisionLayer>& collisionLayers = entity->GetScene()->GetPhysicsSystem()->GetSettings().collisionLayers;
+		const char* layerName = "Invalid";
+		if (rigidBody.layer == RigidBody::defaultLayer)
+		{
+			layerName = "Default";
+		}
+		else if (rigidBody.layer < collisionLayers.size())
+		{
+			layerName = collisionLayers[rigidBody.layer].name.c_str();
+		}
+
+		if (ImGui::BeginCombo("Layer", layerName))
+		{
+			// Follows the static flag.
+			if (ImGui::Selectable("Default", rigidBody.layer == RigidBody::defaultLayer))
+			{
+				rigidBody.layer = RigidBody::defaultLayer;
+				rigidBody.isValid = false;
+			}
+
+			for (size_t layer = 0; layer < collisionLayers.size(); layer++)
+			{
+				if (ImGui::Selectable(collisionLayers[layer].name.c_str(), layer == rigidBody.layer))
+				{
+					rigidBody.layer = static_cast<JPH::ObjectLayer>(layer);
+					rigidBody.isValid = false;
+				}
+			}
+			ImGui::EndCombo();
+		}
+
 		auto& physicsSystem = entity->GetScene()->GetPhysicsSystem()->GetInstance();
 
 		int type = (int)rigidBody.type;
-		const char* types[] = { "Box", "Sphere", "Cylinder" };
+		const char* types[] = { "Box", "Sphere", "Cylinder", "Mesh", "Convex Hull", "Compound" };
 		ImGui::PushID("PhysicsBodyType");
-		if (ImGui::Combo("Type", &type, types, 3))
+		if (ImGui::Combo("Type", &type, types, 6))
 		{
 			rigidBody.type = (RigidBody::Type)type;
+			rigidBody.isValid = false;
 			switch (rigidBody.type)
 			{
 			case RigidBody::Type::Box:
@@ -3104,6 +3236,48 @@ void Editor::PhysicsBoxComponent(const std::shared_ptr<Entity>& entity)
 			}
 			break;
 		}
+		case RigidBody::Type::Mesh:
+		case RigidBody::Type::ConvexHull:
+		{
+			ImGui::Text("Mesh:");
+			ImGui::SameLine();
+			ImGui::Button(rigidBody.mesh ? rigidBody.mesh->GetName().c_str() : none);
+
+			if (ImGui::BeginDragDropTarget())
+			{
+				if (const ImGuiPayload* payload = ImGui::AcceptDragDropPayload("ASSETS_BROWSER_ITEM"))
+				{
+					std::wstring filepath((const wchar_t*)payload->Data);
+					filepath.resize(payload->DataSize / sizeof(wchar_t));
+
+					if (FileFormats::Mesh() == Utils::GetFileFormat(filepath))
+					{
+						rigidBody.mesh = MeshManager::GetInstance().LoadMesh(Utils::GetShortFilepath(filepath));
+						rigidBody.isValid = false;
+					}
+				}
+
+				ImGui::EndDragDropTarget();
+			}
+
+			int meshLod = rigidBody.meshLod;
+			if (ImGui::InputInt("Mesh Lod", &meshLod) && meshLod >= 0)
+			{
+				rigidBody.meshLod = meshLod;
+				rigidBody.isValid = false;
+			}
+
+			if (rigidBody.type == RigidBody::Type::Mesh && !rigidBody.isStatic)
+			{
+				ImGui::Text("Dynamic bodies use the convex hull of the mesh.");
+			}
+			break;
+		}
+		case RigidBody::Type::Compound:
+		{
+			ImGui::Text("Made of the child rigid bodies.");
+			break;
+		}
 		}
 
 		if (ImGui::SliderFloat("Mass", &rigidBody.mass, 0.0f, 10.0f))
@@ -3211,77 +3385,102 @@ void Editor::UserComponents(const std::shared_ptr<Entity>& entity)
 {
 	ReflectionSystem& reflectionSystem = ReflectionSystem::GetInstance();
 
-	std::function<void(void*, ReflectionSystem::RegisteredClass&, size_t)> properties = [this, &properties]
-		(void* instance, ReflectionSystem::RegisteredClass& registeredClass, size_t offset)
+	std::function<void(void*, const ReflectionSystem::RegisteredClass&, size_t)> properties;
+
+	// Values are matched by the type id, containers and reflected structs are drawn as tree nodes.
+	std::function<void(const std::string&, const ReflectionSystem::Type&, void*)> value = [this, &value, &properties, &reflectionSystem]
+		(const std::string& name, const ReflectionSystem::Type& type, void* data)
 	{
-		for (auto& [name, prop] : registeredClass.m_PropertiesByName)
+		if (type.id == GetTypeHash<bool>())
 		{
-#define SERIALIZE_PROPERTY(_type) \
-if (prop.IsValue<_type>()) \
-{ \
-	const _type& value = prop.GetValue<_type>(instance, offset); \
-	out << YAML::Key << "Type" << prop.m_Type; \
-	out << YAML::Key << "Value" << value; \
-}
+			ImGui::Checkbox(name.c_str(), static_cast<bool*>(data));
+		}
+		else if (type.id == GetTypeHash<int>())
+		{
+			ImGui::SliderInt(name.c_str(), static_cast<int*>(data), 0, 10);
+		}
+		else if (type.id == GetTypeHash<float>())
+		{
+			ImGui::SliderFloat(name.c_str(), static_cast<float*>(data), 0.0f, 10.0f);
+		}
+		else if (type.id == GetTypeHash<double>())
+		{
+			ImGui::InputDouble(name.c_str(), static_cast<double*>(data));
+		}
+		else if (type.id == GetTypeHash<std::string>())
+		{
+			std::string& string = *static_cast<std::string*>(data);
 
-			if (prop.IsValue<bool>())
-			{
-				ImGui::Checkbox(name.c_str(), &prop.GetValue<bool>(instance, offset));
-			}
-			else if(prop.IsValue<int>())
-			{
-				ImGui::SliderInt(name.c_str(), &prop.GetValue<int>(instance, offset), 0, 10);
-			}
-			else if (prop.IsValue<float>())
-			{
-				ImGui::SliderFloat(name.c_str(), &prop.GetValue<float>(instance, offset), 0.0f, 10.0f);
-			}
-			else if (prop.IsValue<double>())
+			char textBuffer[256];
+			strncpy(textBuffer, string.data(), sizeof(textBuffer) - 1);
+			textBuffer[sizeof(textBuffer) - 1] = '\0';
+			if (ImGui::InputText(name.c_str(), textBuffer, sizeof(textBuffer)))
 			{
-				ImGui::InputDouble(name.c_str(), &prop.GetValue<double>(instance, offset));
+				string = textBuffer;
 			}
-			else if (prop.IsValue<std::string>())
+		}
+		else if (type.id == GetTypeHash<glm::vec2>())
+		{
+			DrawVec2Control(name, *static_cast<glm::vec2*>(data));
+		}
+		else if (type.id == GetTypeHash<glm::vec3>())
+		{
+			DrawVec3Control(name, *static_cast<glm::vec3*>(data));
+		}
+		else if (type.id == GetTypeHash<glm::vec4>())
+		{
+			DrawVec4Control(name, *static_cast<glm::vec4*>(data));
+		}
+		else if (type.id == GetTypeHash<glm::ivec2>())
+		{
+			DrawIVec2Control(name, *static_cast<glm::ivec2*>(data));
+		}
+		else if (type.id == GetTypeHash<glm::ivec3>())
+		{
+			DrawIVec3Control(name, *static_cast<glm::ivec3*>(data));
+		}
+		else if (type.id == GetTypeHash<glm::ivec4>())
+		{
+			DrawIVec4Control(name, *static_cast<glm::ivec4*>(data));
+		}
+		else if (type.elementType)
+		{
+			if (ImGui::TreeNode(name.c_str()))
 			{
-				char textBuffer[256];
-				strcpy(textBuffer, prop.GetValue<std::string>(instance, offset).data());
-				if (ImGui::InputText(name.c_str(), textBuffer, sizeof(textBuffer)))
+				const size_t size = type.getSize(data);
+				for (size_t i = 0; i < size; i++)
 				{
-					prop.GetValue<std::string>(instance, offset) = textBuffer;
+					ImGui::PushID(static_cast<int>(i));
+					value(std::to_string(i), *type.elementType, type.getElement(data, i));
+					ImGui::PopID();
 				}
+
+				ImGui::TreePop();
 			}
-			else if (prop.IsValue<glm::vec2>())
-			{
-				DrawVec2Control(name, prop.GetValue<glm::vec2>(instance, offset));
-			}
-			else if (prop.IsValue<glm::vec3>())
-			{
-				DrawVec3Control(name, prop.GetValue<glm::vec3>(instance, offset));
-			}
-			else if (prop.IsValue<glm::vec4>())
-			{
-				DrawVec4Control(name, prop.GetValue<glm::vec4>(instance, offset));
-			}
-			else if (prop.IsValue<glm::ivec2>())
-			{
-				DrawIVec2Control(name, prop.GetValue<glm::ivec2>(instance, offset));
-			}
-			else if (prop.IsValue<glm::ivec3>())
-			{
-				DrawIVec3Control(name, prop.GetValue<glm::ivec3>(instance, offset));
-			}
-			else if (prop.IsValue<glm::ivec4>())
+		}
+		else if (const ReflectionSystem::RegisteredClass* registeredClass = reflectionSystem.FindClass(type.id))
+		{
+			if (ImGui::TreeNode(name.c_str()))
 			{
-				DrawIVec4Control(name, prop.GetValue<glm::ivec4>(instance, offset));
+				properties(data, *registeredClass, 0);
+				ImGui::TreePop();
 			}
 		}
+	};
 
-		for (const auto& parent : registeredClass.m_Parents)
+	properties = [&value, &properties, &reflectionSystem]
+		(void* instance, const ReflectionSystem::RegisteredClass& registeredClass, size_t offset)
+	{
+		for (const ReflectionSystem::Property& property : registeredClass.m_Properties)
 		{
-			ReflectionSystem& reflectionSystem = ReflectionSystem::GetInstance();
-			auto classByType = reflectionSystem.m_ClassesByType.find(parent.first);
-			if (classByType != reflectionSystem.m_ClassesByType.end())
+			value(property.m_Name, *property.m_Type, property.GetPointer(instance, offset));
+		}
+
+		for (const auto& [parentId, parentOffset] : registeredClass.m_Parents)
+		{
+			if (const ReflectionSystem::RegisteredClass* parentClass = reflectionSystem.FindClass(parentId))
 			{
-				properties(instance, classByType->second, parent.second);
+				properties(instance, *parentClass, offset + parentOffset);
 			}
 		}
 	};
@@ -3476,9 +3675,9 @@ void Editor::MaterialMenu::Update(Editor& editor)
 			}
 		}
 
-		for (const auto& [passName, pipeline] : material->GetBaseMaterial()->GetPipelinesByPass())
+		for (const auto& [passName, pipeline] : material->GetBaseMaterial()->WaitForPipelines())
 		{
-			if (ImGui::CollapsingHeader(passName.c_str()))
+			if (pipeline && ImGui::CollapsingHeader(passName.c_str()))
 			{
 				for (const auto& [set, uniformLayout] : pipeline->GetUniformLayouts())
 				{
@@ -3752,8 +3951,7 @@ void Editor::CreateViewportMenu::Update(const Editor& editor, Window& window)
 					name[0] = '\0';
 				};
 
-				std::shared_ptr<NextFrameEvent> event = std::make_shared<NextFrameEvent>(callback, Event::Type::OnNextFrame, this);
-				EventSystem::GetInstance().SendEvent(event);
+				EventSystem::GetInstance().SendEvent(NextFrameEvent{ std::move(callback), this });
 			}
 		}
 
@@ -4193,7 +4391,7 @@ void Editor::Thumbnails::UpdateMatMeshThumbnail(const ThumbnailLoadInfo& thumbna
 		}
 
 		cameraTransform.Translate({ 0.0f, 0.0f, 2.0f });
-		cameraTransform.Rotate({});
+		cameraTransform.Rotate(glm::vec3(0.0f));
 		cameraComponent.SetZNear(100.0f * 0.001f);
 		cameraComponent.SetZFar(100.0f);
 	}
@@ -4256,7 +4454,9 @@ void Editor::Thumbnails::UpdateMatMeshThumbnail(const ThumbnailLoadInfo& thumbna
 		}
 	}
 
-	// Update BVH just in case.
+	// Update BVH and the render snapshot just in case, the renderer doesn't read the registry.
+	scene->ExtractRenderSnapshot();
+	scene->PublishRenderSnapshot();
 	scene->GetBVH()->Update(SceneBVH::BuildNodes(scene->GetRegistry()));
 
 	Renderer::RenderViewportInfo renderViewportInfo{};
@@ -4329,7 +4529,8 @@ void Editor::Thumbnails::UpdateScenePrefabThumbnail(const ThumbnailLoadInfo& thu
 	auto& cameraComponent = camera->AddComponent<Camera>(camera);
 	cameraComponent.CreateRenderView(name, m_ThumbnailWindow->GetSize());
 
-	// Update BVH just in case.
+	// Update BVH just in case, publishing first so the BVH built by the last scene update doesn't replace it.
+	scene->PublishRenderSnapshot();
 	scene->GetBVH()->Update(SceneBVH::BuildNodes(scene->GetRegistry()));
 	
 	std::optional<SceneBVH::BVHNode> root = scene->GetBVH()->GetRoot();
@@ -4365,6 +4566,11 @@ void Editor::Thumbnails::UpdateScenePrefabThumbnail(const ThumbnailLoadInfo& thu
 		cameraComponent.SetZNear(maxDistance * distanceScale * 3.0f * 0.001f);
 		cameraComponent.SetZFar(maxDistance * distanceScale * 3.0f);
 	}
+
+	// The renderer reads the snapshot, it has to contain the camera placed above.
+	scene->ExtractRenderSnapshot();
+	scene->PublishRenderSnapshot();
+
 	auto& globalDataAccessor = GlobalDataAccessor::GetInstance();
 	uint32_t& swapChainImageCount = globalDataAccessor.GetSwapChainImageCount();
 	uint32_t& swapChainImageIndex = globalDataAccessor.GetSwapChainImageIndex();
@@ -4511,8 +4717,7 @@ ThumbnailAtlas::TileInfo Editor::Thumbnails::GetOrGenerateThumbnail(
 						TextureManager::GetInstance().Delete(texture.lock()->GetFilepath());
 					};
 
-					std::shared_ptr<NextFrameEvent> event = std::make_shared<NextFrameEvent>(callback, Event::Type::OnNextFrame, this);
-					EventSystem::GetInstance().SendEvent(event);
+					EventSystem::GetInstance().SendEvent(NextFrameEvent{ std::move(callback), this });
 				}, false);
 			}
 		}
@@ -4601,8 +4806,7 @@ ThumbnailAtlas::TileInfo Editor::Thumbnails::TryGetThumbnail(
 						TextureManager::GetInstance().Delete(texture.lock()->GetFilepath());
 					};
 
-					std::shared_ptr<NextFrameEvent> event = std::make_shared<NextFrameEvent>(callback, Event::Type::OnNextFrame, this);
-					EventSystem::GetInstance().SendEvent(event);
+					EventSystem::GetInstance().SendEvent(NextFrameEvent{ std::move(callback), this });
 				}, false);
 			}
 		}
@@ -83,6 +83,8 @@ private:
 
 	void GraphicsSettingsInfo(Pengine::GraphicsSettings& graphicsSettings);
 
+	void PhysicsSettingsInfo(const std::shared_ptr<Pengine::Scene>& scene);
+
 	void CameraComponent(const std::shared_ptr<Pengine::Entity>& entity, Pengine::Window& window);
 
 	void TransformComponent(const std::shared_ptr<Pengine::Entity>& entity);
@@ -0,0 +1,85 @@
+#include "PhysicsJobSystem.h"
+
+#include "../Core/ThreadPool.h"
+
+using namespace Pengine;
+
+PhysicsJobSystem::PhysicsJobSystem(const uint32_t maxJobs, const uint32_t maxBarriers, ThreadPool& threadPool)
+	: JPH::JobSystemWithBarrier(maxBarriers)
+	, m_ThreadPool(threadPool)
+{
+	m_Jobs.Init(maxJobs, maxJobs);
+}
+
+PhysicsJobSystem::~PhysicsJobSystem()
+{
+	// A shut down pool runs the jobs as they are queued, nothing can be left waiting in it.
+	JPH_ASSERT(m_ThreadPool.GetThreadCount() > 0 || m_QueuedJobCount.load() == 0);
+
+	// Jobs that have already been executed by a barrier can still be waiting in the pool queue.
+	while (m_QueuedJobCount.load() > 0)
+	{
+		std::this_thread::yield();
+	}
+}
+
+int PhysicsJobSystem::GetMaxConcurrency() const
+{
+	return static_cast<int>(m_ThreadPool.GetThreadCount()) + 1;
+}
+
+JPH::JobSystem::JobHandle PhysicsJobSystem::CreateJob(const char* inName, JPH::ColorArg inColor, const JobFunction& inJobFunction, JPH::uint32 inNumDependencies)
+{
+	uint32_t index;
+	while ((index = m_Jobs.ConstructObject(inName, inColor, this, inJobFunction, inNumDependencies)) == JPH::FixedSizeFreeList<Job>::cInvalidObjectIndex)
+	{
+		JPH_ASSERT(false, "No jobs available!");
+		std::this_thread::yield();
+	}
+
+	Job* job = &m_Jobs.Get(index);
+
+	// The handle keeps a reference, the job can complete as soon as it is queued.
+	JobHandle handle(job);
+
+	if (inNumDependencies == 0)
+	{
+		QueueJob(job);
+	}
+
+	return handle;
+}
+
+void PhysicsJobSystem::QueueJob(Job* inJob)
+{
+	// Without workers the job is executed by the barrier it is added to.
+	if (m_ThreadPool.GetThreadCount() == 0)
+	{
+		return;
+	}
+
+	inJob->AddRef();
+	m_QueuedJobCount.fetch_add(1);
+
+	m_ThreadPool.EnqueueAsync([this, inJob]()
+	{
+		// Does nothing if a waiting barrier has already executed the job.
+		inJob->Execute();
+		inJob->Release();
+
+		m_QueuedJobCount.fetch_sub(1);
+	});
+}
+
+void PhysicsJobSystem::QueueJobs(Job** inJobs, JPH::uint inNumJobs)
+{
+	for (JPH::uint i = 0; i < inNumJobs; i++)
+	{
+		QueueJob(inJobs[i]);
+	}
+}
+
+void PhysicsJobSystem::FreeJob(Job* inJob)
+{
+	m_Jobs.DestructObject(inJob);
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include "../Core/Core.h"
+
+#include <Jolt/Jolt.h>
+#include <Jolt/Core/JobSystemWithBarrier.h>
+#include <Jolt/Core/FixedSizeFreeList.h>
+
+namespace Pengine
+{
+
+	class ThreadPool;
+
+	/**
+	 * Runs Jolt jobs on the engine ThreadPool instead of a separate set of threads.
+	 * The thread that waits on a barrier executes the jobs itself, so a busy pool only makes the step run on fewer threads.
+	 */
+	class PENGINE_API PhysicsJobSystem final : public JPH::JobSystemWithBarrier
+	{
+	public:
+		PhysicsJobSystem(const uint32_t maxJobs, const uint32_t maxBarriers, ThreadPool& threadPool);
+		virtual ~PhysicsJobSystem() override;
+
+		PhysicsJobSystem(const PhysicsJobSystem&) = delete;
+		PhysicsJobSystem& operator=(const PhysicsJobSystem&) = delete;
+
+		virtual int GetMaxConcurrency() const override;
+
+		virtual JobHandle CreateJob(const char* inName, JPH::ColorArg inColor, const JobFunction& inJobFunction, JPH::uint32 inNumDependencies = 0) override;
+
+	protected:
+		virtual void QueueJob(Job* inJob) override;
+
+		virtual void QueueJobs(Job** inJobs, JPH::uint inNumJobs) override;
+
+		virtual void FreeJob(Job* inJob) override;
+
+	private:
+		JPH::FixedSizeFreeList<Job> m_Jobs;
+		ThreadPool& m_ThreadPool;
+
+		// Jobs handed to the pool that haven't been released yet, they keep the free list alive.
+		std::atomic<uint32_t> m_QueuedJobCount = 0;
+	};
+
+}
@@ -1,8 +1,13 @@
 #include "PhysicsSystem.h"
+#include "PhysicsJobSystem.h"
 
 #include "../Core/Scene.h"
 #include "../Components/Transform.h"
 #include "../Components/RigidBody.h"
+#include "../Core/Logger.h"
+#include "../Core/ThreadPool.h"
+#include "../Core/Serializer.h"
+#include "../Graphics/Mesh.h"
 
 #include "../Utils/Utils.h"
 
@@ -11,11 +16,45 @@
 #include <Jolt/Physics/Collision/Shape/BoxShape.h>
 #include <Jolt/Physics/Collision/Shape/SphereShape.h>
 #include <Jolt/Physics/Collision/Shape/CylinderShape.h>
+#include <Jolt/Physics/Collision/Shape/MeshShape.h>
+#include <Jolt/Physics/Collision/Shape/ConvexHullShape.h>
+#include <Jolt/Physics/Collision/Shape/ScaledShape.h>
+#include <Jolt/Physics/Collision/Shape/StaticCompoundShape.h>
+#include <Jolt/Core/StreamWrapper.h>
 #include <Jolt/Physics/Body/BodyCreationSettings.h>
 
 using namespace Pengine;
 
+std::vector<PhysicsSystem::CollisionLayer> PhysicsSystem::GetDefaultCollisionLayers()
+{
+	std::vector<CollisionLayer> collisionLayers(ObjectLayers::NUM_LAYERS);
+
+	collisionLayers[ObjectLayers::STATIC].name = "Static";
+	collisionLayers[ObjectLayers::STATIC].broadPhaseLayer = BroadPhaseLayers::STATIC;
+	collisionLayers[ObjectLayers::STATIC].collisionMask = (1u << ObjectLayers::DYNAMIC) | (1u << ObjectLayers::DEBRIS);
+
+	collisionLayers[ObjectLayers::DYNAMIC].name = "Dynamic";
+	collisionLayers[ObjectLayers::DYNAMIC].broadPhaseLayer = BroadPhaseLayers::DYNAMIC;
+	collisionLayers[ObjectLayers::DYNAMIC].collisionMask = (1u << ObjectLayers::STATIC) | (1u << ObjectLayers::DYNAMIC) | (1u << ObjectLayers::DEBRIS) | (1u << ObjectLayers::SENSOR);
+
+	collisionLayers[ObjectLayers::DEBRIS].name = "Debris";
+	collisionLayers[ObjectLayers::DEBRIS].broadPhaseLayer = BroadPhaseLayers::DEBRIS;
+	collisionLayers[ObjectLayers::DEBRIS].collisionMask = (1u << ObjectLayers::STATIC) | (1u << ObjectLayers::DYNAMIC);
+
+	collisionLayers[ObjectLayers::SENSOR].name = "Sensor";
+	collisionLayers[ObjectLayers::SENSOR].broadPhaseLayer = BroadPhaseLayers::SENSOR;
+	collisionLayers[ObjectLayers::SENSOR].collisionMask = (1u << ObjectLayers::DYNAMIC);
+
+	return collisionLayers;
+}
+
 PhysicsSystem::PhysicsSystem()
+	: PhysicsSystem(Settings{})
+{
+}
+
+PhysicsSystem::PhysicsSystem(const Settings& settings)
+	: m_Settings(settings)
 {
 	JPH::RegisterDefaultAllocator();
 
@@ -23,20 +62,9 @@ PhysicsSystem::PhysicsSystem()
 
 	JPH::RegisterTypes();
 
-	m_TempAllocator = std::make_unique<JPH::TempAllocatorImpl>(10 * 1024 * 1024);
-	m_JobSystem = std::make_unique<JPH::JobSystemThreadPool>(JPH::cMaxPhysicsJobs, JPH::cMaxPhysicsBarriers, std::thread::hardware_concurrency() - 1);
+	SetJobSystem(nullptr);
 
-	const uint32_t maxBodyCount = 4096;
-	const uint32_t numBodyMutexCount = 0;
-	const uint32_t maxBodyPairCount = 8192;
-	const uint32_t maxContactConstraintCount = 8192;
-
-	m_PhysicsSystem.Init(maxBodyCount, numBodyMutexCount, maxBodyPairCount, maxContactConstraintCount,
-		m_BroadPhaseLayerInterfaceImpl,
-		m_ObjectVsBroadPhaseLayerFilterImpl,
-		m_ObjectLayerPairFilterImpl);
-
-	m_PhysicsSystem.SetGravity({ 0.0f, -9.8f, 0.0f });
+	Rebuild(nullptr);
 
 	auto callback = [this](std::shared_ptr<Entity> entity)
 	{
@@ -45,7 +73,21 @@ PhysicsSystem::PhysicsSystem()
 			return;
 		}
 
+		// The compound is rebuilt without the removed part.
+		if (entity->HasComponent<Transform>())
+		{
+			if (RigidBody* compound = GetCompound(entity->GetComponent<Transform>()))
+			{
+				compound->isValid = false;
+			}
+		}
+
 		RigidBody& rigidBody = entity->GetComponent<RigidBody>();
+		if (rigidBody.id.IsInvalid())
+		{
+			return;
+		}
+
 		m_DestroyBodies.emplace_back(rigidBody.id);
 		m_EntitiesByBodyId.erase(rigidBody.id);
 	};
@@ -61,56 +103,380 @@ PhysicsSystem::~PhysicsSystem()
 
 void PhysicsSystem::OnUpdate(const float deltaTime, std::shared_ptr<Scene> scene)
 {
-	UpdateBodies(scene);
+	// Grown limits need a new world, which updates the bodies again and may have to grow once more.
+	if (!m_IsRebuildPending)
+	{
+		UpdateBodies(scene);
+	}
+	while (m_IsRebuildPending)
+	{
+		Rebuild(scene);
+	}
 
-	m_PhysicsSystem.GetBodyInterface().RemoveBodies(m_DestroyBodies.data(), m_DestroyBodies.size());
-	m_PhysicsSystem.GetBodyInterface().DestroyBodies(m_DestroyBodies.data(), m_DestroyBodies.size());
+	m_PhysicsSystem->GetBodyInterface().RemoveBodies(m_DestroyBodies.data(), m_DestroyBodies.size());
+	m_PhysicsSystem->GetBodyInterface().DestroyBodies(m_DestroyBodies.data(), m_DestroyBodies.size());
 	m_DestroyBodies.clear();
 
-	constexpr int collisionStepCount = 1;
-	m_PhysicsSystem.Update(deltaTime, collisionStepCount, m_TempAllocator.get(), m_JobSystem.get());
+	// Accumulated in double, so the number of steps for the same total time doesn't depend on the frame rate.
+	m_Accumulator = glm::min(m_Accumulator + deltaTime, static_cast<double>(m_FixedTimeStep) * m_MaxStepsPerFrame);
 
-	const auto& view = scene->GetRegistry().view<RigidBody>();
-	for (const entt::entity handle : view)
+	JPH::EPhysicsUpdateError updateError = JPH::EPhysicsUpdateError::None;
+
+	const uint32_t stepCount = static_cast<uint32_t>(m_Accumulator / m_FixedTimeStep);
+	for (uint32_t step = 0; step < stepCount; step++)
 	{
-		Transform& transform = scene->GetRegistry().get<Transform>(handle);
-		RigidBody& rigidBody = scene->GetRegistry().get<RigidBody>(handle);
+		// Only the state before the last step is needed to interpolate up to the next one.
+		if (step == stepCount - 1 && m_InterpolationEnabled)
+		{
+			StorePreviousBodyStates();
+		}
+
+		updateError |= m_PhysicsSystem->Update(m_FixedTimeStep, m_CollisionStepCount, m_TempAllocator.get(), m_JobSystem.get());
+		m_StepCount++;
+	}
+	m_Accumulator -= static_cast<double>(stepCount) * m_FixedTimeStep;
+
+	SyncTransforms(scene);
+
+	if (HandleLimits(false, updateError))
+	{
+		Rebuild(scene);
+	}
+}
+
+void PhysicsSystem::SetJobSystem(std::shared_ptr<JPH::JobSystem> jobSystem)
+{
+	if (!jobSystem)
+	{
+		jobSystem = std::make_shared<PhysicsJobSystem>(JPH::cMaxPhysicsJobs, JPH::cMaxPhysicsBarriers, ThreadPool::GetInstance());
+	}
+
+	m_JobSystem = jobSystem;
+}
+
+void PhysicsSystem::SetSettings(const Settings& settings, std::shared_ptr<Scene> scene)
+{
+	m_Settings = settings;
+	Rebuild(scene);
+}
+
+void PhysicsSystem::SetLayersCollide(const JPH::ObjectLayer layerA, const JPH::ObjectLayer layerB, const bool collide)
+{
+	if (layerA >= m_Settings.collisionLayers.size() || layerB >= m_Settings.collisionLayers.size())
+	{
+		Logger::Warning("PhysicsSystem: Layers {} and {} don't exist!", layerA, layerB);
+		return;
+	}
+
+	if (collide)
+	{
+		m_Settings.collisionLayers[layerA].collisionMask |= 1u << layerB;
+		m_Settings.collisionLayers[layerB].collisionMask |= 1u << layerA;
+	}
+	else
+	{
+		m_Settings.collisionLayers[layerA].collisionMask &= ~(1u << layerB);
+		m_Settings.collisionLayers[layerB].collisionMask &= ~(1u << layerA);
+	}
+
+	ApplyCollisionLayers();
+}
+
+bool PhysicsSystem::GetLayersCollide(const JPH::ObjectLayer layerA, const JPH::ObjectLayer layerB) const
+{
+	return m_ObjectLayerPairFilterImpl.ShouldCollide(layerA, layerB);
+}
 
-		if (rigidBody.isStatic)
+void PhysicsSystem::ApplyCollisionLayers()
+{
+	if (m_Settings.collisionLayers.size() > ObjectLayers::MAX_LAYERS)
+	{
+		Logger::Warning("PhysicsSystem: Only {} collision layers are supported, the rest are ignored!", ObjectLayers::MAX_LAYERS);
+		m_Settings.collisionLayers.resize(ObjectLayers::MAX_LAYERS);
+	}
+
+	const size_t layerCount = m_Settings.collisionLayers.size();
+	const uint32_t existingLayersMask = layerCount == ObjectLayers::MAX_LAYERS ? ~0u : (1u << layerCount) - 1;
+
+	m_ObjectLayerPairFilterImpl.m_CollisionMasks.fill(0);
+	m_ObjectVsBroadPhaseLayerFilterImpl.m_BroadPhaseMasks.fill(0);
+	m_BroadPhaseLayerInterfaceImpl.m_ObjectToBroadPhase.fill(BroadPhaseLayers::DYNAMIC);
+
+	for (size_t layer = 0; layer < layerCount; layer++)
+	{
+		CollisionLayer& collisionLayer = m_Settings.collisionLayers[layer];
+		collisionLayer.collisionMask &= existingLayersMask;
+
+		if ((JPH::BroadPhaseLayer::Type)collisionLayer.broadPhaseLayer >= BroadPhaseLayers::NUM_LAYERS)
 		{
-			continue;
+			collisionLayer.broadPhaseLayer = BroadPhaseLayers::DYNAMIC;
 		}
 
-		JPH::BodyLockRead lock(m_PhysicsSystem.GetBodyLockInterface(), rigidBody.id);
-		if (lock.Succeeded())
+		m_BroadPhaseLayerInterfaceImpl.m_ObjectToBroadPhase[layer] = collisionLayer.broadPhaseLayer;
+
+		// A pair collides if either of the layers wants it.
+		for (size_t otherLayer = 0; otherLayer < layerCount; otherLayer++)
 		{
-			const JPH::Body& body = lock.GetBody();
-			glm::vec3 position = JoltVec3ToGlmVec3(body.GetPosition());
-			glm::vec3 rotation = glm::eulerAngles(JoltQuatToGlmQuat(body.GetRotation()));
+			if (collisionLayer.collisionMask & (1u << otherLayer))
+			{
+				m_ObjectLayerPairFilterImpl.m_CollisionMasks[layer] |= 1u << otherLayer;
+				m_ObjectLayerPairFilterImpl.m_CollisionMasks[otherLayer] |= 1u << layer;
+			}
+		}
+	}
 
-			const std::shared_ptr<Entity> entity = transform.GetEntity();
-			if (entity->HasParent())
+	for (size_t layer = 0; layer < layerCount; layer++)
+	{
+		m_Settings.collisionLayers[layer].collisionMask = m_ObjectLayerPairFilterImpl.m_CollisionMasks[layer];
+
+		for (size_t otherLayer = 0; otherLayer < layerCount; otherLayer++)
+		{
+			if (m_ObjectLayerPairFilterImpl.m_CollisionMasks[layer] & (1u << otherLayer))
 			{
-				const Transform& parentTransform = entity->GetParent()->GetComponent<Transform>();
+				const JPH::BroadPhaseLayer broadPhaseLayer = m_Settings.collisionLayers[otherLayer].broadPhaseLayer;
+				m_ObjectVsBroadPhaseLayerFilterImpl.m_BroadPhaseMasks[layer] |= 1u << (JPH::BroadPhaseLayer::Type)broadPhaseLayer;
+			}
+		}
+	}
+}
 
-				glm::vec3 scale;
-				Utils::DecomposeTransform(
-					parentTransform.GetInverseTransformMat4() * glm::translate(glm::mat4(1.0f), position) * glm::toMat4(JoltQuatToGlmQuat(body.GetRotation())),
-					position,
-					rotation,
-					scale);
+void PhysicsSystem::Rebuild(std::shared_ptr<Scene> scene)
+{
+	struct BodyVelocity
+	{
+		entt::entity handle;
+		JPH::Vec3 linearVelocity;
+		JPH::Vec3 angularVelocity;
+	};
+
+	// Bodies of the old world are created again in the new one, only the velocities have to be carried over.
+	std::vector<BodyVelocity> bodyVelocities;
+	if (scene && m_PhysicsSystem)
+	{
+		const JPH::BodyInterface& bodyInterface = m_PhysicsSystem->GetBodyInterfaceNoLock();
+		for (const auto& [handle, rigidBody] : scene->GetRegistry().view<RigidBody>().each())
+		{
+			if (!rigidBody.id.IsInvalid())
+			{
+				bodyVelocities.emplace_back(BodyVelocity{ handle, bodyInterface.GetLinearVelocity(rigidBody.id), bodyInterface.GetAngularVelocity(rigidBody.id) });
 			}
 
-			transform.Translate(position);
-			transform.Rotate(rotation);
+			rigidBody.id = JPH::BodyID();
+			rigidBody.isValid = false;
+		}
+	}
+
+	m_IsRebuildPending = false;
+
+	m_EntitiesByBodyId.clear();
+	m_DestroyBodies.clear();
+	m_PreviousBodyStates.clear();
+
+	ApplyCollisionLayers();
+
+	m_PhysicsSystem = std::make_unique<JPH::PhysicsSystem>();
+	m_TempAllocator = std::make_unique<JPH::TempAllocatorImplWithMallocFallback>(m_Settings.tempAllocatorSize);
+
+	m_PhysicsSystem->Init(
+		m_Settings.maxBodyCount,
+		m_Settings.bodyMutexCount,
+		m_Settings.maxBodyPairCount,
+		m_Settings.maxContactConstraintCount,
+		m_BroadPhaseLayerInterfaceImpl,
+		m_ObjectVsBroadPhaseLayerFilterImpl,
+		m_ObjectLayerPairFilterImpl);
+
+	m_PhysicsSystem->SetGravity({ 0.0f, -9.8f, 0.0f });
+	m_PhysicsSystem->SetBodyActivationListener(&m_BodyActivationListenerImpl);
+	m_BodyActivationListenerImpl.m_DeactivatedBodies.clear();
+
+	if (!scene)
+	{
+		return;
+	}
+
+	UpdateBodies(scene);
+
+	JPH::BodyInterface& bodyInterface = m_PhysicsSystem->GetBodyInterfaceNoLock();
+	for (const BodyVelocity& bodyVelocity : bodyVelocities)
+	{
+		const RigidBody& rigidBody = scene->GetRegistry().get<RigidBody>(bodyVelocity.handle);
+		if (rigidBody.isValid)
+		{
+			bodyInterface.SetLinearAndAngularVelocity(rigidBody.id, bodyVelocity.linearVelocity, bodyVelocity.angularVelocity);
 		}
 	}
+
+	// Shapes no body of the new world took again are only held by the cache.
+	if (!m_IsRebuildPending)
+	{
+		std::erase_if(m_ShapesByHash, [](const auto& shapeByHash)
+		{
+			return shapeByHash.second->GetRefCount() == 1;
+		});
+	}
+}
+
+bool PhysicsSystem::HandleLimits(const bool bodyCountExceeded, const JPH::EPhysicsUpdateError updateError)
+{
+	const bool bodyPairsExceeded = (updateError & JPH::EPhysicsUpdateError::BodyPairCacheFull) != JPH::EPhysicsUpdateError::None;
+	const bool contactsExceeded = (updateError & (JPH::EPhysicsUpdateError::ManifoldCacheFull | JPH::EPhysicsUpdateError::ContactConstraintsFull)) != JPH::EPhysicsUpdateError::None;
+
+	if (!bodyCountExceeded && !bodyPairsExceeded && !contactsExceeded)
+	{
+		return false;
+	}
+
+	if (!m_Settings.allowGrowth)
+	{
+		if (bodyCountExceeded && !m_IsBodyCountReported)
+		{
+			Logger::Error("PhysicsSystem: Max body count {} is exceeded, new bodies are not created!", m_Settings.maxBodyCount);
+			m_IsBodyCountReported = true;
+		}
+
+		const JPH::EPhysicsUpdateError newErrors = static_cast<JPH::EPhysicsUpdateError>(static_cast<uint32_t>(updateError) & ~static_cast<uint32_t>(m_ReportedUpdateErrors));
+		if ((newErrors & JPH::EPhysicsUpdateError::BodyPairCacheFull) != JPH::EPhysicsUpdateError::None)
+		{
+			Logger::Error("PhysicsSystem: Max body pair count {} is exceeded, some contacts are ignored!", m_Settings.maxBodyPairCount);
+		}
+		if ((newErrors & (JPH::EPhysicsUpdateError::ManifoldCacheFull | JPH::EPhysicsUpdateError::ContactConstraintsFull)) != JPH::EPhysicsUpdateError::None)
+		{
+			Logger::Error("PhysicsSystem: Max contact constraint count {} is exceeded, some contacts are ignored!", m_Settings.maxContactConstraintCount);
+		}
+		m_ReportedUpdateErrors |= updateError;
+
+		return false;
+	}
+
+	if (bodyCountExceeded)
+	{
+		m_Settings.maxBodyCount *= 2;
+		Logger::Warning("PhysicsSystem: Max body count is exceeded, growing to {}!", m_Settings.maxBodyCount);
+	}
+
+	if (bodyPairsExceeded)
+	{
+		m_Settings.maxBodyPairCount *= 2;
+		Logger::Warning("PhysicsSystem: Max body pair count is exceeded, growing to {}!", m_Settings.maxBodyPairCount);
+	}
+
+	if (contactsExceeded)
+	{
+		m_Settings.maxContactConstraintCount *= 2;
+		Logger::Warning("PhysicsSystem: Max contact constraint count is exceeded, growing to {}!", m_Settings.maxContactConstraintCount);
+	}
+
+	return true;
+}
+
+void PhysicsSystem::StorePreviousBodyStates()
+{
+	m_PreviousBodyStates.resize(m_PhysicsSystem->GetMaxBodies());
+
+	const JPH::BodyLockInterfaceNoLock& bodyLockInterface = m_PhysicsSystem->GetBodyLockInterfaceNoLock();
+	const JPH::BodyID* activeBodies = m_PhysicsSystem->GetActiveBodiesUnsafe(JPH::EBodyType::RigidBody);
+	const uint32_t activeBodyCount = m_PhysicsSystem->GetNumActiveBodies(JPH::EBodyType::RigidBody);
+
+	for (uint32_t i = 0; i < activeBodyCount; i++)
+	{
+		if (const JPH::Body* body = bodyLockInterface.TryGetBody(activeBodies[i]))
+		{
+			BodyState& state = m_PreviousBodyStates[activeBodies[i].GetIndex()];
+			state.position = JoltVec3ToGlmVec3(body->GetPosition());
+			state.rotation = JoltQuatToGlmQuat(body->GetRotation());
+			state.stepCount = m_StepCount;
+		}
+	}
+}
+
+void PhysicsSystem::SyncTransforms(std::shared_ptr<Scene> scene)
+{
+	entt::registry& registry = scene->GetRegistry();
+
+	// Only bodies that moved during the step are active, sleeping and static bodies are not visited at all.
+	// The simulation is not running, so bodies are accessed without locking.
+	const JPH::BodyLockInterfaceNoLock& bodyLockInterface = m_PhysicsSystem->GetBodyLockInterfaceNoLock();
+	const JPH::BodyID* activeBodies = m_PhysicsSystem->GetActiveBodiesUnsafe(JPH::EBodyType::RigidBody);
+	const uint32_t activeBodyCount = m_PhysicsSystem->GetNumActiveBodies(JPH::EBodyType::RigidBody);
+
+	for (uint32_t i = 0; i < activeBodyCount; i++)
+	{
+		if (const JPH::Body* body = bodyLockInterface.TryGetBody(activeBodies[i]))
+		{
+			SyncTransform(registry, *body, m_InterpolationEnabled);
+		}
+	}
+
+	// Bodies that went to sleep aren't active anymore, they are snapped to where the simulation left them
+	// instead of staying at the last interpolated pose.
+	for (const JPH::BodyID& bodyId : m_BodyActivationListenerImpl.m_DeactivatedBodies)
+	{
+		const JPH::Body* body = bodyLockInterface.TryGetBody(bodyId);
+		if (body && !body->IsActive())
+		{
+			SyncTransform(registry, *body, false);
+		}
+	}
+	m_BodyActivationListenerImpl.m_DeactivatedBodies.clear();
+}
+
+void PhysicsSystem::SyncTransform(entt::registry& registry, const JPH::Body& body, const bool interpolate)
+{
+	if (!body.IsDynamic())
+	{
+		return;
+	}
+
+	const entt::entity handle = static_cast<entt::entity>(body.GetUserData());
+	if (!registry.valid(handle))
+	{
+		return;
+	}
+
+	Transform* transform = registry.try_get<Transform>(handle);
+	if (!transform)
+	{
+		return;
+	}
+
+	glm::vec3 position = JoltVec3ToGlmVec3(body.GetPosition());
+	glm::quat rotation = JoltQuatToGlmQuat(body.GetRotation());
+
+	// Bodies that were asleep before the last step have no previous state and are shown as simulated.
+	const uint32_t bodyIndex = body.GetID().GetIndex();
+	if (interpolate && bodyIndex < m_PreviousBodyStates.size() && m_PreviousBodyStates[bodyIndex].stepCount + 1 == m_StepCount)
+	{
+		const BodyState& previousState = m_PreviousBodyStates[bodyIndex];
+		const float interpolationFactor = GetInterpolationFactor();
+		position = glm::mix(previousState.position, position, interpolationFactor);
+		rotation = glm::slerp(previousState.rotation, rotation, interpolationFactor);
+	}
+
+	const std::shared_ptr<Entity>& entity = transform->GetEntity();
+	if (entity && entity->HasParent())
+	{
+		const Transform& parentTransform = entity->GetParent()->GetComponent<Transform>();
+		position = parentTransform.GetInverseTransformMat4() * glm::vec4(position, 1.0f);
+		rotation = glm::inverse(parentTransform.GetRotationQuat()) * rotation;
+	}
+
+	transform->Translate(position);
+	transform->Rotate(rotation);
+
+	// The body is already where the transform is, don't move it back on the next update.
+	transform->SetDirty(transform->IsDirty() & ~Transform::DirtyFlagBits::PhysicsBody);
 }
 
 void PhysicsSystem::UpdateBodies(std::shared_ptr<Scene> scene)
 {
 	std::vector<JPH::BodyID> destroyBodies;
 	std::vector<JPH::BodyID> addBodies;
+	std::vector<JPH::BodyID> movedBodies;
+	bool bodyCountExceeded = false;
+
+	// Called outside of the physics update, so bodies are accessed without locking.
+	JPH::BodyInterface& bodyInterface = m_PhysicsSystem->GetBodyInterfaceNoLock();
 
 	const auto& view = scene->GetRegistry().view<RigidBody>();
 	for (const entt::entity handle : view)
@@ -118,54 +484,88 @@ void PhysicsSystem::UpdateBodies(std::shared_ptr<Scene> scene)
 		Transform& transform = scene->GetRegistry().get<Transform>(handle);
 		RigidBody& rigidBody = scene->GetRegistry().get<RigidBody>(handle);
 
-		const glm::vec3 position = transform.GetPosition();
-		const glm::quat rotation = transform.GetRotation();
+		if (RigidBody* compound = GetCompound(transform))
+		{
+			// Parts are simulated as a part of the compound body, which has to be rebuilt when they change.
+			if (!rigidBody.isValid)
+			{
+				compound->isValid = false;
+				rigidBody.isValid = true;
+			}
+
+			if (!rigidBody.id.IsInvalid())
+			{
+				destroyBodies.emplace_back(rigidBody.id);
+				m_EntitiesByBodyId.erase(rigidBody.id);
+				rigidBody.id = JPH::BodyID();
+			}
+
+			transform.SetDirty(transform.IsDirty() & ~Transform::DirtyFlagBits::PhysicsBody);
+			continue;
+		}
 
 		if (rigidBody.isValid)
 		{
-			m_PhysicsSystem.GetBodyInterface().SetPositionAndRotationWhenChanged(
+			// Bodies are moved only when their transform has changed since the last sync.
+			if (!(transform.IsDirty() & Transform::DirtyFlagBits::PhysicsBody))
+			{
+				continue;
+			}
+
+			transform.SetDirty(transform.IsDirty() & ~Transform::DirtyFlagBits::PhysicsBody);
+
+			bodyInterface.SetPositionAndRotationWhenChanged(
 				rigidBody.id,
-				GlmVec3ToJoltVec3(position),
-				GlmQuatToJoltQuat(rotation),
-				JPH::EActivation::Activate);
+				GlmVec3ToJoltVec3(transform.GetPosition()),
+				GlmQuatToJoltQuat(transform.GetRotationQuat()),
+				JPH::EActivation::DontActivate);
+
+			movedBodies.emplace_back(rigidBody.id);
 		}
 		else
 		{
+			const glm::vec3 position = transform.GetPosition();
+			const glm::quat rotation = transform.GetRotationQuat();
+
 			if (!rigidBody.id.IsInvalid())
 			{
 				destroyBodies.emplace_back(rigidBody.id);
 				m_EntitiesByBodyId.erase(rigidBody.id);
 			}
 
-			JPH::ShapeSettings::ShapeResult shapeResult;
-			switch (rigidBody.type)
+			JPH::RefConst<JPH::Shape> shape = GetOrCreateShape(scene->GetRegistry(), handle);
+			if (!shape)
 			{
-			case RigidBody::Type::Box:
-			{
-				JPH::BoxShapeSettings boxShapeSettings(GlmVec3ToJoltVec3(rigidBody.shape.box.halfExtents));
-				shapeResult = boxShapeSettings.Create();
-				break;
+				// The mesh is not loaded yet or the shape failed to build, tried again on the next update.
+				rigidBody.id = JPH::BodyID();
+				continue;
 			}
-			case RigidBody::Type::Sphere:
+
+			// Mesh based shapes are cooked unscaled and shared, the scale is applied per body.
+			if ((rigidBody.type == RigidBody::Type::Mesh || rigidBody.type == RigidBody::Type::ConvexHull)
+				&& transform.GetScale() != glm::vec3(1.0f))
 			{
-				JPH::SphereShapeSettings sphereShapeSettings(rigidBody.shape.sphere.radius);
-				shapeResult = sphereShapeSettings.Create();
-				break;
+				shape = new JPH::ScaledShape(shape, GlmVec3ToJoltVec3(transform.GetScale()));
 			}
-			case RigidBody::Type::Cylinder:
+
+			const JPH::ObjectLayer defaultLayer = rigidBody.isStatic ? ObjectLayers::STATIC : ObjectLayers::DYNAMIC;
+			JPH::ObjectLayer layer = rigidBody.layer;
+			if (layer == RigidBody::defaultLayer)
 			{
-				JPH::CylinderShapeSettings cylinderShapeSettings(rigidBody.shape.cylinder.halfHeight, rigidBody.shape.cylinder.radius);
-				shapeResult = cylinderShapeSettings.Create();
-				break;
+				layer = defaultLayer;
 			}
+			else if (layer >= m_Settings.collisionLayers.size())
+			{
+				Logger::Warning("PhysicsSystem: Collision layer {} doesn't exist, the body is moved to the default layer!", layer);
+				layer = defaultLayer;
 			}
 
 			JPH::BodyCreationSettings bodySettings(
-				shapeResult.Get(),
+				shape,
 				GlmVec3ToJoltVec3(position),
 				GlmQuatToJoltQuat(rotation),
 				rigidBody.isStatic ? JPH::EMotionType::Kinematic : JPH::EMotionType::Dynamic,
-				rigidBody.isStatic ? ObjectLayers::STATIC : ObjectLayers::DYNAMIC
+				layer
 			);
 
 			if (!rigidBody.isStatic)
@@ -174,8 +574,19 @@ void PhysicsSystem::UpdateBodies(std::shared_ptr<Scene> scene)
 				bodySettings.mMassPropertiesOverride.mMass = rigidBody.mass;
 			}
 
-			JPH::Body* body = m_PhysicsSystem.GetBodyInterface().CreateBody(bodySettings);
+			bodySettings.mUserData = static_cast<JPH::uint64>(handle);
+
+			JPH::Body* body = bodyInterface.CreateBody(bodySettings);
+			if (!body)
+			{
+				// Out of bodies, the rigid body stays invalid and is created once there is space.
+				rigidBody.id = JPH::BodyID();
+				bodyCountExceeded = true;
+				continue;
+			}
+
 			rigidBody.id = body->GetID();
+			transform.SetDirty(transform.IsDirty() & ~Transform::DirtyFlagBits::PhysicsBody);
 			rigidBody.isValid = true;
 
 			addBodies.emplace_back(rigidBody.id);
@@ -184,11 +595,282 @@ void PhysicsSystem::UpdateBodies(std::shared_ptr<Scene> scene)
 		}
 	}
 
-	m_PhysicsSystem.GetBodyInterface().RemoveBodies(destroyBodies.data(), destroyBodies.size());
-	m_PhysicsSystem.GetBodyInterface().DestroyBodies(destroyBodies.data(), destroyBodies.size());
+	bodyInterface.ActivateBodies(movedBodies.data(), movedBodies.size());
+
+	bodyInterface.RemoveBodies(destroyBodies.data(), destroyBodies.size());
+	bodyInterface.DestroyBodies(destroyBodies.data(), destroyBodies.size());
+
+	const auto state = bodyInterface.AddBodiesPrepare(addBodies.data(), addBodies.size());
+	bodyInterface.AddBodiesFinalize(addBodies.data(), addBodies.size(), state, JPH::EActivation::Activate);
+
+	// Rebuilding from here would recurse, as Rebuild updates the bodies too.
+	if (HandleLimits(bodyCountExceeded, JPH::EPhysicsUpdateError::None))
+	{
+		m_IsRebuildPending = true;
+	}
+}
+
+RigidBody* PhysicsSystem::GetCompound(const Transform& transform)
+{
+	const std::shared_ptr<Entity>& entity = transform.GetEntity();
+	if (!entity || !entity->HasParent())
+	{
+		return nullptr;
+	}
+
+	const std::shared_ptr<Entity> parent = entity->GetParent();
+	if (!parent->HasComponent<RigidBody>())
+	{
+		return nullptr;
+	}
+
+	RigidBody& rigidBody = parent->GetComponent<RigidBody>();
+	return rigidBody.type == RigidBody::Type::Compound ? &rigidBody : nullptr;
+}
+
+JPH::RefConst<JPH::Shape> PhysicsSystem::GetOrCreateShape(entt::registry& registry, const entt::entity handle)
+{
+	const RigidBody& rigidBody = registry.get<RigidBody>(handle);
+
+	switch (rigidBody.type)
+	{
+	case RigidBody::Type::Box:
+	{
+		const size_t hash = Utils::CombineHash(std::hash<int>{}((int)rigidBody.type), Utils::HashBytes(&rigidBody.shape.box, sizeof(RigidBody::Box)));
+		return GetOrCreateShape(hash, [&rigidBody]()
+		{
+			return JPH::BoxShapeSettings(GlmVec3ToJoltVec3(rigidBody.shape.box.halfExtents)).Create();
+		});
+	}
+	case RigidBody::Type::Sphere:
+	{
+		const size_t hash = Utils::CombineHash(std::hash<int>{}((int)rigidBody.type), Utils::HashBytes(&rigidBody.shape.sphere, sizeof(RigidBody::Sphere)));
+		return GetOrCreateShape(hash, [&rigidBody]()
+		{
+			return JPH::SphereShapeSettings(rigidBody.shape.sphere.radius).Create();
+		});
+	}
+	case RigidBody::Type::Cylinder:
+	{
+		const size_t hash = Utils::CombineHash(std::hash<int>{}((int)rigidBody.type), Utils::HashBytes(&rigidBody.shape.cylinder, sizeof(RigidBody::Cylinder)));
+		return GetOrCreateShape(hash, [&rigidBody]()
+		{
+			return JPH::CylinderShapeSettings(rigidBody.shape.cylinder.halfHeight, rigidBody.shape.cylinder.radius).Create();
+		});
+	}
+	case RigidBody::Type::Mesh:
+	case RigidBody::Type::ConvexHull:
+	{
+		if (!rigidBody.mesh)
+		{
+			return nullptr;
+		}
+
+		// Jolt only supports triangle meshes for static and kinematic bodies.
+		const bool isConvex = rigidBody.type == RigidBody::Type::ConvexHull || !rigidBody.isStatic;
+		return GetOrCreateMeshShape(rigidBody.mesh, rigidBody.meshLod, isConvex);
+	}
+	case RigidBody::Type::Compound:
+	{
+		JPH::StaticCompoundShapeSettings compoundShapeSettings;
+
+		const std::shared_ptr<Entity>& entity = registry.get<Transform>(handle).GetEntity();
+		for (const std::weak_ptr<Entity>& weakChild : entity->GetChilds())
+		{
+			const std::shared_ptr<Entity> child = weakChild.lock();
+			if (!child || !child->IsEnabled() || !child->HasComponent<RigidBody>() || !child->HasComponent<Transform>())
+			{
+				continue;
+			}
+
+			const RigidBody& childRigidBody = child->GetComponent<RigidBody>();
+			if (childRigidBody.type == RigidBody::Type::Compound)
+			{
+				Logger::Warning(entity->GetName() + ":Nested compound rigid bodies are not supported!");
+				continue;
+			}
+
+			JPH::RefConst<JPH::Shape> childShape = GetOrCreateShape(registry, child->GetHandle());
+			if (!childShape)
+			{
+				// Not ready yet, the compound is built once all of its parts are.
+				return nullptr;
+			}
+
+			const Transform& childTransform = child->GetComponent<Transform>();
+			if ((childRigidBody.type == RigidBody::Type::Mesh || childRigidBody.type == RigidBody::Type::ConvexHull)
+				&& childTransform.GetScale(Transform::System::LOCAL) != glm::vec3(1.0f))
+			{
+				childShape = new JPH::ScaledShape(childShape, GlmVec3ToJoltVec3(childTransform.GetScale(Transform::System::LOCAL)));
+			}
+
+			compoundShapeSettings.AddShape(
+				GlmVec3ToJoltVec3(childTransform.GetPosition(Transform::System::LOCAL)),
+				GlmQuatToJoltQuat(childTransform.GetRotationQuat(Transform::System::LOCAL)),
+				childShape);
+		}
+
+		if (compoundShapeSettings.mSubShapes.empty())
+		{
+			return nullptr;
+		}
+
+		// Compounds are unique to their entity, so they are not shared.
+		const JPH::ShapeSettings::ShapeResult shapeResult = compoundShapeSettings.Create();
+		if (shapeResult.HasError())
+		{
+			Logger::Error(entity->GetName() + ":Failed to create compound shape! " + shapeResult.GetError().c_str());
+			return nullptr;
+		}
+
+		return shapeResult.Get();
+	}
+	}
+
+	return nullptr;
+}
+
+JPH::RefConst<JPH::Shape> PhysicsSystem::GetOrCreateShape(const size_t hash, const std::function<JPH::ShapeSettings::ShapeResult()>& create)
+{
+	auto foundShape = m_ShapesByHash.find(hash);
+	if (foundShape != m_ShapesByHash.end())
+	{
+		return foundShape->second;
+	}
+
+	const JPH::ShapeSettings::ShapeResult shapeResult = create();
+	if (shapeResult.HasError())
+	{
+		Logger::Error(std::string("PhysicsSystem: Failed to create shape! ") + shapeResult.GetError().c_str());
+		return nullptr;
+	}
+
+	m_ShapesByHash[hash] = shapeResult.Get();
+	return shapeResult.Get();
+}
+
+JPH::RefConst<JPH::Shape> PhysicsSystem::GetOrCreateMeshShape(const std::shared_ptr<Mesh>& mesh, const uint32_t lodIndex, const bool isConvex)
+{
+	const std::vector<Mesh::Lod>& lods = mesh->GetLods();
+	const uint32_t lod = lods.empty() ? 0 : glm::min<uint32_t>(lodIndex, lods.size() - 1);
+
+	// Bump the version when the cooking settings change, so the old cache is not used.
+	constexpr uint32_t cookingVersion = 1;
+	const size_t settingsHash = Utils::CombineHash(
+		Utils::CombineHash(std::hash<uint32_t>{}(cookingVersion), std::hash<uint32_t>{}(lod)),
+		std::hash<bool>{}(isConvex));
+	const size_t hash = Utils::CombineHash(std::hash<std::string>{}(mesh->GetFilepath().string()), settingsHash);
+
+	return GetOrCreateShape(hash, [&]()
+	{
+		JPH::ShapeSettings::ShapeResult shapeResult;
+
+		const std::string data = Serializer::DeserializePhysicsShapeCache(mesh->GetFilepath(), settingsHash);
+		if (!data.empty())
+		{
+			shapeResult = RestoreShape(data);
+			if (shapeResult.IsValid())
+			{
+				return shapeResult;
+			}
+		}
+
+		// Held while cooking, the mesh may release its CPU data meanwhile.
+		const std::shared_ptr<const Mesh::CpuData> cpuData = mesh->GetCpuData();
+		if (!cpuData->vertices)
+		{
+			Logger::Error(mesh->GetFilepath().string() + ":Failed to create collision shape, the mesh keeps no CPU data!");
+			return shapeResult;
+		}
+
+		const std::vector<uint32_t>& indices = cpuData->indices;
+		shapeResult = CookMeshShape(
+			cpuData->vertices,
+			cpuData->vertexStride,
+			mesh->GetVertexCount(),
+			indices,
+			lods.empty() ? 0 : lods[lod].indexOffset,
+			lods.empty() ? indices.size() : lods[lod].indexCount,
+			isConvex);
+
+		if (shapeResult.IsValid())
+		{
+			Serializer::SerializePhysicsShapeCache(mesh->GetFilepath(), settingsHash, SaveShape(*shapeResult.Get()));
+		}
+
+		return shapeResult;
+	});
+}
+
+JPH::ShapeSettings::ShapeResult PhysicsSystem::CookMeshShape(
+	const uint8_t* vertices,
+	const uint32_t vertexStride,
+	const size_t vertexCount,
+	const std::vector<uint32_t>& indices,
+	const size_t indexOffset,
+	const size_t indexCount,
+	const bool isConvex)
+{
+	auto getPosition = [vertices, vertexStride](const uint32_t index)
+	{
+		const glm::vec3& position = *reinterpret_cast<const glm::vec3*>(vertices + static_cast<size_t>(index) * vertexStride);
+		return JPH::Float3(position.x, position.y, position.z);
+	};
+
+	if (isConvex)
+	{
+		// Only the vertices referenced by the lod.
+		std::vector<bool> isUsed(vertexCount, false);
+		JPH::Array<JPH::Vec3> points;
+		for (size_t i = indexOffset; i < indexOffset + indexCount; i++)
+		{
+			const uint32_t index = indices[i];
+			if (!isUsed[index])
+			{
+				isUsed[index] = true;
+				points.emplace_back(JPH::Vec3(getPosition(index)));
+			}
+		}
+
+		return JPH::ConvexHullShapeSettings(points).Create();
+	}
+
+	JPH::VertexList triangleVertices;
+	triangleVertices.reserve(vertexCount);
+	for (uint32_t i = 0; i < vertexCount; i++)
+	{
+		triangleVertices.emplace_back(getPosition(i));
+	}
+
+	JPH::IndexedTriangleList triangles;
+	triangles.reserve(indexCount / 3);
+	for (size_t i = indexOffset; i + 2 < indexOffset + indexCount; i += 3)
+	{
+		triangles.emplace_back(indices[i + 0], indices[i + 1], indices[i + 2]);
+	}
+
+	return JPH::MeshShapeSettings(std::move(triangleVertices), std::move(triangles)).Create();
+}
+
+std::string PhysicsSystem::SaveShape(const JPH::Shape& shape)
+{
+	std::ostringstream stream(std::ios::binary);
+	JPH::StreamOutWrapper streamOut(stream);
+	JPH::Shape::ShapeToIDMap shapeMap;
+	JPH::Shape::MaterialToIDMap materialMap;
+	shape.SaveWithChildren(streamOut, shapeMap, materialMap);
+
+	return stream.str();
+}
+
+JPH::ShapeSettings::ShapeResult PhysicsSystem::RestoreShape(const std::string& data)
+{
+	std::istringstream stream(data, std::ios::binary);
+	JPH::StreamInWrapper streamIn(stream);
+	JPH::Shape::IDToShapeMap shapeMap;
+	JPH::Shape::IDToMaterialMap materialMap;
 
-	const auto state = m_PhysicsSystem.GetBodyInterface().AddBodiesPrepare(addBodies.data(), addBodies.size());
-	m_PhysicsSystem.GetBodyInterface().AddBodiesFinalize(addBodies.data(), addBodies.size(), state, JPH::EActivation::Activate);
+	return JPH::Shape::sRestoreWithChildren(streamIn, shapeMap, materialMap);
 }
 
 entt::entity PhysicsSystem::GetEntity(JPH::BodyID bodyId) const
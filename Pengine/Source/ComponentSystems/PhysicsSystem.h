@@ -6,81 +6,265 @@
 
 #include <Jolt/Jolt.h>
 #include <Jolt/Physics/PhysicsSystem.h>
+#include <Jolt/Physics/Body/BodyActivationListener.h>
 #include <Jolt/Core/TempAllocator.h>
-#include <Jolt/Core/JobSystemThreadPool.h>
+#include <Jolt/Core/JobSystem.h>
+#include <Jolt/Physics/Collision/Shape/Shape.h>
 
 namespace Pengine
 {
 
+	/**
+	 * Default object layers, scenes can rename them and add their own up to MAX_LAYERS.
+	 */
 	namespace ObjectLayers
 	{
 		static constexpr JPH::ObjectLayer STATIC = 0;
 		static constexpr JPH::ObjectLayer DYNAMIC = 1;
-		static constexpr JPH::ObjectLayer NUM_LAYERS = 2;
+		static constexpr JPH::ObjectLayer DEBRIS = 2;
+		static constexpr JPH::ObjectLayer SENSOR = 3;
+		static constexpr JPH::ObjectLayer NUM_LAYERS = 4;
+		static constexpr JPH::ObjectLayer MAX_LAYERS = 32;
 	};
 
 	namespace BroadPhaseLayers
 	{
 		static constexpr JPH::BroadPhaseLayer STATIC(0);
 		static constexpr JPH::BroadPhaseLayer DYNAMIC(1);
-		static constexpr uint32_t NUM_LAYERS(2);
+		static constexpr JPH::BroadPhaseLayer DEBRIS(2);
+		static constexpr JPH::BroadPhaseLayer SENSOR(3);
+		static constexpr uint32_t NUM_LAYERS(4);
 	};
 
 	class PENGINE_API PhysicsSystem : public ComponentSystem
 	{
 	public:
+		struct CollisionLayer
+		{
+			std::string name;
+			JPH::BroadPhaseLayer broadPhaseLayer = BroadPhaseLayers::DYNAMIC;
+
+			// Bit per object layer this layer collides with, kept symmetric by the PhysicsSystem.
+			uint32_t collisionMask = 0;
+		};
+
+		struct Settings
+		{
+			uint32_t maxBodyCount = 4096;
+			uint32_t bodyMutexCount = 0;
+			uint32_t maxBodyPairCount = 8192;
+			uint32_t maxContactConstraintCount = 8192;
+			uint32_t tempAllocatorSize = 10 * 1024 * 1024;
+
+			// When a limit is hit it is doubled and the world is rebuilt, otherwise the limit is only reported.
+			bool allowGrowth = true;
+
+			std::vector<CollisionLayer> collisionLayers = GetDefaultCollisionLayers();
+		};
+
+		/**
+		 * Static, Dynamic, Debris and Sensor layers, debris and sensors don't collide with themselves.
+		 */
+		static std::vector<CollisionLayer> GetDefaultCollisionLayers();
+
 		PhysicsSystem();
+		explicit PhysicsSystem(const Settings& settings);
 		virtual ~PhysicsSystem() override;
 
 		virtual void OnUpdate(const float deltaTime, std::shared_ptr<class Scene> scene) override;
 
 		virtual std::map<std::string, std::function<void(std::shared_ptr<class Entity>)>> GetRemoveCallbacks() override { return m_RemoveCallbacks; }
 
+		/**
+		 * Creates bodies for new or changed rigid bodies and moves the bodies whose transform has changed.
+		 * When the body limit is hit and allowed to grow, the world is rebuilt on the next OnUpdate.
+		 */
 		void UpdateBodies(std::shared_ptr<class Scene> scene);
 
-		JPH::PhysicsSystem& GetInstance() { return m_PhysicsSystem; }
+		/**
+		 * Writes the position and rotation of the active dynamic bodies back to their transforms,
+		 * interpolated between the last two steps when interpolation is enabled.
+		 */
+		void SyncTransforms(std::shared_ptr<class Scene> scene);
+
+		JPH::PhysicsSystem& GetInstance() { return *m_PhysicsSystem; }
+
+		[[nodiscard]] const Settings& GetSettings() const { return m_Settings; }
+
+		/**
+		 * Recreates the world with the new capacities and layers, the existing bodies are created again
+		 * with their current velocities.
+		 */
+		void SetSettings(const Settings& settings, std::shared_ptr<class Scene> scene);
+
+		/**
+		 * Enables or disables collisions between two object layers, takes effect without rebuilding the world.
+		 */
+		void SetLayersCollide(const JPH::ObjectLayer layerA, const JPH::ObjectLayer layerB, const bool collide);
+
+		[[nodiscard]] bool GetLayersCollide(const JPH::ObjectLayer layerA, const JPH::ObjectLayer layerB) const;
+
+		[[nodiscard]] float GetFixedTimeStep() const { return m_FixedTimeStep; }
+
+		/**
+		 * The simulation always advances by this time, frame time is accumulated and consumed in whole steps.
+		 */
+		void SetFixedTimeStep(const float fixedTimeStep) { m_FixedTimeStep = glm::max(fixedTimeStep, 0.0001f); }
+
+		[[nodiscard]] uint32_t GetMaxStepsPerFrame() const { return m_MaxStepsPerFrame; }
+
+		/**
+		 * Accumulated time above this many steps is dropped, so a slow frame can't make the next one even slower.
+		 */
+		void SetMaxStepsPerFrame(const uint32_t maxStepsPerFrame) { m_MaxStepsPerFrame = glm::max(maxStepsPerFrame, 1u); }
+
+		[[nodiscard]] uint32_t GetCollisionStepCount() const { return m_CollisionStepCount; }
+
+		void SetCollisionStepCount(const uint32_t collisionStepCount) { m_CollisionStepCount = glm::max(collisionStepCount, 1u); }
+
+		[[nodiscard]] bool GetInterpolationEnabled() const { return m_InterpolationEnabled; }
+
+		void SetInterpolationEnabled(const bool interpolationEnabled) { m_InterpolationEnabled = interpolationEnabled; }
+
+		/**
+		 * Number of fixed steps simulated since the system was created.
+		 */
+		[[nodiscard]] uint64_t GetStepCount() const { return m_StepCount; }
+
+		/**
+		 * How far the rendered state is from the previous step to the last one, in [0, 1).
+		 */
+		[[nodiscard]] float GetInterpolationFactor() const { return static_cast<float>(m_Accumulator / m_FixedTimeStep); }
 
 		JPH::TempAllocator* GetTempAllocator() { return m_TempAllocator.get(); }
 
+		[[nodiscard]] std::shared_ptr<JPH::JobSystem> GetJobSystem() const { return m_JobSystem; }
+
+		/**
+		 * By default the jobs run on the engine ThreadPool, nullptr switches back to it.
+		 */
+		void SetJobSystem(std::shared_ptr<JPH::JobSystem> jobSystem);
+
+		[[nodiscard]] uint32_t GetBodyCount() const { return m_PhysicsSystem->GetNumBodies(); }
+
 		[[nodiscard]] entt::entity GetEntity(JPH::BodyID bodyId) const;
 
+		/**
+		 * Triangle mesh or convex hull of the triangles in [indexOffset, indexOffset + indexCount),
+		 * the position is the first attribute of every vertex.
+		 */
+		static JPH::ShapeSettings::ShapeResult CookMeshShape(
+			const uint8_t* vertices,
+			const uint32_t vertexStride,
+			const size_t vertexCount,
+			const std::vector<uint32_t>& indices,
+			const size_t indexOffset,
+			const size_t indexCount,
+			const bool isConvex);
+
+		/**
+		 * Binary data of the shape and its children as stored in the shape cache.
+		 */
+		static std::string SaveShape(const JPH::Shape& shape);
+
+		static JPH::ShapeSettings::ShapeResult RestoreShape(const std::string& data);
+
 	private:
+		struct BodyState
+		{
+			glm::vec3 position;
+			glm::quat rotation;
+			uint64_t stepCount = std::numeric_limits<uint64_t>::max();
+		};
 
-		JPH::PhysicsSystem m_PhysicsSystem;
+		/**
+		 * Remembers the state of the active bodies before the step, indexed by the body index.
+		 */
+		void StorePreviousBodyStates();
+
+		/**
+		 * Writes the simulated or interpolated pose of the dynamic body to the transform of its entity.
+		 */
+		void SyncTransform(entt::registry& registry, const JPH::Body& body, const bool interpolate);
+
+		/**
+		 * Returns the compound rigid body the transform is a part of, if any.
+		 */
+		static class RigidBody* GetCompound(const class Transform& transform);
+
+		/**
+		 * Shape for the rigid body of the entity, null if it can't be built yet.
+		 * Everything except compounds is shared between the bodies with the same collider.
+		 */
+		JPH::RefConst<JPH::Shape> GetOrCreateShape(entt::registry& registry, const entt::entity handle);
+
+		JPH::RefConst<JPH::Shape> GetOrCreateShape(const size_t hash, const std::function<JPH::ShapeSettings::ShapeResult()>& create);
+
+		/**
+		 * Triangle mesh or convex hull of the mesh lod, loaded from the shape cache when it is up to date
+		 * and cooked and saved to it otherwise.
+		 */
+		JPH::RefConst<JPH::Shape> GetOrCreateMeshShape(const std::shared_ptr<class Mesh>& mesh, const uint32_t lodIndex, const bool isConvex);
+
+		/**
+		 * Fills the layer filters from the settings, the collision masks are made symmetric.
+		 */
+		void ApplyCollisionLayers();
+
+		/**
+		 * Creates the Jolt world from the settings and moves the bodies of the scene into it, if any.
+		 */
+		void Rebuild(std::shared_ptr<class Scene> scene);
+
+		/**
+		 * Reports the limits that have been hit and grows them when allowed.
+		 * Returns true when the world has to be rebuilt.
+		 */
+		bool HandleLimits(const bool bodyCountExceeded, const JPH::EPhysicsUpdateError updateError);
+
+		Settings m_Settings;
+
+		std::unique_ptr<JPH::PhysicsSystem> m_PhysicsSystem;
 		std::unique_ptr<JPH::TempAllocator> m_TempAllocator;
-		std::unique_ptr<JPH::JobSystemThreadPool> m_JobSystem;
+		std::shared_ptr<JPH::JobSystem> m_JobSystem;
 
 		std::map<std::string, std::function<void(std::shared_ptr<class Entity>)>> m_RemoveCallbacks;
 		std::vector<JPH::BodyID> m_DestroyBodies;
 		std::unordered_map<JPH::BodyID, entt::entity> m_EntitiesByBodyId;
+		std::vector<BodyState> m_PreviousBodyStates;
+
+		// Shapes don't belong to a world, the ones still used are kept when it is rebuilt.
+		std::unordered_map<size_t, JPH::RefConst<JPH::Shape>> m_ShapesByHash;
+
+		double m_Accumulator = 0.0;
+		uint64_t m_StepCount = 0;
+		float m_FixedTimeStep = 1.0f / 60.0f;
+		uint32_t m_MaxStepsPerFrame = 4;
+		uint32_t m_CollisionStepCount = 1;
+		bool m_InterpolationEnabled = true;
+
+		// Limits are reported only once when growth is disabled.
+		bool m_IsBodyCountReported = false;
+		JPH::EPhysicsUpdateError m_ReportedUpdateErrors = JPH::EPhysicsUpdateError::None;
+
+		// Set by UpdateBodies when the limits have grown, the world is rebuilt by OnUpdate.
+		bool m_IsRebuildPending = false;
 
 		class ObjectLayerPairFilterImpl : public JPH::ObjectLayerPairFilter
 		{
 		public:
 			virtual bool ShouldCollide(JPH::ObjectLayer inLayer1, JPH::ObjectLayer inLayer2) const override
 			{
-				switch (inLayer1)
-				{
-				case ObjectLayers::STATIC:
-					return inLayer2 == ObjectLayers::DYNAMIC;
-				case ObjectLayers::DYNAMIC:
-					return true;
-				default:
-					assert(false);
-					return false;
-				}
+				assert(inLayer1 < ObjectLayers::MAX_LAYERS && inLayer2 < ObjectLayers::MAX_LAYERS);
+				return m_CollisionMasks[inLayer1] & (1u << inLayer2);
 			}
+
+			std::array<uint32_t, ObjectLayers::MAX_LAYERS> m_CollisionMasks{};
 		};
 
 		class BroadPhaseLayerInterfaceImpl final : public JPH::BroadPhaseLayerInterface
 		{
 		public:
-			BroadPhaseLayerInterfaceImpl()
-			{
-				m_ObjectToBroadPhase[ObjectLayers::STATIC] = BroadPhaseLayers::STATIC;
-				m_ObjectToBroadPhase[ObjectLayers::DYNAMIC] = BroadPhaseLayers::DYNAMIC;
-			}
-
 			virtual uint32_t GetNumBroadPhaseLayers() const override
 			{
 				return BroadPhaseLayers::NUM_LAYERS;
@@ -88,7 +272,7 @@ namespace Pengine
 
 			virtual JPH::BroadPhaseLayer GetBroadPhaseLayer(JPH::ObjectLayer inLayer) const override
 			{
-				assert(inLayer < ObjectLayers::NUM_LAYERS);
+				assert(inLayer < ObjectLayers::MAX_LAYERS);
 				return m_ObjectToBroadPhase[inLayer];
 			}
 
@@ -101,14 +285,17 @@ namespace Pengine
 					return "STATIC";
 				case (JPH::BroadPhaseLayer::Type)BroadPhaseLayers::DYNAMIC:
 					return "DYNAMIC";
+				case (JPH::BroadPhaseLayer::Type)BroadPhaseLayers::DEBRIS:
+					return "DEBRIS";
+				case (JPH::BroadPhaseLayer::Type)BroadPhaseLayers::SENSOR:
+					return "SENSOR";
 				default:
 					assert(false); return "INVALID";
 				}
 			}
 #endif
 
-		private:
-			JPH::BroadPhaseLayer m_ObjectToBroadPhase[ObjectLayers::NUM_LAYERS];
+			std::array<JPH::BroadPhaseLayer, ObjectLayers::MAX_LAYERS> m_ObjectToBroadPhase{};
 		};
 
 		class ObjectVsBroadPhaseLayerFilterImpl : public JPH::ObjectVsBroadPhaseLayerFilter
@@ -116,22 +303,36 @@ namespace Pengine
 		public:
 			virtual bool ShouldCollide(JPH::ObjectLayer inLayer1, JPH::BroadPhaseLayer inLayer2) const override
 			{
-				switch (inLayer1)
-				{
-				case ObjectLayers::STATIC:
-					return inLayer2 == BroadPhaseLayers::DYNAMIC;
-				case ObjectLayers::DYNAMIC:
-					return true;
-				default:
-					assert(false);
-					return false;
-				}
+				assert(inLayer1 < ObjectLayers::MAX_LAYERS);
+				return m_BroadPhaseMasks[inLayer1] & (1u << (JPH::BroadPhaseLayer::Type)inLayer2);
+			}
+
+			// Bit per broad phase layer that contains at least one object layer this layer collides with.
+			std::array<uint32_t, ObjectLayers::MAX_LAYERS> m_BroadPhaseMasks{};
+		};
+
+		/**
+		 * Collects the bodies that went to sleep during the steps, called from the physics jobs.
+		 */
+		class BodyActivationListenerImpl final : public JPH::BodyActivationListener
+		{
+		public:
+			virtual void OnBodyActivated(const JPH::BodyID& inBodyID, JPH::uint64 inBodyUserData) override {}
+
+			virtual void OnBodyDeactivated(const JPH::BodyID& inBodyID, JPH::uint64 inBodyUserData) override
+			{
+				std::lock_guard<std::mutex> lock(m_Mutex);
+				m_DeactivatedBodies.emplace_back(inBodyID);
 			}
+
+			std::mutex m_Mutex;
+			std::vector<JPH::BodyID> m_DeactivatedBodies;
 		};
 
 		BroadPhaseLayerInterfaceImpl m_BroadPhaseLayerInterfaceImpl;
 		ObjectVsBroadPhaseLayerFilterImpl m_ObjectVsBroadPhaseLayerFilterImpl;
 		ObjectLayerPairFilterImpl m_ObjectLayerPairFilterImpl;
+		BodyActivationListenerImpl m_BodyActivationListenerImpl;
 	};
 
 	inline glm::vec3 JoltVec3ToGlmVec3(const JPH::Vec3& value)
@@ -6,33 +6,89 @@
 #include "../Core/ThreadPool.h"
 #include "../Core/Timer.h"
 
-#include <future>
-
 using namespace Pengine;
 
+// Smaller batches cost more in scheduling than they win in parallelism.
+constexpr size_t animatorsPerBatch = 8;
+
+SkeletalAnimatorSystem::SkeletalAnimatorSystem()
+{
+	m_Lods =
+	{
+		{ 0.25f, 1 },
+		{ 0.1f, 2 },
+		{ 0.0f, 4, 6 }
+	};
+
+	m_InvisibleLod = { 0.0f, 8, 4 };
+}
+
 void SkeletalAnimatorSystem::OnUpdate(const float deltaTime, std::shared_ptr<Scene> scene)
 {
-	const auto& view = scene->GetRegistry().view<SkeletalAnimator>();
+	entt::registry& registry = scene->GetRegistry();
+	const auto& view = registry.view<SkeletalAnimator>();
 	if (view.empty())
 	{
 		return;
 	}
 
-	std::vector<std::future<void>> futures;
-	glm::mat4 identity = glm::mat4(1.0f);
+	struct Job
+	{
+		SkeletalAnimator* skeletalAnimator = nullptr;
+		std::shared_ptr<Entity> topEntity;
+	};
+
+	std::vector<Job> jobs;
+	jobs.reserve(view.size());
 	for (const entt::entity entity : view)
 	{
-		futures.emplace_back(ThreadPool::GetInstance().EnqueueAsyncFuture([this, scene, entity, &identity, deltaTime]()
+		Transform* transform = registry.try_get<Transform>(entity);
+		if (!transform)
+		{
+			continue;
+		}
+
+		SkeletalAnimator& skeletalAnimator = view.get<SkeletalAnimator>(entity);
+		if (skeletalAnimator.GetLodEnabled())
+		{
+			const Lod& lod = SelectLod(skeletalAnimator.GetScreenSize());
+			skeletalAnimator.SetLod(lod.updateInterval, lod.maxBoneDepth, static_cast<uint32_t>(entt::to_entity(entity)));
+		}
+		else
+		{
+			skeletalAnimator.SetLod(1, std::numeric_limits<uint32_t>::max());
+		}
+
+		// The renderer marks the animator again if it is still visible.
+		skeletalAnimator.SetScreenSize(0.0f);
+
+		jobs.emplace_back(&skeletalAnimator, transform->GetEntity()->GetTopEntity());
+	}
+
+	const glm::mat4 identity = glm::mat4(1.0f);
+	ThreadPool::GetInstance().ParallelFor(jobs.size(), animatorsPerBatch, [&jobs, &identity, deltaTime](const size_t begin, const size_t end)
+	{
+		for (size_t i = begin; i < end; i++)
 		{
-			SkeletalAnimator& skeletalAnimator = scene->GetRegistry().get<SkeletalAnimator>(entity);
-			Transform& transform = scene->GetRegistry().get<Transform>(entity);
-			std::shared_ptr<Entity> topEntity = transform.GetEntity()->GetTopEntity();
-			skeletalAnimator.UpdateAnimation(topEntity, deltaTime, identity);
-		}));
+			jobs[i].skeletalAnimator->UpdateAnimation(jobs[i].topEntity, deltaTime, identity);
+		}
+	});
+}
+
+const SkeletalAnimatorSystem::Lod& SkeletalAnimatorSystem::SelectLod(const float screenSize) const
+{
+	if (screenSize <= 0.0f)
+	{
+		return m_InvisibleLod;
 	}
 
-	for (auto& future : futures)
+	for (const Lod& lod : m_Lods)
 	{
-		future.get();
+		if (screenSize >= lod.minScreenSize)
+		{
+			return lod;
+		}
 	}
+
+	return m_Lods.empty() ? m_InvisibleLod : m_Lods.back();
 }
@@ -10,9 +10,37 @@ namespace Pengine
 	class PENGINE_API SkeletalAnimatorSystem : public ComponentSystem
 	{
 	public:
+		/**
+		 * Picked by the screen size of the animated meshes, the first lod with minScreenSize not greater than it is used.
+		 */
+		struct Lod
+		{
+			float minScreenSize = 0.0f;
+			uint32_t updateInterval = 1;
+			uint32_t maxBoneDepth = std::numeric_limits<uint32_t>::max();
+		};
+
+		SkeletalAnimatorSystem();
 		virtual ~SkeletalAnimatorSystem() override = default;
 
 		virtual void OnUpdate(const float deltaTime, std::shared_ptr<class Scene> scene) override;
+
+		[[nodiscard]] const std::vector<Lod>& GetLods() const { return m_Lods; }
+
+		/**
+		 * Lods must be sorted by minScreenSize from the highest to the lowest.
+		 */
+		void SetLods(const std::vector<Lod>& lods) { m_Lods = lods; }
+
+		[[nodiscard]] const Lod& GetInvisibleLod() const { return m_InvisibleLod; }
+
+		void SetInvisibleLod(const Lod& invisibleLod) { m_InvisibleLod = invisibleLod; }
+
+	private:
+		const Lod& SelectLod(const float screenSize) const;
+
+		std::vector<Lod> m_Lods;
+		Lod m_InvisibleLod;
 	};
 
 }
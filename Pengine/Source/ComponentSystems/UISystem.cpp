@@ -7,6 +7,7 @@
 #include "../Core/Viewport.h"
 #include "../Core/ClayManager.h"
 
+#include "../Components/Renderer3D.h"
 #include "../Components/Transform.h"
 
 #include "../Graphics/FrameBuffer.h"
@@ -42,8 +43,20 @@ void UISystem::OnUpdate(const float deltaTime, std::shared_ptr<Scene> scene)
 			}
 		}
 
-		canvas.commands.clear();
+		// The UI pass draws canvases outside of the main viewport into a frame buffer shown on the Renderer3D.
+		if (Renderer3D* r3d = scene->GetRegistry().try_get<Renderer3D>(entity))
+		{
+			if (canvas.drawInMainViewport)
+			{
+				r3d->isEnabled = false;
+			}
+			else if (canvas.size.x > 0 && canvas.size.y > 0)
+			{
+				r3d->isEnabled = true;
+			}
+		}
 
+		canvas.commands.clear();
 
 		for (auto& script : canvas.scripts)
 		{
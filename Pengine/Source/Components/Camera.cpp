@@ -106,8 +106,7 @@ void Camera::CreateRenderView(const std::string& name, const glm::ivec2& size)
 		m_RenderViewsByName[name] = RenderView::Create(passPerViewportOrder, size);
 	};
 
-	std::shared_ptr<NextFrameEvent> event = std::make_shared<NextFrameEvent>(callback, Event::Type::OnNextFrame, this);
-	EventSystem::GetInstance().SendEvent(event);
+	EventSystem::GetInstance().SendEvent(NextFrameEvent{ std::move(callback), this });
 }
 
 void Camera::ResizeRenderView(const std::string& name, const glm::ivec2& size)
@@ -122,8 +121,7 @@ void Camera::ResizeRenderView(const std::string& name, const glm::ivec2& size)
 			}
 		};
 
-		std::shared_ptr<NextFrameEvent> event = std::make_shared<NextFrameEvent>(callback, Event::Type::OnNextFrame, this);
-		EventSystem::GetInstance().SendEvent(event);
+		EventSystem::GetInstance().SendEvent(NextFrameEvent{ std::move(callback), this });
 	}
 }
 
@@ -140,8 +138,7 @@ void Camera::DeleteRenderView(const std::string& name)
 			}
 		};
 
-		std::shared_ptr<NextFrameEvent> event = std::make_shared<NextFrameEvent>(callback, Event::Type::OnNextFrame, this);
-		EventSystem::GetInstance().SendEvent(event);
+		EventSystem::GetInstance().SendEvent(NextFrameEvent{ std::move(callback), this });
 	}
 }
 
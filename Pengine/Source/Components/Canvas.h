@@ -32,8 +32,6 @@ namespace Pengine
 
 		bool drawInMainViewport = false;
 		glm::ivec2 size{};
-
-		std::shared_ptr<class FrameBuffer> frameBuffer;
 	};
 
 }
@@ -1,7 +1,10 @@
 #include "Renderer3D.h"
 
+#include "SkeletalAnimator.h"
+
 #include "../Core/MaterialManager.h"
 #include "../Core/MeshManager.h"
+#include "../Core/Scene.h"
 
 using namespace Pengine;
 
@@ -10,3 +13,33 @@ Renderer3D::~Renderer3D()
 	MaterialManager::GetInstance().DeleteMaterial(material);
 	MeshManager::GetInstance().DeleteMesh(mesh);
 }
+
+entt::entity Renderer3D::GetSkeletalAnimatorEntity(Scene& scene) const
+{
+	if (!skeletalAnimatorEntityUUID.IsValid())
+	{
+		return entt::null;
+	}
+
+	SkeletalAnimatorHandle& handle = m_SkeletalAnimatorHandle;
+	if (handle.uuid != skeletalAnimatorEntityUUID || handle.scene != &scene || !scene.GetRegistry().valid(handle.entity))
+	{
+		const std::shared_ptr<Entity> skeletalAnimatorEntity = scene.FindEntityByUUID(skeletalAnimatorEntityUUID);
+		if (!skeletalAnimatorEntity)
+		{
+			return entt::null;
+		}
+
+		handle.uuid = skeletalAnimatorEntityUUID;
+		handle.scene = &scene;
+		handle.entity = skeletalAnimatorEntity->GetHandle();
+	}
+
+	return handle.entity;
+}
+
+SkeletalAnimator* Renderer3D::GetSkeletalAnimator(Scene& scene) const
+{
+	const entt::entity entity = GetSkeletalAnimatorEntity(scene);
+	return entity != entt::null ? scene.GetRegistry().try_get<SkeletalAnimator>(entity) : nullptr;
+}
@@ -8,6 +8,8 @@ namespace Pengine
 
 	class Mesh;
 	class Material;
+	class Scene;
+	class SkeletalAnimator;
 
 	class PENGINE_API Renderer3D
 	{
@@ -26,9 +28,35 @@ namespace Pengine
 		uint8_t objectVisibilityMask = -1;
 		uint8_t shadowVisibilityMask = -1;
 
+		/**
+		 * Matched against Raycast::Query::raycastMask, clear all bits to ignore the object in scene ray casts.
+		 */
+		uint8_t raycastMask = -1;
+
 		UUID skeletalAnimatorEntityUUID = UUID(0, 0);
 
 		~Renderer3D();
+
+		/**
+		 * Resolves skeletalAnimatorEntityUUID once and keeps the entity handle, it is resolved again
+		 * only when the uuid changes or the animator entity is deleted, which makes the versioned handle invalid.
+		 */
+		[[nodiscard]] SkeletalAnimator* GetSkeletalAnimator(Scene& scene) const;
+
+		/**
+		 * The entity GetSkeletalAnimator() looks in, entt::null if skeletalAnimatorEntityUUID doesn't resolve.
+		 */
+		[[nodiscard]] entt::entity GetSkeletalAnimatorEntity(Scene& scene) const;
+
+	private:
+		struct SkeletalAnimatorHandle
+		{
+			UUID uuid = UUID(0, 0);
+			const Scene* scene = nullptr;
+			entt::entity entity = entt::null;
+		};
+
+		mutable SkeletalAnimatorHandle m_SkeletalAnimatorHandle;
 	};
 
 }
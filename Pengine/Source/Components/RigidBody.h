@@ -4,6 +4,7 @@
 
 #include <Jolt/Jolt.h>
 #include <Jolt/Physics/Body/BodyID.h>
+#include <Jolt/Physics/Collision/ObjectLayer.h>
 
 namespace Pengine
 {
@@ -16,7 +17,10 @@ namespace Pengine
 		{
 			Box,
 			Sphere,
-			Cylinder
+			Cylinder,
+			Mesh,		// Triangles of the mesh lod, static bodies only, dynamic ones fall back to ConvexHull.
+			ConvexHull,	// Convex hull of the mesh lod vertices.
+			Compound	// Made of the shapes of the child entities with a rigid body, which don't get bodies of their own.
 		};
 
 		struct Box
@@ -46,6 +50,16 @@ namespace Pengine
 		Type type = Type::Box;
 		JPH::BodyID id;
 
+		// Source of the Mesh and ConvexHull shapes, scaled by the transform.
+		std::shared_ptr<class Mesh> mesh;
+		uint32_t meshLod = 0;
+
+		// Follows isStatic, ObjectLayers::STATIC or ObjectLayers::DYNAMIC, until a layer is set.
+		static constexpr JPH::ObjectLayer defaultLayer = JPH::cObjectLayerInvalid;
+
+		// Index into PhysicsSystem::Settings::collisionLayers.
+		JPH::ObjectLayer layer = defaultLayer;
+
 		float mass = 1.0f;
 
 		bool isStatic = false;
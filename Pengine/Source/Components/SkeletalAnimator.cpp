@@ -13,7 +13,7 @@ namespace Pengine
 
 	SkeletalAnimator::SkeletalAnimator()
 	{
-		m_FinalBoneMatrices.resize(100, glm::mat4(1.0f));
+		SetMaxBones(defaultMaxBones);
 	}
 
 	SkeletalAnimator::SkeletalAnimator(const SkeletalAnimator& skeletalAnimator)
@@ -22,11 +22,8 @@ namespace Pengine
 		m_Speed = skeletalAnimator.GetSpeed();
 		m_SkeletalAnimation = skeletalAnimator.GetSkeletalAnimation();
 		m_Skeleton = skeletalAnimator.GetSkeleton();
-		m_FinalBoneMatrices.resize(100, glm::mat4(1.0f));
-
-		// For every new skeletal animator component need to create a unique uniform writer and buffer.
-		m_UniformWriter = nullptr;
-		m_Buffer = nullptr;
+		m_LodEnabled = skeletalAnimator.GetLodEnabled();
+		SetMaxBones(skeletalAnimator.GetMaxBones());
 	}
 
 	void SkeletalAnimator::UpdateAnimation(std::shared_ptr<Entity> entity, const float deltaTime, const glm::mat4& parentTransform)
@@ -63,9 +60,96 @@ namespace Pengine
 			m_NextTime = fmod(m_NextTime, m_NextSkeletalAnimation->GetDuration());
 		}
 
-		for (const uint32_t& rootBoneId : m_Skeleton->GetRootBoneIds())
+		if (m_BoundSkeleton.lock() != m_Skeleton || m_BoundEntity.lock() != entity)
+		{
+			BindEntities(entity);
+		}
+
+		if (m_BoundSkeletalAnimation.lock() != m_SkeletalAnimation)
+		{
+			BindChannels(m_SkeletalAnimation, false);
+		}
+
+		if (m_BoundNextSkeletalAnimation.lock() != m_NextSkeletalAnimation)
+		{
+			BindChannels(m_NextSkeletalAnimation, true);
+		}
+
+		if (m_UpdateInterval <= 1)
+		{
+			SampleBoneTransforms(0.0f, m_Pose);
+			CalculateBoneTransforms(parentTransform);
+			UpdateBoneEntities(entity);
+
+			m_IsPoseValid = true;
+			return;
+		}
+
+		if (!m_IsPoseValid)
+		{
+			SampleBoneTransforms(0.0f, m_Pose);
+			m_IsPoseValid = true;
+		}
+
+		if (m_UpdatePhase == 0)
+		{
+			// The target pose is evaluated for the end of the interval and reached by interpolation,
+			// so the reduced rate doesn't make the animation lag behind.
+			m_PreviousPose = m_Pose;
+			m_TargetPose = m_Pose;
+			SampleBoneTransforms((m_UpdateInterval - 1) * deltaTime * m_Speed, m_TargetPose);
+		}
+		else if (!m_IsTargetPoseValid)
+		{
+			// Started in the middle of the interval, hold the current pose until the next evaluation.
+			m_PreviousPose = m_Pose;
+			m_TargetPose = m_Pose;
+		}
+		m_IsTargetPoseValid = true;
+
+		m_UpdatePhase++;
+
+		// The local transforms are blended instead of the palette, so the bone entities get the same pose as the GPU.
+		const float factor = static_cast<float>(m_UpdatePhase) / static_cast<float>(m_UpdateInterval);
+		for (size_t i = 0; i < m_Pose.positions.size(); i++)
+		{
+			m_Pose.positions[i] = glm::mix(m_PreviousPose.positions[i], m_TargetPose.positions[i], factor);
+			m_Pose.rotations[i] = glm::slerp(m_PreviousPose.rotations[i], m_TargetPose.rotations[i], factor);
+			m_Pose.scales[i] = glm::mix(m_PreviousPose.scales[i], m_TargetPose.scales[i], factor);
+		}
+
+		CalculateBoneTransforms(parentTransform);
+		UpdateBoneEntities(entity);
+
+		if (m_UpdatePhase >= m_UpdateInterval)
 		{
-			CalculateBoneTransform(entity, rootBoneId, parentTransform);
+			m_UpdatePhase = 0;
+		}
+	}
+
+	void SkeletalAnimator::SetMaxBones(const uint32_t maxBones)
+	{
+		if (maxBones == 0)
+		{
+			Logger::Warning(Logger::Category::Animation, "SkeletalAnimator: Max bones must be at least 1, keeping {}!", m_FinalBoneMatrices.size());
+			return;
+		}
+
+		m_FinalBoneMatrices.resize(maxBones, glm::mat4(1.0f));
+		m_IsPoseValid = false;
+		m_IsTargetPoseValid = false;
+	}
+
+	void SkeletalAnimator::SetLod(const uint32_t updateInterval, const uint32_t maxBoneDepth, const uint32_t phase)
+	{
+		m_MaxBoneDepth = maxBoneDepth;
+
+		const uint32_t newUpdateInterval = glm::max(updateInterval, 1u);
+		if (m_UpdateInterval != newUpdateInterval)
+		{
+			m_UpdateInterval = newUpdateInterval;
+			m_UpdatePhase = phase % newUpdateInterval;
+			m_IsTargetPoseValid = false;
 		}
 	}
 
@@ -90,76 +174,239 @@ namespace Pengine
 		m_IsBlending = true;
 	}
 
-	void SkeletalAnimator::CalculateBoneTransform(std::shared_ptr<Entity> entity, const uint32_t boneId, const glm::mat4& parentTransform)
+	void SkeletalAnimator::BindEntities(const std::shared_ptr<Entity>& entity)
 	{
-		const Skeleton::Bone& node = m_Skeleton->GetBones()[boneId];
-		std::string nodeName = node.name;
+		const std::vector<uint32_t>& sortedBoneIds = m_Skeleton->GetSortedBoneIds();
+		const std::vector<Skeleton::Bone>& bones = m_Skeleton->GetBones();
 
-		glm::vec3 currentPosition = glm::vec3(0.0f);
-		glm::quat currentRotation = glm::quat(glm::vec3(0.0f));
-		glm::vec3 currentScale = glm::vec3(1.0f);
-		if (m_SkeletalAnimation->GetBonesByName().contains(nodeName))
+		// One pass over the hierarchy instead of a search per node, the first entity found with a name wins
+		// the same way as in Entity::FindEntityInHierarchy.
+		std::unordered_map<std::string, entt::entity> entitiesByName;
+		std::function<void(const std::shared_ptr<Entity>&)> collectEntities = [&collectEntities, &entitiesByName](const std::shared_ptr<Entity>& entity)
 		{
-			const SkeletalAnimation::Bone& bone = m_SkeletalAnimation->GetBonesByName().at(nodeName);
-			bone.Update(m_CurrentTime, currentPosition, currentRotation, currentScale);
+			entitiesByName.emplace(entity->GetName(), entity->GetHandle());
+
+			for (const std::weak_ptr<Entity>& weakChild : entity->GetChilds())
+			{
+				if (const std::shared_ptr<Entity> child = weakChild.lock())
+				{
+					collectEntities(child);
+				}
+			}
+		};
+		collectEntities(entity);
+
+		m_BoneBindings.resize(sortedBoneIds.size());
+		m_GlobalTransforms.resize(sortedBoneIds.size());
+
+		// Bones skipped by the bone lod keep these until they are evaluated, the same as a bone without a channel.
+		m_Pose.positions.assign(sortedBoneIds.size(), glm::vec3(0.0f));
+		m_Pose.rotations.assign(sortedBoneIds.size(), glm::quat(1.0f, 0.0f, 0.0f, 0.0f));
+		m_Pose.scales.assign(sortedBoneIds.size(), glm::vec3(1.0f));
+
+		if (bones.size() > m_FinalBoneMatrices.size())
+		{
+			Logger::Warning(Logger::Category::Animation, "{}: Skeleton has {} bones, only {} of them are animated on the GPU!",
+				m_Skeleton->GetName(), bones.size(), m_FinalBoneMatrices.size());
 		}
 
-		if (m_NextSkeletalAnimation && m_NextSkeletalAnimation->GetBonesByName().contains(nodeName))
+		m_BoneEntities.clear();
+		for (size_t i = 0; i < sortedBoneIds.size(); i++)
 		{
-			const SkeletalAnimation::Bone& bone = m_NextSkeletalAnimation->GetBonesByName().at(nodeName);
+			const auto foundEntity = entitiesByName.find(bones[sortedBoneIds[i]].name);
+			m_BoneBindings[i].entity = foundEntity != entitiesByName.end() ? foundEntity->second : entt::null;
+			m_BoneEntities.emplace(m_BoneBindings[i].entity);
+		}
+
+		m_BoundSkeleton = m_Skeleton;
+		m_BoundEntity = entity;
+		m_IsPoseValid = false;
+		m_IsTargetPoseValid = false;
 
-			glm::vec3 nextPosition;
-			glm::quat nextRotation;
-			glm::vec3 nextScale;
-			bone.Update(m_NextTime, nextPosition, nextRotation, nextScale);
+		// Channels are stored in the same array, so they have to be resolved again for the new skeleton.
+		BindChannels(m_SkeletalAnimation, false);
+		BindChannels(m_NextSkeletalAnimation, true);
+	}
+
+	void SkeletalAnimator::BindChannels(const std::shared_ptr<SkeletalAnimation>& skeletalAnimation, const bool isNext)
+	{
+		const std::vector<uint32_t>& sortedBoneIds = m_Skeleton->GetSortedBoneIds();
+		const std::vector<Skeleton::Bone>& bones = m_Skeleton->GetBones();
 
-			currentPosition = glm::mix(currentPosition, nextPosition, m_TransitionTimer / m_TransitionTime);
-			currentRotation = glm::normalize(glm::slerp(currentRotation, nextRotation, m_TransitionTimer / m_TransitionTime));
-			currentScale = glm::mix(currentScale, nextScale, m_TransitionTimer / m_TransitionTime);
+		for (size_t i = 0; i < m_BoneBindings.size(); i++)
+		{
+			const SkeletalAnimation::Channel* channel = nullptr;
+			if (skeletalAnimation)
+			{
+				const auto& channelsByName = skeletalAnimation->GetChannelsByName();
+				const auto foundChannel = channelsByName.find(bones[sortedBoneIds[i]].name);
+				channel = foundChannel != channelsByName.end() ? &foundChannel->second : nullptr;
+			}
+
+			if (isNext)
+			{
+				m_BoneBindings[i].nextChannel = channel;
+				m_BoneBindings[i].nextCursor = {};
+			}
+			else
+			{
+				m_BoneBindings[i].currentChannel = channel;
+				m_BoneBindings[i].currentCursor = {};
+			}
 		}
 
-		glm::mat4 nodeTransform = glm::translate(glm::mat4(1.0f), currentPosition) * glm::toMat4(currentRotation) * glm::scale(glm::mat4(1.0f), currentScale);
-		glm::mat4 globalTransform;
-		if (m_ApplySkeletonTransform) globalTransform = parentTransform * node.transform * nodeTransform;
-		else globalTransform = parentTransform * nodeTransform;
-		
-		m_FinalBoneMatrices[node.id] = globalTransform * node.offset;
+		if (isNext)
+		{
+			m_BoundNextSkeletalAnimation = skeletalAnimation;
+		}
+		else
+		{
+			m_BoundSkeletalAnimation = skeletalAnimation;
+		}
+	}
+
+	void SkeletalAnimator::SampleBoneTransforms(const float timeOffset, Pose& pose)
+	{
+		const size_t sampledBoneCount = m_Skeleton->GetSortedBoneCount(m_MaxBoneDepth);
+
+		const bool isTransitioning = m_NextSkeletalAnimation != nullptr;
+		const float transitionFactor = isTransitioning ? m_TransitionTimer / m_TransitionTime : 0.0f;
+
+		const float currentTime = timeOffset > 0.0f ? fmod(m_CurrentTime + timeOffset, m_SkeletalAnimation->GetDuration()) : m_CurrentTime;
+		const float nextTime = isTransitioning && timeOffset > 0.0f ? fmod(m_NextTime + timeOffset, m_NextSkeletalAnimation->GetDuration()) : m_NextTime;
+
+		for (size_t i = 0; i < sampledBoneCount && i < m_BoneBindings.size(); i++)
+		{
+			BoneBinding& boneBinding = m_BoneBindings[i];
+
+			glm::vec3 currentPosition = glm::vec3(0.0f);
+			glm::quat currentRotation = glm::quat(glm::vec3(0.0f));
+			glm::vec3 currentScale = glm::vec3(1.0f);
+			if (boneBinding.currentChannel)
+			{
+				boneBinding.currentChannel->Update(currentTime, currentPosition, currentRotation, currentScale, &boneBinding.currentCursor);
+			}
+
+			if (isTransitioning && boneBinding.nextChannel)
+			{
+				glm::vec3 nextPosition;
+				glm::quat nextRotation;
+				glm::vec3 nextScale;
+				boneBinding.nextChannel->Update(nextTime, nextPosition, nextRotation, nextScale, &boneBinding.nextCursor);
+
+				currentPosition = glm::mix(currentPosition, nextPosition, transitionFactor);
+				currentRotation = glm::normalize(glm::slerp(currentRotation, nextRotation, transitionFactor));
+				currentScale = glm::mix(currentScale, nextScale, transitionFactor);
+			}
+
+			pose.positions[i] = currentPosition;
+			pose.rotations[i] = currentRotation;
+			pose.scales[i] = currentScale;
+		}
+	}
+
+	void SkeletalAnimator::CalculateBoneTransforms(const glm::mat4& parentTransform)
+	{
+		const std::vector<uint32_t>& sortedBoneIds = m_Skeleton->GetSortedBoneIds();
+		const std::vector<int32_t>& sortedParentIndices = m_Skeleton->GetSortedParentIndices();
+		const std::vector<Skeleton::Bone>& bones = m_Skeleton->GetBones();
+
+		for (size_t i = 0; i < sortedBoneIds.size(); i++)
+		{
+			const Skeleton::Bone& node = bones[sortedBoneIds[i]];
+
+			const glm::mat4 nodeTransform = glm::translate(glm::mat4(1.0f), m_Pose.positions[i]) * glm::toMat4(m_Pose.rotations[i]) * glm::scale(glm::mat4(1.0f), m_Pose.scales[i]);
+			const int32_t parentIndex = sortedParentIndices[i];
+			const glm::mat4& parentGlobalTransform = parentIndex < 0 ? parentTransform : m_GlobalTransforms[parentIndex];
+
+			glm::mat4& globalTransform = m_GlobalTransforms[i];
+			if (m_ApplySkeletonTransform) globalTransform = parentGlobalTransform * node.transform * nodeTransform;
+			else globalTransform = parentGlobalTransform * nodeTransform;
+
+			if (node.id < m_FinalBoneMatrices.size())
+			{
+				m_FinalBoneMatrices[node.id] = globalTransform * node.offset;
+			}
+		}
+	}
+
+	void SkeletalAnimator::UpdateBoneEntities(const std::shared_ptr<Entity>& entity)
+	{
+		entt::registry& registry = entity->GetRegistry();
 
-		// TODO: Very slow, maybe optimize!
-		if (const auto& boneEntity = entity->FindEntityInHierarchy(node.name))
+		// Translate, Rotate and Scale would mark every bone below on each call, so the local transforms are written first
+		// and the global ones are updated once per bone afterwards, parents first in the sorted order.
+		m_BoneEntityTransforms.assign(m_BoneBindings.size(), nullptr);
+		for (size_t i = 0; i < m_BoneBindings.size(); i++)
 		{
-			Transform& boneEntityTransform = boneEntity->GetComponent<Transform>();
+			const entt::entity boneEntityHandle = m_BoneBindings[i].entity;
+			if (boneEntityHandle == entt::null)
+			{
+				continue;
+			}
+
+			if (!registry.valid(boneEntityHandle))
+			{
+				// The bone entity has been deleted, resolve the hierarchy again on the next update.
+				InvalidateBindings();
+				continue;
+			}
+
+			Transform* boneEntityTransform = registry.try_get<Transform>(boneEntityHandle);
+			if (!boneEntityTransform)
+			{
+				continue;
+			}
 
 			if (m_ApplySkeletonTransform)
 			{
 				glm::vec3 newPosition = glm::vec3(0.0f);
 				glm::vec3 newRotation = glm::vec3(0.0f);
 				glm::vec3 newScale = glm::vec3(1.0f);
-				Utils::DecomposeTransform(globalTransform, newPosition, newRotation, newScale);
-				boneEntityTransform.Translate(newPosition);
-				boneEntityTransform.Rotate(newRotation);
-				boneEntityTransform.Scale(newScale);
+				Utils::DecomposeTransform(m_GlobalTransforms[i], newPosition, newRotation, newScale);
+				boneEntityTransform->SetLocalTransform(newPosition, glm::quat(newRotation), newScale);
 			}
 			else
 			{
-				boneEntityTransform.Translate(currentPosition);
-				boneEntityTransform.Rotate(glm::eulerAngles(currentRotation));
-				boneEntityTransform.Scale(currentScale);
+				boneEntityTransform->SetLocalTransform(m_Pose.positions[i], m_Pose.rotations[i], m_Pose.scales[i]);
+			}
+
+			m_BoneEntityTransforms[i] = boneEntityTransform;
+		}
+
+		for (Transform* boneEntityTransform : m_BoneEntityTransforms)
+		{
+			if (!boneEntityTransform)
+			{
+				continue;
+			}
+
+			boneEntityTransform->UpdateGlobalTransform();
+
+			const std::shared_ptr<Entity> boneEntity = boneEntityTransform->GetEntity();
+			if (!boneEntity)
+			{
+				continue;
+			}
+
+			// Entities attached to a bone aren't updated by the pass, they follow it the same way as after Translate.
+			for (const std::weak_ptr<Entity>& weakChild : boneEntity->GetChilds())
+			{
+				const std::shared_ptr<Entity> child = weakChild.lock();
+				if (child && !m_BoneEntities.contains(child->GetHandle()))
+				{
+					child->GetComponent<Transform>().Invalidate();
+				}
 			}
 
 			if (GetDrawDebugSkeleton() && boneEntity->HasParent())
 			{
 				boneEntity->GetScene()->GetVisualizer().DrawLine(
-					boneEntityTransform.GetPosition(),
+					boneEntityTransform->GetPosition(),
 					boneEntity->GetParent()->GetComponent<Transform>().GetPosition(),
 					{ 1.0f, 0.0f, 1.0f });
 			}
 		}
-
-		for (int i = 0; i < node.childIds.size(); i++)
-		{
-			CalculateBoneTransform(entity, m_Skeleton->GetBones()[node.childIds[i]].id, globalTransform);
-		}
 	}
 
 }
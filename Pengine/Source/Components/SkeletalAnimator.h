@@ -2,18 +2,23 @@
 
 #include "../Core/Core.h"
 
+#include "../Graphics/SkeletalAnimation.h"
+
 namespace Pengine
 {
 
 	class Skeleton;
-	class SkeletalAnimation;
-	class UniformWriter;
-	class Buffer;
 	class Entity;
+	class Transform;
 
 	class PENGINE_API SkeletalAnimator
 	{
 	public:
+		/**
+		 * Size of the bone palette, bone ids past it leave the vertices unskinned.
+		 */
+		static constexpr uint32_t defaultMaxBones = 100;
+
 		SkeletalAnimator();
 		SkeletalAnimator(const SkeletalAnimator& skeletalAnimator);
 
@@ -29,13 +34,12 @@ namespace Pengine
 
 		[[nodiscard]] const std::vector<glm::mat4>& GetFinalBoneMatrices() const { return m_FinalBoneMatrices; }
 
-		[[nodiscard]] std::shared_ptr<UniformWriter> GetUniformWriter() const { return m_UniformWriter; }
-		
-		void SetUniformWriter(std::shared_ptr<UniformWriter> uniformWriter) { m_UniformWriter = uniformWriter; }
+		[[nodiscard]] uint32_t GetMaxBones() const { return static_cast<uint32_t>(m_FinalBoneMatrices.size()); }
 
-		[[nodiscard]] std::shared_ptr<Buffer> GetBuffer() const { return m_Buffer; }
-
-		void SetBuffer(std::shared_ptr<Buffer> buffer) { m_Buffer = buffer; }
+		/**
+		 * Zero is rejected with a warning, the palette is left as it is.
+		 */
+		void SetMaxBones(const uint32_t maxBones);
 
 		[[nodiscard]] std::shared_ptr<Skeleton> GetSkeleton() const { return m_Skeleton; }
 
@@ -59,23 +63,107 @@ namespace Pengine
 
 		void SetApplySkeletonTransform(bool applySkeletonTransform) { m_ApplySkeletonTransform = applySkeletonTransform; }
 
+		bool GetLodEnabled() const { return m_LodEnabled; }
+
+		void SetLodEnabled(bool lodEnabled) { m_LodEnabled = lodEnabled; }
+
+		/**
+		 * The pose is evaluated only every updateInterval updates and the local bone transforms are interpolated in between,
+		 * bones deeper than maxBoneDepth keep their last evaluated local transform.
+		 * The phase offsets the evaluation so animators with the same interval don't all update on the same frame.
+		 */
+		void SetLod(const uint32_t updateInterval, const uint32_t maxBoneDepth, const uint32_t phase = 0);
+
+		[[nodiscard]] uint32_t GetUpdateInterval() const { return m_UpdateInterval; }
+
+		[[nodiscard]] uint32_t GetMaxBoneDepth() const { return m_MaxBoneDepth; }
+
+		/**
+		 * Fraction of the viewport height covered by the skinned meshes driven by this animator,
+		 * written by the renderer and reset by SkeletalAnimatorSystem after the lod is picked, 0 when not visible.
+		 */
+		[[nodiscard]] float GetScreenSize() const { return m_ScreenSize; }
+
+		void SetScreenSize(const float screenSize) { m_ScreenSize = screenSize; }
+
+		/**
+		 * Forces the skeleton nodes to be resolved to the animation channels and the hierarchy entities again,
+		 * needed when bone entities are added or renamed after the animator has been updated.
+		 */
+		void InvalidateBindings() { m_BoundEntity.reset(); }
+
 	private:
-		void CalculateBoneTransform(std::shared_ptr<Entity> entity, const uint32_t boneId, const glm::mat4& parentTransform);
+		/**
+		 * Skeleton node resolved once to the animation channels and the entity it drives,
+		 * stored in the order of Skeleton::GetSortedBoneIds().
+		 */
+		struct BoneBinding
+		{
+			const SkeletalAnimation::Channel* currentChannel = nullptr;
+			const SkeletalAnimation::Channel* nextChannel = nullptr;
+			SkeletalAnimation::Cursor currentCursor{};
+			SkeletalAnimation::Cursor nextCursor{};
+			entt::entity entity = entt::null;
+		};
+
+		/**
+		 * Local transforms of the skeleton nodes in the order of Skeleton::GetSortedBoneIds().
+		 */
+		struct Pose
+		{
+			std::vector<glm::vec3> positions;
+			std::vector<glm::quat> rotations;
+			std::vector<glm::vec3> scales;
+		};
+
+		void BindEntities(const std::shared_ptr<Entity>& entity);
+
+		void BindChannels(const std::shared_ptr<SkeletalAnimation>& skeletalAnimation, const bool isNext);
+
+		/**
+		 * Samples the bones up to the max bone depth, the deeper ones keep what the pose already has.
+		 */
+		void SampleBoneTransforms(const float timeOffset, Pose& pose);
+
+		/**
+		 * Builds the global transforms and the bone palette from the current pose.
+		 */
+		void CalculateBoneTransforms(const glm::mat4& parentTransform);
+
+		void UpdateBoneEntities(const std::shared_ptr<Entity>& entity);
 
 		std::vector<glm::mat4> m_FinalBoneMatrices;
 
+		std::vector<BoneBinding> m_BoneBindings;
+		std::unordered_set<entt::entity> m_BoneEntities;
+		std::vector<Transform*> m_BoneEntityTransforms;
+		std::vector<glm::mat4> m_GlobalTransforms;
+		Pose m_Pose;
+		Pose m_PreviousPose;
+		Pose m_TargetPose;
+
+		// Weak, so a new object allocated at the address of a destroyed one isn't taken for the bound one.
+		std::weak_ptr<Skeleton> m_BoundSkeleton;
+		std::weak_ptr<Entity> m_BoundEntity;
+		std::weak_ptr<SkeletalAnimation> m_BoundSkeletalAnimation;
+		std::weak_ptr<SkeletalAnimation> m_BoundNextSkeletalAnimation;
+
 		std::shared_ptr<Skeleton> m_Skeleton;
 		std::shared_ptr<SkeletalAnimation> m_SkeletalAnimation;
 		std::shared_ptr<SkeletalAnimation> m_NextSkeletalAnimation;
 
-		std::shared_ptr<UniformWriter> m_UniformWriter;
-		std::shared_ptr<Buffer> m_Buffer;
-
 		float m_TransitionTime = 0.0f;
 		float m_TransitionTimer = 0.0f;
 		float m_Speed = 0.0f;
 		float m_CurrentTime = 0.0f;
 		float m_NextTime = 0.0f;
+		float m_ScreenSize = 0.0f;
+		uint32_t m_UpdateInterval = 1;
+		uint32_t m_MaxBoneDepth = std::numeric_limits<uint32_t>::max();
+		uint32_t m_UpdatePhase = 0;
+		bool m_IsPoseValid = false;
+		bool m_IsTargetPoseValid = false;
+		bool m_LodEnabled = true;
 		bool m_IsBlending = false;
 		bool m_ApplySkeletonTransform = false;
 		bool m_DrawDebugSkeleton = false;
@@ -319,7 +319,7 @@ void Transform::Translate(const glm::vec3& position)
 
 	UpdateTransforms();
 
-	SetDirty(IsDirty() | DirtyFlagBits::TranslateMat4 | DirtyFlagBits::TransformMat4);
+	SetDirty(IsDirty() | DirtyFlagBits::TranslateMat4 | DirtyFlagBits::TransformMat4 | DirtyFlagBits::PhysicsBody);
 
 	std::function<void(Transform&)> translationCallbacks = [&translationCallbacks](const Transform& transform)
 	{
@@ -338,7 +338,7 @@ void Transform::Translate(const glm::vec3& position)
 			if (const std::shared_ptr<Entity> child = weakChild.lock())
 			{
 				Transform& childTransform = child->GetComponent<Transform>();
-				childTransform.SetDirty(childTransform.IsDirty() | DirtyFlagBits::TranslateMat4 | DirtyFlagBits::TransformMat4);
+				childTransform.SetDirty(childTransform.IsDirty() | DirtyFlagBits::TranslateMat4 | DirtyFlagBits::TransformMat4 | DirtyFlagBits::PhysicsBody);
 
 				translationCallbacks(childTransform);
 			}
@@ -353,11 +353,25 @@ void Transform::Rotate(const glm::vec3& rotation)
 	m_LocalTransformData.m_Rotation = rotation;
 	m_LocalTransformData.m_RotationMat4 = glm::toMat4(glm::quat(m_LocalTransformData.m_Rotation));
 
+	OnRotationChanged();
+}
+
+void Transform::Rotate(const glm::quat& rotation)
+{
+	// The matrix is built from the quaternion, euler angles are only kept for GetRotation().
+	m_LocalTransformData.m_Rotation = glm::eulerAngles(rotation);
+	m_LocalTransformData.m_RotationMat4 = glm::toMat4(rotation);
+
+	OnRotationChanged();
+}
+
+void Transform::OnRotationChanged()
+{
 	UpdateTransforms();
 	UpdateVectors();
 
 	SetDirty(IsDirty() | DirtyFlagBits::RotationVec3
-		| DirtyFlagBits::RotationMat4 | DirtyFlagBits::TransformMat4);
+		| DirtyFlagBits::RotationMat4 | DirtyFlagBits::TransformMat4 | DirtyFlagBits::PhysicsBody);
 
 	std::function<void(Transform&)> rotationCallbacks = [&rotationCallbacks](const Transform& transform)
 	{
@@ -377,7 +391,7 @@ void Transform::Rotate(const glm::vec3& rotation)
 			{
 				Transform& childTransform = child->GetComponent<Transform>();
 				childTransform.SetDirty(childTransform.IsDirty() | DirtyFlagBits::RotationVec3
-					| DirtyFlagBits::RotationMat4 | DirtyFlagBits::TransformMat4);
+					| DirtyFlagBits::RotationMat4 | DirtyFlagBits::TransformMat4 | DirtyFlagBits::PhysicsBody);
 
 				rotationCallbacks(childTransform);
 			}
@@ -475,3 +489,82 @@ void Transform::SetTransform(const glm::mat4& transformMat4)
 
 	callbacks(*this);
 }
+
+void Transform::SetLocalTransform(const glm::vec3& position, const glm::quat& rotation, const glm::vec3& scale)
+{
+	m_LocalTransformData.m_PositionMat4 = glm::translate(glm::mat4(1.0f), position);
+	m_LocalTransformData.m_Rotation = glm::eulerAngles(rotation);
+	m_LocalTransformData.m_RotationMat4 = glm::toMat4(rotation);
+	m_LocalTransformData.m_ScaleMat4 = glm::scale(glm::mat4(1.0f), scale);
+
+	UpdateTransforms();
+
+	SetDirty(IsDirty() | DirtyFlagBits::AllTransform);
+}
+
+void Transform::UpdateGlobalTransform()
+{
+	m_GlobalTransformData = m_LocalTransformData;
+	if (m_Entity && m_Entity->HasParent())
+	{
+		const Transform& parentTransform = m_Entity->GetParent()->GetComponent<Transform>();
+		m_GlobalTransformData.m_TransformMat4 = parentTransform.GetTransform() * m_LocalTransformData.m_TransformMat4;
+		m_GlobalTransformData.m_PositionMat4 = parentTransform.GetTransform() * m_LocalTransformData.m_PositionMat4;
+		m_GlobalTransformData.m_RotationMat4 = parentTransform.GetRotationMat4() * m_LocalTransformData.m_RotationMat4;
+		m_GlobalTransformData.m_ScaleMat4 = parentTransform.GetScaleMat4() * m_LocalTransformData.m_ScaleMat4;
+		m_GlobalTransformData.m_Rotation = parentTransform.GetRotation() + m_LocalTransformData.m_Rotation;
+	}
+
+	// Only the physics body is left to follow.
+	SetDirty((IsDirty() & ~DirtyFlagBits::AllTransform) | DirtyFlagBits::PhysicsBody);
+
+	UpdateVectors();
+
+	for (const auto& [name, callback] : m_OnTranslationCallbacks)
+	{
+		callback();
+	}
+
+	for (const auto& [name, callback] : m_OnRotationCallbacks)
+	{
+		callback();
+	}
+
+	for (const auto& [name, callback] : m_OnScaleCallbacks)
+	{
+		callback();
+	}
+}
+
+void Transform::Invalidate()
+{
+	SetDirty(IsDirty() | DirtyFlagBits::AllTransform);
+
+	for (const auto& [name, callback] : m_OnTranslationCallbacks)
+	{
+		callback();
+	}
+
+	for (const auto& [name, callback] : m_OnRotationCallbacks)
+	{
+		callback();
+	}
+
+	for (const auto& [name, callback] : m_OnScaleCallbacks)
+	{
+		callback();
+	}
+
+	if (!m_Entity)
+	{
+		return;
+	}
+
+	for (const std::weak_ptr<Entity>& weakChild : m_Entity->GetChilds())
+	{
+		if (const std::shared_ptr<Entity> child = weakChild.lock())
+		{
+			child->GetComponent<Transform>().Invalidate();
+		}
+	}
+}
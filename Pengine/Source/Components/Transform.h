@@ -22,7 +22,8 @@ namespace Pengine
 			RotationVec3 = 1 << 2,
 			ScaleMat4 = 1 << 3,
 			TransformMat4 = 1 << 4,
-			AllTransform = TranslateMat4 | RotationMat4 | RotationVec3 | ScaleMat4 | TransformMat4
+			PhysicsBody = 1 << 5, // Cleared by the PhysicsSystem once the rigid body is moved to the transform.
+			AllTransform = TranslateMat4 | RotationMat4 | RotationVec3 | ScaleMat4 | TransformMat4 | PhysicsBody
 		};
 
 		using DirtyFlags = uint32_t;
@@ -58,6 +59,7 @@ namespace Pengine
 		void Move(Transform&& transform) noexcept;
 		void UpdateVectors();
 		void UpdateTransforms();
+		void OnRotationChanged();
 
 	public:
 		~Transform() = default;
@@ -88,6 +90,8 @@ namespace Pengine
 		[[nodiscard]] glm::vec3 GetPosition(System system = System::GLOBAL) const;
 		
 		[[nodiscard]] glm::vec3 GetRotation(System system = System::GLOBAL) const;
+
+		[[nodiscard]] glm::quat GetRotationQuat(System system = System::GLOBAL) const { return glm::quat_cast(glm::mat3(GetRotationMat4(system))); }
 		
 		[[nodiscard]] glm::vec3 GetScale(System system = System::GLOBAL) const;
 		
@@ -138,10 +142,29 @@ namespace Pengine
 		void Translate(const glm::vec3& position);
 		
 		void Rotate(const glm::vec3& rotation);
+
+		void Rotate(const glm::quat& rotation);
 		
 		void Scale(const glm::vec3& scale);
 
 		void SetTransform(const glm::mat4& transformMat4);
+
+		/**
+		 * Sets the local position, rotation and scale without marking the children or calling the callbacks,
+		 * the global transform has to be brought up to date with UpdateGlobalTransform afterwards.
+		 */
+		void SetLocalTransform(const glm::vec3& position, const glm::quat& rotation, const glm::vec3& scale);
+
+		/**
+		 * Computes the global transform from the parent, which has to be up to date already, and calls the callbacks.
+		 * Meant for hierarchies updated parent first, the children are not marked, see Invalidate.
+		 */
+		void UpdateGlobalTransform();
+
+		/**
+		 * Marks the global transform of this transform and all of its children as out of date and calls their callbacks.
+		 */
+		void Invalidate();
 	};
 
 }
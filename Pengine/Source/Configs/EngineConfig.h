@@ -1,6 +1,7 @@
 #pragma once
 
 #include "../Core/Core.h"
+#include "../Graphics/Mesh.h"
 
 namespace Pengine
 {
@@ -8,6 +9,19 @@ namespace Pengine
 	struct EngineConfig
 	{
 		GraphicsAPI graphicsAPI;
+
+		// Threads the engine may create besides the main one, 0 to use hardware_concurrency() - 1.
+		// Physics jobs run on the ThreadPool, so they are part of it as well.
+		uint32_t threadBudget = 0;
+
+		// Part of the budget given to the AsyncAssetLoader, the rest goes to the ThreadPool.
+		uint32_t assetLoaderThreadCount = 4;
+
+		// Runs the update of the main scene on the ThreadPool while the previous frame is recorded from its render snapshot.
+		bool asyncSceneUpdate = false;
+
+		// What loaded meshes keep in CPU memory after the upload, see Mesh::CpuResidency.
+		Mesh::CpuResidency meshCpuResidency = Mesh::CpuResidency::ALL;
 	};
 
 }
@@ -0,0 +1,146 @@
+#pragma once
+
+#include "Core.h"
+
+#include <future>
+#include <shared_mutex>
+
+namespace Pengine
+{
+
+	/**
+	 * Resident assets by filepath plus the loads that are still in flight.
+	 * Concurrent requests for an asset that is being loaded wait for that load instead of starting another one.
+	 */
+	template<typename T>
+	class AssetCache
+	{
+	public:
+		using AssetsByFilepath = std::unordered_map<std::filesystem::path, std::shared_ptr<T>, path_hash>;
+
+		/**
+		 * Resident lookups only take a shared lock, so they don't serialize with each other.
+		 */
+		[[nodiscard]] std::shared_ptr<T> Get(const std::filesystem::path& filepath) const
+		{
+			std::shared_lock<std::shared_mutex> lock(m_Mutex);
+			if (const auto assetByFilepath = m_AssetsByFilepath.find(filepath);
+				assetByFilepath != m_AssetsByFilepath.end())
+			{
+				return assetByFilepath->second;
+			}
+
+			return nullptr;
+		}
+
+		/**
+		 * Returns the resident asset, joins the load in flight or runs the load on the calling thread.
+		 * A nullptr returned by the load isn't cached, every waiting caller gets the nullptr.
+		 * An exception thrown by the load is rethrown to every waiting caller.
+		 */
+		template<typename Load>
+		std::shared_ptr<T> GetOrLoad(const std::filesystem::path& filepath, Load&& load)
+		{
+			if (std::shared_ptr<T> asset = Get(filepath))
+			{
+				return asset;
+			}
+
+			std::promise<std::shared_ptr<T>> promise;
+			{
+				std::unique_lock<std::shared_mutex> lock(m_Mutex);
+				if (const auto assetByFilepath = m_AssetsByFilepath.find(filepath);
+					assetByFilepath != m_AssetsByFilepath.end())
+				{
+					return assetByFilepath->second;
+				}
+
+				if (const auto loadByFilepath = m_LoadsByFilepath.find(filepath);
+					loadByFilepath != m_LoadsByFilepath.end())
+				{
+					std::shared_future<std::shared_ptr<T>> inFlight = loadByFilepath->second;
+					lock.unlock();
+
+					return inFlight.get();
+				}
+
+				m_LoadsByFilepath.emplace(filepath, promise.get_future().share());
+			}
+
+			std::shared_ptr<T> asset;
+			try
+			{
+				asset = load();
+			}
+			catch (...)
+			{
+				{
+					std::unique_lock<std::shared_mutex> lock(m_Mutex);
+					m_LoadsByFilepath.erase(filepath);
+				}
+
+				promise.set_exception(std::current_exception());
+				throw;
+			}
+
+			{
+				std::unique_lock<std::shared_mutex> lock(m_Mutex);
+				if (asset)
+				{
+					m_AssetsByFilepath[filepath] = asset;
+				}
+
+				m_LoadsByFilepath.erase(filepath);
+			}
+
+			promise.set_value(asset);
+
+			return asset;
+		}
+
+		void Set(const std::filesystem::path& filepath, std::shared_ptr<T> asset)
+		{
+			std::unique_lock<std::shared_mutex> lock(m_Mutex);
+			m_AssetsByFilepath[filepath] = std::move(asset);
+		}
+
+		void Erase(const std::filesystem::path& filepath)
+		{
+			std::unique_lock<std::shared_mutex> lock(m_Mutex);
+			m_AssetsByFilepath.erase(filepath);
+		}
+
+		/**
+		 * Erases the asset if the cache and the caller hold the only references to it.
+		 * Returns true if it was erased.
+		 */
+		bool EraseIfUnused(const std::shared_ptr<T>& asset)
+		{
+			std::unique_lock<std::shared_mutex> lock(m_Mutex);
+			if (asset.use_count() != 2)
+			{
+				return false;
+			}
+
+			return m_AssetsByFilepath.erase(asset->GetFilepath()) != 0;
+		}
+
+		void Clear()
+		{
+			std::unique_lock<std::shared_mutex> lock(m_Mutex);
+			m_AssetsByFilepath.clear();
+		}
+
+		/**
+		 * Not synchronized, meant for the main thread when no loads are running.
+		 */
+		[[nodiscard]] const AssetsByFilepath& GetAll() const { return m_AssetsByFilepath; }
+
+	private:
+		AssetsByFilepath m_AssetsByFilepath;
+		std::unordered_map<std::filesystem::path, std::shared_future<std::shared_ptr<T>>, path_hash> m_LoadsByFilepath;
+
+		mutable std::shared_mutex m_Mutex;
+	};
+
+}
@@ -12,9 +12,9 @@ AsyncAssetLoader& Pengine::AsyncAssetLoader::GetInstance()
 	return asyncAssetLoader;
 }
 
-void Pengine::AsyncAssetLoader::Initialize()
+void Pengine::AsyncAssetLoader::Initialize(const size_t threadCount)
 {
-	m_ThreadPool.Initialize(10);
+	m_ThreadPool.Initialize(threadCount);
 }
 
 void Pengine::AsyncAssetLoader::Shutdown()
@@ -15,7 +15,7 @@ namespace Pengine
 		AsyncAssetLoader(const AsyncAssetLoader&) = delete;
 		AsyncAssetLoader& operator=(const AsyncAssetLoader&) = delete;
 
-		void Initialize();
+		void Initialize(const size_t threadCount);
 
 		void Shutdown();
 
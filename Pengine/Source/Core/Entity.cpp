@@ -221,6 +221,17 @@ bool Entity::HasAsParent(const std::shared_ptr<Entity>& parent, const bool recur
 	return false;
 }
 
+void Entity::SetName(const std::string& name)
+{
+	const std::string oldName = std::move(m_Name);
+	m_Name = name;
+
+	if (const auto scene = m_Scene.lock())
+	{
+		scene->ReplaceEntityName(*this, oldName);
+	}
+}
+
 void Entity::SetUUID(const UUID& uuid)
 {
 	assert(m_Scene.lock());
@@ -83,7 +83,7 @@ namespace Pengine
 
 		const std::string& GetName() const { return m_Name; }
 
-		void SetName(const std::string& name) { m_Name = name; }
+		void SetName(const std::string& name);
 
 		const UUID& GetUUID() const { return m_UUID; }
 
@@ -125,6 +125,10 @@ namespace Pengine
 
 		UUID m_PrefabFilepathUUID = UUID(0, 0);
 
+		// Positions in the entity list and the name index of the scene.
+		size_t m_SceneIndex = -1;
+		size_t m_NameIndex = -1;
+
 		bool m_IsEnabled = true;
 		bool m_IsDeleted = false;
 
@@ -30,8 +30,8 @@ using namespace Pengine;
 EntryPoint::EntryPoint(Application* application)
 	: m_Application(application)
 {
-	const auto [configGraphicsAPI] = Serializer::DeserializeEngineConfig(std::filesystem::path("Configs") / "Engine.yaml");
-	graphicsAPI = configGraphicsAPI;
+	m_EngineConfig = Serializer::DeserializeEngineConfig(std::filesystem::path("Configs") / "Engine.yaml");
+	graphicsAPI = m_EngineConfig.graphicsAPI;
 }
 
 void LoadAllBaseMaterials(const std::filesystem::path& filepath)
@@ -45,19 +45,11 @@ void LoadAllBaseMaterials(const std::filesystem::path& filepath)
 		}
 	}
 
-	std::atomic<int> baseMaterialsLoadedCount = 0;
+	// Not waited for, materials that need a base material join its load and the pipelines are published
+	// by MaterialManager::Update as they finish compiling, until then the draws using them are skipped.
 	for (const auto& filepath : baseMaterialFilepaths)
 	{
-		AsyncAssetLoader::GetInstance().AsyncLoadBaseMaterial(filepath, [
-			&baseMaterialsLoadedCount](std::weak_ptr<BaseMaterial> baseMaterial)
-		{
-			baseMaterialsLoadedCount.store(baseMaterialsLoadedCount.load() + 1);
-		});
-	}
-
-	while (baseMaterialsLoadedCount.load() != baseMaterialFilepaths.size())
-	{
-		AsyncAssetLoader::GetInstance().Update();
+		AsyncAssetLoader::GetInstance().AsyncLoadBaseMaterial(filepath, [](std::weak_ptr<BaseMaterial> baseMaterial) {});
 	}
 }
 
@@ -137,16 +129,31 @@ void CreateDefaultResources()
 
 void EntryPoint::Run() const
 {
+	const auto startTime = std::chrono::steady_clock::now();
+	auto getMillisecondsSinceStart = [startTime]()
+	{
+		return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+	};
+
 	Device::Create("Pengine");
 
 	EventSystem& eventSystem = EventSystem::GetInstance();
 
 	Serializer::GenerateFilesUUID(std::filesystem::current_path());
 
+	MeshManager::GetInstance().SetDefaultCpuResidency(m_EngineConfig.meshCpuResidency);
 	BindlessUniformWriter::GetInstance().Initialize();
 	RenderPassManager::GetInstance().Initialize();
-	AsyncAssetLoader::GetInstance().Initialize();
-	ThreadPool::GetInstance().Initialize(std::thread::hardware_concurrency() - 1);
+	// The asset loader mostly waits on the disk, the ThreadPool always gets at least one worker.
+	const uint32_t threadBudget = m_EngineConfig.threadBudget > 0
+		? m_EngineConfig.threadBudget
+		: glm::max(std::thread::hardware_concurrency(), 2u) - 1;
+	const uint32_t assetLoaderThreadCount = glm::clamp(m_EngineConfig.assetLoaderThreadCount, 1u, glm::max(threadBudget, 2u) - 1);
+	const uint32_t workerThreadCount = glm::max(threadBudget, assetLoaderThreadCount + 1) - assetLoaderThreadCount;
+
+	AsyncAssetLoader::GetInstance().Initialize(assetLoaderThreadCount);
+	ThreadPool::GetInstance().Initialize(workerThreadCount);
+	Logger::Log("Threads: {} workers, {} asset loaders", workerThreadCount, assetLoaderThreadCount);
 	FontManager::GetInstance().Initialize();
 
 	TextureManager::GetInstance().CreateDefaultResources();
@@ -168,6 +175,11 @@ void EntryPoint::Run() const
 	
 	m_Application->OnStart();
 
+	// The frames rendered while pipelines are still published are the ones that could hitch on first use.
+	bool isFirstFrame = true;
+	bool arePipelinesReady = false;
+	double longestFrameTime = 0.0;
+
 	while (mainWindow->IsRunning())
 	{
 		PROFILER_SCOPE(__FUNCTION__);
@@ -175,6 +187,23 @@ void EntryPoint::Run() const
 		Time::GetInstance().Update();
 		AsyncAssetLoader::GetInstance().Update();
 
+		// Reloaded and newly loaded base materials publish their pipelines here as well, only startup is measured.
+		const bool isMaterialManagerReady = MaterialManager::GetInstance().Update();
+		if (!arePipelinesReady)
+		{
+			if (!isFirstFrame)
+			{
+				longestFrameTime = glm::max(longestFrameTime, Time::GetDeltaTime() * 1000.0);
+			}
+
+			if (isMaterialManagerReady)
+			{
+				Logger::Log("Startup: every pipeline ready after {:.1f} ms, longest frame meanwhile {:.1f} ms",
+					getMillisecondsSinceStart(), longestFrameTime);
+				arePipelinesReady = true;
+			}
+		}
+
 		{
 			PROFILER_SCOPE("EventSystem::ProcessEvents");
 			eventSystem.ProcessEvents();
@@ -185,12 +214,16 @@ void EntryPoint::Run() const
 			m_Application->OnUpdate();
 		}
 
-		if (const std::shared_ptr<Scene> scene = SceneManager::GetInstance().GetSceneByTag("Main"))
+		// Synchronous updates happen before ImGui like the rest of the gameplay, the asynchronous one
+		// starts once ImGui is done with the registry and runs while the frame is recorded from the last snapshot.
+		const std::shared_ptr<Scene> mainScene = SceneManager::GetInstance().GetSceneByTag("Main");
+		if (mainScene && !m_EngineConfig.asyncSceneUpdate)
 		{
 			PROFILER_SCOPE("Scene::Update");
-			scene->Update(Time::GetDeltaTime());
+			mainScene->Update(Time::GetDeltaTime());
 		}
 
+		std::vector<std::shared_ptr<Window>> windowsToRender;
 		for (const auto& [windowName, window] : WindowManager::GetInstance().GetWindows())
 		{
 			if (!window->IsRunning())
@@ -240,43 +273,84 @@ void EntryPoint::Run() const
 
 			window->ImGuiEnd();
 
-			drawCallCount = 0;
-			triangleCount = 0;
+			windowsToRender.emplace_back(window);
+		}
 
-			if (void* frame = window->BeginFrame())
+		// Gathered before the scene update starts, the records only read the snapshots and the render views of the cameras.
+		std::map<std::shared_ptr<Window>, std::map<std::shared_ptr<Scene>, std::vector<Renderer::RenderViewportInfo>>> viewportsByWindow;
+		for (const std::shared_ptr<Window>& window : windowsToRender)
+		{
+			auto& viewportsByScene = viewportsByWindow[window];
+			for (const auto& [viewportName, viewport] : window->GetViewportManager().GetViewports())
 			{
-				std::map<std::shared_ptr<Scene>, std::vector<Renderer::RenderViewportInfo>> viewportsByScene;
-
-				for (const auto& [viewportName, viewport] : window->GetViewportManager().GetViewports())
+				if (const std::shared_ptr<Entity> camera = viewport->GetCamera().lock())
 				{
-					if (const std::shared_ptr<Entity> camera = viewport->GetCamera().lock())
+					if (camera->HasComponent<Camera>())
 					{
-						if (camera->HasComponent<Camera>())
-						{
-							Renderer::RenderViewportInfo renderViewportInfo{};
-							renderViewportInfo.camera = camera;
-							renderViewportInfo.renderView = camera->GetComponent<Camera>().GetRendererTarget(viewportName);
-							renderViewportInfo.projection = viewport->GetProjectionMat4();
-							renderViewportInfo.size = viewport->GetSize();
+						Renderer::RenderViewportInfo renderViewportInfo{};
+						renderViewportInfo.camera = camera;
+						renderViewportInfo.renderView = camera->GetComponent<Camera>().GetRendererTarget(viewportName);
+						renderViewportInfo.projection = viewport->GetProjectionMat4();
+						renderViewportInfo.size = viewport->GetSize();
 
-							viewportsByScene[camera->GetScene()].emplace_back(renderViewportInfo);
-						}
+						viewportsByScene[camera->GetScene()].emplace_back(renderViewportInfo);
 					}
 				}
+			}
+		}
+
+		std::future<void> mainSceneUpdate;
+		if (mainScene)
+		{
+			if (m_EngineConfig.asyncSceneUpdate)
+			{
+				mainSceneUpdate = ThreadPool::GetInstance().EnqueueAsyncFuture([mainScene, deltaTime = Time::GetDeltaTime()]()
+				{
+					PROFILER_SCOPE("Scene::Update");
+					mainScene->Update(deltaTime);
+				});
+			}
+			else
+			{
+				mainScene->PublishRenderSnapshot();
+			}
+		}
+
+		for (const std::shared_ptr<Window>& window : windowsToRender)
+		{
+			WindowManager::GetInstance().SetCurrentWindow(window);
+
+			drawCallCount = 0;
+			triangleCount = 0;
 
+			if (void* frame = window->BeginFrame())
+			{
 				Renderer::Update(
 					frame,
 					window,
 					renderer,
-					viewportsByScene);
+					viewportsByWindow[window]);
 
 				window->ImGuiRenderPass();
 				window->EndFrame(frame);
 			}
 		}
 
+		if (mainSceneUpdate.valid())
+		{
+			PROFILER_SCOPE("Scene::Update Wait");
+			mainSceneUpdate.get();
+			mainScene->PublishRenderSnapshot();
+		}
+
 		device->FlushDeletionQueue();
 
+		if (isFirstFrame)
+		{
+			Logger::Log("Startup: first frame after {:.1f} ms", getMillisecondsSinceStart());
+			isFirstFrame = false;
+		}
+
 		++currentFrame;
 	}
 
@@ -3,6 +3,8 @@
 #include "Core.h"
 #include "Application.h"
 
+#include "../Configs/EngineConfig.h"
+
 namespace Pengine
 {
 
@@ -15,6 +17,7 @@ namespace Pengine
 
 	private:
 		Application* m_Application = nullptr;
+		EngineConfig m_EngineConfig{};
 	};
 
 }
\ No newline at end of file
@@ -77,6 +77,11 @@ namespace Pengine::FileFormats
 		return ".refl";
 	}
 
+	inline const char* PhysicsShape()
+	{
+		return ".pshape";
+	}
+
 	inline const char* Prefab()
 	{
 		return ".prefab";
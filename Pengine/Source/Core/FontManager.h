@@ -2,6 +2,9 @@
 
 #include "Core.h"
 
+#include "../Graphics/Font.h"
+#include "../Graphics/TextLayoutCache.h"
+
 #include <clay/clay.h>
 
 namespace Pengine
@@ -17,40 +20,31 @@ namespace Pengine
 
 		void Initialize();
 
-		struct Font
-		{
-			struct Glyph
-			{
-				glm::ivec2 size;
-				glm::ivec2 bearing;
-				glm::vec2 uvMin;
-				glm::vec2 uvMax;
-				uint32_t advance;
-			};
-
-			std::vector<Glyph> glyphs;
-
-			std::shared_ptr<class Texture> atlas;
+		/**
+		 * One font per face, every font size is drawn from the same distance field atlas.
+		 */
+		std::shared_ptr<Font> LoadFont(const std::filesystem::path& filepath);
 
-			std::string name;
-			uint16_t id = -1;
-			uint16_t size = 0;
-		};
+		glm::ivec2 MeasureText(const std::string& fontName, const uint16_t fontSize, const std::string_view text);
 
-		std::shared_ptr<Font> LoadFont(const std::filesystem::path& filepath, const uint16_t fontSize);
+		/**
+		 * Shared by text measurement and quad emission, a string is laid out once until it is evicted.
+		 */
+		std::shared_ptr<const TextLayoutCache::Layout> GetTextLayout(
+			Font& font,
+			const uint16_t fontSize,
+			const uint16_t letterSpacing,
+			const std::string_view text);
 
-		glm::ivec2 MeasureText(const std::string& fontName, const uint16_t fontSize, const std::string& text);
+		[[nodiscard]] const TextLayoutCache& GetTextLayoutCache() const { return m_TextLayoutCache; }
 
 		static Clay_Dimensions ClayMeasureText(Clay_StringSlice text, Clay_TextElementConfig *config, void* userData);
 
-		std::shared_ptr<Font> GetFont(const std::string& fontName, const uint16_t fontSize) const;
+		std::shared_ptr<Font> GetFont(const std::string& fontName) const;
 
-		const std::string GetFontName(const uint16_t fontId) const;
+		std::shared_ptr<Font> GetFont(const uint16_t fontId) const;
 
-		std::shared_ptr<Font> GetFont(const uint16_t fontId, const uint16_t fontSize) const
-		{
-			return GetFont(GetFontName(fontId), fontSize);
-		}
+		const std::string GetFontName(const uint16_t fontId) const;
 
 		void ShutDown();
 
@@ -58,8 +52,10 @@ namespace Pengine
 		FontManager() = default;
 		~FontManager() = default;
 
-		std::unordered_map<std::string, std::unordered_map<uint16_t, std::shared_ptr<Font>>> m_Fonts;
-		std::unordered_map<uint16_t, std::string> m_FontNamesById;
+		std::unordered_map<std::string, std::shared_ptr<Font>> m_Fonts;
+		std::unordered_map<uint16_t, std::shared_ptr<Font>> m_FontsById;
+
+		TextLayoutCache m_TextLayoutCache{ 4096 };
 
 		uint16_t m_FontIdCounter = 0;
 	};
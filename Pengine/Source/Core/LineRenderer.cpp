@@ -23,6 +23,11 @@ void LineRenderer::Render(const RenderPass::RenderCallbackInfo& renderInfo)
 	if (std::shared_ptr<BaseMaterial> lineBaseMaterial = MaterialManager::GetInstance().LoadBaseMaterial("Materials/Line.basemat"))
 	{
 		std::shared_ptr<Pipeline> pipeline = lineBaseMaterial->GetPipeline(renderInfo.renderPass->GetName());
+		if (!pipeline)
+		{
+			return;
+		}
+
 		std::vector<NativeHandle> uniformWritersNativeHandles;
 		std::vector<std::shared_ptr<UniformWriter>> uniformWriters;
 		RenderPassManager::GetUniformWriters(pipeline, lineBaseMaterial, nullptr, renderInfo, uniformWriters, uniformWritersNativeHandles);
@@ -95,11 +100,9 @@ void LineRenderer::Render(const RenderPass::RenderCallbackInfo& renderInfo)
 			lineIndices.clear();
 		};
 
-		std::queue<Line>& lines = renderInfo.scene->GetVisualizer().GetLines();
+		std::queue<Line> lines = renderInfo.scene->GetVisualizer().TakeLines();
 		if (!lines.empty())
 		{
-			std::queue<Line> linesForTheNextFrame;
-
 			std::vector<glm::vec3> lineVertices;
 			std::vector<uint32_t> lineIndices;
 			lineVertices.reserve(MAX_BATCH_LINE_VERTEX_COUNT * 2);
@@ -127,12 +130,10 @@ void LineRenderer::Render(const RenderPass::RenderCallbackInfo& renderInfo)
 				line.duration -= (float)Time::GetDeltaTime();
 				if (line.duration > 0.0f)
 				{
-					linesForTheNextFrame.emplace(line);
+					renderInfo.scene->GetVisualizer().DrawLine(line.start, line.end, line.color, line.duration);
 				}
 			}
 
-			lines = std::move(linesForTheNextFrame);
-
 			render(index, batchIndex, lineVertices, lineIndices);
 		}
 	}
@@ -1,47 +1,441 @@
 #include "Logger.h"
 
-#include "Time.h"
+#include <chrono>
+#include <csignal>
+#include <ctime>
+#include <fcntl.h>
+
+#ifdef _WIN32
+	#include <io.h>
+#else
+	#include <unistd.h>
+#endif
 
 using namespace Pengine;
 
 constexpr char const* logFilepath = "Log.txt";
 
-void Logger::Log(const std::string& message, const char* color)
+// The same message repeated more than this within the window is dropped and only counted.
+constexpr uint32_t maxRepeatedMessages = 8;
+constexpr std::chrono::seconds repeatedMessagesWindow(1);
+
+struct Logger::RepeatedMessage
+{
+	size_t hash = 0;
+	std::chrono::steady_clock::time_point windowStart;
+	uint32_t count = 0;
+	uint32_t suppressed = 0;
+	Level level = Level::Log;
+	Category category = Category::General;
+
+	~RepeatedMessage() { PushSuppressed(); }
+
+	void PushSuppressed();
+};
+
+struct Logger::Entry
+{
+	std::atomic<Entry*> next = nullptr;
+	std::string message;
+	const char* color = RESET;
+	std::time_t time = 0;
+	Level level = Level::Log;
+	Category category = Category::General;
+};
+
+namespace
+{
+	const char* GetLevelPrefix(const Logger::Level level)
+	{
+		switch (level)
+		{
+		case Logger::Level::Warning:
+			return "WARNING:";
+		case Logger::Level::Error:
+			return "ERROR:";
+		case Logger::Level::FatalError:
+			return "FATAL_ERROR:";
+		default:
+			return "";
+		}
+	}
+
+	// Threads can outlive the logger, their repeated messages are dropped then.
+	std::atomic<bool> isLoggerDestroyed = false;
+
+	std::terminate_handler previousTerminateHandler = nullptr;
+
+	int OpenCrashFile(const char* filepath)
+	{
+#ifdef _WIN32
+		return _open(filepath, _O_WRONLY | _O_APPEND | _O_BINARY);
+#else
+		return open(filepath, O_WRONLY | O_APPEND);
+#endif
+	}
+
+	void CloseCrashFile(const int file)
+	{
+#ifdef _WIN32
+		_close(file);
+#else
+		close(file);
+#endif
+	}
+
+	/**
+	 * Async-signal-safe, the data is written as it is without buffering.
+	 */
+	void WriteOnCrash(const int file, const char* data, const size_t size)
+	{
+		if (file < 0 || size == 0)
+		{
+			return;
+		}
+
+#ifdef _WIN32
+		[[maybe_unused]] const int written = _write(file, data, static_cast<unsigned int>(size));
+#else
+		[[maybe_unused]] const ssize_t written = write(file, data, size);
+#endif
+	}
+
+	void WriteOnCrash(const int file, const char* text)
+	{
+		WriteOnCrash(file, text, std::char_traits<char>::length(text));
+	}
+
+	void OnTerminate()
+	{
+		Logger::Flush();
+		if (previousTerminateHandler)
+		{
+			previousTerminateHandler();
+		}
+		std::abort();
+	}
+}
+
+void Logger::RepeatedMessage::PushSuppressed()
+{
+	if (suppressed == 0 || isLoggerDestroyed.load(std::memory_order_acquire))
+	{
+		return;
+	}
+
+	Entry* entry = new Entry();
+	entry->message = std::format("Last message repeated {} more times", suppressed);
+	entry->color = RESET;
+	entry->time = std::time(nullptr);
+	entry->level = level;
+	entry->category = category;
+	GetInstance().Push(entry);
+
+	suppressed = 0;
+}
+
+Logger::RepeatedMessage& Logger::GetRepeatedMessage()
+{
+	thread_local RepeatedMessage repeatedMessage;
+	return repeatedMessage;
+}
+
+void Logger::FlushRepeatedMessages()
+{
+	GetRepeatedMessage().PushSuppressed();
+}
+
+void Logger::OnCrash(const int signal)
+{
+	// No allocations, locks or streams here. The pending messages are already formatted, they are written
+	// as they are and leaked. If the crash interrupted a drain the queue is left alone.
+	Logger& logger = GetInstance();
+	if (!logger.m_IsDraining.test_and_set(std::memory_order_acquire))
+	{
+		while (Entry* entry = logger.Pop())
+		{
+			WriteOnCrash(logger.m_CrashFile, GetLevelPrefix(entry->level));
+			WriteOnCrash(logger.m_CrashFile, entry->message.data(), entry->message.size());
+			WriteOnCrash(logger.m_CrashFile, "\n");
+		}
+	}
+
+	WriteOnCrash(logger.m_CrashFile, "FATAL_ERROR:The application has crashed!\n");
+
+	std::signal(signal, SIG_DFL);
+	std::raise(signal);
+}
+
+void Logger::FatalError(const std::string& message, const Category category)
+{
+	Write(Level::FatalError, category, message, RED);
+	Flush();
+}
+
+void Logger::SetLevel(const Level level)
+{
+	GetInstance().m_Level.store(static_cast<uint8_t>(level), std::memory_order_relaxed);
+}
+
+void Logger::SetCategoryEnabled(const Category category, const bool enabled)
+{
+	const uint32_t bit = 1u << static_cast<uint32_t>(category);
+	if (enabled)
+	{
+		GetInstance().m_CategoryMask.fetch_or(bit, std::memory_order_relaxed);
+	}
+	else
+	{
+		GetInstance().m_CategoryMask.fetch_and(~bit, std::memory_order_relaxed);
+	}
+}
+
+bool Logger::IsCategoryEnabled(const Category category)
+{
+	return GetInstance().m_CategoryMask.load(std::memory_order_relaxed) & (1u << static_cast<uint32_t>(category));
+}
+
+void Logger::Flush()
+{
+	FlushRepeatedMessages();
+
+	Logger& logger = GetInstance();
+	logger.Drain();
+}
+
+bool Logger::IsEnabled(const Level level, const Category category)
+{
+	// Errors are never filtered, they are rare and usually the only hint of what went wrong.
+	if (level >= Level::Error)
+	{
+		return true;
+	}
+
+	const Logger& logger = GetInstance();
+	return static_cast<uint8_t>(level) >= logger.m_Level.load(std::memory_order_relaxed) && IsCategoryEnabled(category);
+}
+
+void Logger::Write(const Level level, const Category category, const std::string& message, const char* color)
+{
+	if (!IsEnabled(level, category))
+	{
+		return;
+	}
+
+	Logger& logger = GetInstance();
+
+	const size_t hash = std::hash<std::string>{}(message);
+	const auto now = std::chrono::steady_clock::now();
+
+	RepeatedMessage& repeated = GetRepeatedMessage();
+	if (repeated.hash == hash && now - repeated.windowStart < repeatedMessagesWindow)
+	{
+		if (++repeated.count > maxRepeatedMessages)
+		{
+			repeated.suppressed++;
+			return;
+		}
+	}
+	else
+	{
+		repeated.PushSuppressed();
+
+		repeated.hash = hash;
+		repeated.windowStart = now;
+		repeated.count = 1;
+		repeated.level = level;
+		repeated.category = category;
+	}
+
+	Entry* entry = new Entry();
+	entry->message = message;
+	entry->color = color;
+	entry->time = std::time(nullptr);
+	entry->level = level;
+	entry->category = category;
+	logger.Push(entry);
+}
+
+void Logger::Push(Entry* entry)
 {
-	std::lock_guard lock(GetInstance().m_Mutex);
-	GetInstance().m_OutFile << "[" << Time::GetDate() << "] " << message << std::endl;
-	std::cout << color << message << RESET << std::endl;
+	// Counted before publishing, so the writer never sees more entries than the counter.
+	m_PendingCount.fetch_add(1, std::memory_order_release);
+
+	entry->next.store(nullptr, std::memory_order_relaxed);
+	Entry* previous = m_Head.exchange(entry, std::memory_order_acq_rel);
+	previous->next.store(entry, std::memory_order_release);
+
+	if (m_IsRunning.load(std::memory_order_relaxed))
+	{
+		m_PendingCount.notify_one();
+	}
+	else
+	{
+		// No writer thread (not started yet or already shut down), write synchronously.
+		Drain();
+	}
 }
 
-void Logger::Warning(const std::string& message)
+Logger::Entry* Logger::Pop()
 {
-	std::lock_guard lock(GetInstance().m_Mutex);
-	GetInstance().m_OutFile << "[" << Time::GetDate() << "] WARNING:" << message << std::endl;
-	std::cout << YELLOW << "WARNING:" << message << RESET << std::endl;
+	Entry* tail = m_Tail;
+	Entry* next = tail->next.load(std::memory_order_acquire);
+
+	if (tail == m_Stub)
+	{
+		if (!next)
+		{
+			return nullptr;
+		}
+
+		m_Tail = next;
+		tail = next;
+		next = next->next.load(std::memory_order_acquire);
+	}
+
+	if (next)
+	{
+		m_Tail = next;
+		return tail;
+	}
+
+	if (tail != m_Head.load(std::memory_order_acquire))
+	{
+		// A producer has exchanged the head but not linked it yet.
+		return nullptr;
+	}
+
+	m_Stub->next.store(nullptr, std::memory_order_relaxed);
+	Entry* previous = m_Head.exchange(m_Stub, std::memory_order_acq_rel);
+	previous->next.store(m_Stub, std::memory_order_release);
+
+	next = tail->next.load(std::memory_order_acquire);
+	if (next)
+	{
+		m_Tail = next;
+		return tail;
+	}
+
+	return nullptr;
 }
 
-void Logger::Error(const std::string& message)
+void Logger::Drain()
 {
-	std::lock_guard lock(GetInstance().m_Mutex);
-	GetInstance().m_OutFile << "[" << Time::GetDate() << "] ERROR:" << message << std::endl;
-	std::cout << RED << "ERROR:" << message << RESET << std::endl;
+	// Only one consumer at a time, the writer thread or a thread flushing explicitly.
+	while (m_IsDraining.test_and_set(std::memory_order_acquire))
+	{
+		std::this_thread::yield();
+	}
+
+	std::string fileBuffer;
+	std::string consoleBuffer;
+
+	uint32_t drainedCount = 0;
+	while (Entry* entry = Pop())
+	{
+		char date[32]{};
+		std::strftime(date, sizeof(date), "%a %b %d %H:%M:%S %Y", std::localtime(&entry->time));
+
+		const char* prefix = GetLevelPrefix(entry->level);
+
+		fileBuffer += '[';
+		fileBuffer += date;
+		fileBuffer += "] ";
+		fileBuffer += prefix;
+		fileBuffer += entry->message;
+		fileBuffer += '\n';
+
+		consoleBuffer += entry->color;
+		consoleBuffer += prefix;
+		consoleBuffer += entry->message;
+		consoleBuffer += RESET;
+		consoleBuffer += '\n';
+
+		delete entry;
+		drainedCount++;
+	}
+
+	if (drainedCount > 0)
+	{
+		m_OutFile.write(fileBuffer.data(), fileBuffer.size());
+		m_OutFile.flush();
+
+		std::cout.write(consoleBuffer.data(), consoleBuffer.size());
+		std::cout.flush();
+
+		m_PendingCount.fetch_sub(drainedCount, std::memory_order_acq_rel);
+	}
+
+	m_IsDraining.clear(std::memory_order_release);
 }
 
-void Logger::FatalError(const std::string& message)
+void Logger::WriterLoop()
 {
-	std::lock_guard lock(GetInstance().m_Mutex);
-	GetInstance().m_OutFile << "[" << Time::GetDate() << "] FATAL_ERROR:" << message << std::endl;
-	std::cout << RED << "FATAL_ERROR:" << message << RESET << std::endl;
-	GetInstance().m_OutFile.close();
+	while (true)
+	{
+		m_PendingCount.wait(0, std::memory_order_acquire);
+
+		Drain();
+
+		if (!m_IsRunning.load(std::memory_order_acquire))
+		{
+			break;
+		}
+
+		// The entry is counted but not linked yet, give the producer a moment.
+		if (m_PendingCount.load(std::memory_order_acquire) != 0)
+		{
+			std::this_thread::yield();
+		}
+	}
 }
 
 Logger::Logger()
 {
 	m_OutFile.open(logFilepath);
+	m_CrashFile = OpenCrashFile(logFilepath);
+
+	m_Stub = new Entry();
+	m_Head.store(m_Stub, std::memory_order_relaxed);
+	m_Tail = m_Stub;
+
+	m_IsRunning.store(true, std::memory_order_release);
+	m_WriterThread = std::thread(&Logger::WriterLoop, this);
+
+	std::signal(SIGSEGV, OnCrash);
+	std::signal(SIGABRT, OnCrash);
+	std::signal(SIGFPE, OnCrash);
+	std::signal(SIGILL, OnCrash);
+	previousTerminateHandler = std::set_terminate(OnTerminate);
 }
 
 Logger::~Logger()
 {
+	m_IsRunning.store(false, std::memory_order_release);
+
+	// Wake the writer even if there is nothing to write.
+	m_PendingCount.fetch_add(1, std::memory_order_release);
+	m_PendingCount.notify_one();
+
+	if (m_WriterThread.joinable())
+	{
+		m_WriterThread.join();
+	}
+
+	m_PendingCount.fetch_sub(1, std::memory_order_release);
+
+	// The repeats of the main thread were pushed when its thread locals were destroyed, before the logger.
+	isLoggerDestroyed.store(true, std::memory_order_release);
+
+	Drain();
+
+	delete m_Stub;
+
+	if (m_CrashFile >= 0)
+	{
+		CloseCrashFile(m_CrashFile);
+	}
+
 	m_OutFile.close();
 }
 
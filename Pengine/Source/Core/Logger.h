@@ -3,34 +3,205 @@
 #include "Core.h"
 #include "ColoredOutput.h"
 
+#include <atomic>
+#include <format>
 #include <fstream>
 #include <mutex>
+#include <thread>
+
+/**
+ * Messages below this level are compiled out, 0 - Log, 1 - Warning, 2 - Error, 3 - FatalError.
+ * Only the formatting overloads skip building the message, a std::string argument is built by the caller.
+ */
+#ifndef PENGINE_LOG_LEVEL
+	#define PENGINE_LOG_LEVEL 0
+#endif
 
 namespace Pengine
 {
 
+	/**
+	 * Producers only format the message and push it into a lock-free queue,
+	 * the file and console output is done in batches by a background writer thread.
+	 */
 	class PENGINE_API Logger
 	{
 	public:
+		enum class Level : uint8_t
+		{
+			Log = 0,
+			Warning = 1,
+			Error = 2,
+			FatalError = 3
+		};
+
+		enum class Category : uint8_t
+		{
+			General,
+			Core,
+			Graphics,
+			Vulkan,
+			Physics,
+			Animation,
+			Assets,
+			UI,
+			Editor,
+			Count
+		};
+
 		Logger(const Logger&) = delete;
 		Logger& operator=(const Logger&) = delete;
 
-		static void Log(const std::string& message, const char* color = RESET);
+		static void Log(const std::string& message, const char* color = RESET, const Category category = Category::General)
+		{
+			if constexpr (PENGINE_LOG_LEVEL <= static_cast<int>(Level::Log))
+			{
+				Write(Level::Log, category, message, color);
+			}
+		}
+
+		static void Warning(const std::string& message, const Category category = Category::General)
+		{
+			if constexpr (PENGINE_LOG_LEVEL <= static_cast<int>(Level::Warning))
+			{
+				Write(Level::Warning, category, message, YELLOW);
+			}
+		}
+
+		static void Error(const std::string& message, const Category category = Category::General)
+		{
+			if constexpr (PENGINE_LOG_LEVEL <= static_cast<int>(Level::Error))
+			{
+				Write(Level::Error, category, message, RED);
+			}
+		}
+
+		/**
+		 * The message is only formatted if it is going to be written.
+		 */
+		template<typename... Args>
+		static void Log(const std::format_string<Args...> format, Args&&... args)
+		{
+			WriteFormatted<Level::Log>(Category::General, RESET, format, std::forward<Args>(args)...);
+		}
+
+		template<typename... Args>
+		static void Log(const Category category, const std::format_string<Args...> format, Args&&... args)
+		{
+			WriteFormatted<Level::Log>(category, RESET, format, std::forward<Args>(args)...);
+		}
+
+		template<typename... Args>
+		static void Warning(const std::format_string<Args...> format, Args&&... args)
+		{
+			WriteFormatted<Level::Warning>(Category::General, YELLOW, format, std::forward<Args>(args)...);
+		}
 
-		static void Warning(const std::string& message);
+		template<typename... Args>
+		static void Warning(const Category category, const std::format_string<Args...> format, Args&&... args)
+		{
+			WriteFormatted<Level::Warning>(category, YELLOW, format, std::forward<Args>(args)...);
+		}
 
-		static void Error(const std::string& message);
+		template<typename... Args>
+		static void Error(const std::format_string<Args...> format, Args&&... args)
+		{
+			WriteFormatted<Level::Error>(Category::General, RED, format, std::forward<Args>(args)...);
+		}
 
-		static void FatalError(const std::string& message);
+		template<typename... Args>
+		static void Error(const Category category, const std::format_string<Args...> format, Args&&... args)
+		{
+			WriteFormatted<Level::Error>(category, RED, format, std::forward<Args>(args)...);
+		}
+
+		/**
+		 * Blocks until every pending message, including this one, is written.
+		 */
+		static void FatalError(const std::string& message, const Category category = Category::General);
+
+		static void SetLevel(const Level level);
+
+		static void SetCategoryEnabled(const Category category, const bool enabled);
+
+		[[nodiscard]] static bool IsCategoryEnabled(const Category category);
+
+		/**
+		 * Whether a message of the level and category would be written, errors always are.
+		 */
+		[[nodiscard]] static bool IsEnabled(const Level level, const Category category);
+
+		/**
+		 * Writes all pending messages on the calling thread.
+		 */
+		static void Flush();
 
 	private:
+		struct Entry;
+		struct RepeatedMessage;
+
 		Logger();
 		~Logger();
 
 		static Logger& GetInstance();
 
+		static void Write(Level level, Category category, const std::string& message, const char* color);
+
+		template<Level level, typename... Args>
+		static void WriteFormatted(const Category category, const char* color, const std::format_string<Args...> format, Args&&... args)
+		{
+			if constexpr (PENGINE_LOG_LEVEL <= static_cast<int>(level))
+			{
+				if (IsEnabled(level, category))
+				{
+					Write(level, category, std::format(format, std::forward<Args>(args)...), color);
+				}
+			}
+		}
+
+		/**
+		 * The last message written by the calling thread, to drop it when it is repeated too often.
+		 */
+		static RepeatedMessage& GetRepeatedMessage();
+
+		/**
+		 * Pushes the count of the messages dropped as repeats on the calling thread, if there are any.
+		 */
+		static void FlushRepeatedMessages();
+
+		/**
+		 * Signal handler, writes the pending messages with async-signal-safe calls only.
+		 */
+		static void OnCrash(const int signal);
+
+		void Push(Entry* entry);
+
+		Entry* Pop();
+
+		void Drain();
+
+		void WriterLoop();
+
 		std::ofstream m_OutFile;
-		std::mutex m_Mutex;
+
+		/**
+		 * The log file opened a second time for writes from the signal handler, -1 if it failed to open.
+		 */
+		int m_CrashFile = -1;
+
+		// Vyukov intrusive MPSC queue, producers exchange the head, the consumer owns the tail.
+		std::atomic<Entry*> m_Head = nullptr;
+		Entry* m_Tail = nullptr;
+		Entry* m_Stub = nullptr;
+
+		std::atomic<uint32_t> m_PendingCount = 0;
+		std::atomic_flag m_IsDraining = ATOMIC_FLAG_INIT;
+		std::atomic<bool> m_IsRunning = false;
+
+		std::atomic<uint8_t> m_Level = static_cast<uint8_t>(Level::Log);
+		std::atomic<uint32_t> m_CategoryMask = ~0u;
+
+		std::thread m_WriterThread;
 	};
 
 #define FATAL_ERROR(message) Logger::FatalError(std::string(message) + " At: " + __FILE__ + " " + std::to_string(__LINE__)); throw std::runtime_error(message)
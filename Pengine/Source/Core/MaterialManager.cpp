@@ -140,6 +140,30 @@ void MaterialManager::SaveAll()
 	}
 }
 
+bool MaterialManager::Update()
+{
+	// Copied, publishing loads textures and shouldn't hold up the loaders that register new base materials.
+	std::vector<std::shared_ptr<BaseMaterial>> baseMaterials;
+	{
+		std::lock_guard<std::mutex> lock(m_MutexBaseMaterial);
+		for (const auto& [filepath, baseMaterial] : m_BaseMaterialsByFilepath)
+		{
+			if (!baseMaterial->IsReady())
+			{
+				baseMaterials.emplace_back(baseMaterial);
+			}
+		}
+	}
+
+	bool isReady = true;
+	for (const std::shared_ptr<BaseMaterial>& baseMaterial : baseMaterials)
+	{
+		isReady &= baseMaterial->PublishPipelines();
+	}
+
+	return isReady;
+}
+
 void MaterialManager::ShutDown()
 {
 	ShaderModuleManager::GetInstance().ShutDown();
@@ -47,6 +47,12 @@ namespace Pengine
 
 		void Reload(Category category);
 
+		/**
+		 * Publishes the base material pipelines that finished compiling, called once per frame before rendering.
+		 * Returns true when every base material is ready.
+		 */
+		bool Update();
+
 		void SaveAll();
 
 		void ShutDown();
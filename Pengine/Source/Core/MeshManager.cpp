@@ -24,25 +24,18 @@ std::shared_ptr<Mesh> MeshManager::CreateMesh(Mesh::CreateInfo& createInfo)
 
 		return mesh;
 	}
-	else
-	{
-		mesh = std::make_shared<Mesh>(createInfo);
-		std::lock_guard<std::mutex> lock(m_MutexMesh);
-		m_MeshesByFilepath[createInfo.filepath] = mesh;
 
-		return mesh;
-	}
+	return m_Meshes.GetOrLoad(createInfo.filepath, [&createInfo]()
+	{
+		return std::make_shared<Mesh>(createInfo);
+	});
 }
 
 std::shared_ptr<Mesh> MeshManager::LoadMesh(const std::filesystem::path& filepath)
 {
 	PROFILER_SCOPE(__FUNCTION__);
 
-	if (std::shared_ptr<Mesh> mesh = GetMesh(filepath))
-	{
-		return mesh;
-	}
-	else
+	return m_Meshes.GetOrLoad(filepath, [this, &filepath]()
 	{
 		Mesh::CreateInfo createInfo(std::move(Serializer::DeserializeMesh(filepath)));
 		if (createInfo.filepath.empty())
@@ -50,173 +43,95 @@ std::shared_ptr<Mesh> MeshManager::LoadMesh(const std::filesystem::path& filepat
 			FATAL_ERROR(filepath.string() + ":There is no such mesh!");
 		}
 
-		return CreateMesh(createInfo);
-	}
+		createInfo.cpuResidency = m_DefaultCpuResidency;
+
+		return std::make_shared<Mesh>(createInfo);
+	});
 }
 
 std::shared_ptr<Mesh> MeshManager::GetMesh(const std::filesystem::path& filepath) const
 {
-	std::lock_guard<std::mutex> lock(m_MutexMesh);
-	auto meshByFilepath = m_MeshesByFilepath.find(filepath);
-	if (meshByFilepath != m_MeshesByFilepath.end())
-	{
-		return meshByFilepath->second;
-	}
-
-	return nullptr;
+	return m_Meshes.Get(filepath);
 }
 
 void MeshManager::DeleteMesh(std::shared_ptr<Mesh>& mesh)
 {
-	std::lock_guard<std::mutex> lock(m_MutexMesh);
-
-	if (mesh.use_count() == 2)
-	{
-		m_MeshesByFilepath.erase(mesh->GetFilepath());
-	}
-
+	m_Meshes.EraseIfUnused(mesh);
 	mesh = nullptr;
 }
 
 std::shared_ptr<SkeletalAnimation> MeshManager::CreateSkeletalAnimation(SkeletalAnimation::CreateInfo& createInfo)
 {
-	if (std::shared_ptr<SkeletalAnimation> skeletalAnimation = GetSkeletalAnimation(createInfo.filepath))
-	{
-		return skeletalAnimation;
-	}
-	else
+	return m_SkeletalAnimations.GetOrLoad(createInfo.filepath, [&createInfo]()
 	{
-		skeletalAnimation = std::make_shared<SkeletalAnimation>(createInfo);
-		std::lock_guard<std::mutex> lock(m_MutexSkeletalAnimation);
-		m_SkeletalAnimationsByFilepath[createInfo.filepath] = skeletalAnimation;
-
-		return skeletalAnimation;
-	}
+		return std::make_shared<SkeletalAnimation>(createInfo);
+	});
 }
 
 std::shared_ptr<SkeletalAnimation> MeshManager::LoadSkeletalAnimation(const std::filesystem::path& filepath)
 {
-	if (std::shared_ptr<SkeletalAnimation> skeletalAnimation = GetSkeletalAnimation(filepath))
-	{
-		return skeletalAnimation;
-	}
-	else
+	std::shared_ptr<SkeletalAnimation> skeletalAnimation = m_SkeletalAnimations.GetOrLoad(filepath, [&filepath]()
 	{
-		skeletalAnimation = Serializer::DeserializeSkeletalAnimation(filepath);
-		if (!skeletalAnimation)
-		{
-			Logger::Error(filepath.string() + ":There is no such skeletal animation!");
-			return nullptr;
-		}
-
-		std::lock_guard<std::mutex> lock(m_MutexSkeletalAnimation);
-		m_SkeletalAnimationsByFilepath.emplace(filepath, skeletalAnimation);
+		return Serializer::DeserializeSkeletalAnimation(filepath);
+	});
 
-		return skeletalAnimation;
+	if (!skeletalAnimation)
+	{
+		Logger::Error(filepath.string() + ":There is no such skeletal animation!");
 	}
+
+	return skeletalAnimation;
 }
 
 std::shared_ptr<SkeletalAnimation> MeshManager::GetSkeletalAnimation(const std::filesystem::path& filepath) const
 {
-	std::lock_guard<std::mutex> lock(m_MutexSkeletalAnimation);
-	auto skeletalAnimationsByFilepath = m_SkeletalAnimationsByFilepath.find(filepath);
-	if (skeletalAnimationsByFilepath != m_SkeletalAnimationsByFilepath.end())
-	{
-		return skeletalAnimationsByFilepath->second;
-	}
-
-	return nullptr;
+	return m_SkeletalAnimations.Get(filepath);
 }
 
 void MeshManager::DeleteSkeletalAnimation(std::shared_ptr<SkeletalAnimation>& skeletalAnimation)
 {
-	std::lock_guard<std::mutex> lock(m_MutexSkeletalAnimation);
-	
-	if (skeletalAnimation.use_count() == 2)
-	{
-		m_SkeletalAnimationsByFilepath.erase(skeletalAnimation->GetFilepath());
-	}
-
+	m_SkeletalAnimations.EraseIfUnused(skeletalAnimation);
 	skeletalAnimation = nullptr;
 }
 
 std::shared_ptr<Skeleton> MeshManager::CreateSkeleton(Skeleton::CreateInfo& createInfo)
 {
-	if (std::shared_ptr<Skeleton> skeleton = GetSkeleton(createInfo.filepath))
-	{
-		return skeleton;
-	}
-	else
+	return m_Skeletons.GetOrLoad(createInfo.filepath, [&createInfo]()
 	{
-		skeleton = std::make_shared<Skeleton>(createInfo);
-		std::lock_guard<std::mutex> lock(m_MutexSkeleton);
-		m_SkeletonsByFilepath[createInfo.filepath] = skeleton;
-
-		return skeleton;
-	}
+		return std::make_shared<Skeleton>(createInfo);
+	});
 }
 
 std::shared_ptr<Skeleton> MeshManager::LoadSkeleton(const std::filesystem::path& filepath)
 {
-	if (std::shared_ptr<Skeleton> skeleton = GetSkeleton(filepath))
-	{
-		return skeleton;
-	}
-	else
+	return m_Skeletons.GetOrLoad(filepath, [&filepath]()
 	{
-		skeleton = Serializer::DeserializeSkeleton(filepath);
+		std::shared_ptr<Skeleton> skeleton = Serializer::DeserializeSkeleton(filepath);
 		if (!skeleton)
 		{
 			FATAL_ERROR(filepath.string() + ":There is no such skeleton!");
 		}
 
-		std::lock_guard<std::mutex> lock(m_MutexSkeleton);
-		m_SkeletonsByFilepath.emplace(filepath, skeleton);
-
 		return skeleton;
-	}
+	});
 }
 
 std::shared_ptr<Skeleton> MeshManager::GetSkeleton(const std::filesystem::path& filepath) const
 {
-	std::lock_guard<std::mutex> lock(m_MutexSkeleton);
-	auto skeletonsByFilepath = m_SkeletonsByFilepath.find(filepath);
-	if (skeletonsByFilepath != m_SkeletonsByFilepath.end())
-	{
-		return skeletonsByFilepath->second;
-	}
-
-	return nullptr;
+	return m_Skeletons.Get(filepath);
 }
 
 void MeshManager::DeleteSkeleton(std::shared_ptr<Skeleton>& skeleton)
 {
-	std::lock_guard<std::mutex> lock(m_MutexSkeleton);
-
-	if (skeleton.use_count() == 2)
-	{
-		m_SkeletonsByFilepath.erase(skeleton->GetFilepath());
-	}
-
+	m_Skeletons.EraseIfUnused(skeleton);
 	skeleton = nullptr;
 }
 
 void MeshManager::ShutDown()
 {
-	{
-		std::lock_guard<std::mutex> lock(m_MutexMesh);
-		m_MeshesByFilepath.clear();
-	}
-
-	{
-		std::lock_guard<std::mutex> lock(m_MutexSkeletalAnimation);
-		m_SkeletalAnimationsByFilepath.clear();
-	}
-
-	{
-		std::lock_guard<std::mutex> lock(m_MutexSkeleton);
-		m_SkeletonsByFilepath.clear();
-	}
+	m_Meshes.Clear();
+	m_SkeletalAnimations.Clear();
+	m_Skeletons.Clear();
 }
 
 #include "FileFormatNames.h"
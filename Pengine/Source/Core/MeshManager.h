@@ -1,13 +1,12 @@
 #pragma once
 
+#include "AssetCache.h"
 #include "Core.h"
 
 #include "../Graphics/Mesh.h"
 #include "../Graphics/SkeletalAnimation.h"
 #include "../Graphics/Skeleton.h"
 
-#include <mutex>
-
 namespace Pengine
 {
 
@@ -23,6 +22,13 @@ namespace Pengine
 
 		std::shared_ptr<Mesh> LoadMesh(const std::filesystem::path& filepath);
 
+		/**
+		 * Residency of the meshes loaded from files, created meshes use the one from their create info.
+		 */
+		void SetDefaultCpuResidency(const Mesh::CpuResidency cpuResidency) { m_DefaultCpuResidency = cpuResidency; }
+
+		[[nodiscard]] Mesh::CpuResidency GetDefaultCpuResidency() const { return m_DefaultCpuResidency; }
+
 		std::shared_ptr<Mesh> GetMesh(const std::filesystem::path& filepath) const;
 
 		void DeleteMesh(std::shared_ptr<Mesh>& mesh);
@@ -43,11 +49,11 @@ namespace Pengine
 
 		void DeleteSkeleton(std::shared_ptr<Skeleton>& skeleton);
 
-		const std::unordered_map<std::filesystem::path, std::shared_ptr<Mesh>, path_hash>& GetMeshes() const { return m_MeshesByFilepath; }
+		const AssetCache<Mesh>::AssetsByFilepath& GetMeshes() const { return m_Meshes.GetAll(); }
 
-		const std::unordered_map<std::filesystem::path, std::shared_ptr<SkeletalAnimation>, path_hash>& GetSkeletalAnimations() const { return m_SkeletalAnimationsByFilepath; }
+		const AssetCache<SkeletalAnimation>::AssetsByFilepath& GetSkeletalAnimations() const { return m_SkeletalAnimations.GetAll(); }
 
-		const std::unordered_map<std::filesystem::path, std::shared_ptr<Skeleton>, path_hash>& GetSkeletons() const { return m_SkeletonsByFilepath; }
+		const AssetCache<Skeleton>::AssetsByFilepath& GetSkeletons() const { return m_Skeletons.GetAll(); }
 
 		void ShutDown();
 
@@ -57,13 +63,11 @@ namespace Pengine
 		MeshManager() = default;
 		~MeshManager() = default;
 
-		std::unordered_map<std::filesystem::path, std::shared_ptr<Mesh>, path_hash> m_MeshesByFilepath;
-		std::unordered_map<std::filesystem::path, std::shared_ptr<Skeleton>, path_hash> m_SkeletonsByFilepath;
-		std::unordered_map<std::filesystem::path, std::shared_ptr<SkeletalAnimation>, path_hash> m_SkeletalAnimationsByFilepath;
+		AssetCache<Mesh> m_Meshes;
+		AssetCache<Skeleton> m_Skeletons;
+		AssetCache<SkeletalAnimation> m_SkeletalAnimations;
 
-		mutable std::mutex m_MutexMesh;
-		mutable std::mutex m_MutexSkeleton;
-		mutable std::mutex m_MutexSkeletalAnimation;
+		std::atomic<Mesh::CpuResidency> m_DefaultCpuResidency = Mesh::CpuResidency::ALL;
 	};
 
 }
\ No newline at end of file
@@ -2,6 +2,7 @@
 
 #include "SceneManager.h"
 #include "Profiler.h"
+#include "SceneBVH.h"
 
 #include "../Graphics/Mesh.h"
 #include "../Graphics/Vertex.h"
@@ -58,6 +59,52 @@ bool Raycast::IntersectTriangle(
 	return false;
 }
 
+bool Raycast::IntersectRayTriangle(
+	const glm::vec3& start,
+	const glm::vec3& direction,
+	const glm::vec3& a,
+	const glm::vec3& b,
+	const glm::vec3& c,
+	const float length,
+	float& distance,
+	glm::vec2& barycentrics)
+{
+	const glm::vec3 edge0 = b - a;
+	const glm::vec3 edge1 = c - a;
+	const glm::vec3 p = glm::cross(direction, edge1);
+	const float determinant = glm::dot(edge0, p);
+	if (glm::abs(determinant) < 1e-12f)
+	{
+		return false;
+	}
+
+	const float inverseDeterminant = 1.0f / determinant;
+	const glm::vec3 s = start - a;
+	const float u = glm::dot(s, p) * inverseDeterminant;
+	if (u < 0.0f || u > 1.0f)
+	{
+		return false;
+	}
+
+	const glm::vec3 q = glm::cross(s, edge0);
+	const float v = glm::dot(direction, q) * inverseDeterminant;
+	if (v < 0.0f || u + v > 1.0f)
+	{
+		return false;
+	}
+
+	const float t = glm::dot(edge1, q) * inverseDeterminant;
+	if (t < 0.0f || t > length)
+	{
+		return false;
+	}
+
+	distance = t;
+	barycentrics = { u, v };
+
+	return true;
+}
+
 bool Raycast::IntersectBoxOBB(
 	const glm::vec3& start,
 	const glm::vec3& direction,
@@ -136,6 +183,74 @@ bool Raycast::IntersectBoxAABB(
 	return true;
 }
 
+static bool RaycastBVH(
+	const SceneBVH& bvh,
+	const Raycast::Ray& ray,
+	const Raycast::Query& query,
+	Raycast::SceneHit& sceneHit)
+{
+	sceneHit = {};
+
+	const glm::vec3 direction = glm::normalize(ray.direction);
+	const bool anyHit = query.mode == Raycast::Mode::Any;
+
+	bvh.Raycast(ray.start, direction, ray.length, query.raycastMask, [&](const SceneBVH::BVHNode& node, float& maxDistance)
+	{
+		// The linear part is not normalized, so the local hit distance is the world one.
+		const glm::vec3 localStart = node.inverseTransform * glm::vec4(ray.start, 1.0f);
+		const glm::vec3 localDirection = glm::mat3(node.inverseTransform) * direction;
+
+		Raycast::Hit localHit{};
+		if (!node.mesh->Raycast(localStart, localDirection, maxDistance, anyHit, localHit))
+		{
+			return true;
+		}
+
+		maxDistance = localHit.distance;
+
+		sceneHit.hit = localHit;
+		sceneHit.hit.point = ray.start + direction * localHit.distance;
+		sceneHit.hit.normal = glm::normalize(localHit.normal * glm::mat3(node.inverseTransform));
+		sceneHit.entity = node.entity->GetHandle();
+
+		return !anyHit;
+	});
+
+	return sceneHit.IsValid();
+}
+
+bool Raycast::RaycastScene(
+	const std::shared_ptr<Scene>& scene,
+	const Ray& ray,
+	const Query& query,
+	SceneHit& hit)
+{
+	return RaycastBVH(*scene->GetBVH(), ray, query, hit);
+}
+
+void Raycast::RaycastScene(
+	const std::shared_ptr<Scene>& scene,
+	const std::vector<Ray>& rays,
+	const Query& query,
+	std::vector<SceneHit>& hits,
+	ThreadPool& threadPool)
+{
+	PROFILER_SCOPE(__FUNCTION__);
+
+	constexpr size_t packetSize = 64;
+
+	hits.resize(rays.size());
+
+	const std::shared_ptr<SceneBVH> bvh = scene->GetBVH();
+	threadPool.ParallelFor(rays.size(), packetSize, [&](const size_t begin, const size_t end)
+	{
+		for (size_t i = begin; i < end; i++)
+		{
+			RaycastBVH(*bvh, rays[i], query, hits[i]);
+		}
+	});
+}
+
 std::map<Raycast::Hit, std::shared_ptr<Entity>> Raycast::RaycastScene(
 	std::shared_ptr<Scene> scene,
 	const glm::vec3& start,
@@ -217,10 +332,10 @@ bool Raycast::RaycastEntity(
 		length,
 		hitOBB))
 	{
-		const auto hits = RaycastScene(scene, start, direction, length);
-		if (!hits.empty() && hits.begin()->second == entity)
+		SceneHit sceneHit{};
+		if (RaycastScene(scene, { start, direction, length }, {}, sceneHit) && sceneHit.entity == entity->GetHandle())
 		{
-			hit = hits.begin()->first;
+			hit = sceneHit.hit;
 			return true;
 		}
 	}
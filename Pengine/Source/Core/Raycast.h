@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Core.h"
+#include "ThreadPool.h"
 
 namespace Pengine
 {
@@ -15,6 +16,12 @@ namespace Pengine
 			glm::vec2 uv{};
 			float distance = std::numeric_limits<float>::max();
 
+			/**
+			 * Index of the hit triangle in the mesh and the weights of its three vertices at the hit point.
+			 */
+			uint32_t triangle = -1;
+			glm::vec3 barycentrics{};
+
 			std::size_t operator()(const Hit& hit) const
 			{
 				return std::hash<float>{}(hit.distance);
@@ -26,6 +33,44 @@ namespace Pengine
 			}
 		};
 
+		enum class Mode
+		{
+			/**
+			 * Nearest hit along the ray, nodes farther than the current hit are skipped.
+			 */
+			Closest,
+
+			/**
+			 * First hit found, enough for occlusion and line of sight checks.
+			 */
+			Any
+		};
+
+		struct Ray
+		{
+			glm::vec3 start{};
+			glm::vec3 direction{};
+			float length = 0.0f;
+		};
+
+		struct Query
+		{
+			Mode mode = Mode::Closest;
+
+			/**
+			 * Only entities whose Renderer3D::raycastMask shares a bit with it are tested.
+			 */
+			uint8_t raycastMask = -1;
+		};
+
+		struct SceneHit
+		{
+			Hit hit{};
+			entt::entity entity = entt::null;
+
+			[[nodiscard]] bool IsValid() const { return entity != entt::null; }
+		};
+
 		static bool IntersectTriangle(
 			const glm::vec3& start,
 			const glm::vec3& direction,
@@ -55,6 +100,64 @@ namespace Pengine
 			const float length,
 			Hit& hit);
 
+		/**
+		 * Moller-Trumbore test, the direction doesn't have to be normalized, distance is then in its units.
+		 * Barycentrics are the weights of b and c, the weight of a is 1 - x - y.
+		 */
+		static bool IntersectRayTriangle(
+			const glm::vec3& start,
+			const glm::vec3& direction,
+			const glm::vec3& a,
+			const glm::vec3& b,
+			const glm::vec3& c,
+			const float length,
+			float& distance,
+			glm::vec2& barycentrics);
+
+		/**
+		 * Slab test with the inverse direction computed once per ray, distance is the entry distance clamped to 0.
+		 */
+		static bool IntersectRayAABB(
+			const glm::vec3& start,
+			const glm::vec3& inverseDirection,
+			const glm::vec3& min,
+			const glm::vec3& max,
+			const float length,
+			float& distance)
+		{
+			const glm::vec3 t1 = (min - start) * inverseDirection;
+			const glm::vec3 t2 = (max - start) * inverseDirection;
+			const glm::vec3 tMin = glm::min(t1, t2);
+			const glm::vec3 tMax = glm::max(t1, t2);
+
+			const float entry = std::max(std::max(tMin.x, tMin.y), std::max(tMin.z, 0.0f));
+			const float exit = std::min(std::min(tMax.x, tMax.y), std::min(tMax.z, length));
+
+			distance = entry;
+			return entry <= exit;
+		}
+
+		/**
+		 * Casts a ray against the scene BVH and the mesh BVHs of the leaves, no allocations are made.
+		 * Uses the transforms the scene BVH was last built with.
+		 */
+		static bool RaycastScene(
+			const std::shared_ptr<class Scene>& scene,
+			const Ray& ray,
+			const Query& query,
+			SceneHit& hit);
+
+		/**
+		 * Casts the rays in packets spread across the thread pool with ThreadPool::ParallelFor.
+		 * hits is resized to the ray count and can be reused between calls.
+		 */
+		static void RaycastScene(
+			const std::shared_ptr<class Scene>& scene,
+			const std::vector<Ray>& rays,
+			const Query& query,
+			std::vector<SceneHit>& hits,
+			ThreadPool& threadPool = ThreadPool::GetInstance());
+
 		static std::map<Hit, std::shared_ptr<class Entity>> RaycastScene(
 			std::shared_ptr<class Scene> scene,
 			const glm::vec3& start,
@@ -26,20 +26,52 @@ namespace Pengine
 			}
 		};
 
+		/**
+		 * Created once per type and shared by all properties of that type, keyed by GetTypeHash<T>().
+		 */
+		struct Type
+		{
+			entt::id_type id = 0;
+			std::string name;
+			size_t size = 0;
+
+			void (*copy)(void* destination, const void* source) = nullptr;
+
+			/**
+			 * Set by the serializer for value types, out is YAML::Emitter* and in is const YAML::Node*.
+			 */
+			void (*serialize)(void* out, const void* value) = nullptr;
+			void (*deserialize)(const void* in, void* value) = nullptr;
+
+			/**
+			 * Set for std::vector, the elements can be values, containers or reflected structs.
+			 */
+			const Type* elementType = nullptr;
+			size_t (*getSize)(const void* container) = nullptr;
+			void (*resize)(void* container, size_t size) = nullptr;
+			void* (*getElement)(void* container, size_t index) = nullptr;
+		};
+
 		class Property
 		{
 		public:
-			std::string m_Type;
+			std::string m_Name;
+			const Type* m_Type = nullptr;
 			size_t m_Offset = 0;
 
 			template <typename T> bool IsValue() const
 			{
-				return m_Type == GetTypeName<T>();
+				return m_Type->id == GetTypeHash<T>();
 			}
 
 			bool IsVector() const
 			{
-				return m_Type.find("vector") != std::string::npos;
+				return m_Type->elementType != nullptr;
+			}
+
+			void* GetPointer(void* owner, const size_t baseOffset) const
+			{
+				return static_cast<char*>(owner) + m_Offset + baseOffset;
 			}
 
 			template <typename T> T& GetValue(void* owner, const size_t baseOffset)
@@ -93,9 +125,15 @@ namespace Pengine
 
 		struct RegisteredClass
 		{
-			std::vector<std::function<void(void*, void*)>> m_CopyPropertyCallBacks;
-			std::unordered_map<std::string, Property> m_PropertiesByName;
+			/**
+			 * Properties in the order they are declared, the serializer and the editor walk them without lookups.
+			 */
+			std::vector<Property> m_Properties;
 			std::vector<std::pair<entt::id_type, size_t>> m_Parents;
+
+			/**
+			 * Not set for structs that are only used as properties.
+			 */
 			std::function<void*(entt::registry&, entt::entity)> m_CreateCallback;
 			std::function<void(entt::registry&, entt::entity)> m_RemoveCallback;
 			std::function<void(void*, void*, void*)> m_SerializeCallback;
@@ -103,12 +141,83 @@ namespace Pengine
 			entt::type_info m_TypeInfo;
 
 			RegisteredClass(const entt::type_info& typeInfo) : m_TypeInfo(typeInfo) {}
+
+			const Property* FindProperty(const std::string_view name) const
+			{
+				for (const Property& property : m_Properties)
+				{
+					if (property.m_Name == name)
+					{
+						return &property;
+					}
+				}
+
+				return nullptr;
+			}
 		};
 
 		std::map<entt::id_type, RegisteredClass> m_ClassesByType;
 
 		static ReflectionSystem& GetInstance();
 
+		/**
+		 * Returns the class of a reflected struct or nullptr for values and containers.
+		 */
+		const RegisteredClass* FindClass(const entt::id_type id) const
+		{
+			if (const auto classByType = m_ClassesByType.find(id);
+				classByType != m_ClassesByType.end())
+			{
+				return &classByType->second;
+			}
+
+			return nullptr;
+		}
+
+		template <typename T>
+		static Type& GetOrCreateType()
+		{
+			using ValueType = std::remove_cv_t<std::remove_reference_t<T>>;
+
+			ReflectionSystem& reflectionSystem = GetInstance();
+			if (const auto typeById = reflectionSystem.m_TypesById.find(GetTypeHash<ValueType>());
+				typeById != reflectionSystem.m_TypesById.end())
+			{
+				return *typeById->second;
+			}
+
+			std::unique_ptr<Type> type = std::make_unique<Type>();
+			type->id = GetTypeHash<ValueType>();
+			type->name = GetTypeName<ValueType>();
+			type->size = sizeof(ValueType);
+			type->copy = [](void* destination, const void* source)
+			{
+				*static_cast<ValueType*>(destination) = *static_cast<const ValueType*>(source);
+			};
+
+			if constexpr (IsVector<ValueType>::value)
+			{
+				using ElementType = typename ValueType::value_type;
+				static_assert(!std::is_same_v<ElementType, bool>, "std::vector<bool> has no addressable elements!");
+
+				type->elementType = &GetOrCreateType<ElementType>();
+				type->getSize = [](const void* container)
+				{
+					return static_cast<const ValueType*>(container)->size();
+				};
+				type->resize = [](void* container, const size_t size)
+				{
+					static_cast<ValueType*>(container)->resize(size);
+				};
+				type->getElement = [](void* container, const size_t index)
+				{
+					return static_cast<void*>(&(*static_cast<ValueType*>(container))[index]);
+				};
+			}
+
+			return *reflectionSystem.m_TypesById.emplace(type->id, std::move(type)).first->second;
+		}
+
 		template <typename T>
 		static bool SetValueImpl(const T& value, void* instance, const entt::id_type& classId,
 								 const std::string& propertyName, size_t offset)
@@ -116,19 +225,12 @@ namespace Pengine
 			if (const auto classByType = GetInstance().m_ClassesByType.find(classId);
 				classByType != GetInstance().m_ClassesByType.end())
 			{
-				for (auto& [name, property] : classByType->second.m_PropertiesByName)
+				if (const Property* property = classByType->second.FindProperty(propertyName);
+					property && property->template IsValue<T>())
 				{
-					if (propertyName != name)
-					{
-						continue;
-					}
+					*static_cast<T*>(property->GetPointer(instance, offset)) = value;
 
-					if (property.IsValue<T>())
-					{
-						property.SetValue(instance, value, offset);
-
-						return true;
-					}
+					return true;
 				}
 
 				for (const auto& [parentName, parentOffset] : classByType->second.m_Parents)
@@ -159,17 +261,10 @@ namespace Pengine
 			if (const auto classByType = GetInstance().m_ClassesByType.find(classId);
 				classByType != GetInstance().m_ClassesByType.end())
 			{
-				for (auto& [name, property] : classByType->second.m_PropertiesByName)
+				if (const Property* property = classByType->second.FindProperty(propertyName);
+					property && property->template IsValue<T>())
 				{
-					if (propertyName != name)
-					{
-						continue;
-					}
-
-					if (property.IsValue<T>())
-					{
-						return property.GetValue<T>(instance, offset);
-					}
+					return *static_cast<T*>(property->GetPointer(instance, offset));
 				}
 
 				for (const auto& [parentName, parentOffset] : classByType->second.m_Parents)
@@ -188,6 +283,15 @@ namespace Pengine
 		{
 			return GetValueImpl<T>(instance, classId, propertyName, 0);
 		}
+
+	private:
+		template <typename T>
+		struct IsVector : std::false_type {};
+
+		template <typename T, typename Allocator>
+		struct IsVector<std::vector<T, Allocator>> : std::true_type {};
+
+		std::unordered_map<entt::id_type, std::unique_ptr<Type>> m_TypesById;
 	};
 
 #define COM ,
@@ -204,10 +308,22 @@ namespace Pengine
 		{                                                                                                              \
 			registry.remove<_type>(entity);                                                                            \
 		};                                                                                                             \
+		Pengine::ReflectionSystem::GetOrCreateType<_type>();                                                           \
 		Pengine::ReflectionSystem::GetInstance().m_ClassesByType.emplace(                                              \
 			std::make_pair(GetTypeHash<_type>(), registeredClass));                                                    \
 	}
 
+/**
+ * Registers a struct that is used as a property or a container element, it can't be added to an entity.
+ */
+#define REGISTER_STRUCT(_type)                                                                                         \
+	RTTR_REGISTRATION_USER_DEFINED(_type)                                                                              \
+	{                                                                                                                  \
+		Pengine::ReflectionSystem::GetOrCreateType<_type>();                                                           \
+		Pengine::ReflectionSystem::GetInstance().m_ClassesByType.emplace(                                              \
+			std::make_pair(GetTypeHash<_type>(), Pengine::ReflectionSystem::RegisteredClass(entt::type_id<_type>()))); \
+	}
+
 #define SERIALIZE_CALLBACK(_callback)                                                                                  \
 private:                                                                                                               \
 	Pengine::ReflectionSystem::ReflectionWrapper ___ReflectionWrapper_SerializeCallback = Pengine::ReflectionSystem::ReflectionWrapper(\
@@ -238,6 +354,7 @@ private:
 			}                                                                                                          \
 		});
 
+// The property is added once, when the first instance is constructed after the class is registered.
 #define PROPERTY(_type, _name, _value)                                                                                 \
 	_type _name = _value;                                                                                              \
 																													   \
@@ -245,20 +362,21 @@ private:
 	Pengine::ReflectionSystem::ReflectionWrapper ___ReflectionWrapper_##_name = Pengine::ReflectionSystem::ReflectionWrapper(\
 		[baseClass = this]                                                                                             \
 		{                                                                                                              \
+			static bool isRegistered = false;                                                                          \
+			if (isRegistered)                                                                                          \
+				return;                                                                                                \
 			auto classByType =                                                                                         \
 				Pengine::ReflectionSystem::GetInstance().m_ClassesByType.find(GetTypeHash<decltype(*baseClass)>());    \
 			if (classByType != Pengine::ReflectionSystem::GetInstance().m_ClassesByType.end())                         \
 			{                                                                                                          \
-				if (classByType->second.m_PropertiesByName.count(#_name) > 0)                                          \
+				isRegistered = true;                                                                                   \
+				if (classByType->second.FindProperty(#_name))                                                          \
 					return;                                                                                            \
-				classByType->second.m_PropertiesByName.emplace(                                                        \
-					std::string(#_name),                                                                               \
+				classByType->second.m_Properties.emplace_back(                                                         \
 					Pengine::ReflectionSystem::Property{                                                               \
-						GetTypeName<_type>(),                                                                          \
+						std::string(#_name),                                                                           \
+						&Pengine::ReflectionSystem::GetOrCreateType<_type>(),                                          \
 						((::size_t) & reinterpret_cast<char const volatile&>((((decltype(baseClass))0)->_name)))});    \
-				classByType->second.m_CopyPropertyCallBacks.push_back(                                                 \
-					[=](void* a, void* b)                                                                              \
-					{ static_cast<decltype(baseClass)>(a)->_name = static_cast<decltype(baseClass)>(b)->_name; });     \
 			}                                                                                                          \
 		});
 
@@ -267,16 +385,17 @@ private:
 		[this, &_component, &copyProperties](const entt::id_type& typeHash, size_t offset)                             \
 	{                                                                                                                  \
 		auto classByType = Pengine::ReflectionSystem::GetInstance().m_ClassesByType.find(typeHash);                    \
-		if (classByType != Pengine::ReflectionSystem::GetInstance().m_ClassesByType.end())                             \
+		if (classByType == Pengine::ReflectionSystem::GetInstance().m_ClassesByType.end())                             \
 		{                                                                                                              \
-			for (size_t i = 0; i < classByType->second.m_CopyPropertyCallBacks.size(); i++)                            \
-			{                                                                                                          \
-				classByType->second.m_CopyPropertyCallBacks[i]((char*)this + offset, (char*)&_component + offset);     \
-			}                                                                                                          \
+			return;                                                                                                    \
+		}                                                                                                              \
+		for (const Pengine::ReflectionSystem::Property& property : classByType->second.m_Properties)                   \
+		{                                                                                                              \
+			property.m_Type->copy(property.GetPointer(this, offset), property.GetPointer((void*)&_component, offset)); \
 		}                                                                                                              \
 		for (const auto& parent : classByType->second.m_Parents)                                                       \
 		{                                                                                                              \
-			copyProperties(parent.first, parent.second);                                                               \
+			copyProperties(parent.first, offset + parent.second);                                                      \
 		}                                                                                                              \
 	};                                                                                                                 \
 	copyProperties(GetTypeHash<decltype(_component)>(), 0);
@@ -13,14 +13,11 @@
 #include "Profiler.h"
 #include "Timer.h"
 
-#include "../Components/Canvas.h"
 #include "../Components/Camera.h"
-#include "../Components/Decal.h"
 #include "../Components/DirectionalLight.h"
 #include "../Components/PointLight.h"
 #include "../Components/SpotLight.h"
 #include "../Components/Renderer3D.h"
-#include "../Components/SkeletalAnimator.h"
 #include "../Components/Transform.h"
 #include "../Graphics/Device.h"
 #include "../Graphics/Renderer.h"
@@ -32,8 +29,30 @@
 #include "../Core/ViewportManager.h"
 #include "../Core/Viewport.h"
 
+#include <bit>
+
 using namespace Pengine;
 
+namespace
+{
+	const std::string OrderIndependentTransparencyOption = "Order Independent Transparency";
+
+	/**
+	 * Rendering order in the top 4 bits, then a coarse distance bucket, the batch and the fine distance.
+	 * Inside of a bucket the draws are grouped by batch, so equal meshes and materials become one instanced draw
+	 * whose instances are still back to front. Distances are inverted so the farthest comes first.
+	 */
+	uint64_t MakeTransparentSortKey(const int renderingOrder, const float distance2ToCamera, const uint32_t batch)
+	{
+		// Positive floats compare like their bits, the bucket is the exponent and 4 bits of the mantissa.
+		const uint32_t distance = 0x7FFFFFFFu - std::bit_cast<uint32_t>(glm::max(distance2ToCamera, 0.0f));
+		const uint64_t bucket = distance >> 19;
+		const uint64_t fine = (distance >> 7) & 0xFFFFFF;
+
+		return static_cast<uint64_t>(renderingOrder & 0xF) << 60 | bucket << 48 | static_cast<uint64_t>(batch & 0xFFFFFF) << 24 | fine;
+	}
+}
+
 RenderPassManager& RenderPassManager::GetInstance()
 {
 	static RenderPassManager renderPassManager;
@@ -204,7 +223,7 @@ bool RenderPassManager::BindAndFlushUniformWriters(
 	return true;
 }
 
-void RenderPassManager::PrepareUniformsPerViewportBeforeDraw(const RenderPass::RenderCallbackInfo& renderInfo)
+bool RenderPassManager::PrepareUniformsPerViewportBeforeDraw(const RenderPass::RenderCallbackInfo& renderInfo)
 {
 	PROFILER_SCOPE(__FUNCTION__);
 
@@ -213,30 +232,34 @@ void RenderPassManager::PrepareUniformsPerViewportBeforeDraw(const RenderPass::R
 	const std::shared_ptr<Pipeline> pipeline = reflectionBaseMaterial->GetPipeline(DefaultReflection);
 	if (!pipeline)
 	{
-		FATAL_ERROR("DefaultReflection base material is broken! No pipeline found!");
+		if (reflectionBaseMaterial->IsReady())
+		{
+			FATAL_ERROR("DefaultReflection base material is broken! No pipeline found!");
+		}
+
+		return false;
 	}
 
 	const std::shared_ptr<UniformWriter> renderUniformWriter = GetOrCreateUniformWriter(renderInfo.renderView, pipeline, Pipeline::DescriptorSetIndexType::RENDERER, DefaultReflection);
 	const std::string globalBufferName = "GlobalBuffer";
 	const std::shared_ptr<Buffer> globalBuffer = GetOrCreateRenderBuffer(renderInfo.renderView, renderUniformWriter, globalBufferName);
 
-	const Camera& camera = renderInfo.camera->GetComponent<Camera>();
-	const Transform& cameraTransform = renderInfo.camera->GetComponent<Transform>();
-	const glm::mat4 viewProjectionMat4 = renderInfo.projection * camera.GetViewMat4();
+	const RenderSnapshot::CameraData& camera = *renderInfo.cameraData;
+	const glm::mat4 viewProjectionMat4 = renderInfo.projection * camera.viewMat4;
 	reflectionBaseMaterial->WriteToBuffer(
 		globalBuffer,
 		globalBufferName,
 		"camera.viewProjectionMat4",
 		viewProjectionMat4);
 
-	const glm::mat4 viewMat4 = camera.GetViewMat4();
+	const glm::mat4 viewMat4 = camera.viewMat4;
 	reflectionBaseMaterial->WriteToBuffer(
 		globalBuffer,
 		globalBufferName,
 		"camera.viewMat4",
 		viewMat4);
 
-	const glm::mat4 inverseViewMat4 = glm::inverse(camera.GetViewMat4());
+	const glm::mat4 inverseViewMat4 = glm::inverse(camera.viewMat4);
 	reflectionBaseMaterial->WriteToBuffer(
 		globalBuffer,
 		globalBufferName,
@@ -249,21 +272,21 @@ void RenderPassManager::PrepareUniformsPerViewportBeforeDraw(const RenderPass::R
 		"camera.projectionMat4",
 		renderInfo.projection);
 
-	const glm::mat4 inverseRotationMat4 = glm::inverse(cameraTransform.GetRotationMat4());
+	const glm::mat4 inverseRotationMat4 = glm::inverse(camera.rotationMat4);
 	reflectionBaseMaterial->WriteToBuffer(
 		globalBuffer,
 		globalBufferName,
 		"camera.inverseRotationMat4",
 		inverseRotationMat4);
 
-	const glm::vec3 positionViewSpace = camera.GetViewMat4() * glm::vec4(cameraTransform.GetPosition(), 1.0f);
+	const glm::vec3 positionViewSpace = camera.viewMat4 * glm::vec4(camera.position, 1.0f);
 	reflectionBaseMaterial->WriteToBuffer(
 		globalBuffer,
 		globalBufferName,
 		"camera.positionViewSpace",
 		positionViewSpace);
 
-	const glm::vec3 positionWorldSpace = cameraTransform.GetPosition();
+	const glm::vec3 positionWorldSpace = camera.position;
 	reflectionBaseMaterial->WriteToBuffer(
 		globalBuffer,
 		globalBufferName,
@@ -284,14 +307,14 @@ void RenderPassManager::PrepareUniformsPerViewportBeforeDraw(const RenderPass::R
 		"camera.deltaTime",
 		deltaTime);
 
-	const float zNear = camera.GetZNear();
+	const float zNear = camera.zNear;
 	reflectionBaseMaterial->WriteToBuffer(
 		globalBuffer,
 		globalBufferName,
 		"camera.zNear",
 		zNear);
 
-	const float zFar = camera.GetZFar();
+	const float zFar = camera.zFar;
 	reflectionBaseMaterial->WriteToBuffer(
 		globalBuffer,
 		globalBufferName,
@@ -312,7 +335,7 @@ void RenderPassManager::PrepareUniformsPerViewportBeforeDraw(const RenderPass::R
 		"camera.aspectRatio",
 		aspectRation);
 
-	const float tanHalfFOV = tanf(camera.GetFov() / 2.0f);
+	const float tanHalfFOV = tanf(camera.fov / 2.0f);
 	reflectionBaseMaterial->WriteToBuffer(
 		renderInfo.renderView->GetBuffer(globalBufferName),
 		globalBufferName,
@@ -338,6 +361,8 @@ void RenderPassManager::PrepareUniformsPerViewportBeforeDraw(const RenderPass::R
 		globalBufferName,
 		"camera.wind.frequency",
 		windSettings.frequency);
+
+	return true;
 }
 
 std::shared_ptr<Texture> RenderPassManager::ScaleTexture(
@@ -348,6 +373,10 @@ std::shared_ptr<Texture> RenderPassManager::ScaleTexture(
 
 	const std::shared_ptr<Renderer> renderer = Renderer::Create();
 	const std::shared_ptr<BaseMaterial> baseMaterial = MaterialManager::GetInstance().LoadBaseMaterial("Materials/ScaleTexture.basemat");
+
+	// Dispatched right away, so the pipeline can't be skipped until it is published.
+	baseMaterial->WaitForPipelines();
+	baseMaterial->PublishPipelines();
 	const std::shared_ptr<Pipeline> pipeline = baseMaterial->GetPipeline("ScaleTexture");
 	if (!renderer || !pipeline)
 	{
@@ -385,11 +414,13 @@ std::shared_ptr<Texture> RenderPassManager::ScaleTexture(
 
 void RenderPassManager::Initialize()
 {
+	CreateSkinning();
 	CreateDefaultReflection();
 	CreateZPrePass();
 	CreateGBuffer();
 	CreateDeferred();
 	CreateAtmosphere();
+	CreateTransparentOIT();
 	CreateTransparent();
 	CreateToneMappingPass();
 	CreateSSAO();
@@ -415,6 +446,35 @@ void RenderPassManager::GetVertexBuffers(
 {
 	PROFILER_SCOPE(__FUNCTION__);
 
+	GetVertexBuffers(pipeline, mesh->GetVertexLayouts(), mesh->GetVertexLayoutHandles(), vertexBuffers, vertexBufferOffsets);
+}
+
+void RenderPassManager::GetVertexBuffers(
+	std::shared_ptr<Pipeline> pipeline,
+	const SkinningData::Instance& skinnedInstance,
+	std::vector<NativeHandle>& vertexBuffers,
+	std::vector<size_t>& vertexBufferOffsets)
+{
+	PROFILER_SCOPE(__FUNCTION__);
+
+	// The outputs are multibuffered, the handles change every frame.
+	std::vector<NativeHandle> handles;
+	handles.reserve(skinnedInstance.vertexBuffers.size());
+	for (const std::shared_ptr<Buffer>& vertexBuffer : skinnedInstance.vertexBuffers)
+	{
+		handles.emplace_back(vertexBuffer->GetNativeHandle());
+	}
+
+	GetVertexBuffers(pipeline, skinnedInstance.mesh->GetVertexLayouts(), handles, vertexBuffers, vertexBufferOffsets);
+}
+
+void RenderPassManager::GetVertexBuffers(
+	std::shared_ptr<Pipeline> pipeline,
+	const std::vector<VertexLayout>& vertexLayouts,
+	const std::vector<NativeHandle>& handles,
+	std::vector<NativeHandle>& vertexBuffers,
+	std::vector<size_t>& vertexBufferOffsets)
+{
 	if (pipeline->GetType() != Pipeline::Type::GRAPHICS)
 	{
 		FATAL_ERROR("Can't get vertex buffers, pipeline type is not Pipeline::Type::GRAPHICS!");
@@ -423,8 +483,6 @@ void RenderPassManager::GetVertexBuffers(
 	vertexBuffers.clear();
 	vertexBufferOffsets.clear();
 
-	const std::vector<NativeHandle>& handles = mesh->GetVertexLayoutHandles();
-	const std::vector<VertexLayout>& vertexLayouts = mesh->GetVertexLayouts();
 	const size_t vertexLayoutCount = vertexLayouts.size();
 
 	const std::shared_ptr<GraphicsPipeline>& graphicsPipeline = std::static_pointer_cast<GraphicsPipeline>(pipeline);
@@ -451,6 +509,396 @@ void RenderPassManager::GetVertexBuffers(
 	}
 }
 
+const RenderPassManager::SkinningData::Instance* RenderPassManager::GetSkinnedInstance(
+	const std::shared_ptr<Scene>& scene,
+	const entt::entity entity)
+{
+	const SkinningData* skinningData = (SkinningData*)scene->GetRenderView()->GetCustomData("SkinningData");
+	if (!skinningData)
+	{
+		return nullptr;
+	}
+
+	const auto instance = skinningData->instancesByEntity.find(entity);
+	return instance != skinningData->instancesByEntity.end() ? &instance->second : nullptr;
+}
+
+void RenderPassManager::GetTransparentRenderDatas(
+	const RenderPass::RenderCallbackInfo& renderInfo,
+	TransparentData& transparentData)
+{
+	PROFILER_SCOPE(__FUNCTION__);
+
+	transparentData.sortedRenderDatas.clear();
+	transparentData.orderIndependentRenderDatas.clear();
+
+	VisibleData* visibleData = (VisibleData*)renderInfo.renderView->GetCustomData("VisibleData");
+
+	struct BatchKey
+	{
+		const Mesh* mesh = nullptr;
+		const Material* material = nullptr;
+
+		bool operator==(const BatchKey& other) const
+		{
+			return mesh == other.mesh && material == other.material;
+		}
+	};
+
+	struct BatchKeyHash
+	{
+		size_t operator()(const BatchKey& key) const
+		{
+			return Utils::CombineHash(std::hash<const void*>{}(key.mesh), std::hash<const void*>{}(key.material));
+		}
+	};
+
+	std::unordered_map<BatchKey, uint32_t, BatchKeyHash> batchesByKey;
+	uint32_t batchCount = 0;
+
+	const std::shared_ptr<Scene> scene = renderInfo.scene;
+	const RenderSnapshot& snapshot = *renderInfo.snapshot;
+	for (const entt::entity& entity : visibleData->visibleEntities)
+	{
+		const RenderSnapshot::RenderableData& renderable = *snapshot.GetRenderable(entity);
+
+		if (!renderable.material->IsPipelineEnabled(Transparent))
+		{
+			continue;
+		}
+
+		const std::shared_ptr<BaseMaterial>& baseMaterial = renderable.material->GetBaseMaterial();
+		if (!baseMaterial->GetPipeline(Transparent))
+		{
+			continue;
+		}
+
+		TransparentRenderData renderData{};
+		renderData.renderable = &renderable;
+
+		if (renderable.mesh->GetType() == Mesh::Type::SKINNED)
+		{
+			renderData.skinnedInstance = GetSkinnedInstance(scene, entity);
+			if (!renderData.skinnedInstance)
+			{
+				continue;
+			}
+
+			renderData.batch = batchCount++;
+		}
+		else
+		{
+			const auto [batchByKey, isNew] = batchesByKey.try_emplace(BatchKey{ renderable.mesh.get(), renderable.material.get() }, batchCount);
+			renderData.batch = batchByKey->second;
+			if (isNew)
+			{
+				batchCount++;
+			}
+		}
+
+		// Without a pipeline for the order independent pass the material is still sorted.
+		if (renderable.material->IsOptionEnabled(OrderIndependentTransparencyOption) && baseMaterial->GetPipeline(TransparentOIT))
+		{
+			transparentData.orderIndependentRenderDatas.emplace_back(renderData);
+		}
+		else
+		{
+			transparentData.sortedRenderDatas.emplace_back(renderData);
+		}
+	}
+}
+
+void RenderPassManager::RenderTransparent(
+	const RenderPass::RenderCallbackInfo& renderInfo,
+	const std::vector<TransparentRenderData>& renderDatas,
+	const std::vector<Utils::SortEntry>& sortEntries,
+	const std::string& instanceBufferName)
+{
+	PROFILER_SCOPE(__FUNCTION__);
+
+	const std::string& renderPassName = renderInfo.renderPass->GetName();
+
+	std::shared_ptr<Buffer> instanceBuffer = renderInfo.renderView->GetBuffer(instanceBufferName);
+	if (!instanceBuffer || instanceBuffer->GetInstanceCount() < renderDatas.size())
+	{
+		instanceBuffer = Buffer::Create(
+			sizeof(InstanceData),
+			renderDatas.size() * 2,
+			Buffer::Usage::VERTEX_BUFFER,
+			MemoryType::CPU,
+			true);
+
+		renderInfo.renderView->SetBuffer(instanceBufferName, instanceBuffer);
+	}
+
+	std::vector<InstanceData> instanceDatas;
+	instanceDatas.reserve(sortEntries.size());
+
+	for (size_t first = 0; first < sortEntries.size();)
+	{
+		const TransparentRenderData& renderData = renderDatas[sortEntries[first].index];
+
+		size_t last = first + 1;
+		while (last < sortEntries.size() && renderDatas[sortEntries[last].index].batch == renderData.batch)
+		{
+			last++;
+		}
+
+		const size_t instanceDataOffset = instanceDatas.size();
+		for (size_t i = first; i < last; i++)
+		{
+			const RenderSnapshot::RenderableData& renderable = *renderDatas[sortEntries[i].index].renderable;
+
+			InstanceData& data = instanceDatas.emplace_back();
+			data.transform = renderable.transform;
+			data.inverseTransform = glm::transpose(renderable.inverseTransform);
+		}
+
+		const uint32_t instanceCount = static_cast<uint32_t>(last - first);
+		first = last;
+
+		const std::shared_ptr<Pipeline> pipeline = renderData.renderable->material->GetBaseMaterial()->GetPipeline(renderPassName);
+
+		// The whole batch shares the material, the uniform writers are gathered once per draw.
+		std::vector<NativeHandle> uniformWriterNativeHandles;
+		std::vector<std::shared_ptr<UniformWriter>> uniformWriters;
+		GetUniformWriters(
+			pipeline,
+			renderData.renderable->material->GetBaseMaterial(),
+			renderData.renderable->material,
+			renderInfo,
+			uniformWriters,
+			uniformWriterNativeHandles);
+
+		if (!FlushUniformWriters(uniformWriters))
+		{
+			continue;
+		}
+
+		std::vector<NativeHandle> vertexBuffers;
+		std::vector<size_t> vertexBufferOffsets;
+		if (renderData.skinnedInstance)
+		{
+			GetVertexBuffers(pipeline, *renderData.skinnedInstance, vertexBuffers, vertexBufferOffsets);
+		}
+		else
+		{
+			GetVertexBuffers(pipeline, renderData.renderable->mesh, vertexBuffers, vertexBufferOffsets);
+		}
+
+		renderInfo.renderer->Render(
+			vertexBuffers,
+			vertexBufferOffsets,
+			renderData.renderable->mesh->GetIndexBuffer()->GetNativeHandle(),
+			renderData.renderable->mesh->GetLods()[0].indexOffset * sizeof(uint32_t),
+			renderData.renderable->mesh->GetLods()[0].indexCount,
+			pipeline,
+			instanceBuffer->GetNativeHandle(),
+			instanceDataOffset * instanceBuffer->GetInstanceSize(),
+			instanceCount,
+			uniformWriterNativeHandles,
+			renderInfo.frame);
+	}
+
+	// Because these are all just commands and will be rendered later we can write the instance buffer
+	// just once when all instance data is collected.
+	if (!instanceDatas.empty())
+	{
+		instanceBuffer->WriteToBuffer(instanceDatas.data(), instanceDatas.size() * sizeof(InstanceData));
+		instanceBuffer->Flush();
+	}
+}
+
+void RenderPassManager::CreateSkinning()
+{
+	ComputePass::CreateInfo createInfo{};
+	createInfo.type = Pass::Type::COMPUTE;
+	createInfo.name = Skinning;
+
+	createInfo.executeCallback = [this, passName = createInfo.name](const RenderPass::RenderCallbackInfo& renderInfo)
+	{
+		PROFILER_SCOPE(Skinning);
+
+		const std::shared_ptr<Scene> scene = renderInfo.scene;
+		const std::shared_ptr<RenderView> renderView = scene->GetRenderView();
+		const RenderSnapshot& snapshot = *renderInfo.snapshot;
+
+		SkinningData* skinningData = (SkinningData*)renderView->GetCustomData("SkinningData");
+		if (!skinningData)
+		{
+			skinningData = new SkinningData();
+			renderView->SetCustomData("SkinningData", skinningData);
+		}
+
+		skinningData->frame++;
+
+		const std::shared_ptr<BaseMaterial> baseMaterial = MaterialManager::GetInstance().LoadBaseMaterial(
+			std::filesystem::path("Materials") / "Skinning.basemat");
+		const std::shared_ptr<Pipeline> pipeline = baseMaterial->GetPipeline(passName);
+		if (!pipeline)
+		{
+			skinningData->instancesByEntity.clear();
+			return;
+		}
+
+		struct SkinnedEntity
+		{
+			entt::entity entity;
+			std::shared_ptr<Mesh> mesh;
+			uint32_t boneOffset;
+			uint32_t boneCount;
+		};
+
+		// The snapshot already packed the palettes, meshes driven by the same animator share one.
+		const std::vector<glm::mat4>& bonePalettes = snapshot.GetBonePalettes();
+		std::vector<SkinnedEntity> skinnedEntities;
+
+		for (const RenderSnapshot::RenderableData& renderable : snapshot.GetRenderables())
+		{
+			if (renderable.animatorIndex < 0)
+			{
+				continue;
+			}
+
+			const RenderSnapshot::AnimatorData& animator = snapshot.GetAnimators()[renderable.animatorIndex];
+			skinnedEntities.emplace_back(renderable.entity, renderable.mesh, animator.boneOffset, animator.boneCount);
+		}
+
+		if (skinnedEntities.empty() || bonePalettes.empty())
+		{
+			skinningData->instancesByEntity.clear();
+			return;
+		}
+
+		const std::shared_ptr<UniformWriter> sceneUniformWriter = GetOrCreateUniformWriter(
+			renderView,
+			pipeline,
+			Pipeline::DescriptorSetIndexType::SCENE,
+			passName);
+
+		std::shared_ptr<Buffer> bonePaletteBuffer = renderView->GetBuffer("BonePalettes");
+		if (!bonePaletteBuffer || bonePaletteBuffer->GetInstanceCount() < bonePalettes.size())
+		{
+			bonePaletteBuffer = Buffer::Create(
+				sizeof(glm::mat4),
+				bonePalettes.size() * 2,
+				Buffer::Usage::STORAGE_BUFFER,
+				MemoryType::CPU);
+
+			renderView->SetBuffer("BonePalettes", bonePaletteBuffer);
+			sceneUniformWriter->WriteBuffer("BonePalettes", bonePaletteBuffer);
+		}
+
+		bonePaletteBuffer->WriteToBuffer((void*)bonePalettes.data(), bonePalettes.size() * sizeof(glm::mat4));
+
+		if (!FlushUniformWriters({ sceneUniformWriter }))
+		{
+			return;
+		}
+
+		const uint32_t objectSet = *pipeline->GetDescriptorSetIndexByType(Pipeline::DescriptorSetIndexType::OBJECT, passName);
+		const std::shared_ptr<UniformLayout> objectUniformLayout = pipeline->GetUniformLayout(objectSet);
+		const auto skinningInfoBinding = objectUniformLayout->GetBindingByName("SkinningInfo");
+		if (!skinningInfoBinding || !skinningInfoBinding->buffer)
+		{
+			FATAL_ERROR("Skinning.basemat: no SkinningInfo binding was found!");
+		}
+
+		struct SkinningInfo
+		{
+			uint32_t vertexCount;
+			uint32_t boneOffset;
+			uint32_t boneCount;
+		};
+
+		constexpr uint32_t groupSize = 64;
+
+		renderInfo.renderer->BeginCommandLabel(passName, { 1.0f, 0.5f, 0.0f }, renderInfo.frame);
+
+		// The palettes are bound once, only the per instance set changes between dispatches.
+		renderInfo.renderer->BindPipeline(pipeline, renderInfo.frame);
+		renderInfo.renderer->BindUniformWriters(
+			pipeline,
+			{ sceneUniformWriter->GetNativeHandle() },
+			*pipeline->GetDescriptorSetIndexByType(Pipeline::DescriptorSetIndexType::SCENE, passName),
+			renderInfo.frame);
+
+		for (const SkinnedEntity& skinnedEntity : skinnedEntities)
+		{
+			SkinningData::Instance& instance = skinningData->instancesByEntity[skinnedEntity.entity];
+			if (instance.mesh != skinnedEntity.mesh)
+			{
+				instance = {};
+				instance.mesh = skinnedEntity.mesh;
+				instance.uniformWriter = UniformWriter::Create(objectUniformLayout);
+				instance.infoBuffer = Buffer::Create(
+					skinningInfoBinding->buffer->size,
+					1,
+					Buffer::Usage::UNIFORM_BUFFER,
+					MemoryType::CPU);
+				instance.uniformWriter->WriteBuffer("SkinningInfo", instance.infoBuffer);
+
+				// Multibuffered, the next frame can skin while this one is still drawn.
+				const std::vector<VertexLayout>& vertexLayouts = instance.mesh->GetVertexLayouts();
+				for (size_t i = 0; i < vertexLayouts.size(); i++)
+				{
+					const std::shared_ptr<Buffer>& sourceBuffer = instance.mesh->GetVertexBuffer(i);
+					if (vertexLayouts[i].tag == "Position" || vertexLayouts[i].tag == "Normal")
+					{
+						const std::shared_ptr<Buffer> outputBuffer = Buffer::Create(
+							sourceBuffer->GetInstanceSize(),
+							sourceBuffer->GetInstanceCount(),
+							Buffer::Usage::STORAGE_VERTEX_BUFFER,
+							MemoryType::GPU,
+							true);
+
+						instance.uniformWriter->WriteBuffer("Source" + vertexLayouts[i].tag + "s", sourceBuffer);
+						instance.uniformWriter->WriteBuffer(vertexLayouts[i].tag + "s", outputBuffer);
+						instance.vertexBuffers.emplace_back(outputBuffer);
+					}
+					else
+					{
+						if (vertexLayouts[i].tag == "Bones")
+						{
+							instance.uniformWriter->WriteBuffer("SourceBones", sourceBuffer);
+						}
+
+						instance.vertexBuffers.emplace_back(sourceBuffer);
+					}
+				}
+			}
+
+			instance.lastSkinnedFrame = skinningData->frame;
+
+			SkinningInfo skinningInfo{};
+			skinningInfo.vertexCount = static_cast<uint32_t>(instance.mesh->GetVertexCount());
+			skinningInfo.boneOffset = skinnedEntity.boneOffset;
+			skinningInfo.boneCount = skinnedEntity.boneCount;
+			instance.infoBuffer->WriteToBuffer(&skinningInfo, sizeof(SkinningInfo));
+
+			if (!FlushUniformWriters({ instance.uniformWriter }))
+			{
+				continue;
+			}
+
+			renderInfo.renderer->BindUniformWriters(pipeline, { instance.uniformWriter->GetNativeHandle() }, objectSet, renderInfo.frame);
+			renderInfo.renderer->Dispatch({ (skinningInfo.vertexCount + groupSize - 1) / groupSize, 1, 1 }, renderInfo.frame);
+		}
+
+		renderInfo.renderer->MemoryBarrierComputeWriteVertexRead(renderInfo.frame);
+
+		renderInfo.renderer->EndCommandLabel(renderInfo.frame);
+
+		// Entities that were deleted or lost their animator.
+		std::erase_if(skinningData->instancesByEntity, [frame = skinningData->frame](const auto& instance)
+		{
+			return instance.second.lastSkinnedFrame != frame;
+		});
+	};
+
+	CreateComputePass(createInfo);
+}
+
 void RenderPassManager::CreateZPrePass()
 {
 	RenderPass::ClearDepth clearDepth{};
@@ -489,8 +937,9 @@ void RenderPassManager::CreateZPrePass()
 		const std::string& renderPassName = renderInfo.renderPass->GetName();
 
 		const std::shared_ptr<Scene> scene = renderInfo.scene;
-		const Camera& camera = renderInfo.camera->GetComponent<Camera>();
-		const glm::mat4 viewProjectionMat4 = renderInfo.projection * camera.GetViewMat4();
+		const RenderSnapshot& snapshot = *renderInfo.snapshot;
+		const RenderSnapshot::CameraData& camera = *renderInfo.cameraData;
+		const glm::mat4 viewProjectionMat4 = renderInfo.projection * camera.viewMat4;
 
 		const std::vector<entt::entity> visibleEntities = scene->GetBVH()->CullAgainstFrustum(Utils::GetFrustumPlanes(viewProjectionMat4));
 
@@ -507,19 +956,28 @@ void RenderPassManager::CreateZPrePass()
 		// NOTE: All other checks are made in scene BVH during building.
 		for (const entt::entity entity : visibleEntities)
 		{
-			Renderer3D& r3d = scene->GetRegistry().get<Renderer3D>(entity);
-
-			if ((r3d.objectVisibilityMask & camera.GetObjectVisibilityMask()) == 0)
+			// Entities the snapshot skipped, e.g. without a material, aren't rendered.
+			const RenderSnapshot::RenderableData* renderable = snapshot.GetRenderable(entity);
+			if (!renderable)
 			{
 				continue;
 			}
 
-			if (!r3d.material)
+			if ((renderable->objectVisibilityMask & camera.objectVisibilityMask) == 0)
 			{
 				continue;
 			}
 
 			visibleData->visibleEntities.emplace_back(entity);
+
+			// Visible skinned meshes tell their animator how large they are on the screen to pick the animation lod.
+			if (renderable->animatorIndex >= 0)
+			{
+				const float distance = glm::length(camera.position - renderable->position);
+				const float screenSize = distance > renderable->radius ? renderable->radius * glm::abs(renderInfo.projection[1][1]) / distance : 1.0f;
+				const RenderSnapshot::AnimatorData& animator = snapshot.GetAnimators()[renderable->animatorIndex];
+				animator.screenSize = glm::max(animator.screenSize, screenSize);
+			}
 		}
 	};
 
@@ -632,59 +1090,50 @@ void RenderPassManager::CreateGBuffer()
 
 		RenderableEntities renderableEntities;
 		const std::shared_ptr<Scene> scene = renderInfo.scene;
-		entt::registry& registry = scene->GetRegistry();
-		const Camera& camera = renderInfo.camera->GetComponent<Camera>();
-		const glm::vec3 cameraPosition = camera.GetEntity()->GetComponent<Transform>().GetPosition();
-		const glm::mat4 viewProjectionMat4 = renderInfo.projection * camera.GetViewMat4();
+		const RenderSnapshot& snapshot = *renderInfo.snapshot;
+		const glm::vec3 cameraPosition = renderInfo.cameraData->position;
 
 		for (const auto& entity : visibleData->visibleEntities)
 		{
-			const Renderer3D& r3d = registry.get<Renderer3D>(entity);
+			const RenderSnapshot::RenderableData& renderable = *snapshot.GetRenderable(entity);
 
-			if (!r3d.material->IsPipelineEnabled(renderPassName))
+			if (!renderable.material->IsPipelineEnabled(renderPassName))
 			{
 				continue;
 			}
 
-			const std::shared_ptr<Pipeline>& pipeline = r3d.material->GetBaseMaterial()->GetPipeline(renderPassName);
+			const std::shared_ptr<Pipeline>& pipeline = renderable.material->GetBaseMaterial()->GetPipeline(renderPassName);
 			if (!pipeline)
 			{
 				continue;
 			}
 
 			size_t lod = 0;
-			const size_t lodCount = r3d.mesh->GetLods().size();
+			const size_t lodCount = renderable.mesh->GetLods().size();
 			if (lodCount > 1)
 			{
-				const Transform& transform = registry.get<Transform>(entity);
-				lod = GetLod(
-					cameraPosition,
-					transform.GetPosition(),
-					glm::length(transform.GetScale() * glm::max(glm::abs(r3d.mesh->GetBoundingBox().min), glm::abs(r3d.mesh->GetBoundingBox().max))),
-					r3d.mesh->GetLods());
+				lod = GetLod(cameraPosition, renderable.position, renderable.radius, renderable.mesh->GetLods());
 			}
 			
-			if (r3d.mesh->GetType() == Mesh::Type::SKINNED)
+			if (renderable.mesh->GetType() == Mesh::Type::SKINNED)
 			{
-				if (const auto skeletalAnimatorEntity = scene->FindEntityByUUID(r3d.skeletalAnimatorEntityUUID))
+				const SkinningData::Instance* skinnedInstance = GetSkinnedInstance(scene, entity);
+				if (!skinnedInstance)
 				{
-					SkeletalAnimator* skeletalAnimator = registry.try_get<SkeletalAnimator>(skeletalAnimatorEntity->GetHandle());
-					if (skeletalAnimator)
-					{
-						UpdateSkeletalAnimator(skeletalAnimator, r3d.material->GetBaseMaterial(), pipeline);
-					}
+					continue;
 				}
 
 				EntitiesByMesh::Single single{};
 				single.entity = entity;
-				single.mesh = r3d.mesh;
+				single.mesh = renderable.mesh;
+				single.skinnedInstance = skinnedInstance;
 				single.lod = lod;
 
-				renderableEntities[r3d.material->GetBaseMaterial()][r3d.material].single.emplace_back(single);
+				renderableEntities[renderable.material->GetBaseMaterial()][renderable.material].single.emplace_back(single);
 			}
-			else if (r3d.mesh->GetType() == Mesh::Type::STATIC)
+			else if (renderable.mesh->GetType() == Mesh::Type::STATIC)
 			{
-				auto& entities = renderableEntities[r3d.material->GetBaseMaterial()][r3d.material].instanced[r3d.mesh];
+				auto& entities = renderableEntities[renderable.material->GetBaseMaterial()][renderable.material].instanced[renderable.mesh];
 				entities.resize(lodCount);
 				entities[lod].emplace_back(entity);
 			}
@@ -793,9 +1242,9 @@ void RenderPassManager::CreateGBuffer()
 						for (const entt::entity& entity : entitiesByLod[lod])
 						{
 							InstanceData data{};
-							const Transform& transform = registry.get<Transform>(entity);
-							data.transform = transform.GetTransform();
-							data.inverseTransform = glm::transpose(transform.GetInverseTransform());
+							const RenderSnapshot::RenderableData* renderable = snapshot.GetRenderable(entity);
+							data.transform = renderable->transform;
+							data.inverseTransform = glm::transpose(renderable->inverseTransform);
 							instanceDatas.emplace_back(data);
 						}
 
@@ -820,50 +1269,26 @@ void RenderPassManager::CreateGBuffer()
 					const size_t instanceDataOffset = instanceDatas.size();
 
 					InstanceData data{};
-					const Transform& transform = registry.get<Transform>(single.entity);
-					data.transform = transform.GetTransform();
-					data.inverseTransform = glm::transpose(transform.GetInverseTransform());
+					const RenderSnapshot::RenderableData* renderable = snapshot.GetRenderable(single.entity);
+					data.transform = renderable->transform;
+					data.inverseTransform = glm::transpose(renderable->inverseTransform);
 					instanceDatas.emplace_back(data);
 
-					const SkeletalAnimator* skeletalAnimator = nullptr;
-					const Renderer3D& r3d = registry.get<Renderer3D>(single.entity);
-					if (const auto skeletalAnimatorEntity = scene->FindEntityByUUID(r3d.skeletalAnimatorEntityUUID))
-					{
-						skeletalAnimator = registry.try_get<SkeletalAnimator>(skeletalAnimatorEntity->GetHandle());
-					}
+					GetVertexBuffers(pipeline, *single.skinnedInstance, vertexBuffers, vertexBufferOffsets);
 
-					if (skeletalAnimator)
-					{
-						if (!BindAndFlushUniformWriters(
-							pipeline,
-							nullptr,
-							nullptr,
-							renderInfo,
-							{
-								Pipeline::DescriptorSetIndexType::OBJECT,
-							},
-							skeletalAnimator->GetUniformWriter()
-						))
-						{
-							continue;
-						}
-						
-						GetVertexBuffers(pipeline, single.mesh, vertexBuffers, vertexBufferOffsets);
+					renderInfo.renderer->BindVertexBuffers(
+						vertexBuffers,
+						vertexBufferOffsets,
+						single.mesh->GetIndexBuffer()->GetNativeHandle(),
+						single.mesh->GetLods()[single.lod].indexOffset * sizeof(uint32_t),
+						instanceBuffer->GetNativeHandle(),
+						instanceDataOffset * instanceBuffer->GetInstanceSize(),
+						renderInfo.frame);
 
-						renderInfo.renderer->BindVertexBuffers(
-							vertexBuffers,
-							vertexBufferOffsets,
-							single.mesh->GetIndexBuffer()->GetNativeHandle(),
-							single.mesh->GetLods()[single.lod].indexOffset * sizeof(uint32_t),
-							instanceBuffer->GetNativeHandle(),
-							instanceDataOffset * instanceBuffer->GetInstanceSize(),
-							renderInfo.frame);
-						
-						renderInfo.renderer->DrawIndexed(
-							single.mesh->GetLods()[single.lod].indexCount,
-							1,
-							renderInfo.frame);
-					}
+					renderInfo.renderer->DrawIndexed(
+						single.mesh->GetLods()[single.lod].indexCount,
+						1,
+						renderInfo.frame);
 				}
 			}
 		}
@@ -879,7 +1304,7 @@ void RenderPassManager::CreateGBuffer()
 		lineRenderer->Render(renderInfo);
 
 		// Render SkyBox.
-		if (!registry.view<DirectionalLight>().empty())
+		if (snapshot.GetDirectionalLight())
 		{
 			std::shared_ptr<Mesh> cubeMesh = MeshManager::GetInstance().LoadMesh("UnitCube");
 			std::shared_ptr<BaseMaterial> skyBoxBaseMaterial = MaterialManager::GetInstance().LoadBaseMaterial(
@@ -941,24 +1366,21 @@ void RenderPassManager::CreateDeferred()
 		const std::shared_ptr<UniformWriter> lightsUniformWriter = GetOrCreateRendererUniformWriter(renderInfo.renderView, pipeline, lightsBufferName);
 		const std::shared_ptr<Buffer> lightsBuffer = GetOrCreateRenderBuffer(renderInfo.renderView, lightsUniformWriter, lightsBufferName);
 
-		const Camera& camera = renderInfo.camera->GetComponent<Camera>();
+		const RenderSnapshot::CameraData& camera = *renderInfo.cameraData;
 
 		const GraphicsSettings& graphicsSettings = renderInfo.scene->GetGraphicsSettings();
 		baseMaterial->WriteToBuffer(lightsBuffer, lightsBufferName, "brightnessThreshold", graphicsSettings.bloom.brightnessThreshold);
 
-		auto directionalLightView = renderInfo.scene->GetRegistry().view<DirectionalLight>();
-		if (!directionalLightView.empty())
+		if (const auto& directionalLight = renderInfo.snapshot->GetDirectionalLight())
 		{
-			const entt::entity& entity = directionalLightView.back();
-			DirectionalLight& dl = renderInfo.scene->GetRegistry().get<DirectionalLight>(entity);
-			const Transform& transform = renderInfo.scene->GetRegistry().get<Transform>(entity);
+			const DirectionalLight& dl = directionalLight->light;
 
 			baseMaterial->WriteToBuffer(lightsBuffer, lightsBufferName, "directionalLight.color", dl.color);
 			baseMaterial->WriteToBuffer(lightsBuffer, lightsBufferName, "directionalLight.intensity", dl.intensity);
 			baseMaterial->WriteToBuffer(lightsBuffer, lightsBufferName, "directionalLight.ambient", dl.ambient);
 
-			const glm::vec3 directionWorldSpace = transform.GetForward();
-			const glm::vec3 directionViewSpace = glm::normalize(glm::mat3(camera.GetViewMat4()) * directionWorldSpace);
+			const glm::vec3 directionWorldSpace = directionalLight->forward;
+			const glm::vec3 directionViewSpace = glm::normalize(glm::mat3(camera.viewMat4) * directionWorldSpace);
 			baseMaterial->WriteToBuffer(lightsBuffer, lightsBufferName, "directionalLight.directionWorldSpace", directionWorldSpace);
 			baseMaterial->WriteToBuffer(lightsBuffer, lightsBufferName, "directionalLight.directionViewSpace", directionViewSpace);
 
@@ -1103,9 +1525,9 @@ void RenderPassManager::CreateAtmosphere()
 
 		const std::string& renderPassName = renderInfo.renderPass->GetName();
 		std::shared_ptr<FrameBuffer> frameBuffer = renderInfo.scene->GetRenderView()->GetFrameBuffer(Atmosphere);
-		auto directionalLightView = renderInfo.scene->GetRegistry().view<DirectionalLight>();
+		const auto& directionalLight = renderInfo.snapshot->GetDirectionalLight();
 
-		const bool hasDirectionalLight = !directionalLightView.empty();
+		const bool hasDirectionalLight = directionalLight.has_value();
 		if (!hasDirectionalLight)
 		{
 			renderInfo.scene->GetRenderView()->DeleteFrameBuffer(renderPassName);
@@ -1138,15 +1560,13 @@ void RenderPassManager::CreateAtmosphere()
 
 		if (hasDirectionalLight)
 		{
-			const entt::entity& entity = directionalLightView.back();
-			DirectionalLight& dl = renderInfo.scene->GetRegistry().get<DirectionalLight>(entity);
-			const Transform& transform = renderInfo.scene->GetRegistry().get<Transform>(entity);
+			const DirectionalLight& dl = directionalLight->light;
 
 			baseMaterial->WriteToBuffer(atmosphereBuffer, "AtmosphereBuffer", "directionalLight.color", dl.color);
 			baseMaterial->WriteToBuffer(atmosphereBuffer, "AtmosphereBuffer", "directionalLight.intensity", dl.intensity);
 			baseMaterial->WriteToBuffer(atmosphereBuffer, "AtmosphereBuffer", "directionalLight.ambient", dl.ambient);
 
-			const glm::vec3 directionWorldSpace = transform.GetForward();
+			const glm::vec3 directionWorldSpace = directionalLight->forward;
 			baseMaterial->WriteToBuffer(atmosphereBuffer, "AtmosphereBuffer", "directionalLight.directionWorldSpace", directionWorldSpace);
 
 			int hasDirectionalLight = 1;
@@ -1213,6 +1633,100 @@ void RenderPassManager::CreateAtmosphere()
 	CreateRenderPass(createInfo);
 }
 
+void RenderPassManager::CreateTransparentOIT()
+{
+	RenderPass::ClearDepth clearDepth{};
+	clearDepth.clearDepth = 0.0f;
+	clearDepth.clearStencil = 0;
+
+	glm::vec4 clearAccumulation = { 0.0f, 0.0f, 0.0f, 0.0f };
+	glm::vec4 clearRevealage = { 1.0f, 1.0f, 1.0f, 1.0f };
+
+	RenderPass::AttachmentDescription accumulation{};
+	accumulation.textureCreateInfo.format = Format::R16G16B16A16_SFLOAT;
+	accumulation.textureCreateInfo.aspectMask = Texture::AspectMask::COLOR;
+	accumulation.textureCreateInfo.instanceSize = sizeof(uint16_t) * 4;
+	accumulation.textureCreateInfo.isMultiBuffered = true;
+	accumulation.textureCreateInfo.usage = { Texture::Usage::SAMPLED, Texture::Usage::TRANSFER_SRC, Texture::Usage::COLOR_ATTACHMENT };
+	accumulation.textureCreateInfo.name = "OITAccumulation";
+	accumulation.textureCreateInfo.filepath = accumulation.textureCreateInfo.name;
+	accumulation.layout = Texture::Layout::COLOR_ATTACHMENT_OPTIMAL;
+
+	RenderPass::AttachmentDescription revealage{};
+	revealage.textureCreateInfo.format = Format::R16_SFLOAT;
+	revealage.textureCreateInfo.aspectMask = Texture::AspectMask::COLOR;
+	revealage.textureCreateInfo.instanceSize = sizeof(uint16_t);
+	revealage.textureCreateInfo.isMultiBuffered = true;
+	revealage.textureCreateInfo.usage = { Texture::Usage::SAMPLED, Texture::Usage::TRANSFER_SRC, Texture::Usage::COLOR_ATTACHMENT };
+	revealage.textureCreateInfo.name = "OITRevealage";
+	revealage.textureCreateInfo.filepath = revealage.textureCreateInfo.name;
+	revealage.layout = Texture::Layout::COLOR_ATTACHMENT_OPTIMAL;
+
+	RenderPass::AttachmentDescription depth = GetRenderPass(ZPrePass)->GetAttachmentDescriptions()[0];
+	depth.layout = Texture::Layout::DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+	depth.load = RenderPass::Load::LOAD;
+	depth.store = RenderPass::Store::STORE;
+	depth.getFrameBufferCallback = [](RenderView* renderView)
+	{
+		return renderView->GetFrameBuffer(ZPrePass)->GetAttachment(0);
+	};
+
+	RenderPass::CreateInfo createInfo{};
+	createInfo.type = Pass::Type::GRAPHICS;
+	createInfo.name = TransparentOIT;
+	createInfo.clearDepths = { clearDepth };
+	createInfo.clearColors = { clearAccumulation, clearRevealage };
+	createInfo.attachmentDescriptions = { accumulation, revealage, depth };
+	createInfo.resizeWithViewport = true;
+
+	createInfo.executeCallback = [](const RenderPass::RenderCallbackInfo& renderInfo)
+	{
+		PROFILER_SCOPE(TransparentOIT);
+
+		// Runs right before the Transparent pass, which reuses what is gathered here.
+		TransparentData* transparentData = (TransparentData*)renderInfo.renderView->GetCustomData("TransparentData");
+		if (!transparentData)
+		{
+			transparentData = new TransparentData();
+			renderInfo.renderView->SetCustomData("TransparentData", transparentData);
+		}
+
+		GetTransparentRenderDatas(renderInfo, *transparentData);
+
+		const std::vector<TransparentRenderData>& renderDatas = transparentData->orderIndependentRenderDatas;
+
+		// Nothing is composited by the Transparent pass either, the attachments can stay stale.
+		if (renderDatas.empty())
+		{
+			return;
+		}
+
+		// Weighted blended accumulation doesn't depend on the order, the entries are only grouped by batch for instancing.
+		std::vector<Utils::SortEntry>& sortEntries = transparentData->sortEntries;
+		sortEntries.clear();
+		sortEntries.reserve(renderDatas.size());
+		for (size_t i = 0; i < renderDatas.size(); i++)
+		{
+			sortEntries.emplace_back(Utils::SortEntry{ renderDatas[i].batch, static_cast<uint32_t>(i) });
+		}
+
+		Utils::RadixSort(sortEntries, transparentData->scratch);
+
+		const std::shared_ptr<FrameBuffer> frameBuffer = renderInfo.renderView->GetFrameBuffer(renderInfo.renderPass->GetName());
+		RenderPass::SubmitInfo submitInfo{};
+		submitInfo.frame = renderInfo.frame;
+		submitInfo.renderPass = renderInfo.renderPass;
+		submitInfo.frameBuffer = frameBuffer;
+		renderInfo.renderer->BeginRenderPass(submitInfo);
+
+		RenderTransparent(renderInfo, renderDatas, sortEntries, "InstanceBufferTransparentOIT");
+
+		renderInfo.renderer->EndRenderPass(submitInfo);
+	};
+
+	CreateRenderPass(createInfo);
+}
+
 void RenderPassManager::CreateTransparent()
 {
 	RenderPass::ClearDepth clearDepth{};
@@ -1272,145 +1786,88 @@ void RenderPassManager::CreateTransparent()
 		return renderView->GetFrameBuffer(ZPrePass)->GetAttachment(0);
 	};
 
-	RenderPass::CreateInfo createInfo{};
-	createInfo.type = Pass::Type::GRAPHICS;
-	createInfo.name = Transparent;
-	createInfo.clearDepths = { clearDepth };
-	createInfo.clearColors = { clearColor, clearNormal, clearShading, clearEmissive };
-	createInfo.attachmentDescriptions = { color, normal, shading, emissive, depth };
-	createInfo.resizeWithViewport = true;
-
-	createInfo.executeCallback = [](const RenderPass::RenderCallbackInfo& renderInfo)
-	{
-		PROFILER_SCOPE(Transparent);
-
-		const std::string& renderPassName = renderInfo.renderPass->GetName();
-
-		VisibleData* visibleData = (VisibleData*)renderInfo.renderView->GetCustomData("VisibleData");
-
-		struct RenderData
-		{
-			Renderer3D r3d;
-			glm::mat4 transformMat4;
-			glm::mat4 rotationMat4;
-			glm::mat3 inversetransformMat3;
-			glm::vec3 scale;
-			glm::vec3 position;
-			entt::entity entity;
-			float distance2ToCamera = 0.0f;
-		};
-
-		std::vector<std::vector<RenderData>> renderDatasByRenderingOrder;
-		renderDatasByRenderingOrder.resize(11);
-
-		size_t renderableCount = 0;
-		const Camera& camera = renderInfo.camera->GetComponent<Camera>();
-		const std::shared_ptr<Scene> scene = renderInfo.scene;
-		entt::registry& registry = scene->GetRegistry();
-		for (const entt::entity& entity : visibleData->visibleEntities)
-		{
-			Renderer3D& r3d = registry.get<Renderer3D>(entity);
-			Transform& transform = registry.get<Transform>(entity);
-
-			if (!r3d.material->IsPipelineEnabled(renderPassName))
-			{
-				continue;
-			}
-
-			const std::shared_ptr<Pipeline> pipeline = r3d.material->GetBaseMaterial()->GetPipeline(renderPassName);
-			if (!pipeline)
-			{
-				continue;
-			}
-
-			const glm::mat4& transformMat4 = transform.GetTransform();
-			const BoundingBox& box = r3d.mesh->GetBoundingBox();
-
-			if (scene->GetSettings().drawBoundingBoxes)
-			{
-				constexpr glm::vec3 color = glm::vec3(0.0f, 1.0f, 0.0f);
-				scene->GetVisualizer().DrawBox(box.min, box.max, color, transformMat4);
-			}
-
-			RenderData renderData{};
-			renderData.entity = entity;
-			renderData.r3d = r3d;
-			renderData.transformMat4 = transformMat4;
-			renderData.rotationMat4 = transform.GetRotationMat4();
-			renderData.inversetransformMat3 = transform.GetInverseTransform();
-			renderData.scale = transform.GetScale();
-			renderData.position = transform.GetPosition();
+	RenderPass::CreateInfo createInfo{};
+	createInfo.type = Pass::Type::GRAPHICS;
+	createInfo.name = Transparent;
+	createInfo.clearDepths = { clearDepth };
+	createInfo.clearColors = { clearColor, clearNormal, clearShading, clearEmissive };
+	createInfo.attachmentDescriptions = { color, normal, shading, emissive, depth };
+	createInfo.resizeWithViewport = true;
 
-			if (const auto skeletalAnimatorEntity = scene->FindEntityByUUID(r3d.skeletalAnimatorEntityUUID))
-			{
-				SkeletalAnimator* skeletalAnimator = registry.try_get<SkeletalAnimator>(skeletalAnimatorEntity->GetHandle());
-				if (skeletalAnimator)
-				{
-					UpdateSkeletalAnimator(skeletalAnimator, r3d.material->GetBaseMaterial(), pipeline);
-				}
-			}
+	createInfo.executeCallback = [](const RenderPass::RenderCallbackInfo& renderInfo)
+	{
+		PROFILER_SCOPE(Transparent);
 
-			renderDatasByRenderingOrder[r3d.renderingOrder].emplace_back(renderData);
+		const std::string& renderPassName = renderInfo.renderPass->GetName();
 
-			renderableCount++;
+		// Gathered this frame by the TransparentOIT pass.
+		TransparentData* transparentData = (TransparentData*)renderInfo.renderView->GetCustomData("TransparentData");
+		if (!transparentData)
+		{
+			return;
 		}
 
-		if (renderableCount == 0)
+		const std::vector<TransparentRenderData>& renderDatas = transparentData->sortedRenderDatas;
+		const std::vector<TransparentRenderData>& orderIndependentRenderDatas = transparentData->orderIndependentRenderDatas;
+
+		if (renderDatas.empty() && orderIndependentRenderDatas.empty())
 		{
 			return;
 		}
 
-		const glm::vec3 cameraPosition = renderInfo.camera->GetComponent<Transform>().GetPosition();
-
-		for (auto& renderDataByRenderingOrder : renderDatasByRenderingOrder)
+		const std::shared_ptr<Scene> scene = renderInfo.scene;
+		if (scene->GetSettings().drawBoundingBoxes)
 		{
-			for (RenderData& renderData : renderDataByRenderingOrder)
+			constexpr glm::vec3 color = glm::vec3(0.0f, 1.0f, 0.0f);
+			for (const auto* transparentRenderDatas : { &renderDatas, &orderIndependentRenderDatas })
 			{
-				const glm::vec3 boundingBoxWorldPosition = renderData.position + renderData.r3d.mesh->GetBoundingBox().offset * renderData.scale;
-				const glm::vec3 direction = glm::normalize((boundingBoxWorldPosition) - cameraPosition);
-
-				Raycast::Hit hit{};
-				if (Raycast::IntersectBoxOBB(
-					cameraPosition,
-					direction,
-					renderData.r3d.mesh->GetBoundingBox().min,
-					renderData.r3d.mesh->GetBoundingBox().max,
-					renderData.position,
-					renderData.scale,
-					renderData.rotationMat4,
-					FLT_MAX,
-					hit))
-				{
-					renderData.distance2ToCamera = glm::distance2(cameraPosition, hit.point);
-				}
-				else
+				for (const TransparentRenderData& renderData : *transparentRenderDatas)
 				{
-					renderData.distance2ToCamera = glm::distance2(cameraPosition, renderData.position);
+					const BoundingBox& box = renderData.renderable->mesh->GetBoundingBox();
+					scene->GetVisualizer().DrawBox(box.min, box.max, color, renderData.renderable->transform);
 				}
 			}
-
-			auto isFurther = [cameraPosition](const RenderData& a, const RenderData& b)
-			{
-				return a.distance2ToCamera > b.distance2ToCamera;
-			};
-
-			std::sort(renderDataByRenderingOrder.begin(), renderDataByRenderingOrder.end(), isFurther);
 		}
 
-		std::shared_ptr<Buffer> instanceBuffer = renderInfo.renderView->GetBuffer("InstanceBufferTransparent");
-		if ((renderableCount != 0 && !instanceBuffer) || (instanceBuffer && renderableCount != 0 && instanceBuffer->GetInstanceCount() < renderableCount))
+		const glm::vec3 cameraPosition = renderInfo.cameraData->position;
+
+		std::vector<Utils::SortEntry>& sortEntries = transparentData->sortEntries;
+		sortEntries.clear();
+		sortEntries.reserve(renderDatas.size());
+		for (size_t i = 0; i < renderDatas.size(); i++)
 		{
-			instanceBuffer = Buffer::Create(
-				sizeof(InstanceData),
-				renderableCount * 2,
-				Buffer::Usage::VERTEX_BUFFER,
-				MemoryType::CPU,
-				true);
+			const RenderSnapshot::RenderableData& renderable = *renderDatas[i].renderable;
+
+			const glm::vec3 boundingBoxWorldPosition = renderable.position + renderable.mesh->GetBoundingBox().offset * renderable.scale;
+			const glm::vec3 direction = glm::normalize((boundingBoxWorldPosition) - cameraPosition);
+
+			float distance2ToCamera = 0.0f;
 
-			renderInfo.renderView->SetBuffer("InstanceBufferTransparent", instanceBuffer);
+			Raycast::Hit hit{};
+			if (Raycast::IntersectBoxOBB(
+				cameraPosition,
+				direction,
+				renderable.mesh->GetBoundingBox().min,
+				renderable.mesh->GetBoundingBox().max,
+				renderable.position,
+				renderable.scale,
+				renderable.rotationMat4,
+				FLT_MAX,
+				hit))
+			{
+				distance2ToCamera = glm::distance2(cameraPosition, hit.point);
+			}
+			else
+			{
+				distance2ToCamera = glm::distance2(cameraPosition, renderable.position);
+			}
+
+			sortEntries.emplace_back(Utils::SortEntry{
+				MakeTransparentSortKey(renderable.renderingOrder, distance2ToCamera, renderDatas[i].batch),
+				static_cast<uint32_t>(i) });
 		}
 
-		std::vector<InstanceData> instanceDatas;
+		Utils::RadixSort(sortEntries, transparentData->scratch);
 
 		const std::shared_ptr<FrameBuffer> frameBuffer = renderInfo.renderView->GetFrameBuffer(renderPassName);
 		RenderPass::SubmitInfo submitInfo{};
@@ -1419,72 +1876,46 @@ void RenderPassManager::CreateTransparent()
 		submitInfo.frameBuffer = frameBuffer;
 		renderInfo.renderer->BeginRenderPass(submitInfo);
 
-		for (auto& renderDataByRenderingOrder : renderDatasByRenderingOrder)
+		// The order independent surfaces are resolved under the sorted ones.
+		if (!orderIndependentRenderDatas.empty())
 		{
-			for (const auto& renderData : renderDataByRenderingOrder)
-			{
-				const std::shared_ptr<Pipeline> pipeline = renderData.r3d.material->GetBaseMaterial()->GetPipeline(renderPassName);
-
-				const size_t instanceDataOffset = instanceDatas.size();
+			const std::shared_ptr<Mesh> plane = MeshManager::GetInstance().LoadMesh("FullScreenQuad");
 
-				InstanceData data{};
-				data.transform = renderData.transformMat4;
-				data.inverseTransform = glm::transpose(renderData.inversetransformMat3);
-				instanceDatas.emplace_back(data);
+			const std::shared_ptr<BaseMaterial> baseMaterial = MaterialManager::GetInstance().LoadBaseMaterial("Materials/TransparentOITComposite.basemat");
+			const std::shared_ptr<Pipeline> pipeline = baseMaterial->GetPipeline(renderPassName);
+			if (pipeline)
+			{
+				const std::shared_ptr<UniformWriter> renderUniformWriter = GetOrCreateRendererUniformWriter(renderInfo.renderView, pipeline, "TransparentOITComposite");
+				WriteRenderViews(renderInfo.renderView, renderInfo.scene->GetRenderView(), pipeline, renderUniformWriter);
 
-				// Can be done more optimal I guess.
 				std::vector<NativeHandle> uniformWriterNativeHandles;
 				std::vector<std::shared_ptr<UniformWriter>> uniformWriters;
-				GetUniformWriters(
-					pipeline,
-					renderData.r3d.material->GetBaseMaterial(),
-					renderData.r3d.material,
-					renderInfo,
-					uniformWriters,
-					uniformWriterNativeHandles);
-				
-				SkeletalAnimator* skeletalAnimator = nullptr;
-				const Renderer3D& r3d = registry.get<Renderer3D>(renderData.entity);
-				if (const auto skeletalAnimatorEntity = scene->FindEntityByUUID(r3d.skeletalAnimatorEntityUUID))
+				GetUniformWriters(pipeline, baseMaterial, nullptr, renderInfo, uniformWriters, uniformWriterNativeHandles);
+				if (FlushUniformWriters(uniformWriters))
 				{
-					skeletalAnimator = registry.try_get<SkeletalAnimator>(skeletalAnimatorEntity->GetHandle());
-				}
+					std::vector<NativeHandle> vertexBuffers;
+					std::vector<size_t> vertexBufferOffsets;
+					GetVertexBuffers(pipeline, plane, vertexBuffers, vertexBufferOffsets);
 
-				if (skeletalAnimator)
-				{
-					uniformWriters.emplace_back(skeletalAnimator->GetUniformWriter());
-				}
-				
-				if (!FlushUniformWriters(uniformWriters))
-				{
-					continue;
+					renderInfo.renderer->Render(
+						vertexBuffers,
+						vertexBufferOffsets,
+						plane->GetIndexBuffer()->GetNativeHandle(),
+						plane->GetLods()[0].indexOffset * sizeof(uint32_t),
+						plane->GetLods()[0].indexCount,
+						pipeline,
+						NativeHandle::Invalid(),
+						0,
+						1,
+						uniformWriterNativeHandles,
+						renderInfo.frame);
 				}
-
-				std::vector<NativeHandle> vertexBuffers;
-				std::vector<size_t> vertexBufferOffsets;
-				GetVertexBuffers(pipeline, renderData.r3d.mesh, vertexBuffers, vertexBufferOffsets);
-
-				renderInfo.renderer->Render(
-					vertexBuffers,
-					vertexBufferOffsets,
-					renderData.r3d.mesh->GetIndexBuffer()->GetNativeHandle(),
-					renderData.r3d.mesh->GetLods()[0].indexOffset * sizeof(uint32_t),
-					renderData.r3d.mesh->GetLods()[0].indexCount,
-					pipeline,
-					instanceBuffer->GetNativeHandle(),
-					instanceDataOffset * instanceBuffer->GetInstanceSize(),
-					1,
-					uniformWriterNativeHandles,
-					renderInfo.frame);
 			}
 		}
 
-		// Because these are all just commands and will be rendered later we can write the instance buffer
-		// just once when all instance data is collected.
-		if (instanceBuffer && !instanceDatas.empty())
+		if (!renderDatas.empty())
 		{
-			instanceBuffer->WriteToBuffer(instanceDatas.data(), instanceDatas.size() * sizeof(InstanceData));
-			instanceBuffer->Flush();
+			RenderTransparent(renderInfo, renderDatas, sortEntries, "InstanceBufferTransparent");
 		}
 
 		renderInfo.renderer->EndRenderPass(submitInfo);
@@ -1573,36 +2004,30 @@ void RenderPassManager::CreateCSM()
 
 		size_t renderableCount = 0;
 		const std::shared_ptr<Scene> scene = renderInfo.scene;
-		const Camera& camera = renderInfo.camera->GetComponent<Camera>();
-		const glm::vec3 cameraPosition = camera.GetEntity()->GetComponent<Transform>().GetPosition();
-		entt::registry& registry = scene->GetRegistry();
+		const RenderSnapshot& snapshot = *renderInfo.snapshot;
+		const RenderSnapshot::CameraData& camera = *renderInfo.cameraData;
+		const glm::vec3 cameraPosition = camera.position;
 
-		glm::vec3 lightDirection{};
-		auto directionalLightView = renderInfo.scene->GetRegistry().view<DirectionalLight>();
-		if (directionalLightView.empty())
+		const auto& directionalLight = snapshot.GetDirectionalLight();
+		if (!directionalLight)
 		{
 			return;
 		}
 
-		{
-			const entt::entity& entity = directionalLightView.back();
-			DirectionalLight& dl = renderInfo.scene->GetRegistry().get<DirectionalLight>(entity);
-			const Transform& transform = renderInfo.scene->GetRegistry().get<Transform>(entity);
-			lightDirection = transform.GetForward();
-		}
+		const glm::vec3 lightDirection = directionalLight->forward;
 
 		// TODO: Camera can be ortho, so need to make for ortho as well.
 		const glm::mat4 projectionMat4 = glm::perspective(
-			camera.GetFov(),
+			camera.fov,
 			(float)renderInfo.viewportSize.x / (float)renderInfo.viewportSize.y,
-			camera.GetZNear(),
+			camera.zNear,
 			shadowsSettings.maxDistance);
 
 		const bool recreateFrameBuffer = csmRenderer->GenerateLightSpaceMatrices(
-			projectionMat4 * camera.GetViewMat4(),
+			projectionMat4 * camera.viewMat4,
 			lightDirection,
 			shadowMapSize,
-			camera.GetZNear(),
+			camera.zNear,
 			shadowsSettings.maxDistance,
 			shadowsSettings.cascadeCount,
 			shadowsSettings.splitFactor,
@@ -1629,63 +2054,50 @@ void RenderPassManager::CreateCSM()
 		
 		for (const auto& [entity, layers] : visibleEntities)
 		{
-			const Renderer3D& r3d = registry.get<Renderer3D>(entity);
-
-			if (!r3d.castShadows)
-			{
-				continue;
-			}
-
-			if ((r3d.shadowVisibilityMask & camera.GetShadowVisibilityMask()) == 0)
+			const RenderSnapshot::RenderableData* renderable = snapshot.GetRenderable(entity);
+			if (!renderable || !renderable->castShadows)
 			{
 				continue;
 			}
 
-			const Transform& transform = registry.get<Transform>(entity);
-			if (!r3d.isEnabled)
+			if ((renderable->shadowVisibilityMask & camera.shadowVisibilityMask) == 0)
 			{
 				continue;
 			}
 
-			if (!r3d.mesh || !r3d.material || !r3d.material->IsPipelineEnabled(renderPassName))
+			if (!renderable->material->IsPipelineEnabled(renderPassName))
 			{
 				continue;
 			}
 
-			const std::shared_ptr<Pipeline> pipeline = r3d.material->GetBaseMaterial()->GetPipeline(renderPassName);
+			const std::shared_ptr<Pipeline> pipeline = renderable->material->GetBaseMaterial()->GetPipeline(renderPassName);
 			if (!pipeline)
 			{
 				continue;
 			}
 
-			auto lod = GetLod(
-				cameraPosition,
-				transform.GetPosition(),
-				glm::length(transform.GetScale() * glm::max(glm::abs(r3d.mesh->GetBoundingBox().min), glm::abs(r3d.mesh->GetBoundingBox().max))),
-				r3d.mesh->GetLods());
+			auto lod = GetLod(cameraPosition, renderable->position, renderable->radius, renderable->mesh->GetLods());
 
-			if (r3d.mesh->GetType() == Mesh::Type::SKINNED)
+			if (renderable->mesh->GetType() == Mesh::Type::SKINNED)
 			{
-				if (const auto skeletalAnimatorEntity = scene->FindEntityByUUID(r3d.skeletalAnimatorEntityUUID))
+				const SkinningData::Instance* skinnedInstance = GetSkinnedInstance(scene, entity);
+				if (!skinnedInstance)
 				{
-					SkeletalAnimator* skeletalAnimator = registry.try_get<SkeletalAnimator>(skeletalAnimatorEntity->GetHandle());
-					if (skeletalAnimator)
-					{
-						UpdateSkeletalAnimator(skeletalAnimator, r3d.material->GetBaseMaterial(), pipeline);
-					}
+					continue;
 				}
 
 				EntitiesByMesh::Single single{};
 				single.entity = entity;
-				single.mesh = r3d.mesh;
+				single.mesh = renderable->mesh;
+				single.skinnedInstance = skinnedInstance;
 				single.lod = lod;
 
-				renderableEntities[r3d.material->GetBaseMaterial()][r3d.material].single.emplace_back(single);
+				renderableEntities[renderable->material->GetBaseMaterial()][renderable->material].single.emplace_back(single);
 			}
-			else if (r3d.mesh->GetType() == Mesh::Type::STATIC)
+			else if (renderable->mesh->GetType() == Mesh::Type::STATIC)
 			{
-				auto& entities = renderableEntities[r3d.material->GetBaseMaterial()][r3d.material].instanced[r3d.mesh];
-				entities.resize(r3d.mesh->GetLods().size());
+				auto& entities = renderableEntities[renderable->material->GetBaseMaterial()][renderable->material].instanced[renderable->mesh];
+				entities.resize(renderable->mesh->GetLods().size());
 				entities[lod].reserve(50);
 				entities[lod].emplace_back(entity);
 			}
@@ -1761,8 +2173,7 @@ void RenderPassManager::CreateCSM()
 						submitInfo.frameBuffer->Resize(submitInfo.frameBuffer->GetSize());
 					};
 
-					std::shared_ptr<NextFrameEvent> event = std::make_shared<NextFrameEvent>(callback, Event::Type::OnNextFrame, this);
-					EventSystem::GetInstance().SendEvent(event);
+					EventSystem::GetInstance().SendEvent(NextFrameEvent{ std::move(callback), this });
 				}
 			}
 			
@@ -1787,8 +2198,7 @@ void RenderPassManager::CreateCSM()
 						for (const entt::entity& entity : entitiesByLod[lod])
 						{
 							InstanceDataCSM data{};
-							const Transform& transform = registry.get<Transform>(entity);
-							data.transform = transform.GetTransform();
+							data.transform = snapshot.GetRenderable(entity)->transform;
 							data.layers = visibleEntities[entity];
 							instanceDatas.emplace_back(data);
 						}
@@ -1817,40 +2227,26 @@ void RenderPassManager::CreateCSM()
 					const size_t instanceDataOffset = instanceDatas.size();
 
 					InstanceDataCSM data{};
-					const Transform& transform = registry.get<Transform>(single.entity);
-					data.transform = transform.GetTransform();
+					data.transform = snapshot.GetRenderable(single.entity)->transform;
 					data.layers = visibleEntities[single.entity];
 					instanceDatas.emplace_back(data);
 
-					SkeletalAnimator* skeletalAnimator = nullptr;
-					const Renderer3D& r3d = registry.get<Renderer3D>(single.entity);
-					if (const auto skeletalAnimatorEntity = scene->FindEntityByUUID(r3d.skeletalAnimatorEntityUUID))
-					{
-						skeletalAnimator = registry.try_get<SkeletalAnimator>(skeletalAnimatorEntity->GetHandle());
-					}
-
-					if (skeletalAnimator)
-					{
-						std::vector<NativeHandle> newUniformWriterNativeHandles = uniformWriterNativeHandles;
-						newUniformWriterNativeHandles.emplace_back(skeletalAnimator->GetUniformWriter()->GetNativeHandle());
-
-						std::vector<NativeHandle> vertexBuffers;
-						std::vector<size_t> vertexBufferOffsets;
-						GetVertexBuffers(pipeline, single.mesh, vertexBuffers, vertexBufferOffsets);
+					std::vector<NativeHandle> vertexBuffers;
+					std::vector<size_t> vertexBufferOffsets;
+					GetVertexBuffers(pipeline, *single.skinnedInstance, vertexBuffers, vertexBufferOffsets);
 
-						renderInfo.renderer->Render(
-							vertexBuffers,
-							vertexBufferOffsets,
-							single.mesh->GetIndexBuffer()->GetNativeHandle(),
-							single.mesh->GetLods()[single.lod].indexOffset * sizeof(uint32_t),
-							single.mesh->GetLods()[single.lod].indexCount,
-							pipeline,
-							instanceBuffer->GetNativeHandle(),
-							instanceDataOffset * instanceBuffer->GetInstanceSize(),
-							1,
-							newUniformWriterNativeHandles,
-							renderInfo.frame);
-					}
+					renderInfo.renderer->Render(
+						vertexBuffers,
+						vertexBufferOffsets,
+						single.mesh->GetIndexBuffer()->GetNativeHandle(),
+						single.mesh->GetLods()[single.lod].indexOffset * sizeof(uint32_t),
+						single.mesh->GetLods()[single.lod].indexCount,
+						pipeline,
+						instanceBuffer->GetNativeHandle(),
+						instanceDataOffset * instanceBuffer->GetInstanceSize(),
+						1,
+						uniformWriterNativeHandles,
+						renderInfo.frame);
 				}
 			}
 		}
@@ -1911,9 +2307,9 @@ void RenderPassManager::CreatePointLightShadows()
 
 		size_t renderableCount = 0;
 		const std::shared_ptr<Scene> scene = renderInfo.scene;
-		const Camera& camera = renderInfo.camera->GetComponent<Camera>();
-		const glm::vec3 cameraPosition = camera.GetEntity()->GetComponent<Transform>().GetPosition();
-		entt::registry& registry = scene->GetRegistry();
+		const RenderSnapshot& snapshot = *renderInfo.snapshot;
+		const RenderSnapshot::CameraData& camera = *renderInfo.cameraData;
+		const glm::vec3 cameraPosition = camera.position;
 
 		struct FaceInfo
 		{
@@ -1987,32 +2383,26 @@ void RenderPassManager::CreatePointLightShadows()
 		deferredBaseMaterial->WriteToBuffer(lightsBuffer, lightsBufferName, "pointLightShadows.shadowMapAtlasSize", shadowMapAtlasSize.x);
 		deferredBaseMaterial->WriteToBuffer(lightsBuffer, lightsBufferName, "pointLightShadows.faceSize", faceSize);
 
-		const auto view = registry.view<PointLight>();
+		const std::vector<RenderSnapshot::LightData<PointLight>>& pointLights = snapshot.GetPointLights();
 
 		struct LightInfoToSort
 		{
-			entt::entity entity;
+			const RenderSnapshot::LightData<PointLight>* lightData;
 			glm::vec3 position;
 			float radius;
 		};
 
-		const std::array<glm::vec4, 6> cameraFrustumPlanes = Utils::GetFrustumPlanes(renderInfo.projection * camera.GetViewMat4());
+		const std::array<glm::vec4, 6> cameraFrustumPlanes = Utils::GetFrustumPlanes(renderInfo.projection * camera.viewMat4);
 
 		std::vector<LightInfoToSort> lights;
-		lights.reserve(view.size());
+		lights.reserve(pointLights.size());
 
-		for (size_t i = 0; i < view.size(); i++)
+		for (const RenderSnapshot::LightData<PointLight>& pointLight : pointLights)
 		{
-			Transform& transform = registry.get<Transform>(view[i]);
-			if (!transform.GetEntity()->IsEnabled())
-			{
-				continue;
-			}
-
 			LightInfoToSort lightInfoToSort{};
-			lightInfoToSort.entity = view[i];
-			lightInfoToSort.position = transform.GetPosition();
-			lightInfoToSort.radius = registry.get<PointLight>(view[i]).radius;
+			lightInfoToSort.lightData = &pointLight;
+			lightInfoToSort.position = pointLight.position;
+			lightInfoToSort.radius = pointLight.light.radius;
 
 			if (Utils::IsSphereInsideFrustum(cameraFrustumPlanes, lightInfoToSort.position, lightInfoToSort.radius))
 			{
@@ -2021,7 +2411,7 @@ void RenderPassManager::CreatePointLightShadows()
 		}
 
 		std::sort(lights.begin(), lights.end(),
-		[&registry, &cameraPosition](const LightInfoToSort& first, const LightInfoToSort& second)
+		[&cameraPosition](const LightInfoToSort& first, const LightInfoToSort& second)
 		{
 			float firstDistance2 = 0.0f;
 			{
@@ -2048,10 +2438,10 @@ void RenderPassManager::CreatePointLightShadows()
 			LightInfo& lightInfo = lightInfos.emplace_back();
 			lightInfo.lightIndex = lightIndex;
 
-			PointLight& pl = registry.get<PointLight>(light.entity);
+			const PointLight& pl = light.lightData->light;
 
 			const glm::vec3 lightPositionWorldSpace = light.position;
-			const glm::vec3 lightPositionViewSpace = camera.GetViewMat4() * glm::vec4(light.position, 1.0f);
+			const glm::vec3 lightPositionViewSpace = camera.viewMat4 * glm::vec4(light.position, 1.0f);
 			const int castSSS = pl.castSSS;
 			deferredBaseMaterial->WriteToBuffer(lightsBuffer, lightsBufferName, std::format("pointLights[{}].positionWorldSpace", lightIndex), lightPositionWorldSpace);
 			deferredBaseMaterial->WriteToBuffer(lightsBuffer, lightsBufferName, std::format("pointLights[{}].positionViewSpace", lightIndex), lightPositionViewSpace);
@@ -2064,8 +2454,7 @@ void RenderPassManager::CreatePointLightShadows()
 			if (pl.drawBoundingSphere)
 			{
 				constexpr glm::vec3 color = glm::vec3(0.0f, 1.0f, 0.0f);
-				Transform& transform = registry.get<Transform>(light.entity);
-				renderInfo.scene->GetVisualizer().DrawSphere(color, transform.GetTransform(), pl.radius, 10);
+				renderInfo.scene->GetVisualizer().DrawSphere(color, light.lightData->transform, pl.radius, 10);
 			}
 
 			int plShadowMapIndex = -1;
@@ -2080,7 +2469,7 @@ void RenderPassManager::CreatePointLightShadows()
 				const glm::mat4 projectionMat4 = glm::perspective(
 					glm::radians(90.0f),
 					1.0f,
-					camera.GetZNear(),
+					camera.zNear,
 					pl.radius);
 
 				std::vector<SceneBVH::BVHNode> bvhNodes;
@@ -2160,58 +2549,50 @@ void RenderPassManager::CreatePointLightShadows()
 			{
 				for (const entt::entity& entity : faceInfo.entities)
 				{
-					const Renderer3D& r3d = registry.get<Renderer3D>(entity);
-
-					if (!r3d.castShadows)
+					const RenderSnapshot::RenderableData* renderable = snapshot.GetRenderable(entity);
+					if (!renderable || !renderable->castShadows)
 					{
 						continue;
 					}
 
-					if ((r3d.shadowVisibilityMask & camera.GetShadowVisibilityMask()) == 0)
+					if ((renderable->shadowVisibilityMask & camera.shadowVisibilityMask) == 0)
 					{
 						continue;
 					}
 
-					if (!r3d.material || !r3d.material->IsPipelineEnabled(renderPassName))
+					if (!renderable->material->IsPipelineEnabled(renderPassName))
 					{
 						continue;
 					}
 
-					const std::shared_ptr<Pipeline> pipeline = r3d.material->GetBaseMaterial()->GetPipeline(renderPassName);
+					const std::shared_ptr<Pipeline> pipeline = renderable->material->GetBaseMaterial()->GetPipeline(renderPassName);
 					if (!pipeline)
 					{
 						continue;
 					}
 					
-					const Transform& transform = registry.get<Transform>(entity);
-					auto lod = GetLod(
-						cameraPosition,
-						transform.GetPosition(),
-						glm::length(transform.GetScale() * glm::max(glm::abs(r3d.mesh->GetBoundingBox().min), glm::abs(r3d.mesh->GetBoundingBox().max))),
-						r3d.mesh->GetLods());
-
-					if (r3d.mesh->GetType() == Mesh::Type::SKINNED)
+					auto lod = GetLod(cameraPosition, renderable->position, renderable->radius, renderable->mesh->GetLods());
+
+					if (renderable->mesh->GetType() == Mesh::Type::SKINNED)
 					{
-						if (const auto skeletalAnimatorEntity = scene->FindEntityByUUID(r3d.skeletalAnimatorEntityUUID))
+						const SkinningData::Instance* skinnedInstance = GetSkinnedInstance(scene, entity);
+						if (!skinnedInstance)
 						{
-							SkeletalAnimator* skeletalAnimator = registry.try_get<SkeletalAnimator>(skeletalAnimatorEntity->GetHandle());
-							if (skeletalAnimator)
-							{
-								UpdateSkeletalAnimator(skeletalAnimator, r3d.material->GetBaseMaterial(), pipeline);
-							}
+							continue;
 						}
 
 						EntitiesByMesh::Single single{};
 						single.entity = entity;
-						single.mesh = r3d.mesh;
+						single.mesh = renderable->mesh;
+						single.skinnedInstance = skinnedInstance;
 						single.lod = lod;
 
-						faceInfo.renderableEntities[r3d.material->GetBaseMaterial()][r3d.material].single.emplace_back(single);
+						faceInfo.renderableEntities[renderable->material->GetBaseMaterial()][renderable->material].single.emplace_back(single);
 					}
-					else if (r3d.mesh->GetType() == Mesh::Type::STATIC)
+					else if (renderable->mesh->GetType() == Mesh::Type::STATIC)
 					{
-						auto& entities = faceInfo.renderableEntities[r3d.material->GetBaseMaterial()][r3d.material].instanced[r3d.mesh];
-						entities.resize(r3d.mesh->GetLods().size());
+						auto& entities = faceInfo.renderableEntities[renderable->material->GetBaseMaterial()][renderable->material].instanced[renderable->mesh];
+						entities.resize(renderable->mesh->GetLods().size());
 						entities[lod].reserve(50);
 						entities[lod].emplace_back(entity);
 					}
@@ -2347,8 +2728,7 @@ void RenderPassManager::CreatePointLightShadows()
 								for (const entt::entity& entity : entitiesByLod[lod])
 								{
 									InstanceData data{};
-									const Transform& transform = registry.get<Transform>(entity);
-									data.transform = transform.GetTransform();
+									data.transform = snapshot.GetRenderable(entity)->transform;
 									data.lightIndex = lightInfo.lightIndex;
 									data.faceIndex = faceInfo.faceIndex;
 									instanceDatas.emplace_back(data);
@@ -2378,41 +2758,27 @@ void RenderPassManager::CreatePointLightShadows()
 							const size_t instanceDataOffset = instanceDatas.size();
 
 							InstanceData data{};
-							const Transform& transform = registry.get<Transform>(single.entity);
-							data.transform = transform.GetTransform();
+							data.transform = snapshot.GetRenderable(single.entity)->transform;
 							data.lightIndex = lightInfo.lightIndex;
 							data.faceIndex = faceInfo.faceIndex;
 							instanceDatas.emplace_back(data);
 
-							SkeletalAnimator* skeletalAnimator = nullptr;
-							const Renderer3D& r3d = registry.get<Renderer3D>(single.entity);
-							if (const auto skeletalAnimatorEntity = scene->FindEntityByUUID(r3d.skeletalAnimatorEntityUUID))
-							{
-								skeletalAnimator = registry.try_get<SkeletalAnimator>(skeletalAnimatorEntity->GetHandle());
-							}
-
-							if (skeletalAnimator)
-							{
-								std::vector<NativeHandle> newUniformWriterNativeHandles = uniformWriterNativeHandles;
-								newUniformWriterNativeHandles.emplace_back(skeletalAnimator->GetUniformWriter()->GetNativeHandle());
-
-								std::vector<NativeHandle> vertexBuffers;
-								std::vector<size_t> vertexBufferOffsets;
-								GetVertexBuffers(pipeline, single.mesh, vertexBuffers, vertexBufferOffsets);
+							std::vector<NativeHandle> vertexBuffers;
+							std::vector<size_t> vertexBufferOffsets;
+							GetVertexBuffers(pipeline, *single.skinnedInstance, vertexBuffers, vertexBufferOffsets);
 
-								renderInfo.renderer->Render(
-									vertexBuffers,
-									vertexBufferOffsets,
-									single.mesh->GetIndexBuffer()->GetNativeHandle(),
-									single.mesh->GetLods()[single.lod].indexOffset * sizeof(uint32_t),
-									single.mesh->GetLods()[single.lod].indexCount,
-									pipeline,
-									instanceBuffer->GetNativeHandle(),
-									instanceDataOffset * instanceBuffer->GetInstanceSize(),
-									1,
-									newUniformWriterNativeHandles,
-									renderInfo.frame);
-							}
+							renderInfo.renderer->Render(
+								vertexBuffers,
+								vertexBufferOffsets,
+								single.mesh->GetIndexBuffer()->GetNativeHandle(),
+								single.mesh->GetLods()[single.lod].indexOffset * sizeof(uint32_t),
+								single.mesh->GetLods()[single.lod].indexCount,
+								pipeline,
+								instanceBuffer->GetNativeHandle(),
+								instanceDataOffset * instanceBuffer->GetInstanceSize(),
+								1,
+								uniformWriterNativeHandles,
+								renderInfo.frame);
 						}
 					}
 				}
@@ -2479,9 +2845,9 @@ void RenderPassManager::CreateSpotLightShadows()
 
 		size_t renderableCount = 0;
 		const std::shared_ptr<Scene> scene = renderInfo.scene;
-		const Camera& camera = renderInfo.camera->GetComponent<Camera>();
-		const glm::vec3 cameraPosition = camera.GetEntity()->GetComponent<Transform>().GetPosition();
-		entt::registry& registry = scene->GetRegistry();
+		const RenderSnapshot& snapshot = *renderInfo.snapshot;
+		const RenderSnapshot::CameraData& camera = *renderInfo.cameraData;
+		const glm::vec3 cameraPosition = camera.position;
 
 		struct LightInfo
 		{
@@ -2520,32 +2886,26 @@ void RenderPassManager::CreateSpotLightShadows()
 		deferredBaseMaterial->WriteToBuffer(lightsBuffer, lightsBufferName, "spotLightShadows.shadowMapAtlasSize", shadowMapAtlasSize.x);
 		deferredBaseMaterial->WriteToBuffer(lightsBuffer, lightsBufferName, "spotLightShadows.faceSize", faceSize);
 
-		const auto view = registry.view<SpotLight>();
+		const std::vector<RenderSnapshot::LightData<SpotLight>>& spotLights = snapshot.GetSpotLights();
 
 		struct LightInfoToSort
 		{
-			entt::entity entity;
+			const RenderSnapshot::LightData<SpotLight>* lightData;
 			glm::vec3 position;
 			float radius;
 		};
 
-		const std::array<glm::vec4, 6> cameraFrustumPlanes = Utils::GetFrustumPlanes(renderInfo.projection * camera.GetViewMat4());
+		const std::array<glm::vec4, 6> cameraFrustumPlanes = Utils::GetFrustumPlanes(renderInfo.projection * camera.viewMat4);
 
 		std::vector<LightInfoToSort> lights;
-		lights.reserve(view.size());
+		lights.reserve(spotLights.size());
 
-		for (size_t i = 0; i < view.size(); i++)
+		for (const RenderSnapshot::LightData<SpotLight>& spotLight : spotLights)
 		{
-			Transform& transform = registry.get<Transform>(view[i]);
-			if (!transform.GetEntity()->IsEnabled())
-			{
-				continue;
-			}
-
 			LightInfoToSort lightInfoToSort{};
-			lightInfoToSort.entity = view[i];
-			lightInfoToSort.position = transform.GetPosition();
-			lightInfoToSort.radius = registry.get<SpotLight>(view[i]).radius;
+			lightInfoToSort.lightData = &spotLight;
+			lightInfoToSort.position = spotLight.position;
+			lightInfoToSort.radius = spotLight.light.radius;
 
 			if (Utils::IsSphereInsideFrustum(cameraFrustumPlanes, lightInfoToSort.position, lightInfoToSort.radius))
 			{
@@ -2554,7 +2914,7 @@ void RenderPassManager::CreateSpotLightShadows()
 		}
 
 		std::sort(lights.begin(), lights.end(),
-		[&registry, &cameraPosition](const LightInfoToSort& first, const LightInfoToSort& second)
+		[&cameraPosition](const LightInfoToSort& first, const LightInfoToSort& second)
 		{
 			float firstDistance2 = 0.0f;
 			{
@@ -2581,12 +2941,11 @@ void RenderPassManager::CreateSpotLightShadows()
 			LightInfo& lightInfo = lightInfos.emplace_back();
 			lightInfo.lightIndex = lightIndex;
 
-			SpotLight& sl = registry.get<SpotLight>(light.entity);
-			Transform& transform = registry.get<Transform>(light.entity);
+			const SpotLight& sl = light.lightData->light;
 
 			const glm::vec3 lightPositionWorldSpace = light.position;
-			const glm::vec3 lightPositionViewSpace = camera.GetViewMat4() * glm::vec4(light.position, 1.0f);
-			const glm::vec3 directionViewSpace = glm::mat3(camera.GetViewMat4()) * transform.GetForward();
+			const glm::vec3 lightPositionViewSpace = camera.viewMat4 * glm::vec4(light.position, 1.0f);
+			const glm::vec3 directionViewSpace = glm::mat3(camera.viewMat4) * light.lightData->forward;
 			const int castSSS = sl.castSSS;
 			deferredBaseMaterial->WriteToBuffer(lightsBuffer, lightsBufferName, std::format("spotLights[{}].positionWorldSpace", lightIndex), lightPositionWorldSpace);
 			deferredBaseMaterial->WriteToBuffer(lightsBuffer, lightsBufferName, std::format("spotLights[{}].positionViewSpace", lightIndex), lightPositionViewSpace);
@@ -2602,7 +2961,7 @@ void RenderPassManager::CreateSpotLightShadows()
 			if (sl.drawBoundingSphere)
 			{
 				constexpr glm::vec3 color = glm::vec3(0.0f, 1.0f, 0.0f);
-				renderInfo.scene->GetVisualizer().DrawSphere(color, transform.GetTransform(), sl.radius, 10);
+				renderInfo.scene->GetVisualizer().DrawSphere(color, light.lightData->transform, sl.radius, 10);
 			}
 
 			int slShadowMapIndex = -1;
@@ -2617,8 +2976,8 @@ void RenderPassManager::CreateSpotLightShadows()
 				const glm::mat4 viewProjectionMat4 = glm::perspective(
 					sl.outerCutOff * 2.0f,
 					1.0f,
-					camera.GetZNear(),
-					sl.radius) * transform.GetInverseTransformMat4();
+					camera.zNear,
+					sl.radius) * light.lightData->inverseTransform;
 
 				const auto frustumPlanes = Utils::GetFrustumPlanes(viewProjectionMat4);
 
@@ -2686,58 +3045,50 @@ void RenderPassManager::CreateSpotLightShadows()
 		{
 			for (const entt::entity& entity : lightInfo.entities)
 			{
-				const Renderer3D& r3d = registry.get<Renderer3D>(entity);
-
-				if (!r3d.castShadows)
+				const RenderSnapshot::RenderableData* renderable = snapshot.GetRenderable(entity);
+				if (!renderable || !renderable->castShadows)
 				{
 					continue;
 				}
 
-				if ((r3d.shadowVisibilityMask & camera.GetShadowVisibilityMask()) == 0)
+				if ((renderable->shadowVisibilityMask & camera.shadowVisibilityMask) == 0)
 				{
 					continue;
 				}
 
-				if (!r3d.material || !r3d.material->IsPipelineEnabled(renderPassName))
+				if (!renderable->material->IsPipelineEnabled(renderPassName))
 				{
 					continue;
 				}
 
-				const std::shared_ptr<Pipeline> pipeline = r3d.material->GetBaseMaterial()->GetPipeline(renderPassName);
+				const std::shared_ptr<Pipeline> pipeline = renderable->material->GetBaseMaterial()->GetPipeline(renderPassName);
 				if (!pipeline)
 				{
 					continue;
 				}
 
-				const Transform& transform = registry.get<Transform>(entity);
-				auto lod = GetLod(
-					cameraPosition,
-					transform.GetPosition(),
-					glm::length(transform.GetScale() * glm::max(glm::abs(r3d.mesh->GetBoundingBox().min), glm::abs(r3d.mesh->GetBoundingBox().max))),
-					r3d.mesh->GetLods());
+				auto lod = GetLod(cameraPosition, renderable->position, renderable->radius, renderable->mesh->GetLods());
 
-				if (r3d.mesh->GetType() == Mesh::Type::SKINNED)
+				if (renderable->mesh->GetType() == Mesh::Type::SKINNED)
 				{
-					if (const auto skeletalAnimatorEntity = scene->FindEntityByUUID(r3d.skeletalAnimatorEntityUUID))
+					const SkinningData::Instance* skinnedInstance = GetSkinnedInstance(scene, entity);
+					if (!skinnedInstance)
 					{
-						SkeletalAnimator* skeletalAnimator = registry.try_get<SkeletalAnimator>(skeletalAnimatorEntity->GetHandle());
-						if (skeletalAnimator)
-						{
-							UpdateSkeletalAnimator(skeletalAnimator, r3d.material->GetBaseMaterial(), pipeline);
-						}
+						continue;
 					}
 
 					EntitiesByMesh::Single single{};
 					single.entity = entity;
-					single.mesh = r3d.mesh;
+					single.mesh = renderable->mesh;
+					single.skinnedInstance = skinnedInstance;
 					single.lod = lod;
 
-					lightInfo.renderableEntities[r3d.material->GetBaseMaterial()][r3d.material].single.emplace_back(single);
+					lightInfo.renderableEntities[renderable->material->GetBaseMaterial()][renderable->material].single.emplace_back(single);
 				}
-				else if (r3d.mesh->GetType() == Mesh::Type::STATIC)
+				else if (renderable->mesh->GetType() == Mesh::Type::STATIC)
 				{
-					auto& entities = lightInfo.renderableEntities[r3d.material->GetBaseMaterial()][r3d.material].instanced[r3d.mesh];
-					entities.resize(r3d.mesh->GetLods().size());
+					auto& entities = lightInfo.renderableEntities[renderable->material->GetBaseMaterial()][renderable->material].instanced[renderable->mesh];
+					entities.resize(renderable->mesh->GetLods().size());
 					entities[lod].reserve(50);
 					entities[lod].emplace_back(entity);
 				}
@@ -2866,8 +3217,7 @@ void RenderPassManager::CreateSpotLightShadows()
 							for (const entt::entity& entity : entitiesByLod[lod])
 							{
 								InstanceData data{};
-								const Transform& transform = registry.get<Transform>(entity);
-								data.transform = transform.GetTransform();
+								data.transform = snapshot.GetRenderable(entity)->transform;
 								data.lightIndex = lightInfo.lightIndex;
 								instanceDatas.emplace_back(data);
 							}
@@ -2896,40 +3246,26 @@ void RenderPassManager::CreateSpotLightShadows()
 						const size_t instanceDataOffset = instanceDatas.size();
 
 						InstanceData data{};
-						const Transform& transform = registry.get<Transform>(single.entity);
-						data.transform = transform.GetTransform();
+						data.transform = snapshot.GetRenderable(single.entity)->transform;
 						data.lightIndex = lightInfo.lightIndex;
 						instanceDatas.emplace_back(data);
 
-						SkeletalAnimator* skeletalAnimator = nullptr;
-						const Renderer3D& r3d = registry.get<Renderer3D>(single.entity);
-						if (const auto skeletalAnimatorEntity = scene->FindEntityByUUID(r3d.skeletalAnimatorEntityUUID))
-						{
-							skeletalAnimator = registry.try_get<SkeletalAnimator>(skeletalAnimatorEntity->GetHandle());
-						}
-
-						if (skeletalAnimator)
-						{
-							std::vector<NativeHandle> newUniformWriterNativeHandles = uniformWriterNativeHandles;
-							uniformWriterNativeHandles.emplace_back(skeletalAnimator->GetUniformWriter()->GetNativeHandle());
-
-							std::vector<NativeHandle> vertexBuffers;
-							std::vector<size_t> vertexBufferOffsets;
-							GetVertexBuffers(pipeline, single.mesh, vertexBuffers, vertexBufferOffsets);
+						std::vector<NativeHandle> vertexBuffers;
+						std::vector<size_t> vertexBufferOffsets;
+						GetVertexBuffers(pipeline, *single.skinnedInstance, vertexBuffers, vertexBufferOffsets);
 
-							renderInfo.renderer->Render(
-								vertexBuffers,
-								vertexBufferOffsets,
-								single.mesh->GetIndexBuffer()->GetNativeHandle(),
-								single.mesh->GetLods()[single.lod].indexOffset * sizeof(uint32_t),
-								single.mesh->GetLods()[single.lod].indexCount,
-								pipeline,
-								instanceBuffer->GetNativeHandle(),
-								instanceDataOffset * instanceBuffer->GetInstanceSize(),
-								1,
-								newUniformWriterNativeHandles,
-								renderInfo.frame);
-						}
+						renderInfo.renderer->Render(
+							vertexBuffers,
+							vertexBufferOffsets,
+							single.mesh->GetIndexBuffer()->GetNativeHandle(),
+							single.mesh->GetLods()[single.lod].indexOffset * sizeof(uint32_t),
+							single.mesh->GetLods()[single.lod].indexCount,
+							pipeline,
+							instanceBuffer->GetNativeHandle(),
+							instanceDataOffset * instanceBuffer->GetInstanceSize(),
+							1,
+							uniformWriterNativeHandles,
+							renderInfo.frame);
 					}
 				}
 			}
@@ -3831,50 +4167,7 @@ void RenderPassManager::CreateUI()
 		}
 
 		const std::shared_ptr<BaseMaterial> baseMaterial = MaterialManager::GetInstance().LoadBaseMaterial("Materials/RectangleUI.basemat");
-		const auto& view = renderInfo.scene->GetRegistry().view<Canvas>();
-		std::vector<entt::entity> entities;
-		entities.reserve(view.size());
-		for (const auto& entity : view)
-		{
-			entities.emplace_back(entity);
-
-			Canvas& canvas = renderInfo.scene->GetRegistry().get<Canvas>(entity);
-			Renderer3D* r3d = renderInfo.scene->GetRegistry().try_get<Renderer3D>(entity);
-			if (!canvas.drawInMainViewport)
-			{
-				if (canvas.size.x > 0 && canvas.size.y > 0)
-				{
-					if (!canvas.frameBuffer)
-					{
-						canvas.frameBuffer = FrameBuffer::Create(renderInfo.renderPass, nullptr, canvas.size);
-					}
-					else
-					{
-						if (canvas.size != canvas.frameBuffer->GetSize())
-						{
-							canvas.frameBuffer->Resize(canvas.size);
-						}
-					}
-
-					if (r3d)
-					{
-						r3d->isEnabled = true;
-						r3d->material->GetUniformWriter(GBuffer)->WriteTexture("albedoTexture", canvas.frameBuffer->GetAttachment(0));
-					}
-				}
-			}
-			else
-			{
-				if (canvas.frameBuffer)
-				{
-					r3d->isEnabled = false;
-					r3d->material->GetUniformWriter(GBuffer)->WriteTexture("albedoTexture", TextureManager::GetInstance().GetWhite());
-					canvas.frameBuffer = nullptr;
-				}
-			}
-		}
-
-		uiRenderer->Render(entities, baseMaterial, renderInfo);
+		uiRenderer->Render(baseMaterial, renderInfo);
 	};
 
 	CreateRenderPass(createInfo);
@@ -3932,30 +4225,20 @@ void RenderPassManager::CreateDecalPass()
 		const std::string& renderPassName = renderInfo.renderPass->GetName();
 
 		size_t renderableCount = 0;
-		const std::shared_ptr<Scene> scene = renderInfo.scene;
-		entt::registry& registry = scene->GetRegistry();
-		const Camera& camera = renderInfo.camera->GetComponent<Camera>();
-		const glm::mat4 viewProjectionMat4 = renderInfo.projection * camera.GetViewMat4();
-		const auto r3dView = registry.view<Decal>();
+		const RenderSnapshot::CameraData& camera = *renderInfo.cameraData;
+		const glm::mat4 viewProjectionMat4 = renderInfo.projection * camera.viewMat4;
 		const auto unitCubeMesh = MeshManager::GetInstance().LoadMesh("UnitCube");
 
-		std::unordered_map<std::shared_ptr<BaseMaterial>, std::unordered_map<std::shared_ptr<Material>, std::vector<entt::entity>>> renderableEntities;
+		std::unordered_map<std::shared_ptr<BaseMaterial>, std::unordered_map<std::shared_ptr<Material>, std::vector<const RenderSnapshot::DecalData*>>> renderableDecals;
 
-		for (const entt::entity& entity : r3dView)
+		for (const RenderSnapshot::DecalData& decal : renderInfo.snapshot->GetDecals())
 		{
-			const Decal& decal = registry.get<Decal>(entity);
-			if ((decal.objectVisibilityMask & camera.GetObjectVisibilityMask()) == 0)
-			{
-				continue;
-			}
-
-			const Transform& transform = registry.get<Transform>(entity);
-			if (!transform.GetEntity()->IsEnabled())
+			if ((decal.objectVisibilityMask & camera.objectVisibilityMask) == 0)
 			{
 				continue;
 			}
 
-			if (!decal.material || !decal.material->IsPipelineEnabled(Decals))
+			if (!decal.material->IsPipelineEnabled(Decals))
 			{
 				continue;
 			}
@@ -3966,16 +4249,15 @@ void RenderPassManager::CreateDecalPass()
 				continue;
 			}
 
-			const glm::mat4& transformMat4 = transform.GetTransform();
 			const BoundingBox& box = unitCubeMesh->GetBoundingBox();
 
-			bool isInFrustum = FrustumCulling::CullBoundingBox(viewProjectionMat4, transformMat4, box.min, box.max, camera.GetZNear());
+			bool isInFrustum = FrustumCulling::CullBoundingBox(viewProjectionMat4, decal.transform, box.min, box.max, camera.zNear);
 			if (!isInFrustum)
 			{
 				continue;
 			}
 
-			renderableEntities[decal.material->GetBaseMaterial()][decal.material].emplace_back(entity);
+			renderableDecals[decal.material->GetBaseMaterial()][decal.material].emplace_back(&decal);
 
 			renderableCount++;
 		}
@@ -4025,7 +4307,7 @@ void RenderPassManager::CreateDecalPass()
 		submitInfo.frameBuffer = frameBuffer;
 		renderInfo.renderer->BeginRenderPass(submitInfo);
 
-		for (const auto& [baseMaterial, entitiesByMaterial] : renderableEntities)
+		for (const auto& [baseMaterial, decalsByMaterial] : renderableDecals)
 		{
 			const std::shared_ptr<Pipeline> pipeline = baseMaterial->GetPipeline(renderPassName);
 			if (!pipeline)
@@ -4033,7 +4315,7 @@ void RenderPassManager::CreateDecalPass()
 				continue;
 			}
 
-			for (const auto& [material, entities] : entitiesByMaterial)
+			for (const auto& [material, decals] : decalsByMaterial)
 			{
 				std::vector<NativeHandle> uniformWriterNativeHandles;
 				std::vector<std::shared_ptr<UniformWriter>> uniformWriters;
@@ -4045,12 +4327,11 @@ void RenderPassManager::CreateDecalPass()
 
 				const size_t instanceDataOffset = instanceDatas.size();
 
-				for (const entt::entity& entity : entities)
+				for (const RenderSnapshot::DecalData* decal : decals)
 				{
 					DecalInstanceData data{};
-					const Transform& transform = registry.get<Transform>(entity);
-					data.transform = transform.GetTransform();
-					data.inverseTransform = transform.GetInverseTransformMat4();
+					data.transform = decal->transform;
+					data.inverseTransform = decal->inverseTransform;
 					instanceDatas.emplace_back(data);
 				}
 
@@ -4067,7 +4348,7 @@ void RenderPassManager::CreateDecalPass()
 					pipeline,
 					instanceBuffer->GetNativeHandle(),
 					instanceDataOffset * instanceBuffer->GetInstanceSize(),
-					entities.size(),
+					decals.size(),
 					uniformWriterNativeHandles,
 					renderInfo.frame);
 			}
@@ -4415,40 +4696,6 @@ std::shared_ptr<Buffer> RenderPassManager::GetOrCreateRenderBuffer(
 	FATAL_ERROR(bufferName + ":Failed to create buffer, no such binding was found!");
 }
 
-void RenderPassManager::UpdateSkeletalAnimator(
-	SkeletalAnimator* skeletalAnimator,
-	std::shared_ptr<BaseMaterial> baseMaterial,
-	std::shared_ptr<Pipeline> pipeline)
-{
-	PROFILER_SCOPE(__FUNCTION__);
-
-	if (!skeletalAnimator->GetUniformWriter())
-	{
-		const std::shared_ptr<UniformLayout> renderUniformLayout =
-			pipeline->GetUniformLayout(*pipeline->GetDescriptorSetIndexByType(Pipeline::DescriptorSetIndexType::OBJECT, GBuffer));
-		skeletalAnimator->SetUniformWriter(UniformWriter::Create(renderUniformLayout));
-	}
-
-	if (!skeletalAnimator->GetBuffer())
-	{
-		auto binding = skeletalAnimator->GetUniformWriter()->GetUniformLayout()->GetBindingByName("BoneMatrices");
-		if (binding && binding->buffer)
-		{
-			skeletalAnimator->SetBuffer(Buffer::Create(
-				binding->buffer->size,
-				1,
-				Buffer::Usage::UNIFORM_BUFFER,
-				MemoryType::CPU));
-
-			skeletalAnimator->GetUniformWriter()->WriteBuffer(binding->buffer->name, skeletalAnimator->GetBuffer());
-			skeletalAnimator->GetUniformWriter()->Flush();
-		}
-	}
-
-	baseMaterial->WriteToBuffer(skeletalAnimator->GetBuffer(), "BoneMatrices", "boneMatrices", *skeletalAnimator->GetFinalBoneMatrices().data());
-	skeletalAnimator->GetBuffer()->Flush();
-}
-
 size_t RenderPassManager::GetLod(
 	const glm::vec3& cameraPosition,
 	const glm::vec3& meshPosition,
@@ -9,6 +9,7 @@
 #include "../Graphics/RenderPass.h"
 #include "../Graphics/Pipeline.h"
 #include "../Graphics/Mesh.h"
+#include "../Utils/RadixSort.h"
 
 namespace Pengine
 {
@@ -53,13 +54,39 @@ namespace Pengine
 			const std::vector<Pipeline::DescriptorSetIndexType>& descriptorSetIndexTypes,
 			std::shared_ptr<UniformWriter> objectUniformWriter = nullptr);
 
-		static void PrepareUniformsPerViewportBeforeDraw(const RenderPass::RenderCallbackInfo& renderInfo);
+		/**
+		 * Returns false while the pipeline that owns the global buffer is still compiling, the viewport is skipped then.
+		 */
+		static bool PrepareUniformsPerViewportBeforeDraw(const RenderPass::RenderCallbackInfo& renderInfo);
 
 		std::shared_ptr<Texture> ScaleTexture(
 			std::shared_ptr<Texture> sourceTexture,
 			const glm::ivec2& dstSize);
 
 	private:
+		/**
+		 * Skinned vertices written once per frame by the Skinning pass, stored in the scene render view.
+		 */
+		struct SkinningData : public CustomData
+		{
+			struct Instance
+			{
+				std::shared_ptr<class Mesh> mesh;
+				std::shared_ptr<class UniformWriter> uniformWriter;
+				std::shared_ptr<class Buffer> infoBuffer;
+
+				/**
+				 * Parallel to the mesh vertex layouts, the skinned Position and Normal outputs replace the source buffers.
+				 */
+				std::vector<std::shared_ptr<class Buffer>> vertexBuffers;
+
+				uint64_t lastSkinnedFrame = 0;
+			};
+
+			std::unordered_map<entt::entity, Instance> instancesByEntity;
+			uint64_t frame = 0;
+		};
+
 		struct EntitiesByMesh
 		{
 			std::unordered_map<std::shared_ptr<class Mesh>, std::vector<std::vector<entt::entity>>> instanced;
@@ -67,6 +94,7 @@ namespace Pengine
 			struct Single
 			{
 				std::shared_ptr<class Mesh> mesh;
+				const SkinningData::Instance* skinnedInstance;
 				entt::entity entity;
 				uint32_t lod;
 			};
@@ -88,6 +116,30 @@ namespace Pengine
 			glm::mat3 inverseTransform;
 		};
 
+		struct TransparentRenderData
+		{
+			const RenderSnapshot::RenderableData* renderable = nullptr;
+			const SkinningData::Instance* skinnedInstance = nullptr;
+
+			/**
+			 * Equal for renderables with the same mesh and material, skinned renderables always have their own.
+			 */
+			uint32_t batch = 0;
+		};
+
+		/**
+		 * Transparent renderables gathered once per frame by the TransparentOIT pass and reused by the Transparent pass,
+		 * stored in the viewport render view with the sort buffers to not allocate every frame.
+		 */
+		struct TransparentData : public CustomData
+		{
+			std::vector<TransparentRenderData> sortedRenderDatas;
+			std::vector<TransparentRenderData> orderIndependentRenderDatas;
+
+			std::vector<Utils::SortEntry> sortEntries;
+			std::vector<Utils::SortEntry> scratch;
+		};
+
 		RenderPassManager() = default;
 		~RenderPassManager() = default;
 
@@ -97,6 +149,44 @@ namespace Pengine
 			std::vector<NativeHandle>& vertexBuffers,
 			std::vector<size_t>& vertexBufferOffsets);
 
+		static void GetVertexBuffers(
+			std::shared_ptr<class Pipeline> pipeline,
+			const SkinningData::Instance& skinnedInstance,
+			std::vector<NativeHandle>& vertexBuffers,
+			std::vector<size_t>& vertexBufferOffsets);
+
+		static void GetVertexBuffers(
+			std::shared_ptr<class Pipeline> pipeline,
+			const std::vector<VertexLayout>& vertexLayouts,
+			const std::vector<NativeHandle>& handles,
+			std::vector<NativeHandle>& vertexBuffers,
+			std::vector<size_t>& vertexBufferOffsets);
+
+		/**
+		 * Returns the vertices skinned this frame for the entity, nullptr if it has no animator to be skinned with.
+		 */
+		static const SkinningData::Instance* GetSkinnedInstance(
+			const std::shared_ptr<class Scene>& scene,
+			const entt::entity entity);
+
+		/**
+		 * Visible renderables with transparency enabled, split by the Order Independent Transparency material option.
+		 */
+		static void GetTransparentRenderDatas(
+			const RenderPass::RenderCallbackInfo& renderInfo,
+			TransparentData& transparentData);
+
+		/**
+		 * Draws in the order of the sort entries, consecutive entries of the same batch are drawn as one instanced draw.
+		 */
+		static void RenderTransparent(
+			const RenderPass::RenderCallbackInfo& renderInfo,
+			const std::vector<TransparentRenderData>& renderDatas,
+			const std::vector<Utils::SortEntry>& sortEntries,
+			const std::string& instanceBufferName);
+
+		void CreateSkinning();
+
 		void CreateZPrePass();
 
 		void CreateGBuffer();
@@ -107,6 +197,8 @@ namespace Pengine
 
 		void CreateAtmosphere();
 
+		void CreateTransparentOIT();
+
 		void CreateTransparent();
 
 		void CreateCSM();
@@ -164,11 +256,6 @@ namespace Pengine
 			const std::string& bufferName,
 			const std::string& setBufferName = {});
 
-		static void UpdateSkeletalAnimator(
-			class SkeletalAnimator* skeletalAnimator,
-			std::shared_ptr<class BaseMaterial> baseMaterial,
-			std::shared_ptr<class Pipeline> pipeline);
-
 		static size_t GetLod(
 			const glm::vec3& cameraPosition,
 			const glm::vec3& meshPosition,
@@ -8,6 +8,7 @@ namespace Pengine
 
 	const std::vector<std::string> passPerSceneOrder =
 	{
+		Skinning,
 		Atmosphere
 	};
 
@@ -25,6 +26,7 @@ namespace Pengine
 		SSS,
 		SSSBlur,
 		Deferred,
+		TransparentOIT,
 		Transparent,
 		SSR,
 		SSRBlur,
@@ -0,0 +1,281 @@
+#include "RenderSnapshot.h"
+
+#include "Profiler.h"
+#include "Scene.h"
+
+#include "../Components/Camera.h"
+#include "../Components/Canvas.h"
+#include "../Components/Decal.h"
+#include "../Components/Renderer3D.h"
+#include "../Components/SkeletalAnimator.h"
+#include "../Components/Transform.h"
+#include "../Graphics/Mesh.h"
+
+using namespace Pengine;
+
+void RenderSnapshot::Extract(Scene& scene)
+{
+	PROFILER_SCOPE(__FUNCTION__);
+
+	Clear();
+
+	entt::registry& registry = scene.GetRegistry();
+
+	const auto r3dView = registry.view<Renderer3D>();
+	m_Renderables.reserve(r3dView.size());
+
+	std::unordered_map<entt::entity, int> animatorIndices;
+
+	for (const entt::entity entity : r3dView)
+	{
+		const Renderer3D& r3d = r3dView.get<Renderer3D>(entity);
+		if (!r3d.isEnabled || !r3d.mesh || !r3d.material)
+		{
+			continue;
+		}
+
+		const Transform& transform = registry.get<Transform>(entity);
+		if (!transform.GetEntity()->IsEnabled())
+		{
+			continue;
+		}
+
+		RenderableData& renderable = m_Renderables.emplace_back();
+		renderable.mesh = r3d.mesh;
+		renderable.material = r3d.material;
+		renderable.transform = transform.GetTransform();
+		renderable.rotationMat4 = transform.GetRotationMat4();
+		renderable.inverseTransform = transform.GetInverseTransform();
+		renderable.position = transform.GetPosition();
+		renderable.scale = transform.GetScale();
+		renderable.radius = glm::length(renderable.scale * glm::max(glm::abs(r3d.mesh->GetBoundingBox().min), glm::abs(r3d.mesh->GetBoundingBox().max)));
+		renderable.entity = entity;
+		renderable.renderingOrder = r3d.renderingOrder;
+		renderable.animatorIndex = -1;
+		renderable.objectVisibilityMask = r3d.objectVisibilityMask;
+		renderable.shadowVisibilityMask = r3d.shadowVisibilityMask;
+		renderable.castShadows = r3d.castShadows;
+
+		if (r3d.mesh->GetType() == Mesh::Type::SKINNED)
+		{
+			const entt::entity animatorEntity = r3d.GetSkeletalAnimatorEntity(scene);
+			const SkeletalAnimator* skeletalAnimator = animatorEntity != entt::null ? registry.try_get<SkeletalAnimator>(animatorEntity) : nullptr;
+			if (skeletalAnimator)
+			{
+				// Meshes driven by the same animator share its palette, every palette is copied once.
+				const auto [animatorIndex, isNew] = animatorIndices.emplace(animatorEntity, static_cast<int>(m_Animators.size()));
+				if (isNew)
+				{
+					const std::vector<glm::mat4>& finalBoneMatrices = skeletalAnimator->GetFinalBoneMatrices();
+					m_Animators.emplace_back(animatorEntity, static_cast<uint32_t>(m_BonePalettes.size()), static_cast<uint32_t>(finalBoneMatrices.size()), 0.0f);
+					m_BonePalettes.insert(m_BonePalettes.end(), finalBoneMatrices.begin(), finalBoneMatrices.end());
+				}
+
+				renderable.animatorIndex = animatorIndex->second;
+			}
+		}
+
+		const size_t entityIndex = entt::to_entity(entity);
+		if (entityIndex >= m_RenderableIndices.size())
+		{
+			m_RenderableIndices.resize(entityIndex + 1, -1);
+		}
+
+		m_RenderableIndices[entityIndex] = static_cast<uint32_t>(m_Renderables.size() - 1);
+	}
+
+	for (const entt::entity entity : registry.view<Camera>())
+	{
+		const Camera& camera = registry.get<Camera>(entity);
+		const Transform& transform = registry.get<Transform>(entity);
+
+		CameraData& cameraData = m_Cameras.emplace_back();
+		cameraData.viewMat4 = camera.GetViewMat4();
+		cameraData.rotationMat4 = transform.GetRotationMat4();
+		cameraData.position = transform.GetPosition();
+		cameraData.fov = camera.GetFov();
+		cameraData.zNear = camera.GetZNear();
+		cameraData.zFar = camera.GetZFar();
+		cameraData.entity = entity;
+		cameraData.objectVisibilityMask = camera.GetObjectVisibilityMask();
+		cameraData.shadowVisibilityMask = camera.GetShadowVisibilityMask();
+	}
+
+	auto makeLightData = [&registry]<typename Light>(const entt::entity entity, const Light& light)
+	{
+		const Transform& transform = registry.get<Transform>(entity);
+
+		LightData<Light> lightData{};
+		lightData.light = light;
+		lightData.transform = transform.GetTransform();
+		lightData.inverseTransform = transform.GetInverseTransformMat4();
+		lightData.position = transform.GetPosition();
+		lightData.forward = transform.GetForward();
+		return lightData;
+	};
+
+	// Only one directional light is used, the last one like before the snapshot.
+	const auto directionalLightView = registry.view<DirectionalLight>();
+	if (!directionalLightView.empty())
+	{
+		const entt::entity entity = directionalLightView.back();
+		m_DirectionalLight = makeLightData(entity, registry.get<DirectionalLight>(entity));
+	}
+
+	for (const entt::entity entity : registry.view<PointLight>())
+	{
+		if (registry.get<Transform>(entity).GetEntity()->IsEnabled())
+		{
+			m_PointLights.emplace_back(makeLightData(entity, registry.get<PointLight>(entity)));
+		}
+	}
+
+	for (const entt::entity entity : registry.view<SpotLight>())
+	{
+		if (registry.get<Transform>(entity).GetEntity()->IsEnabled())
+		{
+			m_SpotLights.emplace_back(makeLightData(entity, registry.get<SpotLight>(entity)));
+		}
+	}
+
+	for (const entt::entity entity : registry.view<Decal>())
+	{
+		const Decal& decal = registry.get<Decal>(entity);
+		const Transform& transform = registry.get<Transform>(entity);
+		if (!decal.material || !transform.GetEntity()->IsEnabled())
+		{
+			continue;
+		}
+
+		DecalData& decalData = m_Decals.emplace_back();
+		decalData.material = decal.material;
+		decalData.transform = transform.GetTransform();
+		decalData.inverseTransform = transform.GetInverseTransformMat4();
+		decalData.objectVisibilityMask = decal.objectVisibilityMask;
+	}
+
+	// The commands live in the Clay arena of the canvas scripts, the next layout overwrites them.
+	const auto canvasView = registry.view<Canvas>();
+	size_t textLength = 0;
+	for (const entt::entity entity : canvasView)
+	{
+		for (const Clay_RenderCommandArray& renderCommands : canvasView.get<Canvas>(entity).commands)
+		{
+			for (int i = 0; i < renderCommands.length; i++)
+			{
+				if (renderCommands.internalArray[i].commandType == CLAY_RENDER_COMMAND_TYPE_TEXT)
+				{
+					textLength += renderCommands.internalArray[i].renderData.text.stringContents.length;
+				}
+			}
+		}
+	}
+
+	// Reserved up front, the copied slices point into the string.
+	m_CanvasText.reserve(textLength);
+
+	for (const entt::entity entity : canvasView)
+	{
+		const Canvas& canvas = canvasView.get<Canvas>(entity);
+		const Renderer3D* r3d = registry.try_get<Renderer3D>(entity);
+
+		CanvasData& canvasData = m_Canvases.emplace_back();
+		canvasData.material = r3d ? r3d->material : nullptr;
+		canvasData.size = canvas.size;
+		canvasData.entity = entity;
+		canvasData.commandOffset = static_cast<uint32_t>(m_CanvasCommands.size());
+		canvasData.drawInMainViewport = canvas.drawInMainViewport;
+
+		for (const Clay_RenderCommandArray& renderCommands : canvas.commands)
+		{
+			for (int i = 0; i < renderCommands.length; i++)
+			{
+				Clay_RenderCommand& renderCommand = m_CanvasCommands.emplace_back(renderCommands.internalArray[i]);
+				if (renderCommand.commandType == CLAY_RENDER_COMMAND_TYPE_TEXT)
+				{
+					Clay_StringSlice& text = renderCommand.renderData.text.stringContents;
+					const size_t textOffset = m_CanvasText.size();
+					m_CanvasText.append(text.chars, text.length);
+					text.chars = m_CanvasText.data() + textOffset;
+					text.baseChars = text.chars;
+				}
+			}
+		}
+
+		canvasData.commandCount = static_cast<uint32_t>(m_CanvasCommands.size()) - canvasData.commandOffset;
+	}
+}
+
+void RenderSnapshot::WriteBackScreenSizes(Scene& scene) const
+{
+	entt::registry& registry = scene.GetRegistry();
+	for (const AnimatorData& animator : m_Animators)
+	{
+		if (animator.screenSize <= 0.0f)
+		{
+			continue;
+		}
+
+		// The versioned handle is no longer valid if the animator entity was deleted since the snapshot was taken.
+		if (SkeletalAnimator* skeletalAnimator = registry.valid(animator.entity) ? registry.try_get<SkeletalAnimator>(animator.entity) : nullptr)
+		{
+			skeletalAnimator->SetScreenSize(glm::max(skeletalAnimator->GetScreenSize(), animator.screenSize));
+		}
+	}
+}
+
+void RenderSnapshot::Clear()
+{
+	for (const RenderableData& renderable : m_Renderables)
+	{
+		m_RenderableIndices[entt::to_entity(renderable.entity)] = -1;
+	}
+
+	m_Renderables.clear();
+	m_Animators.clear();
+	m_BonePalettes.clear();
+	m_Cameras.clear();
+	m_DirectionalLight.reset();
+	m_PointLights.clear();
+	m_SpotLights.clear();
+	m_Decals.clear();
+	m_Canvases.clear();
+	m_CanvasCommands.clear();
+	m_CanvasText.clear();
+}
+
+const RenderSnapshot::RenderableData* RenderSnapshot::GetRenderable(const entt::entity entity) const
+{
+	const size_t entityIndex = entt::to_entity(entity);
+	if (entityIndex >= m_RenderableIndices.size() || m_RenderableIndices[entityIndex] == -1)
+	{
+		return nullptr;
+	}
+
+	const RenderableData& renderable = m_Renderables[m_RenderableIndices[entityIndex]];
+	return renderable.entity == entity ? &renderable : nullptr;
+}
+
+const RenderSnapshot::CameraData* RenderSnapshot::GetCamera(const entt::entity entity) const
+{
+	for (const CameraData& camera : m_Cameras)
+	{
+		if (camera.entity == entity)
+		{
+			return &camera;
+		}
+	}
+
+	return nullptr;
+}
+
+Clay_RenderCommandArray RenderSnapshot::GetCanvasCommands(const CanvasData& canvas) const
+{
+	Clay_RenderCommandArray renderCommands{};
+	renderCommands.capacity = static_cast<int32_t>(canvas.commandCount);
+	renderCommands.length = static_cast<int32_t>(canvas.commandCount);
+
+	// Clay arrays aren't const, the renderer only reads them.
+	renderCommands.internalArray = const_cast<Clay_RenderCommand*>(m_CanvasCommands.data()) + canvas.commandOffset;
+	return renderCommands;
+}
@@ -0,0 +1,172 @@
+#pragma once
+
+#include "Core.h"
+
+#include "../Components/DirectionalLight.h"
+#include "../Components/PointLight.h"
+#include "../Components/SpotLight.h"
+
+#include <clay/clay.h>
+
+namespace Pengine
+{
+
+	class Scene;
+	class Mesh;
+	class Material;
+
+	/**
+	 * Everything the passes read from a scene, copied from the registry at the end of Scene::Update().
+	 * The renderer only reads the published snapshot, so the registry can change while a frame is recorded.
+	 */
+	class PENGINE_API RenderSnapshot
+	{
+	public:
+		struct RenderableData
+		{
+			std::shared_ptr<Mesh> mesh;
+			std::shared_ptr<Material> material;
+			glm::mat4 transform;
+			glm::mat4 rotationMat4;
+			glm::mat3 inverseTransform;
+			glm::vec3 position;
+			glm::vec3 scale;
+
+			/**
+			 * World space radius of the mesh bounding box, picks the lod.
+			 */
+			float radius;
+
+			entt::entity entity;
+			int renderingOrder;
+
+			/**
+			 * Index into GetAnimators(), -1 for static meshes and skinned meshes without an animator.
+			 */
+			int animatorIndex;
+
+			uint8_t objectVisibilityMask;
+			uint8_t shadowVisibilityMask;
+			bool castShadows;
+		};
+
+		struct AnimatorData
+		{
+			entt::entity entity;
+			uint32_t boneOffset;
+			uint32_t boneCount;
+
+			/**
+			 * Written by the passes, handed back to the animator when the snapshot stops being rendered.
+			 */
+			mutable float screenSize;
+		};
+
+		struct CameraData
+		{
+			glm::mat4 viewMat4;
+			glm::mat4 rotationMat4;
+			glm::vec3 position;
+			float fov;
+			float zNear;
+			float zFar;
+			entt::entity entity;
+			uint8_t objectVisibilityMask;
+			uint8_t shadowVisibilityMask;
+		};
+
+		template<typename Light>
+		struct LightData
+		{
+			Light light;
+			glm::mat4 transform;
+			glm::mat4 inverseTransform;
+			glm::vec3 position;
+			glm::vec3 forward;
+		};
+
+		struct DecalData
+		{
+			std::shared_ptr<Material> material;
+			glm::mat4 transform;
+			glm::mat4 inverseTransform;
+			uint8_t objectVisibilityMask;
+		};
+
+		struct CanvasData
+		{
+			/**
+			 * Material of the Renderer3D the canvas is drawn onto, nullptr if the canvas has none.
+			 */
+			std::shared_ptr<Material> material;
+			glm::ivec2 size;
+			entt::entity entity;
+			uint32_t commandOffset;
+			uint32_t commandCount;
+			bool drawInMainViewport;
+		};
+
+		/**
+		 * Replaces the content with the current state of the scene, the vectors keep their capacity.
+		 */
+		void Extract(Scene& scene);
+
+		/**
+		 * Gives the screen sizes the passes measured to the animators, they pick the animation lod with them.
+		 */
+		void WriteBackScreenSizes(Scene& scene) const;
+
+		void Clear();
+
+		/**
+		 * Returns nullptr if the entity wasn't renderable when the snapshot was taken.
+		 */
+		[[nodiscard]] const RenderableData* GetRenderable(const entt::entity entity) const;
+
+		[[nodiscard]] const std::vector<RenderableData>& GetRenderables() const { return m_Renderables; }
+
+		[[nodiscard]] const std::vector<AnimatorData>& GetAnimators() const { return m_Animators; }
+
+		/**
+		 * The palettes of all animators one after another, AnimatorData::boneOffset points into it.
+		 */
+		[[nodiscard]] const std::vector<glm::mat4>& GetBonePalettes() const { return m_BonePalettes; }
+
+		[[nodiscard]] const CameraData* GetCamera(const entt::entity entity) const;
+
+		[[nodiscard]] const std::optional<LightData<DirectionalLight>>& GetDirectionalLight() const { return m_DirectionalLight; }
+
+		[[nodiscard]] const std::vector<LightData<PointLight>>& GetPointLights() const { return m_PointLights; }
+
+		[[nodiscard]] const std::vector<LightData<SpotLight>>& GetSpotLights() const { return m_SpotLights; }
+
+		[[nodiscard]] const std::vector<DecalData>& GetDecals() const { return m_Decals; }
+
+		[[nodiscard]] const std::vector<CanvasData>& GetCanvases() const { return m_Canvases; }
+
+		/**
+		 * The copied render commands of the canvas, text points into the snapshot instead of the Clay arena.
+		 */
+		[[nodiscard]] Clay_RenderCommandArray GetCanvasCommands(const CanvasData& canvas) const;
+
+	private:
+		std::vector<RenderableData> m_Renderables;
+
+		/**
+		 * Indexed by entt::to_entity(), the versioned entity in RenderableData rejects stale handles.
+		 */
+		std::vector<uint32_t> m_RenderableIndices;
+
+		std::vector<AnimatorData> m_Animators;
+		std::vector<glm::mat4> m_BonePalettes;
+		std::vector<CameraData> m_Cameras;
+		std::optional<LightData<DirectionalLight>> m_DirectionalLight;
+		std::vector<LightData<PointLight>> m_PointLights;
+		std::vector<LightData<SpotLight>> m_SpotLights;
+		std::vector<DecalData> m_Decals;
+		std::vector<CanvasData> m_Canvases;
+		std::vector<Clay_RenderCommand> m_CanvasCommands;
+		std::string m_CanvasText;
+	};
+
+}
@@ -3,6 +3,7 @@
 #include "Logger.h"
 #include "Viewport.h"
 #include "FileFormatNames.h"
+#include "Profiler.h"
 #include "ThreadPool.h"
 
 #include "../Components/Transform.h"
@@ -40,6 +41,9 @@ void Scene::Copy(const Scene& scene)
 
 void Scene::FlushDeletionQueue()
 {
+	// Collected once, the systems return their callbacks by value.
+	const auto removeCallbacks = GetRemoveCallbacks();
+
 	while (!m_EntityDeletionQueue.empty())
 	{
 		const auto entity = m_EntityDeletionQueue.front();
@@ -55,31 +59,94 @@ void Scene::FlushDeletionQueue()
 
 		if (entity->GetHandle() != entt::tombstone)
 		{
-			for (const auto& [componentSystemName, componentSystem] : m_ComponentSystemsByName)
+			for (const auto& callback : removeCallbacks)
 			{
-				const auto removeCallbacks = std::move(componentSystem->GetRemoveCallbacks());
-				for (const auto& [componentName, callback] : removeCallbacks)
-				{
-					if (callback)
-					{
-						callback(entity);
-					}
-				}
+				callback(entity);
 			}
 
+			m_Registry.destroy(entity->GetHandle());
+		}
+	}
+
+	if (m_HasDeletedEntities)
+	{
+		size_t count = 0;
+		for (size_t i = 0; i < m_Entities.size(); i++)
+		{
+			if (m_Entities[i]->IsDeleted())
 			{
-				const auto removeCallbacks = std::move(m_PhysicsSystem->GetRemoveCallbacks());
-				for (const auto& [componentName, callback] : removeCallbacks)
-				{
-					if (callback)
-					{
-						callback(entity);
-					}
-				}
+				m_Entities[i]->m_SceneIndex = -1;
+				continue;
 			}
 
-			m_Registry.destroy(entity->GetHandle());
+			if (i != count)
+			{
+				m_Entities[count] = std::move(m_Entities[i]);
+			}
+
+			m_Entities[count]->m_SceneIndex = count;
+			count++;
 		}
+
+		m_Entities.resize(count);
+		m_HasDeletedEntities = false;
+	}
+}
+
+std::vector<std::function<void(std::shared_ptr<Entity>)>> Scene::GetRemoveCallbacks() const
+{
+	std::vector<std::function<void(std::shared_ptr<Entity>)>> callbacks;
+	auto addCallbacks = [&callbacks](const std::map<std::string, std::function<void(std::shared_ptr<Entity>)>>& removeCallbacks)
+	{
+		for (const auto& [componentName, callback] : removeCallbacks)
+		{
+			if (callback)
+			{
+				callbacks.emplace_back(callback);
+			}
+		}
+	};
+
+	for (const auto& [componentSystemName, componentSystem] : m_ComponentSystemsByName)
+	{
+		addCallbacks(componentSystem->GetRemoveCallbacks());
+	}
+
+	addCallbacks(m_PhysicsSystem->GetRemoveCallbacks());
+
+	return callbacks;
+}
+
+void Scene::AddToNameIndex(Entity& entity)
+{
+	std::vector<Entity*>& entities = m_EntitiesByName[entity.GetName()];
+	entity.m_NameIndex = entities.size();
+	entities.emplace_back(&entity);
+}
+
+void Scene::RemoveFromNameIndex(Entity& entity, const std::string& name)
+{
+	const auto entitiesByName = m_EntitiesByName.find(name);
+	if (entitiesByName == m_EntitiesByName.end())
+	{
+		return;
+	}
+
+	std::vector<Entity*>& entities = entitiesByName->second;
+	const size_t index = entity.m_NameIndex;
+	if (index >= entities.size() || entities[index] != &entity)
+	{
+		return;
+	}
+
+	entities[index] = entities.back();
+	entities[index]->m_NameIndex = index;
+	entities.pop_back();
+	entity.m_NameIndex = -1;
+
+	if (entities.empty())
+	{
+		m_EntitiesByName.erase(entitiesByName);
 	}
 }
 
@@ -119,40 +186,64 @@ void Scene::ReplaceEntityUUID(UUID oldUUID, UUID newUUID)
 	m_EntitiesByUUID.erase(oldUUID);
 }
 
-void Scene::Clear()
+void Scene::ReplaceEntityName(Entity& entity, const std::string& oldName)
 {
-	m_Name = none;
-	m_Filepath = none;
+	if (!m_IsNameIndexEnabled || entity.IsDeleted()
+		|| entity.m_SceneIndex >= m_Entities.size() || m_Entities[entity.m_SceneIndex].get() != &entity)
+	{
+		return;
+	}
 
-	for (const auto& entity : m_Entities)
+	RemoveFromNameIndex(entity, oldName);
+	AddToNameIndex(entity);
+}
+
+void Scene::SetNameIndexEnabled(const bool enabled)
+{
+	if (m_IsNameIndexEnabled == enabled)
 	{
-		for (const auto& [componentSystemName, componentSystem] : m_ComponentSystemsByName)
+		return;
+	}
+
+	m_IsNameIndexEnabled = enabled;
+	m_EntitiesByName.clear();
+
+	if (m_IsNameIndexEnabled)
+	{
+		for (const std::shared_ptr<Entity>& entity : m_Entities)
 		{
-			const auto removeCallbacks = std::move(componentSystem->GetRemoveCallbacks());
-			for (const auto& [componentName, callback] : removeCallbacks)
+			if (!entity->IsDeleted())
 			{
-				if (callback)
-				{
-					callback(entity);
-				}
+				AddToNameIndex(*entity);
 			}
-
 		}
+	}
+}
+
+void Scene::Clear()
+{
+	m_Name = none;
+	m_Filepath = none;
 
+	const auto removeCallbacks = GetRemoveCallbacks();
+	for (const auto& entity : m_Entities)
+	{
+		for (const auto& callback : removeCallbacks)
 		{
-			const auto removeCallbacks = std::move(m_PhysicsSystem->GetRemoveCallbacks());
-			for (const auto& [componentName, callback] : removeCallbacks)
-			{
-				if (callback)
-				{
-					callback(entity);
-				}
-			}
+			callback(entity);
 		}
 	}
 
+	// The snapshots hold the meshes and materials too, they are released before the components.
+	for (RenderSnapshot& renderSnapshot : m_RenderSnapshots)
+	{
+		renderSnapshot.Clear();
+	}
+
 	m_Entities.clear();
+	m_HasDeletedEntities = false;
 	m_EntitiesByUUID.clear();
+	m_EntitiesByName.clear();
 	m_Registry.clear();
 	m_SelectedEntities.clear();
 
@@ -290,30 +381,68 @@ void Scene::Update(const float deltaTime)
 {
 	UpdateSystems(deltaTime);
 
+	FlushDeletionQueue();
+
 	{
+		// The building BVH can still be rebuilt from the previous update.
 		std::unique_lock<std::mutex> lock(m_LockBVH);
 		m_BVHConditionalVariable.wait(lock, [this]
 		{
 			return !m_IsBuildingBVH;
 		});
 
-		std::swap(m_CurrentBVH, m_BuildingBVH);
+		m_IsBuildingBVH = true;
 	}
 
-	FlushDeletionQueue();
-
 	std::unique_ptr<std::vector<SceneBVH::BVHNode>> nodes = std::make_unique<std::vector<SceneBVH::BVHNode>>();
 	*nodes = std::move(SceneBVH::BuildNodes(GetRegistry()));
 
-	// TODO: Potential big problem, during rebuilding BVH entities can be added to the scene from other thread!
+	// Only the building BVH is written, the renderer keeps reading the current one until PublishRenderSnapshot().
 	ThreadPool::GetInstance().EnqueueAsync([this, nodes = std::move(nodes)]()
 	{
-		std::lock_guard<std::mutex> lock(m_LockBVH);
-		m_IsBuildingBVH = true;
 		m_BuildingBVH->Update(std::move(*nodes));
+
+		std::lock_guard<std::mutex> lock(m_LockBVH);
 		m_IsBuildingBVH = false;
+		m_IsBVHBuilt = true;
 		m_BVHConditionalVariable.notify_all();
 	});
+
+	ExtractRenderSnapshot();
+}
+
+void Scene::ExtractRenderSnapshot()
+{
+	m_RenderSnapshots[m_RenderSnapshotIndex ^ 1].Extract(*this);
+	m_IsRenderSnapshotExtracted = true;
+}
+
+void Scene::PublishRenderSnapshot()
+{
+	PROFILER_SCOPE(__FUNCTION__);
+
+	{
+		std::unique_lock<std::mutex> lock(m_LockBVH);
+		m_BVHConditionalVariable.wait(lock, [this]
+		{
+			return !m_IsBuildingBVH;
+		});
+
+		if (m_IsBVHBuilt)
+		{
+			std::swap(m_CurrentBVH, m_BuildingBVH);
+			m_IsBVHBuilt = false;
+		}
+	}
+
+	if (m_IsRenderSnapshotExtracted)
+	{
+		// Nothing records with the published snapshot anymore, the animators get the screen sizes measured with it.
+		m_RenderSnapshots[m_RenderSnapshotIndex].WriteBackScreenSizes(*this);
+
+		m_RenderSnapshotIndex ^= 1;
+		m_IsRenderSnapshotExtracted = false;
+	}
 }
 
 void Scene::UpdateSystems(const float deltaTime)
@@ -379,6 +508,21 @@ void Scene::UpdateSystems(const float deltaTime)
 				GetVisualizer().DrawCylinder(bottomCenter, topCenter, { 0.0f, 1.0f, 0.0f }, transformMat4, rigidBody.shape.cylinder.radius, 12);
 				break;
 			}
+			case RigidBody::Type::Mesh:
+			case RigidBody::Type::ConvexHull:
+			{
+				if (rigidBody.mesh)
+				{
+					const BoundingBox& boundingBox = rigidBody.mesh->GetBoundingBox();
+					GetVisualizer().DrawBox(boundingBox.min, boundingBox.max, { 0.0f, 1.0f, 0.0f }, transformMat4 * transform.GetScaleMat4());
+				}
+				break;
+			}
+			case RigidBody::Type::Compound:
+			{
+				// Drawn by the parts.
+				break;
+			}
 			}
 		}
 	}
@@ -387,73 +531,150 @@ void Scene::UpdateSystems(const float deltaTime)
 std::shared_ptr<Entity> Scene::CreateEntity(const std::string& name, const UUID& uuid)
 {
 	std::shared_ptr<Entity> entity = std::make_shared<Entity>(shared_from_this(), name, uuid);
+	entity->m_SceneIndex = m_Entities.size();
 	m_Entities.emplace_back(entity);
 	m_EntitiesByUUID[entity->GetUUID()] = entity;
 
+	if (m_IsNameIndexEnabled)
+	{
+		AddToNameIndex(*entity);
+	}
+
 	return entity;
 }
 
 std::shared_ptr<Entity> Scene::CloneEntity(std::shared_ptr<Entity> entity)
 {
-	std::function<std::shared_ptr<Entity>(std::shared_ptr<Entity>)> cloneEntity = [this, &cloneEntity](std::shared_ptr<Entity> entity)
+	return Instantiate(entity, 1).front();
+}
+
+std::vector<std::shared_ptr<Entity>> Scene::Instantiate(
+	const std::shared_ptr<Entity>& prefab,
+	const size_t count,
+	const std::vector<glm::mat4>& transforms)
+{
+	PROFILER_SCOPE(__FUNCTION__);
+
+	// The prefab hierarchy in depth first order, parents go before their children.
+	std::vector<std::shared_ptr<Entity>> sources;
+	std::vector<size_t> sourceParents;
+	std::function<void(const std::shared_ptr<Entity>&, size_t)> addSource = [&](const std::shared_ptr<Entity>& entity, const size_t parent)
 	{
-		std::shared_ptr<Entity> newEntity = CreateEntity(entity->GetName());
+		const size_t index = sources.size();
+		sources.emplace_back(entity);
+		sourceParents.emplace_back(parent);
 
-		if (entity->IsPrefab())
+		for (const std::weak_ptr<Entity>& weakChild : entity->GetChilds())
 		{
-			newEntity->SetPrefabFilepathUUID(entity->GetPrefabFilepathUUID());
+			if (const std::shared_ptr<Entity> child = weakChild.lock())
+			{
+				addSource(child, index);
+			}
 		}
+	};
+	addSource(prefab, -1);
+
+	const size_t sourceCount = sources.size();
+	const size_t entityCount = sourceCount * count;
+
+	m_Entities.reserve(m_Entities.size() + entityCount);
+	m_EntitiesByUUID.reserve(m_EntitiesByUUID.size() + entityCount);
 
-		for (auto [id, storage] : m_Registry.storage())
+	// Copies of the same source are next to each other.
+	std::vector<std::shared_ptr<Entity>> entities(entityCount);
+	for (size_t source = 0; source < sourceCount; source++)
+	{
+		for (size_t copy = 0; copy < count; copy++)
 		{
-			if (storage.contains(entity->GetHandle()))
+			std::shared_ptr<Entity> entity = CreateEntity(sources[source]->GetName());
+			if (sources[source]->IsPrefab())
 			{
-				storage.push(newEntity->GetHandle(), storage.value(entity->GetHandle()));
+				entity->SetPrefabFilepathUUID(sources[source]->GetPrefabFilepathUUID());
 			}
-		}
 
-		// Transform and Camera requires to explicitly set the entity or set it as a constructor argument.
-		if (newEntity->HasComponent<Transform>())
-		{
-			newEntity->GetComponent<Transform>().SetEntity(newEntity);
+			entities[source * count + copy] = std::move(entity);
 		}
+	}
 
-		if (newEntity->HasComponent<Camera>())
+	for (auto [id, storage] : m_Registry.storage())
+	{
+		for (size_t source = 0; source < sourceCount; source++)
 		{
-			newEntity->GetComponent<Camera>().SetEntity(newEntity);
-		}
+			const entt::entity sourceHandle = sources[source]->GetHandle();
+			if (!storage.contains(sourceHandle))
+			{
+				continue;
+			}
 
-		for (const std::weak_ptr<Entity> weakChild : entity->GetChilds())
-		{
-			if (const std::shared_ptr<Entity> child = weakChild.lock())
+			// Pages of the storage don't move when it grows, the value stays valid.
+			const void* value = storage.value(sourceHandle);
+			storage.reserve(storage.size() + count);
+			for (size_t copy = 0; copy < count; copy++)
 			{
-				newEntity->AddChild(cloneEntity(child), false);
+				storage.push(entities[source * count + copy]->GetHandle(), value);
 			}
 		}
+	}
 
-		return newEntity;
-	};
+	for (size_t source = 0; source < sourceCount; source++)
+	{
+		const bool hasTransform = sources[source]->HasComponent<Transform>();
+		const bool hasCamera = sources[source]->HasComponent<Camera>();
+		for (size_t copy = 0; copy < count; copy++)
+		{
+			const std::shared_ptr<Entity>& entity = entities[source * count + copy];
 
-	std::shared_ptr<Entity> newEntity = cloneEntity(entity);
+			// Transform and Camera requires to explicitly set the entity or set it as a constructor argument.
+			if (hasTransform)
+			{
+				entity->GetComponent<Transform>().SetEntity(entity);
+			}
 
-	// At the moment of move constructor transform is created,
-	// but at that moment entity of this transform is invalid,
-	// so passing global transform to its child entities will not happen,
-	// so here by copy we update the global transform of the whole hierarchy of entities.
-	{
-		Transform& transform = newEntity->GetComponent<Transform>();
-		bool copyable = transform.IsCopyable();
-		transform.SetCopyable(true);
-		transform = entity->GetComponent<Transform>();
-		transform.SetCopyable(copyable);
+			if (hasCamera)
+			{
+				entity->GetComponent<Camera>().SetEntity(entity);
+			}
+
+			if (sourceParents[source] != -1)
+			{
+				entities[sourceParents[source] * count + copy]->AddChild(entity, false);
+			}
+		}
 	}
 
-	if (entity->HasParent())
+	std::vector<std::shared_ptr<Entity>> roots(entities.begin(), entities.begin() + count);
+	const std::shared_ptr<Entity> parent = prefab->GetParent();
+	for (size_t copy = 0; copy < count; copy++)
 	{
-		entity->GetParent()->AddChild(newEntity, false);
+		const std::shared_ptr<Entity>& root = roots[copy];
+		if (parent)
+		{
+			parent->AddChild(root, false);
+		}
+
+		// At the moment of copy the transform is created, but at that moment entity of this transform is invalid,
+		// so passing global transform to its child entities will not happen,
+		// so here we set the transform again to update the global transform of the whole hierarchy of entities.
+		if (!root->HasComponent<Transform>())
+		{
+			continue;
+		}
+
+		Transform& transform = root->GetComponent<Transform>();
+		if (copy < transforms.size())
+		{
+			transform.SetTransform(transforms[copy]);
+		}
+		else
+		{
+			const bool copyable = transform.IsCopyable();
+			transform.SetCopyable(true);
+			transform = prefab->GetComponent<Transform>();
+			transform.SetCopyable(copyable);
+		}
 	}
 
-	return newEntity;
+	return roots;
 }
 
 void Scene::DeleteEntity(std::shared_ptr<Entity>& entity)
@@ -467,11 +688,18 @@ void Scene::DeleteEntity(std::shared_ptr<Entity>& entity)
 		parent->RemoveChild(entity);
 	}
 
-	if (const auto entityToErase = std::find(m_Entities.begin(), m_Entities.end(), entity);
-		entityToErase != m_Entities.end())
+	const size_t index = entity->m_SceneIndex;
+	if (index < m_Entities.size() && m_Entities[index] == entity)
 	{
 		m_EntitiesByUUID.erase(entity->GetUUID());
-		m_Entities.erase(entityToErase);
+
+		if (m_IsNameIndexEnabled)
+		{
+			RemoveFromNameIndex(*entity, entity->GetName());
+		}
+
+		// Erased from m_Entities by FlushDeletionQueue(), a swap with the last entity would reorder the hierarchy.
+		m_HasDeletedEntities = true;
 	}
 
 	entity = nullptr;
@@ -490,9 +718,20 @@ std::shared_ptr<Entity> Scene::FindEntityByUUID(const UUID& uuid)
 
 std::shared_ptr<Entity> Scene::FindEntityByName(const std::string& name)
 {
+	if (m_IsNameIndexEnabled)
+	{
+		const auto entities = m_EntitiesByName.find(name);
+		if (entities != m_EntitiesByName.end())
+		{
+			return entities->second.front()->shared_from_this();
+		}
+
+		return nullptr;
+	}
+
 	for (std::shared_ptr<Entity> entity : m_Entities)
 	{
-		if (entity->GetName() == name)
+		if (!entity->IsDeleted() && entity->GetName() == name)
 		{
 			return entity;
 		}
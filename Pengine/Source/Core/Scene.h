@@ -5,6 +5,7 @@
 #include "Entity.h"
 #include "Visualizer.h"
 #include "GraphicsSettings.h"
+#include "RenderSnapshot.h"
 #include "SceneBVH.h"
 
 #include "../Graphics/RenderView.h"
@@ -30,6 +31,9 @@ namespace Pengine
 		~Scene();
 		Scene& operator=(const Scene& scene);
 
+		/**
+		 * Updates the systems and the physics, then builds the BVH and extracts the render snapshot for PublishRenderSnapshot().
+		 */
 		void Update(const float deltaTime);
 
 		void UpdateSystems(const float deltaTime);
@@ -38,12 +42,32 @@ namespace Pengine
 
 		std::shared_ptr<Entity> CloneEntity(std::shared_ptr<Entity> entity);
 
+		/**
+		 * Creates count copies of the prefab hierarchy, the components are copied storage by storage in one pass.
+		 * The copies get the parent of the prefab and the transforms if given, otherwise the transform of the prefab.
+		 * Returns the roots of the copies.
+		 */
+		std::vector<std::shared_ptr<Entity>> Instantiate(
+			const std::shared_ptr<Entity>& prefab,
+			const size_t count,
+			const std::vector<glm::mat4>& transforms = {});
+
 		// Delete the entity in the next frame, the entity will be marked deleted,
 		// which can be checked by calling entity->IsEnabled() or entity->IsDeleted() or entity->IsValid().
+		// The entity stays in GetEntities() until FlushDeletionQueue(), which erases the deleted entities
+		// in one pass and keeps the order of the rest.
 		void DeleteEntity(std::shared_ptr<Entity>& entity);
 
+		/**
+		 * Destroys the entities deleted since the last call, called by Update().
+		 */
+		void FlushDeletionQueue();
+
 		std::shared_ptr<Entity> FindEntityByUUID(const UUID& uuid);
 
+		/**
+		 * Uses the name index if it is enabled, otherwise looks through all entities.
+		 */
 		std::shared_ptr<Entity> FindEntityByName(const std::string& name);
 
 		const std::vector<std::shared_ptr<Entity>>& GetEntities() const { return m_Entities; }
@@ -53,6 +77,18 @@ namespace Pengine
 		 */
 		void ReplaceEntityUUID(UUID oldUUID, UUID newUUID);
 
+		/**
+		 * Entity can change name, so we need to replace the name in the name index as well.
+		 */
+		void ReplaceEntityName(Entity& entity, const std::string& oldName);
+
+		/**
+		 * The name index makes FindEntityByName() constant time, it is off by default to not pay for it on every create and delete.
+		 */
+		void SetNameIndexEnabled(const bool enabled);
+
+		bool IsNameIndexEnabled() const { return m_IsNameIndexEnabled; }
+
 		void Clear();
 
 		void SetTag(const std::string& tag) { m_Tag = tag; }
@@ -77,6 +113,19 @@ namespace Pengine
 
 		std::shared_ptr<SceneBVH> GetBVH() const { return m_CurrentBVH; }
 
+		/**
+		 * Copies what the renderer needs from the registry into the snapshot that isn't published, called by Update().
+		 */
+		void ExtractRenderSnapshot();
+
+		/**
+		 * Makes the last extracted snapshot and the BVH built with it the ones the renderer reads.
+		 * Must not be called while a frame of the scene is recorded or the scene is updated.
+		 */
+		void PublishRenderSnapshot();
+
+		const RenderSnapshot& GetRenderSnapshot() const { return m_RenderSnapshots[m_RenderSnapshotIndex]; }
+
 		void SetRenderView(std::shared_ptr<RenderView> renderView) { m_RenderView = renderView; }
 
 		void SetComponentSystem(const std::string& name, std::function<std::shared_ptr<ComponentSystem>()> componentSystem) { m_ComponentSystemsByName[name] = componentSystem(); }
@@ -126,6 +175,9 @@ namespace Pengine
 		std::unordered_map<UUID, std::shared_ptr<Entity>, uuid_hash> m_EntitiesByUUID;
 
 		std::vector<std::shared_ptr<Entity>> m_Entities;
+		std::unordered_map<std::string, std::vector<Entity*>> m_EntitiesByName;
+		bool m_IsNameIndexEnabled = false;
+		bool m_HasDeletedEntities = false;
 		std::queue<std::shared_ptr<Entity>> m_EntityDeletionQueue;
 		entt::registry m_Registry;
 		Visualizer m_Visualizer;
@@ -144,13 +196,22 @@ namespace Pengine
 		std::shared_ptr<SceneBVH> m_BuildingBVH;
 		std::shared_ptr<SceneBVH> m_CurrentBVH;
 		bool m_IsBuildingBVH = false;
+		bool m_IsBVHBuilt = false;
 		bool m_IsSystemUpdating = true;
 		std::mutex m_LockBVH;
 		std::condition_variable m_BVHConditionalVariable;
 
+		std::array<RenderSnapshot, 2> m_RenderSnapshots;
+		size_t m_RenderSnapshotIndex = 0;
+		bool m_IsRenderSnapshotExtracted = false;
+
 		void Copy(const Scene& scene);
 
-		void FlushDeletionQueue();
+		void AddToNameIndex(Entity& entity);
+
+		void RemoveFromNameIndex(Entity& entity, const std::string& name);
+
+		std::vector<std::function<void(std::shared_ptr<Entity>)>> GetRemoveCallbacks() const;
 	};
 
 }
@@ -67,6 +67,9 @@ std::vector<SceneBVH::BVHNode> SceneBVH::BuildNodes(const entt::registry& regist
 		node.aabb = std::move(aabb);
 		node.entity = transform.GetEntity();
 		node.subtreeSize = 1;
+		node.mesh = r3d.mesh;
+		node.inverseTransform = transform.GetInverseTransformMat4();
+		node.raycastMask = r3d.raycastMask;
 		nodes.emplace_back(std::move(node));
 	}
 
@@ -375,6 +378,7 @@ uint32_t SceneBVH::BuildRecursive(int start, int end, std::atomic<int>& parallel
 	const BVHNode& right = m_Nodes[node.right];
 	node.aabb = left.aabb.Expanded(right.aabb);
 	node.subtreeSize = left.subtreeSize + right.subtreeSize;
+	node.raycastMask = left.raycastMask | right.raycastMask;
 
 	std::lock_guard<std::mutex> lock(m_LockWrite);
 	m_Nodes.emplace_back(std::move(node));
@@ -9,6 +9,7 @@ namespace Pengine
 {
 	class Scene;
 	class Entity;
+	class Mesh;
 
 	class PENGINE_API SceneBVH
 	{
@@ -22,6 +23,14 @@ namespace Pengine
 			std::shared_ptr<Entity> entity;
 			int subtreeSize = 0;
 
+			/**
+			 * Leaf data captured when the nodes are built so ray casts don't touch the registry,
+			 * inner nodes combine the masks of their children.
+			 */
+			std::shared_ptr<Mesh> mesh;
+			glm::mat4 inverseTransform{};
+			uint8_t raycastMask = 0;
+
 			[[nodiscard]] bool IsLeaf() const { return left == -1 && right == -1; }
 		};
 
@@ -45,6 +54,101 @@ namespace Pengine
 			const glm::vec3& direction,
 			const float length) const;
 
+		/**
+		 * Visits the leaves hit by the ray front to back, the nearer child is always visited first
+		 * and nodes entered farther than maxDistance are skipped. The callback is called as
+		 * bool(const BVHNode& leaf, float& maxDistance), it can shorten maxDistance and returns false to stop.
+		 */
+		template<typename Callback>
+		void Raycast(
+			const glm::vec3& start,
+			const glm::vec3& direction,
+			const float length,
+			const uint8_t raycastMask,
+			Callback&& callback) const
+		{
+			struct StackEntry
+			{
+				uint32_t node;
+				float distance;
+			};
+
+			// Reused between calls, ray casts don't allocate once the stack has grown to the tree depth.
+			thread_local std::vector<StackEntry> stack;
+
+			if (m_Root == -1) return;
+
+			m_BVHUseCount.fetch_add(1);
+
+			const glm::vec3 inverseDirection = 1.0f / direction;
+			float maxDistance = length;
+
+			float rootDistance;
+			if ((m_Nodes[m_Root].raycastMask & raycastMask) &&
+				Pengine::Raycast::IntersectRayAABB(start, inverseDirection, m_Nodes[m_Root].aabb.min, m_Nodes[m_Root].aabb.max, maxDistance, rootDistance))
+			{
+				stack.push_back({ m_Root, rootDistance });
+			}
+
+			while (!stack.empty())
+			{
+				const StackEntry entry = stack.back();
+				stack.pop_back();
+
+				if (entry.distance > maxDistance)
+				{
+					continue;
+				}
+
+				const BVHNode& node = m_Nodes[entry.node];
+				if (node.IsLeaf())
+				{
+					if (node.entity->IsValid() && !callback(node, maxDistance))
+					{
+						break;
+					}
+
+					continue;
+				}
+
+				float leftDistance, rightDistance;
+				const BVHNode& left = m_Nodes[node.left];
+				const BVHNode& right = m_Nodes[node.right];
+				const bool hitLeft = (left.raycastMask & raycastMask) &&
+					Pengine::Raycast::IntersectRayAABB(start, inverseDirection, left.aabb.min, left.aabb.max, maxDistance, leftDistance);
+				const bool hitRight = (right.raycastMask & raycastMask) &&
+					Pengine::Raycast::IntersectRayAABB(start, inverseDirection, right.aabb.min, right.aabb.max, maxDistance, rightDistance);
+
+				// The nearer child goes on top of the stack.
+				if (hitLeft && hitRight)
+				{
+					if (leftDistance < rightDistance)
+					{
+						stack.push_back({ node.right, rightDistance });
+						stack.push_back({ node.left, leftDistance });
+					}
+					else
+					{
+						stack.push_back({ node.left, leftDistance });
+						stack.push_back({ node.right, rightDistance });
+					}
+				}
+				else if (hitLeft)
+				{
+					stack.push_back({ node.left, leftDistance });
+				}
+				else if (hitRight)
+				{
+					stack.push_back({ node.right, rightDistance });
+				}
+			}
+
+			stack.clear();
+
+			m_BVHUseCount.fetch_sub(1);
+			m_BVHConditionalVariable.notify_all();
+		}
+
 		[[nodiscard]] std::optional<BVHNode> GetRoot() const { return m_Root == -1 ? std::nullopt : std::optional<BVHNode>(m_Nodes[m_Root]); }
 
 	private:
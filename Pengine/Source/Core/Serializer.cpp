@@ -506,6 +506,42 @@ EngineConfig Serializer::DeserializeEngineConfig(const std::filesystem::path& fi
 		engineConfig.graphicsAPI = GraphicsAPI::Vk;
 	}
 
+	if (YAML::Node threadBudgetData = data["ThreadBudget"])
+	{
+		engineConfig.threadBudget = threadBudgetData.as<uint32_t>();
+	}
+
+	if (YAML::Node assetLoaderThreadCountData = data["AssetLoaderThreadCount"])
+	{
+		engineConfig.assetLoaderThreadCount = assetLoaderThreadCountData.as<uint32_t>();
+	}
+
+	if (YAML::Node asyncSceneUpdateData = data["AsyncSceneUpdate"])
+	{
+		engineConfig.asyncSceneUpdate = asyncSceneUpdateData.as<bool>();
+	}
+
+	if (YAML::Node meshCpuResidencyData = data["MeshCpuResidency"])
+	{
+		const std::string meshCpuResidency = meshCpuResidencyData.as<std::string>();
+		if (meshCpuResidency == "ALL")
+		{
+			engineConfig.meshCpuResidency = Mesh::CpuResidency::ALL;
+		}
+		else if (meshCpuResidency == "COLLISION")
+		{
+			engineConfig.meshCpuResidency = Mesh::CpuResidency::COLLISION;
+		}
+		else if (meshCpuResidency == "NONE")
+		{
+			engineConfig.meshCpuResidency = Mesh::CpuResidency::NONE;
+		}
+		else
+		{
+			Logger::Warning("Engine config: unknown MeshCpuResidency " + meshCpuResidency + ", expected ALL, COLLISION or NONE!");
+		}
+	}
+
 	Logger::Log("Engine config has been loaded!", BOLDGREEN);
 	Logger::Log("Graphics API:" + std::to_string(static_cast<int>(engineConfig.graphicsAPI)));
 
@@ -1294,8 +1330,13 @@ void Serializer::SerializeMaterial(const std::shared_ptr<Material>& material, bo
 
 	out << YAML::BeginSeq;
 
-	for (const auto& [passName, pipeline] : material->GetBaseMaterial()->GetPipelinesByPass())
+	for (const auto& [passName, pipeline] : material->GetBaseMaterial()->WaitForPipelines())
 	{
+		if (!pipeline)
+		{
+			continue;
+		}
+
 		out << YAML::BeginMap;
 
 		out << YAML::Key << "RenderPass" << YAML::Value << passName;
@@ -1442,6 +1483,36 @@ void Serializer::SerializeMesh(const std::filesystem::path& directory,  const st
 {
 	PROFILER_SCOPE(__FUNCTION__);
 
+	// Held while writing, the mesh may release its CPU data meanwhile.
+	const std::shared_ptr<MeshBVH> bvh = mesh->GetBVH();
+	const MeshBVH::Data* bvhData = &bvh->GetData();
+
+	const std::shared_ptr<const Mesh::CpuData> cpuData = mesh->GetCpuData();
+	const void* vertices = cpuData->vertices;
+	const std::vector<uint32_t>* indices = &cpuData->indices;
+
+	// Every attribute is written, a mesh that released them after the upload is read back from its file
+	// instead, the residency of the mesh itself stays as it is.
+	Mesh::CreateInfo fileCreateInfo{};
+	if (!cpuData->vertices || cpuData->vertexStride != mesh->GetVertexSize())
+	{
+		fileCreateInfo = DeserializeMesh(mesh->GetFilepath());
+		if (!fileCreateInfo.vertices || fileCreateInfo.vertexCount != mesh->GetVertexCount()
+			|| fileCreateInfo.vertexSize != mesh->GetVertexSize() || fileCreateInfo.indices.size() != mesh->GetIndexCount())
+		{
+			delete[] static_cast<uint8_t*>(fileCreateInfo.vertices);
+			Logger::Error(mesh->GetFilepath().string() + ":Failed to serialize mesh, there is no CPU data to write!");
+			return;
+		}
+
+		vertices = fileCreateInfo.vertices;
+		indices = &fileCreateInfo.indices;
+		if (bvhData->nodes.empty() && fileCreateInfo.bvh)
+		{
+			bvhData = &*fileCreateInfo.bvh;
+		}
+	}
+
 	const std::string meshName = mesh->GetName();
 
 	size_t vertexLayoutsSize = 0;
@@ -1466,9 +1537,12 @@ void Serializer::SerializeMesh(const std::filesystem::path& directory,  const st
 		mesh->GetCreateInfo().sourceFileInfo.filepath.string().size() +
 		sizeof(BoundingBox) +
 		sizeof(Mesh::Lod) * mesh->GetLods().size() +
-		11 * 4;
+		bvhData->nodes.size() * sizeof(MeshBVH::BVHNode) +
+		bvhData->triangleIndices.size() * sizeof(uint32_t) +
+		14 * 4;
 	// Type, Primitive Index, Source Mesh Size, Source Filepath Size, Vertex Count,
-	// Vertex Size, Index Count, Mesh Size, Filepath Size, Vertex Layout Count, Lod Count.
+	// Vertex Size, Index Count, Mesh Size, Filepath Size, Vertex Layout Count, Lod Count,
+	// BVH Version, BVH Node Count, BVH Triangle Index Count.
 
 	uint32_t offset = 0;
 
@@ -1545,7 +1619,6 @@ void Serializer::SerializeMesh(const std::filesystem::path& directory,  const st
 		Utils::GetValue<uint32_t>(data, offset) = mesh->GetVertexSize();
 		offset += sizeof(uint32_t);
 
-		const void* vertices = mesh->GetRawVertices();
 		memcpy(&Utils::GetValue<uint8_t>(data, offset), vertices, mesh->GetVertexCount() * mesh->GetVertexSize());
 		offset += mesh->GetVertexCount() * mesh->GetVertexSize();
 	}
@@ -1580,17 +1653,35 @@ void Serializer::SerializeMesh(const std::filesystem::path& directory,  const st
 		offset += sizeof(uint32_t);
 
 		// Potential optimization of using 2 bit instead of 4 bit.
-		std::vector<uint32_t> indices = mesh->GetRawIndices();
-		memcpy(&Utils::GetValue<uint8_t>(data, offset), indices.data(), mesh->GetIndexCount() * sizeof(uint32_t));
+		memcpy(&Utils::GetValue<uint8_t>(data, offset), indices->data(), mesh->GetIndexCount() * sizeof(uint32_t));
 		offset += mesh->GetIndexCount() * sizeof(uint32_t);
 	}
 
+	// BVH, optional, older files end after the indices.
+	{
+		Utils::GetValue<uint32_t>(data, offset) = MeshBVH::version;
+		offset += sizeof(uint32_t);
+
+		Utils::GetValue<uint32_t>(data, offset) = bvhData->nodes.size();
+		offset += sizeof(uint32_t);
+
+		memcpy(&Utils::GetValue<uint8_t>(data, offset), bvhData->nodes.data(), bvhData->nodes.size() * sizeof(MeshBVH::BVHNode));
+		offset += bvhData->nodes.size() * sizeof(MeshBVH::BVHNode);
+
+		Utils::GetValue<uint32_t>(data, offset) = bvhData->triangleIndices.size();
+		offset += sizeof(uint32_t);
+
+		memcpy(&Utils::GetValue<uint8_t>(data, offset), bvhData->triangleIndices.data(), bvhData->triangleIndices.size() * sizeof(uint32_t));
+		offset += bvhData->triangleIndices.size() * sizeof(uint32_t);
+	}
+
 	std::filesystem::path outMeshFilepath = directory / (meshName + FileFormats::Mesh());
 	std::ofstream out(outMeshFilepath, std::ostream::binary);
 
 	out.write((char*)data, static_cast<std::streamsize>(dataSize));
 
 	delete[] data;
+	delete[] static_cast<uint8_t*>(fileCreateInfo.vertices);
 
 	out.close();
 
@@ -1754,6 +1845,57 @@ Mesh::CreateInfo Serializer::DeserializeMesh(const std::filesystem::path& filepa
 		offset += indicesSize * sizeof(uint32_t);
 	}
 
+	std::optional<MeshBVH::Data> bvh;
+	// BVH, the counts come from the file, a block that doesn't fit is dropped and the hierarchy is rebuilt.
+	if (offset + sizeof(uint32_t) <= size && Utils::GetValue<uint32_t>(data, offset) == MeshBVH::version)
+	{
+		offset += sizeof(uint32_t);
+
+		auto readCount = [&](uint32_t& count, const size_t elementSize)
+		{
+			if (offset + sizeof(uint32_t) > size)
+			{
+				return false;
+			}
+
+			count = Utils::GetValue<uint32_t>(data, offset);
+			offset += sizeof(uint32_t);
+
+			return count <= static_cast<size_t>(size - offset) / elementSize;
+		};
+
+		bvh.emplace();
+
+		uint32_t nodeCount = 0;
+		uint32_t triangleIndexCount = 0;
+		if (readCount(nodeCount, sizeof(MeshBVH::BVHNode)))
+		{
+			bvh->nodes.resize(nodeCount);
+			memcpy(bvh->nodes.data(), &Utils::GetValue<uint8_t>(data, offset), nodeCount * sizeof(MeshBVH::BVHNode));
+			offset += nodeCount * sizeof(MeshBVH::BVHNode);
+
+			if (readCount(triangleIndexCount, sizeof(uint32_t)))
+			{
+				bvh->triangleIndices.resize(triangleIndexCount);
+				memcpy(bvh->triangleIndices.data(), &Utils::GetValue<uint8_t>(data, offset), triangleIndexCount * sizeof(uint32_t));
+				offset += triangleIndexCount * sizeof(uint32_t);
+			}
+			else
+			{
+				bvh.reset();
+			}
+		}
+		else
+		{
+			bvh.reset();
+		}
+
+		if (!bvh)
+		{
+			Logger::Warning(filepath.string() + ": BVH data is corrupted, the BVH will be rebuilt!");
+		}
+	}
+
 	delete[] data;
 
 	Logger::Log("Mesh:" + filepath.string() + " has been loaded!", BOLDGREEN);
@@ -1770,6 +1912,7 @@ Mesh::CreateInfo Serializer::DeserializeMesh(const std::filesystem::path& filepa
 	createInfo.vertexLayouts = vertexLayouts;
 	createInfo.boundingBox = boundingBox;
 	createInfo.lods = lods;
+	createInfo.bvh = std::move(bvh);
 
 	return createInfo;
 }
@@ -1890,7 +2033,7 @@ std::shared_ptr<Skeleton> Serializer::DeserializeSkeleton(const std::filesystem:
 
 	Logger::Log("Skeleton:" + filepath.string() + " has been loaded!", BOLDGREEN);
 
-	return MeshManager::GetInstance().CreateSkeleton(createInfo);
+	return std::make_shared<Skeleton>(createInfo);
 }
 
 void Serializer::SerializeSkeletalAnimation(const std::shared_ptr<SkeletalAnimation>& skeletalAnimation)
@@ -1910,8 +2053,10 @@ void Serializer::SerializeSkeletalAnimation(const std::shared_ptr<SkeletalAnimat
 
 	out << YAML::BeginSeq;
 
-	for (const auto& [name, bone] : skeletalAnimation->GetBonesByName())
+	for (const auto& [name, channel] : skeletalAnimation->GetChannelsByName())
 	{
+		const SkeletalAnimation::Bone bone = channel.Decompress();
+
 		out << YAML::BeginMap;
 
 		out << YAML::Key << "Name" << YAML::Value << name;
@@ -2084,7 +2229,7 @@ std::shared_ptr<SkeletalAnimation> Serializer::DeserializeSkeletalAnimation(cons
 
 	Logger::Log("Skeletal Animation:" + filepath.string() + " has been loaded!", BOLDGREEN);
 
-	return MeshManager::GetInstance().CreateSkeletalAnimation(createInfo);
+	return std::make_shared<SkeletalAnimation>(createInfo);
 }
 
 void Serializer::SerializeShaderCache(const std::filesystem::path& filepath, const std::string& code)
@@ -2162,6 +2307,71 @@ std::string Serializer::DeserializeShaderCache(const std::filesystem::path& file
 	return {};
 }
 
+void Serializer::SerializePhysicsShapeCache(const std::filesystem::path& meshFilepath, const size_t settingsHash, const std::string& data)
+{
+	// Meshes created at runtime have no uuid and are cooked every time.
+	const UUID uuid = Utils::FindUuid(meshFilepath);
+	if (!uuid.IsValid() || !std::filesystem::exists(meshFilepath))
+	{
+		return;
+	}
+
+	const std::filesystem::path directory = std::filesystem::path("Physics") / "Cache";
+
+	if (!std::filesystem::exists(directory))
+	{
+		std::filesystem::create_directories(directory);
+	}
+
+	std::filesystem::path cacheFilepath = directory / (uuid.ToString() + "_" + std::to_string(settingsHash));
+	cacheFilepath.concat(FileFormats::PhysicsShape());
+	std::ofstream out(cacheFilepath, std::ostream::binary);
+
+	const size_t lastWriteTime = std::filesystem::last_write_time(meshFilepath).time_since_epoch().count();
+
+	out.write((char*)&lastWriteTime, sizeof(size_t));
+	out.write(data.data(), data.size());
+	out.close();
+}
+
+std::string Serializer::DeserializePhysicsShapeCache(const std::filesystem::path& meshFilepath, const size_t settingsHash)
+{
+	const UUID uuid = Utils::FindUuid(meshFilepath);
+	if (!uuid.IsValid() || !std::filesystem::exists(meshFilepath))
+	{
+		return {};
+	}
+
+	const std::filesystem::path directory = std::filesystem::path("Physics") / "Cache";
+	std::filesystem::path cacheFilepath = directory / (uuid.ToString() + "_" + std::to_string(settingsHash));
+	cacheFilepath.concat(FileFormats::PhysicsShape());
+	if (!std::filesystem::exists(cacheFilepath))
+	{
+		return {};
+	}
+
+	std::ifstream in(cacheFilepath, std::ifstream::binary);
+
+	in.seekg(0, std::ifstream::end);
+	const std::streamoff size = static_cast<std::streamoff>(in.tellg()) - static_cast<std::streamoff>(sizeof(size_t));
+	in.seekg(0, std::ifstream::beg);
+
+	size_t lastWriteTime = 0;
+	in.read((char*)&lastWriteTime, sizeof(size_t));
+
+	if (size <= 0 || lastWriteTime != std::filesystem::last_write_time(meshFilepath).time_since_epoch().count())
+	{
+		return {};
+	}
+
+	std::string data;
+	data.resize(size);
+	in.read(data.data(), size);
+	in.close();
+
+	return data;
+}
+
 void Serializer::SerializeShaderModuleReflection(
 	const std::filesystem::path& filepath,
 	const ShaderReflection::ReflectShaderModule& reflectShaderModule)
@@ -2505,7 +2715,7 @@ Serializer::ImportInfo Serializer::GetImportInfo(const std::filesystem::path& fi
 	auto data = fastgltf::GltfDataBuffer::FromPath(filepath);
 	if (data.error() != fastgltf::Error::None)
 	{
-		Logger::Error(std::format("Failed to load intermediate {}!", filepath.string()));
+		Logger::Error("Failed to load intermediate {}!", filepath.string());
 		return {};
 	}
 
@@ -2514,7 +2724,7 @@ Serializer::ImportInfo Serializer::GetImportInfo(const std::filesystem::path& fi
 
 	if (asset.error() != fastgltf::Error::None)
 	{
-		Logger::Error(std::format("Failed to load intermediate {}!", filepath.string()));
+		Logger::Error("Failed to load intermediate {}!", filepath.string());
 		return {};
 	}
 
@@ -2606,7 +2816,7 @@ Serializer::LoadIntermediate(
 	auto data = fastgltf::GltfDataBuffer::FromPath(options.filepath);
 	if (data.error() != fastgltf::Error::None)
 	{
-		Logger::Error(std::format("Failed to load intermediate {}!", options.filepath.string()));
+		Logger::Error("Failed to load intermediate {}!", options.filepath.string());
 		return {};
 	}
 
@@ -2616,7 +2826,7 @@ Serializer::LoadIntermediate(
 
 	if (asset.error() != fastgltf::Error::None)
 	{
-		Logger::Error(std::format("Failed to load intermediate {}!", options.filepath.string()));
+		Logger::Error("Failed to load intermediate {}!", options.filepath.string());
 		return {};
 	}
 
@@ -2924,7 +3134,7 @@ std::shared_ptr<Texture> Serializer::LoadGltfTexture(
 
 			if (!createInfo.data)
 			{
-				Logger::Error(std::format("{}:Failed to load embedded texture!", createInfo.name));
+				Logger::Error("{}:Failed to load embedded texture!", createInfo.name);
 				return nullptr;
 			}
 
@@ -2990,7 +3200,7 @@ std::optional<Mesh::CreateInfo> Serializer::GenerateMesh(
 
 	if (primitive.type != fastgltf::PrimitiveType::Triangles)
 	{
-		Logger::Error(std::format("{}: Primitive type is not supported!", meshName));
+		Logger::Error("{}: Primitive type is not supported!", meshName);
 		return std::nullopt;
 	}
 
@@ -3019,7 +3229,7 @@ std::optional<Mesh::CreateInfo> Serializer::GenerateMesh(
 
 	if (positionAttribute == primitive.attributes.end())
 	{
-		Logger::Error(std::format("{}: Mesh doesn't have POSITION attribute!", name));
+		Logger::Error("{}: Mesh doesn't have POSITION attribute!", name);
 		return std::nullopt;
 	}
 
@@ -3127,7 +3337,7 @@ std::optional<Mesh::CreateInfo> Serializer::GenerateMesh(
 		}
 		else
 		{
-			Logger::Error(std::format("{}: Index type is not supported!", meshName));
+			Logger::Error("{}: Index type is not supported!", meshName);
 		}
 	}
 	else
@@ -3366,8 +3576,8 @@ std::optional<Mesh::CreateInfo> Serializer::GenerateMesh(
 	}
 	else
 	{
-		Logger::Error(std::format("Failed to generate mesh {} at {}, unsupported mesh type!",
-			meshName, sourceFileInfo.filepath.string()));
+		Logger::Error("Failed to generate mesh {} at {}, unsupported mesh type!",
+			meshName, sourceFileInfo.filepath.string());
 		return std::nullopt;
 	}
 	
@@ -3614,11 +3824,16 @@ std::shared_ptr<SkeletalAnimation> Serializer::GenerateAnimation(
 	createInfo.name = name;
 	createInfo.filepath = (directory / createInfo.name).concat(FileFormats::Anim());
 
+	// Redundant keys are removed only once on import, loading the saved keys again is lossless.
+	createInfo.compressionSettings.positionTolerance = 0.0001f;
+	createInfo.compressionSettings.rotationTolerance = 0.0005f;
+	createInfo.compressionSettings.scaleTolerance = 0.0001f;
+
 	for (const auto& channel : animation.channels)
 	{
 		if (!channel.nodeIndex)
 		{
-			Logger::Warning(std::format("{}: Animation channel doesn't have node index!", name));
+			Logger::Warning("{}: Animation channel doesn't have node index!", name);
 			continue;
 		}
 
@@ -4297,6 +4512,7 @@ void Serializer::SerializeRenderer3D(YAML::Emitter& out, const std::shared_ptr<E
 	out << YAML::Key << "CastShadows" << YAML::Value << r3d.castShadows;
 	out << YAML::Key << "ObjectVisibilityMask" << YAML::Value << (uint32_t)r3d.objectVisibilityMask;
 	out << YAML::Key << "ShadowVisibilityMask" << YAML::Value << (uint32_t)r3d.shadowVisibilityMask;
+	out << YAML::Key << "RaycastMask" << YAML::Value << (uint32_t)r3d.raycastMask;
 
 	out << YAML::EndMap;
 }
@@ -4335,8 +4551,7 @@ void Serializer::DeserializeRenderer3D(const YAML::Node& in, const std::shared_p
 				}
 			};
 
-			std::shared_ptr<NextFrameEvent> event = std::make_shared<NextFrameEvent>(callback, Event::Type::OnNextFrame, nullptr);
-			EventSystem::GetInstance().SendEvent(event);
+			EventSystem::GetInstance().SendEvent(NextFrameEvent{ std::move(callback), nullptr });
 		}
 
 		if (const auto& castShadowsData = renderer3DData["CastShadows"])
@@ -4354,6 +4569,11 @@ void Serializer::DeserializeRenderer3D(const YAML::Node& in, const std::shared_p
 			r3d.shadowVisibilityMask = shadowVisibilityMaskData.as<uint32_t>();
 		}
 
+		if (const auto& raycastMaskData = renderer3DData["RaycastMask"])
+		{
+			r3d.raycastMask = raycastMaskData.as<uint32_t>();
+		}
+
 		if (const auto& meshData = renderer3DData["Mesh"])
 		{
 			const UUID uuid = meshData.as<UUID>();
@@ -4380,8 +4600,7 @@ void Serializer::DeserializeRenderer3D(const YAML::Node& in, const std::shared_p
 						MeshManager::GetInstance().DeleteMesh(sharedMesh);
 					};
 
-					std::shared_ptr<NextFrameEvent> event = std::make_shared<NextFrameEvent>(callback, Event::Type::OnNextFrame, nullptr);
-					EventSystem::GetInstance().SendEvent(event);
+					EventSystem::GetInstance().SendEvent(NextFrameEvent{ std::move(callback), nullptr });
 					
 				}
 			});
@@ -4414,8 +4633,7 @@ void Serializer::DeserializeRenderer3D(const YAML::Node& in, const std::shared_p
 						MaterialManager::GetInstance().DeleteMaterial(sharedMaterial);
 					};
 
-					std::shared_ptr<NextFrameEvent> event = std::make_shared<NextFrameEvent>(callback, Event::Type::OnNextFrame, nullptr);
-					EventSystem::GetInstance().SendEvent(event);
+					EventSystem::GetInstance().SendEvent(NextFrameEvent{ std::move(callback), nullptr });
 				}
 			});
 		}
@@ -4652,6 +4870,8 @@ void Serializer::SerializeSkeletalAnimator(YAML::Emitter& out, const std::shared
 	out << YAML::Key << "Speed" << YAML::Value << skeletalAnimator.GetSpeed();
 	out << YAML::Key << "CurrentTime" << YAML::Value << skeletalAnimator.GetCurrentTime();
 	out << YAML::Key << "ApplySkeletonTransform" << YAML::Value << skeletalAnimator.GetApplySkeletonTransform();
+	out << YAML::Key << "LodEnabled" << YAML::Value << skeletalAnimator.GetLodEnabled();
+	out << YAML::Key << "MaxBones" << YAML::Value << skeletalAnimator.GetMaxBones();
 
 	out << YAML::EndMap;
 }
@@ -4691,6 +4911,16 @@ void Serializer::DeserializeSkeletalAnimator(const YAML::Node& in, const std::sh
 		{
 			skeletalAnimator.SetApplySkeletonTransform(applySkeletonTransformData.as<bool>());
 		}
+
+		if (const auto& lodEnabledData = skeletalAnimatorData["LodEnabled"])
+		{
+			skeletalAnimator.SetLodEnabled(lodEnabledData.as<bool>());
+		}
+
+		if (const auto& maxBonesData = skeletalAnimatorData["MaxBones"])
+		{
+			skeletalAnimator.SetMaxBones(maxBonesData.as<uint32_t>());
+		}
 	}
 }
 
@@ -4953,6 +5183,7 @@ void Serializer::SerializeRigidBody(YAML::Emitter& out, const std::shared_ptr<En
 	out << YAML::BeginMap;
 
 	out << YAML::Key << "IsStatic" << YAML::Value << rigidBody.isStatic;
+	out << YAML::Key << "Layer" << YAML::Value << rigidBody.layer;
 	out << YAML::Key << "Mass" << YAML::Value << rigidBody.mass;
 	out << YAML::Key << "Type" << YAML::Value << (int)rigidBody.type;
 	
@@ -4974,6 +5205,20 @@ void Serializer::SerializeRigidBody(YAML::Emitter& out, const std::shared_ptr<En
 		out << YAML::Key << "Radius" << YAML::Value << rigidBody.shape.cylinder.radius;
 		break;
 	}
+	case RigidBody::Type::Mesh:
+	case RigidBody::Type::ConvexHull:
+	{
+		if (rigidBody.mesh)
+		{
+			const UUID uuid = Utils::FindUuid(rigidBody.mesh->GetFilepath());
+			if (uuid.IsValid())
+			{
+				out << YAML::Key << "Mesh" << YAML::Value << uuid;
+			}
+		}
+		out << YAML::Key << "MeshLod" << YAML::Value << rigidBody.meshLod;
+		break;
+	}
 	}
 
 	auto& joltPhysicsSystem = entity->GetScene()->GetPhysicsSystem()->GetInstance();
@@ -5010,6 +5255,13 @@ void Serializer::DeserializeRigidBody(const YAML::Node& in, const std::shared_pt
 			rigidBody.isStatic = isStaticData.as<bool>();
 		}
 
+		// Scenes saved before collision layers only have the static flag.
+		rigidBody.layer = RigidBody::defaultLayer;
+		if (const auto& layerData = rigidBodyData["Layer"])
+		{
+			rigidBody.layer = layerData.as<JPH::ObjectLayer>();
+		}
+
 		if (const auto& massData = rigidBodyData["Mass"])
 		{
 			rigidBody.mass = massData.as<float>();
@@ -5051,6 +5303,34 @@ void Serializer::DeserializeRigidBody(const YAML::Node& in, const std::shared_pt
 			}
 			break;
 		}
+		case RigidBody::Type::Mesh:
+		case RigidBody::Type::ConvexHull:
+		{
+			if (const auto& meshLodData = rigidBodyData["MeshLod"])
+			{
+				rigidBody.meshLod = meshLodData.as<uint32_t>();
+			}
+
+			// The body is created once the mesh is loaded.
+			if (const auto& meshData = rigidBodyData["Mesh"])
+			{
+				const UUID uuid = meshData.as<UUID>();
+				AsyncAssetLoader::GetInstance().AsyncLoadMesh(Utils::FindFilepath(uuid), [wEntity = std::weak_ptr(entity)](std::weak_ptr<Mesh> mesh)
+				{
+					std::shared_ptr<Mesh> sharedMesh = mesh.lock();
+					std::shared_ptr<Entity> entity = wEntity.lock();
+					if (!sharedMesh || !entity || !entity->HasComponent<RigidBody>())
+					{
+						return;
+					}
+
+					RigidBody& rigidBody = entity->GetComponent<RigidBody>();
+					rigidBody.mesh = sharedMesh;
+					rigidBody.isValid = false;
+				});
+			}
+			break;
+		}
 		}
 
 		const auto physicsSystem = entity->GetScene()->GetPhysicsSystem();
@@ -5157,8 +5437,7 @@ void Serializer::DeserializeDecal(const YAML::Node& in, const std::shared_ptr<En
 						MaterialManager::GetInstance().DeleteMaterial(sharedMaterial);
 					};
 
-					std::shared_ptr<NextFrameEvent> event = std::make_shared<NextFrameEvent>(callback, Event::Type::OnNextFrame, nullptr);
-					EventSystem::GetInstance().SendEvent(event);
+					EventSystem::GetInstance().SendEvent(NextFrameEvent{ std::move(callback), nullptr });
 				}
 			});
 		}
@@ -5170,74 +5449,234 @@ void Serializer::DeserializeDecal(const YAML::Node& in, const std::shared_ptr<En
 	}
 }
 
-void Serializer::SerializeUserComponents(YAML::Emitter& out, const std::shared_ptr<Entity>& entity)
+namespace
 {
-	std::function<void(void*, const ReflectionSystem::RegisteredClass&, size_t)> serialize = [&out, &serialize]
-		(void* instance, const ReflectionSystem::RegisteredClass& registeredClass, size_t offset)
+
+	template <typename T>
+	void RegisterReflectedValueType()
 	{
-		for (auto& [name, prop] : registeredClass.m_PropertiesByName)
+		ReflectionSystem::Type& type = ReflectionSystem::GetOrCreateType<T>();
+		type.serialize = [](void* out, const void* value)
 		{
-#define SERIALIZE_PROPERTY(_type) \
-if (prop.IsValue<_type>()) \
-{ \
-	const _type& value = prop.GetValue<_type>(instance, offset); \
-	out << YAML::Key << "Type" << prop.m_Type; \
-	out << YAML::Key << "Value" << value; \
-}
+			*static_cast<YAML::Emitter*>(out) << *static_cast<const T*>(value);
+		};
+		type.deserialize = [](const void* in, void* value)
+		{
+			*static_cast<T*>(value) = static_cast<const YAML::Node*>(in)->as<T>();
+		};
+	}
+
+	/**
+	 * Value types are registered once, properties call them through their type without comparing type names.
+	 */
+	void RegisterReflectedValueTypes()
+	{
+		static const bool isRegistered = []()
+		{
+			RegisterReflectedValueType<bool>();
+			RegisterReflectedValueType<float>();
+			RegisterReflectedValueType<int>();
+			RegisterReflectedValueType<double>();
+			RegisterReflectedValueType<std::string>();
+			RegisterReflectedValueType<glm::vec2>();
+			RegisterReflectedValueType<glm::vec3>();
+			RegisterReflectedValueType<glm::vec4>();
+			RegisterReflectedValueType<glm::ivec2>();
+			RegisterReflectedValueType<glm::ivec3>();
+			RegisterReflectedValueType<glm::ivec4>();
+
+			return true;
+		}();
+	}
+
+	bool IsSerializable(const ReflectionSystem::Type& type)
+	{
+		if (type.serialize)
+		{
+			return true;
+		}
+
+		if (type.elementType)
+		{
+			return IsSerializable(*type.elementType);
+		}
+
+		return ReflectionSystem::GetInstance().FindClass(type.id) != nullptr;
+	}
 
-			out << YAML::Key << name;
+	void SerializeReflectedProperties(
+		YAML::Emitter& out,
+		void* instance,
+		const ReflectionSystem::RegisteredClass& registeredClass,
+		const size_t offset);
+
+	void DeserializeReflectedProperties(
+		const YAML::Node& in,
+		void* instance,
+		const ReflectionSystem::RegisteredClass& registeredClass,
+		const size_t offset);
+
+	void SerializeReflectedValue(YAML::Emitter& out, const ReflectionSystem::Type& type, void* value)
+	{
+		if (type.serialize)
+		{
+			type.serialize(&out, value);
+		}
+		else if (type.elementType)
+		{
+			out << YAML::BeginSeq;
+
+			const size_t size = type.getSize(value);
+			for (size_t i = 0; i < size; i++)
+			{
+				SerializeReflectedValue(out, *type.elementType, type.getElement(value, i));
+			}
+
+			out << YAML::EndSeq;
+		}
+		else if (const ReflectionSystem::RegisteredClass* registeredClass = ReflectionSystem::GetInstance().FindClass(type.id))
+		{
 			out << YAML::BeginMap;
+			SerializeReflectedProperties(out, value, *registeredClass, 0);
+			out << YAML::EndMap;
+		}
+	}
 
-			SERIALIZE_PROPERTY(bool)
-			else SERIALIZE_PROPERTY(float)
-			else SERIALIZE_PROPERTY(int)
-			else SERIALIZE_PROPERTY(double)
-			else SERIALIZE_PROPERTY(std::string)
-			else SERIALIZE_PROPERTY(glm::vec2)
-			else SERIALIZE_PROPERTY(glm::vec3)
-			else SERIALIZE_PROPERTY(glm::vec4)
-			else SERIALIZE_PROPERTY(glm::ivec2)
-			else SERIALIZE_PROPERTY(glm::ivec3)
-			else SERIALIZE_PROPERTY(glm::ivec4)
+	void DeserializeReflectedValue(const YAML::Node& in, const ReflectionSystem::Type& type, void* value)
+	{
+		if (type.deserialize)
+		{
+			type.deserialize(&in, value);
+		}
+		else if (type.elementType)
+		{
+			type.resize(value, in.size());
+			for (size_t i = 0; i < in.size(); i++)
+			{
+				DeserializeReflectedValue(in[i], *type.elementType, type.getElement(value, i));
+			}
+		}
+		else if (const ReflectionSystem::RegisteredClass* registeredClass = ReflectionSystem::GetInstance().FindClass(type.id))
+		{
+			DeserializeReflectedProperties(in, value, *registeredClass, 0);
+		}
+	}
+
+	void SerializeReflectedProperties(
+		YAML::Emitter& out,
+		void* instance,
+		const ReflectionSystem::RegisteredClass& registeredClass,
+		const size_t offset)
+	{
+		for (const ReflectionSystem::Property& property : registeredClass.m_Properties)
+		{
+			if (!IsSerializable(*property.m_Type))
+			{
+				continue;
+			}
+
+			out << YAML::Key << property.m_Name;
+			out << YAML::BeginMap;
+
+			out << YAML::Key << "Type" << YAML::Value << property.m_Type->name;
+			out << YAML::Key << "Value" << YAML::Value;
+			SerializeReflectedValue(out, *property.m_Type, property.GetPointer(instance, offset));
 
 			out << YAML::EndMap;
 		}
 
-		for (const auto& parent : registeredClass.m_Parents)
+		for (const auto& [parentId, parentOffset] : registeredClass.m_Parents)
 		{
-			ReflectionSystem& reflectionSystem = ReflectionSystem::GetInstance();
-			auto classByType = reflectionSystem.m_ClassesByType.find(parent.first);
-			if (classByType != reflectionSystem.m_ClassesByType.end())
+			if (const ReflectionSystem::RegisteredClass* parentClass = ReflectionSystem::GetInstance().FindClass(parentId))
 			{
-				serialize(instance, classByType->second, parent.second);
+				SerializeReflectedProperties(out, instance, *parentClass, offset + parentOffset);
 			}
 		}
-	};
+	}
+
+	void DeserializeReflectedProperties(
+		const YAML::Node& in,
+		void* instance,
+		const ReflectionSystem::RegisteredClass& registeredClass,
+		const size_t offset)
+	{
+		for (const ReflectionSystem::Property& property : registeredClass.m_Properties)
+		{
+			const YAML::Node& propertyData = in[property.m_Name];
+			if (!propertyData)
+			{
+				continue;
+			}
+
+			// A property whose declared type has changed keeps its default value.
+			const YAML::Node& typeData = propertyData["Type"];
+			if (!typeData || typeData.as<std::string>() != property.m_Type->name || !IsSerializable(*property.m_Type))
+			{
+				continue;
+			}
+
+			if (const YAML::Node& valueData = propertyData["Value"])
+			{
+				DeserializeReflectedValue(valueData, *property.m_Type, property.GetPointer(instance, offset));
+			}
+		}
+
+		for (const auto& [parentId, parentOffset] : registeredClass.m_Parents)
+		{
+			if (const ReflectionSystem::RegisteredClass* parentClass = ReflectionSystem::GetInstance().FindClass(parentId))
+			{
+				DeserializeReflectedProperties(in, instance, *parentClass, offset + parentOffset);
+			}
+		}
+	}
 
+}
+
+void Serializer::SerializeReflectedClass(YAML::Emitter& out, void* instance, const entt::id_type classId)
+{
+	RegisterReflectedValueTypes();
+
+	if (const ReflectionSystem::RegisteredClass* registeredClass = ReflectionSystem::GetInstance().FindClass(classId))
+	{
+		SerializeReflectedProperties(out, instance, *registeredClass, 0);
+	}
+}
+
+void Serializer::DeserializeReflectedClass(const YAML::Node& in, void* instance, const entt::id_type classId)
+{
+	RegisterReflectedValueTypes();
+
+	if (const ReflectionSystem::RegisteredClass* registeredClass = ReflectionSystem::GetInstance().FindClass(classId))
+	{
+		DeserializeReflectedProperties(in, instance, *registeredClass, 0);
+	}
+}
+
+void Serializer::SerializeUserComponents(YAML::Emitter& out, const std::shared_ptr<Entity>& entity)
+{
 	ReflectionSystem& reflectionSystem = ReflectionSystem::GetInstance();
 
 	for (auto [id, storage] : entity->GetRegistry().storage())
 	{
 		if (storage.contains(entity->GetHandle()))
 		{
-			auto classByType = reflectionSystem.m_ClassesByType.find(id);
-			if (classByType == reflectionSystem.m_ClassesByType.end())
+			const ReflectionSystem::RegisteredClass* registeredClass = reflectionSystem.FindClass(id);
+			if (!registeredClass || !registeredClass->m_CreateCallback)
 			{
 				continue;
 			}
 
-			const auto& registeredClass = classByType->second;
 			void* component = storage.value(entity->GetHandle());
 
-			out << YAML::Key << registeredClass.m_TypeInfo.name().data();
+			out << YAML::Key << registeredClass->m_TypeInfo.name().data();
 
 			out << YAML::BeginMap;
 
-			serialize(component, classByType->second, 0);
+			SerializeReflectedClass(out, component, id);
 
-			if (registeredClass.m_SerializeCallback)
+			if (registeredClass->m_SerializeCallback)
 			{
-				registeredClass.m_SerializeCallback(&out, component, entity.get());
+				registeredClass->m_SerializeCallback(&out, component, entity.get());
 			}
 
 			out << YAML::EndMap;
@@ -5247,56 +5686,18 @@ if (prop.IsValue<_type>()) \
 
 void Serializer::DeserializeUserComponents(const YAML::Node& in, const std::shared_ptr<Entity>& entity)
 {
-	std::function<void(const YAML::Node&, void*, ReflectionSystem::RegisteredClass&, size_t)> deserialize = [&deserialize]
-	(const YAML::Node& in, void* instance, ReflectionSystem::RegisteredClass& registeredClass, size_t offset)
-	{
-		ReflectionSystem& reflectionSystem = ReflectionSystem::GetInstance();
-
-		for (auto& [name, prop] : registeredClass.m_PropertiesByName)
-		{
-			if (auto& propData = in[name])
-			{
-				const std::string type = propData["Type"].as<std::string>();
-
-#define DESERIALIZE_PROPERTY(_type)             \
-if (GetTypeName<_type>() == type)               \
-{                                               \
-	_type value = propData["Value"].as<_type>();\
-	prop.SetValue(instance, value, offset);     \
-}                                               \
-
-				DESERIALIZE_PROPERTY(bool)
-				else DESERIALIZE_PROPERTY(float)
-				else DESERIALIZE_PROPERTY(int)
-				else DESERIALIZE_PROPERTY(double)
-				else DESERIALIZE_PROPERTY(std::string)
-				else DESERIALIZE_PROPERTY(glm::vec2)
-				else DESERIALIZE_PROPERTY(glm::vec3)
-				else DESERIALIZE_PROPERTY(glm::vec4)
-				else DESERIALIZE_PROPERTY(glm::ivec2)
-				else DESERIALIZE_PROPERTY(glm::ivec3)
-				else DESERIALIZE_PROPERTY(glm::ivec4)
-			}
-		}
-
-		for (const auto& parent : registeredClass.m_Parents)
-		{
-			ReflectionSystem& reflectionSystem = ReflectionSystem::GetInstance();
-			auto classByType = reflectionSystem.m_ClassesByType.find(parent.first);
-			if (classByType != reflectionSystem.m_ClassesByType.end())
-			{
-				deserialize(in, instance, classByType->second, parent.second);
-			}
-		}
-	};
-
 	ReflectionSystem& reflectionSystem = ReflectionSystem::GetInstance();
 	for (auto& [id, registeredClass] : reflectionSystem.m_ClassesByType)
 	{
+		if (!registeredClass.m_CreateCallback)
+		{
+			continue;
+		}
+
 		if (const auto& userComponentData = in[registeredClass.m_TypeInfo.name().data()])
 		{
 			void* component = registeredClass.m_CreateCallback(entity->GetRegistry(), entity->GetHandle());
-			deserialize(userComponentData, component, registeredClass, 0);
+			DeserializeReflectedClass(userComponentData, component, id);
 
 			if (registeredClass.m_DeserializeCallback)
 			{
@@ -5337,6 +5738,33 @@ void Serializer::SerializeScene(const std::filesystem::path& filepath, const std
 	out << YAML::EndMap;
 	//
 
+	// Physics Settings.
+	out << YAML::Key << "Physics";
+	out << YAML::Value << YAML::BeginMap;
+
+	const PhysicsSystem::Settings& physicsSettings = scene->GetPhysicsSystem()->GetSettings();
+	out << YAML::Key << "MaxBodyCount" << YAML::Value << physicsSettings.maxBodyCount;
+	out << YAML::Key << "BodyMutexCount" << YAML::Value << physicsSettings.bodyMutexCount;
+	out << YAML::Key << "MaxBodyPairCount" << YAML::Value << physicsSettings.maxBodyPairCount;
+	out << YAML::Key << "MaxContactConstraintCount" << YAML::Value << physicsSettings.maxContactConstraintCount;
+	out << YAML::Key << "TempAllocatorSize" << YAML::Value << physicsSettings.tempAllocatorSize;
+	out << YAML::Key << "AllowGrowth" << YAML::Value << physicsSettings.allowGrowth;
+
+	out << YAML::Key << "CollisionLayers";
+	out << YAML::Value << YAML::BeginSeq;
+	for (const PhysicsSystem::CollisionLayer& collisionLayer : physicsSettings.collisionLayers)
+	{
+		out << YAML::BeginMap;
+		out << YAML::Key << "Name" << YAML::Value << collisionLayer.name;
+		out << YAML::Key << "BroadPhaseLayer" << YAML::Value << (uint32_t)(JPH::BroadPhaseLayer::Type)collisionLayer.broadPhaseLayer;
+		out << YAML::Key << "CollisionMask" << YAML::Value << collisionLayer.collisionMask;
+		out << YAML::EndMap;
+	}
+	out << YAML::EndSeq;
+
+	out << YAML::EndMap;
+	//
+
 	out << YAML::EndMap;
 	//
 
@@ -5403,12 +5831,73 @@ std::shared_ptr<Scene> Serializer::DeserializeScene(const std::filesystem::path&
 		"Main");
 	scene->SetFilepath(filepath);
 
+	// The physics world has to be configured before any rigid body is created.
+	const auto& settingsData = data["Settings"];
+	if (const auto& physicsSettingsData = settingsData ? settingsData["Physics"] : YAML::Node())
+	{
+		PhysicsSystem::Settings physicsSettings{};
+		if (const auto& maxBodyCountData = physicsSettingsData["MaxBodyCount"])
+		{
+			physicsSettings.maxBodyCount = maxBodyCountData.as<uint32_t>();
+		}
+
+		if (const auto& bodyMutexCountData = physicsSettingsData["BodyMutexCount"])
+		{
+			physicsSettings.bodyMutexCount = bodyMutexCountData.as<uint32_t>();
+		}
+
+		if (const auto& maxBodyPairCountData = physicsSettingsData["MaxBodyPairCount"])
+		{
+			physicsSettings.maxBodyPairCount = maxBodyPairCountData.as<uint32_t>();
+		}
+
+		if (const auto& maxContactConstraintCountData = physicsSettingsData["MaxContactConstraintCount"])
+		{
+			physicsSettings.maxContactConstraintCount = maxContactConstraintCountData.as<uint32_t>();
+		}
+
+		if (const auto& tempAllocatorSizeData = physicsSettingsData["TempAllocatorSize"])
+		{
+			physicsSettings.tempAllocatorSize = tempAllocatorSizeData.as<uint32_t>();
+		}
+
+		if (const auto& allowGrowthData = physicsSettingsData["AllowGrowth"])
+		{
+			physicsSettings.allowGrowth = allowGrowthData.as<bool>();
+		}
+
+		if (const auto& collisionLayersData = physicsSettingsData["CollisionLayers"])
+		{
+			physicsSettings.collisionLayers.clear();
+			for (const auto& collisionLayerData : collisionLayersData)
+			{
+				PhysicsSystem::CollisionLayer& collisionLayer = physicsSettings.collisionLayers.emplace_back();
+				if (const auto& nameData = collisionLayerData["Name"])
+				{
+					collisionLayer.name = nameData.as<std::string>();
+				}
+
+				if (const auto& broadPhaseLayerData = collisionLayerData["BroadPhaseLayer"])
+				{
+					collisionLayer.broadPhaseLayer = JPH::BroadPhaseLayer(broadPhaseLayerData.as<uint32_t>());
+				}
+
+				if (const auto& collisionMaskData = collisionLayerData["CollisionMask"])
+				{
+					collisionLayer.collisionMask = collisionMaskData.as<uint32_t>();
+				}
+			}
+		}
+
+		scene->GetPhysicsSystem()->SetSettings(physicsSettings, scene);
+	}
+
 	for (const auto& entityData : data["Scene"])
 	{
 		DeserializeEntity(entityData, scene);
 	}
 
-	if (const auto& settingsData = data["Settings"])
+	if (settingsData)
 	{
 		if (const auto& drawBoundingBoxesData = settingsData["DrawBoundingBoxes"])
 		{
@@ -70,6 +70,16 @@ namespace Pengine
 
 		static std::string DeserializeShaderCache(const std::filesystem::path& filepath);
 
+		/**
+		 * Cooked physics shape of the mesh, keyed by the mesh uuid and the hash of the cooking settings.
+		 */
+		static void SerializePhysicsShapeCache(const std::filesystem::path& meshFilepath, const size_t settingsHash, const std::string& data);
+
+		/**
+		 * Returns an empty string when there is no cache or the mesh has changed since it was saved.
+		 */
+		static std::string DeserializePhysicsShapeCache(const std::filesystem::path& meshFilepath, const size_t settingsHash);
+
 		static void SerializeShaderModuleReflection(const std::filesystem::path& filepath, const ShaderReflection::ReflectShaderModule& reflectShaderModule);
 
 		static std::optional<ShaderReflection::ReflectShaderModule> DeserializeShaderModuleReflection(const std::filesystem::path& filepath);
@@ -222,6 +232,13 @@ namespace Pengine
 
 		static void DeserializeUserComponents(const YAML::Node& in, const std::shared_ptr<Entity>& entity);
 
+		/**
+		 * Writes the properties of a reflected class and of its parents, classId is GetTypeHash<T>().
+		 */
+		static void SerializeReflectedClass(YAML::Emitter& out, void* instance, const entt::id_type classId);
+
+		static void DeserializeReflectedClass(const YAML::Node& in, void* instance, const entt::id_type classId);
+
 		static void SerializeScene(const std::filesystem::path& filepath, const std::shared_ptr<Scene>& scene);
 
 		static std::shared_ptr<Scene> DeserializeScene(const std::filesystem::path& filepath);
@@ -22,9 +22,7 @@ std::shared_ptr<Texture> TextureManager::Create(const Texture::CreateInfo& creat
 	PROFILER_SCOPE(__FUNCTION__);
 
 	std::shared_ptr<Texture> texture = Texture::Create(createInfo);
-
-	std::lock_guard<std::mutex> lock(m_MutexTexture);
-	m_TexturesByFilepath[createInfo.filepath] = texture;
+	m_Textures.Set(createInfo.filepath, texture);
 
 	return texture;
 }
@@ -33,24 +31,13 @@ std::shared_ptr<Texture> TextureManager::Load(const std::filesystem::path& filep
 {
 	PROFILER_SCOPE(__FUNCTION__);
 
-	if (std::shared_ptr<Texture> texture = GetTexture(filepath))
-	{
-		return texture;
-	}
-	else
+	std::shared_ptr<Texture> texture = m_Textures.GetOrLoad(filepath, [&filepath, flip]()
 	{
 		auto meta = Serializer::DeserializeTextureMeta(filepath.string() + FileFormats::Meta());
-		texture = Texture::Load(filepath, flip, *meta);
-		if (texture)
-		{
-			std::lock_guard<std::mutex> lock(m_MutexTexture);
-			m_TexturesByFilepath[filepath] = texture;
-
-			return texture;
-		}
+		return Texture::Load(filepath, flip, *meta);
+	});
 
-		return GetPink();
-	}
+	return texture ? texture : GetPink();
 }
 
 std::vector<std::shared_ptr<Texture>> TextureManager::LoadFromFolder(const std::filesystem::path& directory, bool flip)
@@ -75,14 +62,7 @@ std::vector<std::shared_ptr<Texture>> TextureManager::LoadFromFolder(const std::
 
 std::shared_ptr<Texture> TextureManager::GetTexture(const std::filesystem::path& filepath) const
 {
-	std::lock_guard<std::mutex> lock(m_MutexTexture);
-	if (const auto textureByFilepath = m_TexturesByFilepath.find(filepath);
-		textureByFilepath != m_TexturesByFilepath.end())
-	{
-		return textureByFilepath->second;
-	}
-
-	return nullptr;
+	return m_Textures.Get(filepath);
 }
 
 std::shared_ptr<Texture> TextureManager::GetWhite() const
@@ -182,16 +162,14 @@ void TextureManager::CreateDefaultResources()
 
 void TextureManager::Delete(const std::filesystem::path& filepath)
 {
-	std::lock_guard<std::mutex> lock(m_MutexTexture);
-	m_TexturesByFilepath.erase(filepath);
+	m_Textures.Erase(filepath);
 }
 
 void TextureManager::Delete(std::shared_ptr<Texture>& texture)
 {
-	if (texture.use_count() == 2)
+	if (m_Textures.EraseIfUnused(texture))
 	{
 		BindlessUniformWriter::GetInstance().UnBindTexture(texture);
-		Delete(texture->GetFilepath());
 	}
 
 	texture = nullptr;
@@ -199,8 +177,7 @@ void TextureManager::Delete(std::shared_ptr<Texture>& texture)
 
 void TextureManager::ShutDown()
 {
-	std::lock_guard<std::mutex> lock(m_MutexTexture);
-	m_TexturesByFilepath.clear();
+	m_Textures.Clear();
 
 	m_WhiteLayered = nullptr;
 	m_White = nullptr;
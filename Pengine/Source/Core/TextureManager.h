@@ -1,11 +1,10 @@
 #pragma once
 
+#include "AssetCache.h"
 #include "Core.h"
 
 #include "../Graphics/Texture.h"
 
-#include <mutex>
-
 namespace Pengine
 {
 
@@ -25,7 +24,7 @@ namespace Pengine
 
 		std::shared_ptr<Texture> GetTexture(const std::filesystem::path& filepath) const;
 
-		const std::unordered_map<std::filesystem::path, std::shared_ptr<Texture>, path_hash>& GetTextures() const { return m_TexturesByFilepath; }
+		const AssetCache<Texture>::AssetsByFilepath& GetTextures() const { return m_Textures.GetAll(); }
 
 		std::shared_ptr<Texture> GetWhite() const;
 
@@ -47,14 +46,12 @@ namespace Pengine
 		TextureManager() = default;
 		~TextureManager() = default;
 
-		std::unordered_map<std::filesystem::path, std::shared_ptr<Texture>, path_hash> m_TexturesByFilepath;
+		AssetCache<Texture> m_Textures;
 
 		std::shared_ptr<Texture> m_White;
 		std::shared_ptr<Texture> m_Black;
 		std::shared_ptr<Texture> m_Pink;
 		std::shared_ptr<Texture> m_WhiteLayered;
-
-		mutable std::mutex m_MutexTexture;
 	};
 
 }
\ No newline at end of file
@@ -4,10 +4,20 @@ using namespace Pengine;
 
 void ThreadPool::Initialize(size_t threadCount)
 {
+	// The workers look themselves up in m_IsThreadBusy, which is filled under the same lock.
+	std::unique_lock<std::mutex> lock(m_Mutex);
+	m_IsStoped = false;
+
 	for (size_t i = 0; i < threadCount; i++)
 	{
 		m_Threads.emplace_back([this]
 		{
+			std::map<std::thread::id, bool>::iterator isThreadBusy;
+			{
+				std::unique_lock<std::mutex> lock(m_Mutex);
+				isThreadBusy = m_IsThreadBusy.find(std::this_thread::get_id());
+			}
+
 			while (true)
 			{
 				if (m_MainId == std::this_thread::get_id())
@@ -15,8 +25,6 @@ void ThreadPool::Initialize(size_t threadCount)
 					return;
 				}
 
-				const auto isThreadBusy = m_IsThreadBusy.find(std::this_thread::get_id());
-
 				Task task;
 				{
 					std::unique_lock<std::mutex> lock(m_Mutex);
@@ -71,9 +79,74 @@ void ThreadPool::Shutdown()
 
 	m_RunCondVar.notify_all();
 
+	// Joined, a detached worker would still touch the pool after it is destroyed.
 	for (std::thread& thread : m_Threads)
 	{
-		thread.detach();
+		if (!thread.joinable())
+		{
+			continue;
+		}
+
+		if (thread.get_id() == std::this_thread::get_id())
+		{
+			thread.detach();
+		}
+		else
+		{
+			thread.join();
+		}
+	}
+
+	std::unique_lock<std::mutex> lock(m_Mutex);
+	m_Threads.clear();
+	m_IsThreadBusy.clear();
+}
+
+void ThreadPool::ParallelFor(const size_t count, const size_t batchSize, const std::function<void(size_t begin, size_t end)>& function)
+{
+	if (count == 0)
+	{
+		return;
+	}
+
+	struct Batches
+	{
+		std::atomic<size_t> next = 0;
+		std::atomic<size_t> done = 0;
+	};
+
+	// Shared with the tasks, a task that starts after all batches were taken only touches the counters.
+	const std::shared_ptr<Batches> batches = std::make_shared<Batches>();
+	const size_t batchCount = (count + batchSize - 1) / batchSize;
+
+	auto runBatches = [batches, batchCount, batchSize, count, function = &function]()
+	{
+		size_t batch;
+		while ((batch = batches->next.fetch_add(1)) < batchCount)
+		{
+			(*function)(batch * batchSize, std::min((batch + 1) * batchSize, count));
+
+			if (batches->done.fetch_add(1) + 1 == batchCount)
+			{
+				batches->done.notify_all();
+			}
+		}
+	};
+
+	const size_t helperCount = std::min(GetThreadCount(), batchCount - 1);
+	for (size_t i = 0; i < helperCount; i++)
+	{
+		auto task = runBatches;
+		EnqueueAsync(std::move(task));
+	}
+
+	runBatches();
+
+	// Batches taken by the workers can still be in progress.
+	size_t done;
+	while ((done = batches->done.load()) < batchCount)
+	{
+		batches->done.wait(done);
 	}
 }
 
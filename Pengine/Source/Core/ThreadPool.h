@@ -31,6 +31,9 @@ namespace Pengine
 
 		inline size_t GetThreadCount() { return m_Threads.size(); }
 
+		/**
+		 * Waits for the queued tasks and joins the workers, tasks enqueued afterwards run on the calling thread.
+		 */
 		void Shutdown();
 
 		template<typename F, typename ...Args>
@@ -52,10 +55,18 @@ namespace Pengine
 
 			{
 				std::unique_lock<std::mutex> lock(m_Mutex);
-				m_Tasks.emplace(std::move(task));
+				if (!m_IsStoped)
+				{
+					m_Tasks.emplace(std::move(task));
+					lock.unlock();
+
+					m_RunCondVar.notify_one();
+					return;
+				}
 			}
 
-			m_RunCondVar.notify_one();
+			// No worker would take it anymore.
+			task();
 		}
 
 		template<typename F, typename ...Args>
@@ -75,15 +86,31 @@ namespace Pengine
 			
 			{
 				std::unique_lock<std::mutex> lock(m_Mutex);
-				m_Tasks.emplace(std::move(packagedTask));
+				if (!m_IsStoped)
+				{
+					m_Tasks.emplace(std::move(packagedTask));
+					lock.unlock();
+
+					m_RunCondVar.notify_one();
+					return future;
+				}
 			}
-			
-			m_RunCondVar.notify_one();
+
+			packagedTask();
 			return future;
 		}
 
+		/**
+		 * Splits [0, count) into batches of batchSize that the workers and the calling thread take in turn,
+		 * returns once all batches are done. The calling thread never waits for a worker to become free,
+		 * with a busy pool or no threads at all it runs the batches itself.
+		 */
+		void ParallelFor(const size_t count, const size_t batchSize, const std::function<void(size_t begin, size_t end)>& function);
+
 		bool IsMainThread() const { return m_MainId == std::this_thread::get_id(); }
 
+		bool IsWorkerThread() const { return m_IsThreadBusy.contains(std::this_thread::get_id()); }
+
 		void WaitIdle();
 
 	private:
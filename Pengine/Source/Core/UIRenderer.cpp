@@ -3,28 +3,90 @@
 #include "FontManager.h"
 #include "RenderPassManager.h"
 #include "MaterialManager.h"
+#include "Profiler.h"
 #include "TextureManager.h"
 #include "Scene.h"
 #include "Time.h"
 
+#include "../Graphics/FrameBuffer.h"
 #include "../Graphics/Renderer.h"
 
-#include "../Components/Canvas.h"
+#include "../Utils/Utils.h"
 
-// Also need to change in Shaders/RectangleUI.frag.
-#define MAX_BATCH_QUAD_COUNT 10000
+#include <bit>
 
-#define QUAD_VERTEX_COUNT 4
 #define QUAD_INDEX_COUNT 6
-#define MAX_BATCH_QUAD_VERTEX_COUNT MAX_BATCH_QUAD_COUNT * QUAD_VERTEX_COUNT
-#define MAX_BATCH_QUAD_INDEX_COUNT MAX_BATCH_QUAD_COUNT * QUAD_INDEX_COUNT
 
 using namespace Pengine;
 
+namespace
+{
+
+	/**
+	 * Hashes everything a quad is built from. Text also hashes the version of the font atlas,
+	 * glyph uvs and the atlas texture change when the atlas grows.
+	 */
+	size_t HashCommands(const Clay_RenderCommandArray& commands)
+	{
+		size_t hash = 0;
+		for (int i = 0; i < commands.length; i++)
+		{
+			const Clay_RenderCommand& renderCommand = commands.internalArray[i];
+
+			hash = Utils::CombineHash(hash, renderCommand.commandType);
+			hash = Utils::CombineHash(hash, Utils::HashBytes(&renderCommand.boundingBox, sizeof(renderCommand.boundingBox)));
+
+			switch (renderCommand.commandType)
+			{
+			case CLAY_RENDER_COMMAND_TYPE_RECTANGLE:
+			{
+				hash = Utils::CombineHash(hash, Utils::HashBytes(&renderCommand.renderData.rectangle, sizeof(renderCommand.renderData.rectangle)));
+				break;
+			}
+			case CLAY_RENDER_COMMAND_TYPE_IMAGE:
+			{
+				hash = Utils::CombineHash(hash, Utils::HashBytes(&renderCommand.renderData.image, sizeof(renderCommand.renderData.image)));
+				break;
+			}
+			case CLAY_RENDER_COMMAND_TYPE_TEXT:
+			{
+				const Clay_TextRenderData& text = renderCommand.renderData.text;
+
+				hash = Utils::CombineHash(hash, Utils::HashBytes(&text.textColor, sizeof(text.textColor)));
+				hash = Utils::CombineHash(hash, Utils::HashBytes(text.stringContents.chars, text.stringContents.length));
+
+				const uint64_t style = static_cast<uint64_t>(text.fontId) | static_cast<uint64_t>(text.fontSize) << 16 |
+					static_cast<uint64_t>(text.letterSpacing) << 32 | static_cast<uint64_t>(text.lineHeight) << 48;
+				hash = Utils::CombineHash(hash, std::hash<uint64_t>{}(style));
+
+				if (const std::shared_ptr<Font> font = FontManager::GetInstance().GetFont(text.fontId))
+				{
+					hash = Utils::CombineHash(hash, font->GetAtlas().GetVersion());
+				}
+				break;
+			}
+			default:
+				break;
+			}
+		}
+
+		return hash;
+	}
+
+}
+
 UIRenderer::UIRenderer()
 {
-	m_QuadVertices.reserve(MAX_BATCH_QUAD_VERTEX_COUNT);
-	m_QuadIndices.reserve(MAX_BATCH_QUAD_INDEX_COUNT);
+	static_assert(sizeof(QuadInstance) == sizeof(glm::vec4) * 4 + sizeof(int), "QuadInstance must be tightly packed for the vertex input.");
+
+	uint32_t quadIndices[QUAD_INDEX_COUNT] = { 0, 1, 2, 2, 3, 1 };
+	m_QuadIndexBuffer = Buffer::Create(
+		sizeof(uint32_t),
+		QUAD_INDEX_COUNT,
+		Buffer::Usage::INDEX_BUFFER,
+		MemoryType::GPU);
+	m_QuadIndexBuffer->WriteToBuffer(quadIndices, sizeof(quadIndices));
+
 	m_WhiteTexture = TextureManager::GetInstance().GetWhite().get();
 }
 
@@ -40,62 +102,20 @@ void UIRenderer::DrawQuad(
 	const glm::vec2& uvMax,
 	const glm::vec4& color,
 	const glm::vec4& cornerRadius,
-	const glm::mat4& projectionMat4,
 	void* texture,
 	const bool isText)
 {
-	const glm::vec2 quadHalfSize = size * 0.5f;
-	const glm::vec2 quadCenter = position + quadHalfSize;
-
-	const int instanceIndex = m_QuadInstances.size();
-
-	QuadInstance quadInstance{};
+	QuadInstance& quadInstance = m_QuadInstances.emplace_back();
+	quadInstance.positionAndSize = { position.x, position.y, size.x, size.y };
+	quadInstance.uvMinMax = { uvMin.x, uvMin.y, uvMax.x, uvMax.y };
 	quadInstance.color = color;
-	quadInstance.quadCenterAndHalfSize = { quadCenter.x, quadCenter.y, quadHalfSize.x, quadHalfSize.y };
-	quadInstance.customData[0] = isText;
-
-	QuadVertex quadVertex{};
-	quadVertex.instanceIndex = instanceIndex;
-
-	quadVertex.positionInPixels = position;
-	quadVertex.position = projectionMat4 * glm::vec4{ position.x, position.y, 0.0f, 1.0f };
-	quadVertex.uv = uvMin;
-	quadVertex.cornerRadius = cornerRadius[0];
-	m_QuadVertices.emplace_back(quadVertex);
-
-	quadVertex.positionInPixels = position + glm::vec2(size.x, 0.0f);
-	quadVertex.position = projectionMat4 * glm::vec4{ position.x + size.x, position.y, 0.0f, 1.0f };
-	quadVertex.uv = glm::vec2(uvMax.x, uvMin.y);
-	quadVertex.cornerRadius = cornerRadius[1];
-	m_QuadVertices.emplace_back(quadVertex);
-
-	quadVertex.positionInPixels = position + glm::vec2(0.0f, size.y);
-	quadVertex.position = projectionMat4 * glm::vec4{ position.x, position.y + size.y, 0.0f, 1.0f };
-	quadVertex.uv = glm::vec2(uvMin.x, uvMax.y);
-	quadVertex.cornerRadius = cornerRadius[2];
-	m_QuadVertices.emplace_back(quadVertex);
-
-	quadVertex.positionInPixels = position + glm::vec2(size.x, size.y);
-	quadVertex.position = projectionMat4 * glm::vec4{ position.x + size.x, position.y + size.y, 0.0f, 1.0f };
-	quadVertex.uv = uvMax;
-	quadVertex.cornerRadius = cornerRadius[3];
-	m_QuadVertices.emplace_back(quadVertex);
-
-	m_QuadIndices.emplace_back(m_QuadCount * QUAD_VERTEX_COUNT + 0);
-	m_QuadIndices.emplace_back(m_QuadCount * QUAD_VERTEX_COUNT + 1);
-	m_QuadIndices.emplace_back(m_QuadCount * QUAD_VERTEX_COUNT + 2);
-	m_QuadIndices.emplace_back(m_QuadCount * QUAD_VERTEX_COUNT + 2);
-	m_QuadIndices.emplace_back(m_QuadCount * QUAD_VERTEX_COUNT + 3);
-	m_QuadIndices.emplace_back(m_QuadCount * QUAD_VERTEX_COUNT + 1);
-
-	m_QuadCount++;
-	m_CurrentTextureId = texture;
+	quadInstance.cornerRadius = cornerRadius;
+	quadInstance.isText = isText;
 
-	m_QuadInstances.emplace_back(quadInstance);
+	m_CurrentTextureId = texture;
 }
 
 void UIRenderer::Render(
-	const std::vector<entt::entity>& entities,
 	std::shared_ptr<BaseMaterial> baseMaterial,
 	const RenderPass::RenderCallbackInfo& renderInfo)
 {
@@ -115,43 +135,40 @@ void UIRenderer::Render(
 	std::shared_ptr<Pipeline> pipeline = baseMaterial->GetPipeline(renderInfo.renderPass->GetName());
 	if (!pipeline)
 	{
-		Logger::Error("Trying to render UI, but pipeline is nullptr!");
+		// Not an error while the pipeline is still compiling.
+		if (baseMaterial->IsReady())
+		{
+			Logger::Error("Trying to render UI, but pipeline is nullptr!");
+		}
 		return;
 	}
 
-	struct CanvasInfo
+	for (auto& [entity, batch] : m_Batches)
 	{
-		glm::ivec2 size;
-		std::vector<Clay_RenderCommandArray> commands;
-		std::shared_ptr<FrameBuffer> frameBuffer;
-	};
+		batch.isUsed = false;
+	}
 
-	std::vector<CanvasInfo> canvasInfos;
-	std::vector<CanvasInfo> canvasMainViewportInfos;
+	const RenderSnapshot& snapshot = *renderInfo.snapshot;
 
-	uint32_t batchIndex = 0;
-	for (const entt::entity entity : entities)
-	{
-		Canvas& canvas = renderInfo.scene->GetRegistry().get<Canvas>(entity);
+	UpdateFrameBuffers(snapshot, renderInfo);
 
-		if (canvas.commands.empty())
+	std::vector<const RenderSnapshot::CanvasData*> canvases;
+	std::vector<const RenderSnapshot::CanvasData*> canvasesInMainViewport;
+
+	for (const RenderSnapshot::CanvasData& canvas : snapshot.GetCanvases())
+	{
+		if (canvas.commandCount == 0)
 		{
-			break;
+			continue;
 		}
 
 		if (canvas.drawInMainViewport)
 		{
-			CanvasInfo& canvasInfo = canvasMainViewportInfos.emplace_back();
-			canvasInfo.commands = canvas.commands;
-			canvasInfo.frameBuffer = renderInfo.renderView->GetFrameBuffer(renderInfo.renderPass->GetName());
-			canvasInfo.size = canvas.size;
+			canvasesInMainViewport.emplace_back(&canvas);
 		}
-		else
+		else if (m_FrameBuffers.contains(canvas.entity))
 		{
-			CanvasInfo& canvasInfo = canvasInfos.emplace_back();
-			canvasInfo.commands = canvas.commands;
-			canvasInfo.frameBuffer = canvas.frameBuffer;
-			canvasInfo.size = canvas.size;
+			canvases.emplace_back(&canvas);
 		}
 	}
 
@@ -165,116 +182,118 @@ void UIRenderer::Render(
 
 		if (submitInfo.frameBuffer)
 		{
-			for (const auto& canvasInfo : canvasMainViewportInfos)
+			for (const RenderSnapshot::CanvasData* canvas : canvasesInMainViewport)
 			{
-				glm::mat4 projectionMat4 = glm::ortho(0.0f, (float)canvasInfo.size.x, (float)canvasInfo.size.y, 0.0f);
-
-				for (const auto& commands : canvasInfo.commands)
-				{
-					for (int i = 0; i < commands.length; i++)
-					{
-						ProcessCommand(renderInfo, &commands.internalArray[i], batchIndex, pipeline, projectionMat4);
-					}
-				}
-
-				RenderBatch(batchIndex, renderInfo, pipeline);
+				RenderCanvas(canvas->entity, canvas->size, snapshot.GetCanvasCommands(*canvas), renderInfo, pipeline);
 			}
 		}
 
 		renderInfo.renderer->EndRenderPass(submitInfo);
 	}
-	
-	for (const auto& canvasInfo : canvasInfos)
+
+	for (const RenderSnapshot::CanvasData* canvas : canvases)
 	{
-		glm::mat4 projectionMat4 = glm::ortho(0.0f, (float)canvasInfo.size.x, (float)canvasInfo.size.y, 0.0f);
-		
 		RenderPass::SubmitInfo submitInfo{};
 		submitInfo.frame = renderInfo.frame;
 		submitInfo.renderPass = renderInfo.renderPass;
-		submitInfo.frameBuffer = canvasInfo.frameBuffer;
+		submitInfo.frameBuffer = m_FrameBuffers.at(canvas->entity);
 
 		renderInfo.renderer->BeginRenderPass(submitInfo);
 
-		for (const auto& commands : canvasInfo.commands)
-		{
-			for (int i = 0; i < commands.length; i++)
-			{
-				ProcessCommand(renderInfo, &commands.internalArray[i], batchIndex, pipeline, projectionMat4);
-			}
-		}
-
-		RenderBatch(batchIndex, renderInfo, pipeline);
+		RenderCanvas(canvas->entity, canvas->size, snapshot.GetCanvasCommands(*canvas), renderInfo, pipeline);
 
 		renderInfo.renderer->EndRenderPass(submitInfo);
 	}
+
+	// Buffers are destroyed with a delay, draws that are still in flight keep them.
+	std::erase_if(m_Batches, [](const auto& batch) { return !batch.second.isUsed; });
 }
 
-void UIRenderer::RecordPreviousDrawCommand(const uint32_t batchIndex, std::shared_ptr<Pipeline> pipeline)
+void UIRenderer::UpdateFrameBuffers(const RenderSnapshot& snapshot, const RenderPass::RenderCallbackInfo& renderInfo)
 {
-	Batch::DrawCommand drawCommand{};
+	std::unordered_set<entt::entity> canvasEntities;
 
-	Batch& batch = GetOrCreateBatch(batchIndex, pipeline);
-	if (batch.drawCommands.empty())
+	for (const RenderSnapshot::CanvasData& canvas : snapshot.GetCanvases())
 	{
-		if (m_QuadIndices.empty())
+		if (canvas.drawInMainViewport)
 		{
-			return;
+			// Moved to the main viewport, the Renderer3D was disabled by the UISystem.
+			if (const auto frameBuffer = m_FrameBuffers.find(canvas.entity); frameBuffer != m_FrameBuffers.end())
+			{
+				if (canvas.material)
+				{
+					canvas.material->GetUniformWriter(GBuffer)->WriteTexture("albedoTexture", TextureManager::GetInstance().GetWhite());
+				}
+
+				m_FrameBuffers.erase(frameBuffer);
+			}
+
+			continue;
 		}
 
-		drawCommand.indexCount = m_QuadIndices.size();
-		drawCommand.quadCount = m_QuadCount;
-	}
-	else
-	{
-		Batch::DrawCommand lastDrawCommand = batch.drawCommands.back();
+		canvasEntities.emplace(canvas.entity);
 
-		// Trying to add command that has been already added.
-		if (lastDrawCommand.quadCount == m_QuadCount)
+		if (canvas.size.x <= 0 || canvas.size.y <= 0)
 		{
-			return;
+			continue;
 		}
 
-		drawCommand.indexCount = (m_QuadCount - lastDrawCommand.quadCount) * QUAD_INDEX_COUNT;
-		drawCommand.indexBufferOffset = lastDrawCommand.quadCount * batch.indexBuffer->GetInstanceSize();
-		drawCommand.quadCount = m_QuadCount;
-	}
+		std::shared_ptr<FrameBuffer>& frameBuffer = m_FrameBuffers[canvas.entity];
+		if (!frameBuffer)
+		{
+			frameBuffer = FrameBuffer::Create(renderInfo.renderPass, nullptr, canvas.size);
+		}
+		else if (canvas.size != frameBuffer->GetSize())
+		{
+			frameBuffer->Resize(canvas.size);
+		}
 
-	if (m_Scissors)
-	{
-		drawCommand.scissors = *m_Scissors;
+		if (canvas.material)
+		{
+			canvas.material->GetUniformWriter(GBuffer)->WriteTexture("albedoTexture", frameBuffer->GetAttachment(0));
+		}
 	}
 
-	drawCommand.textureId = m_CurrentTextureId;
-	m_CurrentTextureId = nullptr;
-
-	batch.drawCommands.emplace_back(drawCommand);
+	// Deleted canvases.
+	std::erase_if(m_FrameBuffers, [&canvasEntities](const auto& frameBuffer) { return !canvasEntities.contains(frameBuffer.first); });
 }
 
-void UIRenderer::RenderBatch(
-	uint32_t& batchIndex,
+void UIRenderer::RenderCanvas(
+	const entt::entity entity,
+	const glm::ivec2& size,
+	const Clay_RenderCommandArray& commands,
 	const RenderPass::RenderCallbackInfo& renderInfo,
 	std::shared_ptr<Pipeline> pipeline)
 {
-	if (m_QuadVertices.empty() || m_QuadIndices.empty() || m_QuadInstances.empty())
+	PROFILER_SCOPE(__FUNCTION__);
+
+	CanvasBatch& batch = GetOrCreateBatch(entity, pipeline);
+	batch.isUsed = true;
+
+	// Hashed before the build, glyphs rasterised while building change the atlas version and rebuild the next frame.
+	if (const size_t hash = HashCommands(commands); hash != batch.hash)
 	{
-		return;
+		Build(batch, commands);
+		batch.hash = hash;
 	}
 
-	Batch& batch = GetOrCreateBatch(batchIndex, pipeline);
+	if (batch.size != size)
+	{
+		glm::mat4 projectionMat4 = glm::ortho(0.0f, (float)size.x, (float)size.y, 0.0f);
+		batch.uniformBuffer->WriteToBuffer(&projectionMat4, sizeof(glm::mat4));
+		batch.size = size;
+	}
 
-	batch.uniformBuffer->WriteToBuffer(m_QuadInstances.data(), m_QuadInstances.size() * sizeof(QuadInstance));
-	batch.vertexBuffer->WriteToBuffer(m_QuadVertices.data(), m_QuadVertices.size() * sizeof(QuadVertex));
-	batch.indexBuffer->WriteToBuffer(m_QuadIndices.data(), m_QuadIndices.size() * sizeof(uint32_t));
+	if (batch.drawCommands.empty())
+	{
+		return;
+	}
 
+	batch.instanceBuffer->Flush();
 	batch.uniformBuffer->Flush();
-	batch.vertexBuffer->Flush();
-	batch.indexBuffer->Flush();
-
 	batch.uniformWriter->Flush();
 
-	RecordPreviousDrawCommand(batchIndex, pipeline);
-
-	for (const auto& drawCommand : batch.drawCommands)
+	for (const DrawCommand& drawCommand : batch.drawCommands)
 	{
 		Texture* texture = static_cast<Texture*>(drawCommand.textureId ? drawCommand.textureId : m_WhiteTexture);
 
@@ -283,82 +302,159 @@ void UIRenderer::RenderBatch(
 			renderInfo.renderer->SetScissors(*drawCommand.scissors, renderInfo.frame);
 		}
 
-		std::vector<NativeHandle> vertexBuffers = { batch.vertexBuffer->GetNativeHandle() };
-		std::vector<size_t> vertexBufferOffsets = { 0 };
+		// The draw has no first instance, the instance stream is bound at the first quad instead.
+		std::vector<NativeHandle> vertexBuffers = { batch.instanceBuffer->GetNativeHandle() };
+		std::vector<size_t> vertexBufferOffsets = { drawCommand.firstQuad * sizeof(QuadInstance) };
 
 		renderInfo.renderer->Render(
 			vertexBuffers,
 			vertexBufferOffsets,
-			batch.indexBuffer->GetNativeHandle(),
-			drawCommand.indexBufferOffset,
-			drawCommand.indexCount,
+			m_QuadIndexBuffer->GetNativeHandle(),
+			0,
+			QUAD_INDEX_COUNT,
 			pipeline,
 			NativeHandle::Invalid(),
 			0,
-			1,
+			drawCommand.quadCount,
 			{ texture->GetUniformWriter()->GetNativeHandle(), batch.uniformWriter->GetNativeHandle() },
 			renderInfo.frame);
 	}
+}
+
+void UIRenderer::Build(CanvasBatch& batch, const Clay_RenderCommandArray& commands)
+{
+	PROFILER_SCOPE(__FUNCTION__);
 
-	batchIndex++;
-	m_QuadCount = 0;
-	m_QuadVertices.clear();
-	m_QuadIndices.clear();
 	m_QuadInstances.clear();
 	m_CurrentTextureId = nullptr;
+	m_Scissors = std::nullopt;
 	batch.drawCommands.clear();
+	batch.retainedTextures.clear();
+
+	for (int i = 0; i < commands.length; i++)
+	{
+		ProcessCommand(batch, commands.internalArray[i]);
+	}
+
+	RecordPreviousDrawCommand(batch);
+
+	Upload(batch);
 }
 
-void UIRenderer::ProcessCommand(
-	const RenderPass::RenderCallbackInfo& renderInfo,
-	void* command,
-	uint32_t& batchIndex,
-	std::shared_ptr<Pipeline> pipeline,
-	const glm::mat4& projectionMat4)
+void UIRenderer::Upload(CanvasBatch& batch)
 {
-	Clay_RenderCommand* renderCommand = static_cast<Clay_RenderCommand*>(command);
+	const size_t quadCount = m_QuadInstances.size();
+	if (quadCount == 0)
+	{
+		batch.quadInstances.clear();
+		return;
+	}
+
+	if (!batch.instanceBuffer || batch.instanceBuffer->GetInstanceCount() < quadCount)
+	{
+		batch.instanceBuffer = Buffer::Create(
+			sizeof(QuadInstance),
+			std::bit_ceil(static_cast<uint32_t>(quadCount)),
+			Buffer::Usage::VERTEX_BUFFER,
+			MemoryType::CPU,
+			true);
 
-	glm::vec2 position = { renderCommand->boundingBox.x, renderCommand->boundingBox.y };
-	const glm::vec2 size = { renderCommand->boundingBox.width, renderCommand->boundingBox.height };
-	const glm::vec2 boundingBoxPosition = position;
-	const glm::vec2 boundingBoxSize = size;
+		// The new buffer is empty, everything is written.
+		batch.quadInstances.clear();
+	}
+
+	auto isSame = [&batch, this](const size_t index)
+	{
+		return memcmp(&m_QuadInstances[index], &batch.quadInstances[index], sizeof(QuadInstance)) == 0;
+	};
+
+	// Usually a few quads change, e.g. a label or a hovered button, the unchanged head and tail are not written.
+	size_t first = 0;
+	const size_t commonCount = glm::min(quadCount, batch.quadInstances.size());
+	while (first < commonCount && isSame(first))
+	{
+		first++;
+	}
+
+	size_t last = quadCount;
+	if (quadCount == batch.quadInstances.size())
+	{
+		while (last > first && isSame(last - 1))
+		{
+			last--;
+		}
+	}
+
+	if (first < last)
+	{
+		batch.instanceBuffer->WriteToBuffer(
+			&m_QuadInstances[first],
+			(last - first) * sizeof(QuadInstance),
+			first * sizeof(QuadInstance));
+	}
+
+	std::swap(batch.quadInstances, m_QuadInstances);
+}
+
+void UIRenderer::RecordPreviousDrawCommand(CanvasBatch& batch)
+{
+	DrawCommand drawCommand{};
+	if (!batch.drawCommands.empty())
+	{
+		const DrawCommand& lastDrawCommand = batch.drawCommands.back();
+		drawCommand.firstQuad = lastDrawCommand.firstQuad + lastDrawCommand.quadCount;
+	}
+
+	// Trying to add command that has been already added.
+	if (drawCommand.firstQuad == m_QuadInstances.size())
+	{
+		return;
+	}
+
+	drawCommand.quadCount = m_QuadInstances.size() - drawCommand.firstQuad;
+	drawCommand.scissors = m_Scissors;
+	drawCommand.textureId = m_CurrentTextureId;
+	m_CurrentTextureId = nullptr;
+
+	batch.drawCommands.emplace_back(drawCommand);
+}
+
+void UIRenderer::ProcessCommand(CanvasBatch& batch, const Clay_RenderCommand& renderCommand)
+{
+	const glm::vec2 position = { renderCommand.boundingBox.x, renderCommand.boundingBox.y };
+	const glm::vec2 size = { renderCommand.boundingBox.width, renderCommand.boundingBox.height };
 
 	glm::vec4 color{};
 	glm::vec4 cornerRadius{};
 	void* textureId = nullptr;
 
-	switch (renderCommand->commandType)
+	switch (renderCommand.commandType)
 	{
 	case CLAY_RENDER_COMMAND_TYPE_RECTANGLE:
 	{
 		color =
 		{
-			renderCommand->renderData.rectangle.backgroundColor.r,
-			renderCommand->renderData.rectangle.backgroundColor.g,
-			renderCommand->renderData.rectangle.backgroundColor.b,
-			renderCommand->renderData.rectangle.backgroundColor.a,
+			renderCommand.renderData.rectangle.backgroundColor.r,
+			renderCommand.renderData.rectangle.backgroundColor.g,
+			renderCommand.renderData.rectangle.backgroundColor.b,
+			renderCommand.renderData.rectangle.backgroundColor.a,
 		};
 		cornerRadius =
 		{
-			renderCommand->renderData.rectangle.cornerRadius.topLeft,
-			renderCommand->renderData.rectangle.cornerRadius.topRight,
-			renderCommand->renderData.rectangle.cornerRadius.bottomLeft,
-			renderCommand->renderData.rectangle.cornerRadius.bottomRight,
+			renderCommand.renderData.rectangle.cornerRadius.topLeft,
+			renderCommand.renderData.rectangle.cornerRadius.topRight,
+			renderCommand.renderData.rectangle.cornerRadius.bottomLeft,
+			renderCommand.renderData.rectangle.cornerRadius.bottomRight,
 		};
 
 		textureId = m_WhiteTexture;
 
-		if (m_QuadIndices.size() == MAX_BATCH_QUAD_INDEX_COUNT)
-		{
-			RenderBatch(batchIndex, renderInfo, pipeline);
-		}
-
 		if (color.a < 1.0f || m_CurrentTextureId != textureId)
 		{
-			RecordPreviousDrawCommand(batchIndex, pipeline);
+			RecordPreviousDrawCommand(batch);
 		}
 
-		DrawQuad(position, size, { 0.0f, 1.0f }, { 1.0f, 0.0f }, color, cornerRadius, projectionMat4, textureId, false);
+		DrawQuad(position, size, { 0.0f, 1.0f }, { 1.0f, 0.0f }, color, cornerRadius, textureId, false);
 
 		break;
 	}
@@ -366,32 +462,27 @@ void UIRenderer::ProcessCommand(
 	{
 		color =
 		{
-			renderCommand->renderData.image.backgroundColor.r,
-			renderCommand->renderData.image.backgroundColor.g,
-			renderCommand->renderData.image.backgroundColor.b,
-			renderCommand->renderData.image.backgroundColor.a,
+			renderCommand.renderData.image.backgroundColor.r,
+			renderCommand.renderData.image.backgroundColor.g,
+			renderCommand.renderData.image.backgroundColor.b,
+			renderCommand.renderData.image.backgroundColor.a,
 		};
 		cornerRadius =
 		{
-			renderCommand->renderData.image.cornerRadius.topLeft,
-			renderCommand->renderData.image.cornerRadius.topRight,
-			renderCommand->renderData.image.cornerRadius.bottomLeft,
-			renderCommand->renderData.image.cornerRadius.bottomRight,
+			renderCommand.renderData.image.cornerRadius.topLeft,
+			renderCommand.renderData.image.cornerRadius.topRight,
+			renderCommand.renderData.image.cornerRadius.bottomLeft,
+			renderCommand.renderData.image.cornerRadius.bottomRight,
 		};
 
-		textureId = renderCommand->renderData.image.imageData;
-
-		if (m_QuadIndices.size() == MAX_BATCH_QUAD_INDEX_COUNT)
-		{
-			RenderBatch(batchIndex, renderInfo, pipeline);
-		}
+		textureId = renderCommand.renderData.image.imageData;
 
 		if (color.a < 1.0f || m_CurrentTextureId != textureId)
 		{
-			RecordPreviousDrawCommand(batchIndex, pipeline);
+			RecordPreviousDrawCommand(batch);
 		}
 
-		DrawQuad(position, size, { 0.0f, 1.0f }, { 1.0f, 0.0f }, color, cornerRadius, projectionMat4, textureId, false);
+		DrawQuad(position, size, { 0.0f, 1.0f }, { 1.0f, 0.0f }, color, cornerRadius, textureId, false);
 
 		break;
 	}
@@ -399,57 +490,62 @@ void UIRenderer::ProcessCommand(
 	{
 		color =
 		{
-			renderCommand->renderData.text.textColor.r,
-			renderCommand->renderData.text.textColor.g,
-			renderCommand->renderData.text.textColor.b,
-			renderCommand->renderData.text.textColor.a,
+			renderCommand.renderData.text.textColor.r,
+			renderCommand.renderData.text.textColor.g,
+			renderCommand.renderData.text.textColor.b,
+			renderCommand.renderData.text.textColor.a,
 		};
 
-		const auto font = FontManager::GetInstance().GetFont(renderCommand->renderData.text.fontId, renderCommand->renderData.text.fontSize);
-
-		textureId = font->atlas.get();
-
-		if (color.a < 1.0f || m_CurrentTextureId != textureId)
+		const std::shared_ptr<Font> font = FontManager::GetInstance().GetFont(renderCommand.renderData.text.fontId);
+		if (!font)
 		{
-			RecordPreviousDrawCommand(batchIndex, pipeline);
+			break;
 		}
 
-		const float lineHeight = renderCommand->boundingBox.height + renderCommand->renderData.text.lineHeight;
+		// Usually cached when Clay measured the text. Its glyphs are in the atlas before the texture is taken.
+		const std::shared_ptr<const TextLayoutCache::Layout> layout = FontManager::GetInstance().GetTextLayout(
+			*font,
+			renderCommand.renderData.text.fontSize,
+			renderCommand.renderData.text.letterSpacing,
+			std::string_view(renderCommand.renderData.text.stringContents.chars, renderCommand.renderData.text.stringContents.length));
+
+		std::shared_ptr<Texture> atlas = font->GetAtlasTexture();
+		textureId = atlas.get();
 
-		for (int j = 0; j < renderCommand->renderData.text.stringContents.length; ++j)
+		if (color.a < 1.0f || m_CurrentTextureId != textureId)
 		{
-			const auto& character = renderCommand->renderData.text.stringContents.chars[j];
-			const auto& glyph = font->glyphs[character];
+			RecordPreviousDrawCommand(batch);
+		}
 
-			glm::vec2 glyphPosition{};
-			glyphPosition.x = position.x + glyph.bearing.x;
-			glyphPosition.y = position.y + (glyph.size.y - glyph.bearing.y) + (lineHeight - glyph.size.y);
+		const glm::vec2 atlasSize = atlas->GetSize();
+		batch.retainedTextures.emplace_back(std::move(atlas));
 
-			if (m_QuadIndices.size() == MAX_BATCH_QUAD_INDEX_COUNT)
-			{
-				RenderBatch(batchIndex, renderInfo, pipeline);
-			}
+		const float lineHeight = renderCommand.boundingBox.height + renderCommand.renderData.text.lineHeight;
+		const glm::vec2 baseline = { position.x, position.y + lineHeight };
 
-			DrawQuad(glyphPosition, glyph.size, glyph.uvMin, glyph.uvMax, color, cornerRadius, projectionMat4, textureId, true);
+		for (const TextLayoutCache::PositionedGlyph& glyph : layout->glyphs)
+		{
+			const glm::vec2 uvMin = glm::vec2(glyph.rect.offset) / atlasSize;
+			const glm::vec2 uvMax = glm::vec2(glyph.rect.offset + glyph.rect.size) / atlasSize;
 
-			position.x += glyph.advance + renderCommand->renderData.text.letterSpacing;
+			DrawQuad(baseline + glyph.offset, glyph.size, uvMin, uvMax, color, cornerRadius, textureId, true);
 		}
 
 		break;
 	}
 	case CLAY_RENDER_COMMAND_TYPE_SCISSOR_START:
 	{
-		RecordPreviousDrawCommand(batchIndex, pipeline);
+		RecordPreviousDrawCommand(batch);
 
 		RenderPass::Scissors scissors{};
-		scissors.size = boundingBoxSize;
-		scissors.offset = boundingBoxPosition;
+		scissors.size = size;
+		scissors.offset = position;
 		m_Scissors.emplace(scissors);
 		break;
 	}
 	case CLAY_RENDER_COMMAND_TYPE_SCISSOR_END:
 	{
-		RecordPreviousDrawCommand(batchIndex, pipeline);
+		RecordPreviousDrawCommand(batch);
 
 		m_Scissors = std::nullopt;
 		break;
@@ -457,38 +553,26 @@ void UIRenderer::ProcessCommand(
 	}
 }
 
-UIRenderer::Batch& UIRenderer::GetOrCreateBatch(const uint32_t batchIndex, std::shared_ptr<Pipeline> pipeline)
+UIRenderer::CanvasBatch& UIRenderer::GetOrCreateBatch(const entt::entity entity, std::shared_ptr<Pipeline> pipeline)
 {
-	if (m_Batches.size() == batchIndex)
+	if (const auto batchByEntity = m_Batches.find(entity);
+		batchByEntity != m_Batches.end())
 	{
-		Batch batch;
-		batch.vertexBuffer = Buffer::Create(
-			sizeof(QuadVertex) * QUAD_VERTEX_COUNT,
-			MAX_BATCH_QUAD_COUNT,
-			Buffer::Usage::VERTEX_BUFFER,
-			MemoryType::CPU,
-			true);
-
-		batch.indexBuffer = Buffer::Create(
-			sizeof(uint32_t) * QUAD_INDEX_COUNT,
-			MAX_BATCH_QUAD_COUNT,
-			Buffer::Usage::INDEX_BUFFER,
-			MemoryType::CPU,
-			true);
+		return batchByEntity->second;
+	}
 
-		batch.uniformBuffer = Buffer::Create(
-			sizeof(QuadInstance),
-			MAX_BATCH_QUAD_COUNT,
-			Buffer::Usage::STORAGE_BUFFER,
-			MemoryType::CPU,
-			true);
+	CanvasBatch& batch = m_Batches[entity];
 
-		batch.uniformWriter = UniformWriter::Create(pipeline->GetUniformLayout(1));
-		batch.uniformWriter->WriteBuffer("InstanceBuffer", batch.uniformBuffer);
-		batch.uniformWriter->Flush();
+	batch.uniformBuffer = Buffer::Create(
+		sizeof(glm::mat4),
+		1,
+		Buffer::Usage::UNIFORM_BUFFER,
+		MemoryType::CPU,
+		true);
 
-		m_Batches.emplace_back(batch);
-	}
+	batch.uniformWriter = UniformWriter::Create(pipeline->GetUniformLayout(1));
+	batch.uniformWriter->WriteBuffer("UIBuffer", batch.uniformBuffer);
+	batch.uniformWriter->Flush();
 
-	return m_Batches[batchIndex];
+	return batch;
 }
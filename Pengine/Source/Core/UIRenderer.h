@@ -2,6 +2,7 @@
 
 #include "Core.h"
 #include "CustomData.h"
+#include "RenderSnapshot.h"
 
 #include "../Graphics/Buffer.h"
 #include "../Graphics/Texture.h"
@@ -9,95 +10,129 @@
 #include "../Graphics/RenderPass.h"
 #include "../Graphics/UniformWriter.h"
 
+#include <clay/clay.h>
+
 namespace Pengine
 {
 
+	/**
+	 * Draws canvases from instanced quads, the corners are generated in Shaders/RectangleUI.vert.
+	 * Each canvas keeps its quads in a persistent buffer, they are rebuilt only when the render commands change
+	 * and only the instances that differ from the previous build are uploaded.
+	 */
 	class PENGINE_API UIRenderer : public CustomData
 	{
 	public:
 		UIRenderer();
 		virtual ~UIRenderer() override;
 
-		void DrawQuad(
-			const glm::vec2& position,
-			const glm::vec2& size,
-			const glm::vec2& uvMin,
-			const glm::vec2& uvMax,
-			const glm::vec4& color,
-			const glm::vec4& cornerRadius,
-			const glm::mat4& projectionMat4,
-			void* texture,
-			const bool isText);
-
+		/**
+		 * Draws the canvases of the render snapshot, the registry isn't read while recording.
+		 */
 		void Render(
-			const std::vector<entt::entity>& entities,
 			std::shared_ptr<class BaseMaterial> baseMaterial,
 			const RenderPass::RenderCallbackInfo& renderInfo);
 
-private:
-		void RecordPreviousDrawCommand(const uint32_t batchIndex, std::shared_ptr<Pipeline> pipeline);
-
-		void RenderBatch(
-			uint32_t& batchIndex,
-			const RenderPass::RenderCallbackInfo& renderInfo,
-			std::shared_ptr<Pipeline> pipeline);
-
-		void ProcessCommand(
-			const RenderPass::RenderCallbackInfo& renderInfo,
-			void* command,
-			uint32_t& batchIndex,
-			std::shared_ptr<Pipeline> pipeline,
-			const glm::mat4& projectionMat4);
-
-		struct QuadVertex
-		{
-			glm::vec4 position;
-			glm::vec2 positionInPixels;
-			glm::vec2 uv;
-			float cornerRadius;
-			int instanceIndex;
-		};
-
+	private:
+		/**
+		 * Read per instance, the layout matches the instance binding in Materials/RectangleUI.basemat.
+		 */
 		struct QuadInstance
 		{
+			glm::vec4 positionAndSize;
+			glm::vec4 uvMinMax;
 			glm::vec4 color;
-			glm::vec4 quadCenterAndHalfSize;
 
 			/**
-			 * { isText, empty, empty. empty }
+			 * { topLeft, topRight, bottomLeft, bottomRight }
 			 */
-			glm::ivec4 customData;
+			glm::vec4 cornerRadius;
+			int isText;
 		};
 
-		struct Batch
+		struct DrawCommand
 		{
-			std::shared_ptr<Buffer> vertexBuffer;
-			std::shared_ptr<Buffer> indexBuffer;
+			uint32_t firstQuad = 0;
+			uint32_t quadCount = 0;
+			void* textureId = nullptr;
+
+			std::optional<RenderPass::Scissors> scissors;
+		};
+
+		struct CanvasBatch
+		{
+			std::shared_ptr<Buffer> instanceBuffer;
 			std::shared_ptr<Buffer> uniformBuffer;
 			std::shared_ptr<UniformWriter> uniformWriter;
 
-			struct DrawCommand
-			{
-				size_t indexBufferOffset = 0;
-				int indexCount = 0;
-
-				uint32_t quadCount = 0;
-				void* textureId = nullptr;
+			/**
+			 * Copy of the instances in the buffer, the next build is compared against it.
+			 */
+			std::vector<QuadInstance> quadInstances;
+			std::vector<DrawCommand> drawCommands;
 
-				std::optional<RenderPass::Scissors> scissors;
-			};
+			/**
+			 * The font replaces the atlas texture when it grows, recorded draws keep using the previous one.
+			 */
+			std::vector<std::shared_ptr<Texture>> retainedTextures;
 
-			std::vector<DrawCommand> drawCommands;
+			/**
+			 * Hash of the render commands the quads were built from.
+			 */
+			std::optional<size_t> hash;
+			glm::ivec2 size = { 0, 0 };
+			bool isUsed = false;
 		};
 
-		std::vector<Batch> m_Batches;
+		/**
+		 * Creates and resizes the frame buffers of the canvases outside of the main viewport
+		 * and shows them on the material of their Renderer3D.
+		 */
+		void UpdateFrameBuffers(const RenderSnapshot& snapshot, const RenderPass::RenderCallbackInfo& renderInfo);
+
+		void RenderCanvas(
+			const entt::entity entity,
+			const glm::ivec2& size,
+			const Clay_RenderCommandArray& commands,
+			const RenderPass::RenderCallbackInfo& renderInfo,
+			std::shared_ptr<Pipeline> pipeline);
+
+		void Build(CanvasBatch& batch, const Clay_RenderCommandArray& commands);
+
+		/**
+		 * Writes the instances that differ from the previous build, the buffer grows to the next power of two.
+		 */
+		void Upload(CanvasBatch& batch);
+
+		void DrawQuad(
+			const glm::vec2& position,
+			const glm::vec2& size,
+			const glm::vec2& uvMin,
+			const glm::vec2& uvMax,
+			const glm::vec4& color,
+			const glm::vec4& cornerRadius,
+			void* texture,
+			const bool isText);
+
+		void RecordPreviousDrawCommand(CanvasBatch& batch);
+
+		void ProcessCommand(CanvasBatch& batch, const Clay_RenderCommand& renderCommand);
+
+		CanvasBatch& GetOrCreateBatch(const entt::entity entity, std::shared_ptr<Pipeline> pipeline);
+
+		std::unordered_map<entt::entity, CanvasBatch> m_Batches;
+
+		/**
+		 * Kept while the canvas is outside of the main viewport, also when it has nothing to draw.
+		 */
+		std::unordered_map<entt::entity, std::shared_ptr<class FrameBuffer>> m_FrameBuffers;
 
-		Batch& GetOrCreateBatch(const uint32_t batchIndex, std::shared_ptr<Pipeline> pipeline);
+		/**
+		 * Shared by all quads, the corner of a quad is its vertex index.
+		 */
+		std::shared_ptr<Buffer> m_QuadIndexBuffer;
 
 		std::vector<QuadInstance> m_QuadInstances;
-		std::vector<QuadVertex> m_QuadVertices;
-		std::vector<uint32_t> m_QuadIndices;
-		uint32_t m_QuadCount = 0;
 		void* m_CurrentTextureId = nullptr;
 		void* m_WhiteTexture = nullptr;
 		std::optional<RenderPass::Scissors> m_Scissors;
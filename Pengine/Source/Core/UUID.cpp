@@ -1,43 +1,139 @@
 #include "UUID.h"
 
-#include "RandomGenerator.h"
+#include <cassert>
+#include <charconv>
+#include <chrono>
+#include <stdexcept>
+#include <thread>
 
-#include "../Utils/Utils.h"
+namespace
+{
+	uint64_t SplitMix64(uint64_t& state)
+	{
+		uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+		z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+		z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+		return z ^ (z >> 31);
+	}
+
+	/**
+	 * xoshiro256**, one per thread so generation never waits for other threads.
+	 */
+	class Random
+	{
+	public:
+		Random()
+		{
+			// The random device can be deterministic on some platforms, the thread and the time make the seeds differ anyway.
+			std::random_device randomDevice;
+			uint64_t seed = (static_cast<uint64_t>(randomDevice()) << 32) | randomDevice();
+			seed ^= std::hash<std::thread::id>()(std::this_thread::get_id());
+			seed ^= static_cast<uint64_t>(std::chrono::high_resolution_clock::now().time_since_epoch().count());
+
+			for (uint64_t& state : m_State)
+			{
+				state = SplitMix64(seed) ^ ((static_cast<uint64_t>(randomDevice()) << 32) | randomDevice());
+			}
+		}
+
+		uint64_t Next()
+		{
+			const uint64_t result = Rotate(m_State[1] * 5, 7) * 9;
+			const uint64_t t = m_State[1] << 17;
+
+			m_State[2] ^= m_State[0];
+			m_State[3] ^= m_State[1];
+			m_State[1] ^= m_State[2];
+			m_State[0] ^= m_State[3];
+			m_State[2] ^= t;
+			m_State[3] = Rotate(m_State[3], 45);
+
+			return result;
+		}
+
+	private:
+		static uint64_t Rotate(const uint64_t x, const int k)
+		{
+			return (x << k) | (x >> (64 - k));
+		}
+
+		uint64_t m_State[4];
+	};
+
+	Random& GetRandom()
+	{
+		thread_local Random random;
+		return random;
+	}
+
+	uint64_t ParseHex(const std::string& string, const size_t offset)
+	{
+		uint64_t value = 0;
+		const char* begin = string.data() + offset;
+		const char* end = begin + 16;
+		const auto [ptr, errorCode] = std::from_chars(begin, end, value, 16);
+		if (errorCode != std::errc() || ptr != end)
+		{
+			throw std::runtime_error("Not a valid UUID");
+		}
+
+		return value;
+	}
+
+	void WriteHex(uint64_t value, char* chars)
+	{
+		constexpr char digits[] = "0123456789abcdef";
+		for (int i = 15; i >= 0; i--)
+		{
+			chars[i] = digits[value & 0x0F];
+			value >>= 4;
+		}
+	}
+}
 
 namespace Pengine
 {
 	uint64_t UUID::Generate()
 	{
-		RandomGenerator& random = RandomGenerator::GetInstance();
-		NibblePacker packer;
+		return GetRandom().Next();
+	}
 
-		for (size_t i = 0; i < 16; i++)
-		{
-			packer.Pack(random.Get<short>(0, 15));
-		}
+	UUID UUID::GenerateTimeOrdered()
+	{
+		const uint64_t milliseconds = std::chrono::duration_cast<std::chrono::milliseconds>(
+			std::chrono::system_clock::now().time_since_epoch()).count();
+
+		Random& random = GetRandom();
+
+		// 48 bits of time, version 7, 12 random bits | variant 0b10, 62 random bits.
+		const uint64_t upper = (milliseconds << 16) | (0x7ull << 12) | (random.Next() & 0x0FFF);
+		const uint64_t lower = (0x2ull << 62) | (random.Next() >> 2);
 
-		return packer.Get();
+		return UUID(upper, lower);
 	}
 
 	UUID UUID::FromString(const std::string& string)
 	{
-		// UUID string have to have two hex uint64_t, each one has 16 digits!
+		// UUID string have to have two hex uint64_t after 0x, each one has 16 digits!
 		assert(string.size() == 34);
 
-		// The first characters are 0x
-
-		const std::string upperUUIDString = string.substr(2, 16);
-		const std::string lowerUUIDString = string.substr(18, 16);
-		const uint64_t upper = Utils::stringToUint64(upperUUIDString, 16);
-		const uint64_t lower = Utils::stringToUint64(lowerUUIDString, 16);
+		if (string.size() != 34)
+		{
+			throw std::runtime_error("Not a valid UUID");
+		}
 
-		return UUID(upper, lower);
+		return UUID(ParseHex(string, 2), ParseHex(string, 18));
 	}
 
 	UUID::UUID()
 	{
-		m_Upper = Generate();
-		m_Lower = Generate();
+		Random& random = GetRandom();
+		do
+		{
+			m_Upper = random.Next();
+			m_Lower = random.Next();
+		}
+		while (!IsValid());
 	}
 
 	UUID& UUID::operator=(const UUID& uuid)
@@ -62,39 +158,12 @@ namespace Pengine
 
 	std::string UUID::ToString() const
 	{
-		std::stringstream stringstream;
-		stringstream << "0x"
-			<< std::hex << std::setw(16) << std::setfill('0')
-			<< std::nouppercase
-			<< static_cast<unsigned long long>(GetUpper())
-			<< std::hex << std::setw(16) << std::setfill('0')
-			<< std::nouppercase
-			<< static_cast<unsigned long long>(GetLower());
-
-		std::string string = stringstream.str();
-
-		// UUID string have to have two hex uint64_t, each one has 16 digits!
-		assert(string.size() == 34);
+		std::string string(34, '0');
+		string[1] = 'x';
+		WriteHex(GetUpper(), string.data() + 2);
+		WriteHex(GetLower(), string.data() + 18);
 
 		return string;
 	}
 
-	void UUID::NibblePacker::Reset()
-	{
-		m_Packed = 0;
-		m_Position = 0;
-	}
-
-	void UUID::NibblePacker::Pack(uint8_t byte, BitsType bitsType)
-	{
-			if (m_Position >= 64) return;
-
-			uint8_t nibble = bitsType == BitsType::Upper ?
-				(byte >> 4) & 0x0F :  // Upper 4 bits
-				byte & 0x0F;          // Lower 4 bits
-
-			m_Packed |= static_cast<uint64_t>(nibble) << (60 - m_Position);
-			m_Position += 4;
-	}
-
 }
@@ -1,6 +1,8 @@
 #pragma once
 
+#include <cstdint>
 #include <random>
+#include <string>
 
 namespace Pengine
 {
@@ -8,10 +10,22 @@ namespace Pengine
 	class UUID
 	{
 	public:
+		/**
+		 * Random 64 bits from the generator of the calling thread.
+		 */
 		static uint64_t Generate();
 
+		/**
+		 * UUIDv7 layout, the upper half starts with the unix time in milliseconds,
+		 * so ids generated one after another are close to each other in ordered containers.
+		 */
+		static UUID GenerateTimeOrdered();
+
 		static UUID FromString(const std::string& string);
 
+		/**
+		 * Random 128 bits, generated in one call without any locking.
+		 */
 		UUID();
 
 		UUID(uint64_t upper, uint64_t lower)
@@ -50,37 +64,15 @@ namespace Pengine
 	private:
 		uint64_t m_Upper = 0;
 		uint64_t m_Lower = 0;
-
-		class NibblePacker
-		{
-		private:
-			uint64_t m_Packed = 0;
-			int m_Position = 0;
-
-		public:
-			enum class BitsType
-			{
-				Upper,
-				Lower,
-			};
-
-			void Reset();
-
-			void Pack(uint8_t byte, BitsType bitsType = BitsType::Lower);
-
-			uint64_t Get() const { return m_Packed; }
-
-			int Remaining() const { return (64 - m_Position) / 4; }
-		};
 	};
 
 	struct uuid_hash
 	{
 		std::size_t operator()(const UUID& uuid) const
 		{
-			const uint64_t a = uuid.GetUpper();
-			const uint64_t b = uuid.GetLower();
-			return ((a + b) / 2 * (a + b + 1)) + b;
+			// The upper half of time ordered ids changes slowly, so it is multiplied to spread it over all bits.
+			const uint64_t hash = uuid.GetLower() ^ (uuid.GetUpper() * 0x9E3779B97F4A7C15ull);
+			return static_cast<std::size_t>(hash ^ (hash >> 32));
 		}
 	};
 
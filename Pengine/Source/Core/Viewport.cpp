@@ -83,18 +83,17 @@ void Viewport::Update(const std::shared_ptr<Texture>& viewportTexture, std::shar
 								const glm::vec3 ray = GetMouseRay(m_MousePosition);
 
 								const glm::vec3 start = camera->GetComponent<Transform>().GetPosition();
-								const auto hits = Raycast::RaycastScene(camera->GetScene(), start, ray, camera->GetComponent<Camera>().GetZFar());
-								if (!hits.empty())
+								Raycast::SceneHit hit{};
+								if (Raycast::RaycastScene(camera->GetScene(), { start, ray, camera->GetComponent<Camera>().GetZFar() }, {}, hit))
 								{
-									entity->GetComponent<Transform>().Translate(hits.begin()->first.point);
+									entity->GetComponent<Transform>().Translate(hit.hit.point);
 								}
 							}
 						}
 					}
 				};
 
-				std::shared_ptr<NextFrameEvent> event = std::make_shared<NextFrameEvent>(callback, Event::Type::OnNextFrame, this);
-				EventSystem::GetInstance().SendEvent(event);
+				EventSystem::GetInstance().SendEvent(NextFrameEvent{ std::move(callback), this });
 			}
 			else if (FileFormats::Scene() == Utils::GetFileFormat(path))
 			{
@@ -108,8 +107,7 @@ void Viewport::Update(const std::shared_ptr<Texture>& viewportTexture, std::shar
 					Serializer::DeserializeScene(path);
 				};
 
-				std::shared_ptr<NextFrameEvent> event = std::make_shared<NextFrameEvent>(callback, Event::Type::OnNextFrame, this);
-				EventSystem::GetInstance().SendEvent(event);
+				EventSystem::GetInstance().SendEvent(NextFrameEvent{ std::move(callback), this });
 			}
 			else if (FileFormats::Mat() == Utils::GetFileFormat(path))
 			{
@@ -121,10 +119,11 @@ void Viewport::Update(const std::shared_ptr<Texture>& viewportTexture, std::shar
 						{
 							const glm::vec3 ray = GetMouseRay(m_MousePosition);
 
-							const auto hits = Raycast::RaycastScene(camera->GetScene(), camera->GetComponent<Transform>().GetPosition(), ray, camera->GetComponent<Camera>().GetZFar());
-							if (!hits.empty())
+							const std::shared_ptr<Scene> currentScene = camera->GetScene();
+							Raycast::SceneHit hit{};
+							if (Raycast::RaycastScene(currentScene, { camera->GetComponent<Transform>().GetPosition(), ray, camera->GetComponent<Camera>().GetZFar() }, {}, hit))
 							{
-								std::shared_ptr<Entity> entity = hits.begin()->second;
+								std::shared_ptr<Entity> entity = currentScene->GetRegistry().get<Transform>(hit.entity).GetEntity();
 								if (entity->HasComponent<Renderer3D>())
 								{
 									std::shared_ptr<Material> material = MaterialManager::GetInstance().LoadMaterial(path);
@@ -138,8 +137,7 @@ void Viewport::Update(const std::shared_ptr<Texture>& viewportTexture, std::shar
 					}
 				};
 
-				std::shared_ptr<NextFrameEvent> event = std::make_shared<NextFrameEvent>(callback, Event::Type::OnNextFrame, this);
-				EventSystem::GetInstance().SendEvent(event);
+				EventSystem::GetInstance().SendEvent(NextFrameEvent{ std::move(callback), this });
 			}
 			else if (FileFormats::Mesh() == Utils::GetFileFormat(path))
 			{
@@ -152,11 +150,11 @@ void Viewport::Update(const std::shared_ptr<Texture>& viewportTexture, std::shar
 							const glm::vec3 ray = GetMouseRay(m_MousePosition);
 
 							const glm::vec3 start = camera->GetComponent<Transform>().GetPosition();
-							const auto hits = Raycast::RaycastScene(camera->GetScene(), start, ray, camera->GetComponent<Camera>().GetZFar());
+							Raycast::SceneHit hit{};
 							glm::vec3 position{};
-							if (!hits.empty())
+							if (Raycast::RaycastScene(camera->GetScene(), { start, ray, camera->GetComponent<Camera>().GetZFar() }, {}, hit))
 							{
-								position = hits.begin()->first.point;
+								position = hit.hit.point;
 							}
 
 							std::shared_ptr<Mesh> mesh = MeshManager::GetInstance().LoadMesh(path);
@@ -182,8 +180,7 @@ void Viewport::Update(const std::shared_ptr<Texture>& viewportTexture, std::shar
 					}
 				};
 
-				std::shared_ptr<NextFrameEvent> event = std::make_shared<NextFrameEvent>(callback, Event::Type::OnNextFrame, this);
-				EventSystem::GetInstance().SendEvent(event);
+				EventSystem::GetInstance().SendEvent(NextFrameEvent{ std::move(callback), this });
 			}
 		}
 
@@ -201,8 +198,7 @@ void Viewport::Update(const std::shared_ptr<Texture>& viewportTexture, std::shar
 				}
 			};
 
-			std::shared_ptr<NextFrameEvent> event = std::make_shared<NextFrameEvent>(callback, Event::Type::OnNextFrame, this);
-			EventSystem::GetInstance().SendEvent(event);
+			EventSystem::GetInstance().SendEvent(NextFrameEvent{ std::move(callback), this });
 		}
 
 		ImGui::EndDragDropTarget();
@@ -247,10 +243,10 @@ void Viewport::Update(const std::shared_ptr<Texture>& viewportTexture, std::shar
 		{
 			const glm::vec3 ray = GetMouseRay(m_MousePosition);
 
-			const auto hits = Raycast::RaycastScene(scene, camera->GetComponent<Transform>().GetPosition(), ray, camera->GetComponent<Camera>().GetZFar());
-			if (!hits.empty())
+			Raycast::SceneHit hit{};
+			if (Raycast::RaycastScene(scene, { camera->GetComponent<Transform>().GetPosition(), ray, camera->GetComponent<Camera>().GetZFar() }, {}, hit))
 			{
-				std::shared_ptr<Entity> entity = hits.begin()->second;
+				std::shared_ptr<Entity> entity = scene->GetRegistry().get<Transform>(hit.entity).GetEntity();
 				std::shared_ptr<Entity> parent = entity->GetTopEntity();
 				if (entity != parent && !scene->GetSelectedEntities().count(parent))
 				{
@@ -321,8 +317,7 @@ void Viewport::Resize(const glm::ivec2& size)
 		camera->GetComponent<Camera>().ResizeRenderView(m_Name, m_Size);
 	}
 	
-	std::shared_ptr<ResizeEvent> event = std::make_shared<ResizeEvent>(size, m_Name, Event::Type::OnResize, this);
-	EventSystem::GetInstance().SendEvent(event);
+	EventSystem::GetInstance().SendEvent(ResizeEvent{ size, m_Name, this });
 }
 
 void Viewport::UpdateProjectionMat4()
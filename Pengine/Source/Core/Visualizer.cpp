@@ -15,9 +15,17 @@ void Visualizer::DrawLine(
 	line.end = end;
 	line.color = color;
 	line.duration = duration;
+
+	std::lock_guard<std::mutex> lock(m_Mutex);
 	m_Lines.emplace(line);
 }
 
+std::queue<Line> Visualizer::TakeLines()
+{
+	std::lock_guard<std::mutex> lock(m_Mutex);
+	return std::exchange(m_Lines, {});
+}
+
 void Visualizer::DrawBox(
 	const glm::vec3& min,
 	const glm::vec3& max,
@@ -354,7 +362,7 @@ void Visualizer::DrawFrustum(std::array<glm::vec4, 6> planes, const glm::vec3& c
 
 		if (fabs(det) < 1e-8f)
 		{
-			Logger::Warning(std::format("DrawFrustum::planeIntersection(): Degenerate intersection! Det = {}", det));
+			Logger::Warning("DrawFrustum::planeIntersection(): Degenerate intersection! Det = {}", det);
 			return glm::vec3(0.0f);
 		}
 
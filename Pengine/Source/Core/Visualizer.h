@@ -63,10 +63,14 @@ namespace Pengine
 			const glm::vec3& color,
 			float duration = 0.0f);
 
-		std::queue<Line>& GetLines() { return m_Lines; }
+		/**
+		 * Returns the lines drawn since the last call, lines can be drawn from the scene update and the passes at the same time.
+		 */
+		std::queue<Line> TakeLines();
 
 	private:
 		std::queue<Line> m_Lines;
+		std::mutex m_Mutex;
 	};
 
 }
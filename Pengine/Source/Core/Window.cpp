@@ -48,8 +48,7 @@ bool Window::Resize(const glm::ivec2& size)
 		return false;
 	}
 
-	std::shared_ptr<ResizeEvent> event = std::make_shared<ResizeEvent>(size, m_Name, Event::Type::OnResize, this);
-	EventSystem::GetInstance().SendEvent(event);
+	EventSystem::GetInstance().SendEvent(ResizeEvent{ size, m_Name, this });
 
 	return true;
 }
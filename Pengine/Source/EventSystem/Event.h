@@ -5,10 +5,17 @@
 namespace Pengine
 {
 
+	using EventId = uint32_t;
+
+	/**
+	 * Events are plain structs sent by value, each declares its compile-time id:
+	 * static constexpr EventId id = ...;
+	 * Engine events take their id from Event::Type, application events use ids from Event::userId up to Event::maxId.
+	 */
 	class PENGINE_API Event
 	{
 	public:
-		enum class Type
+		enum class Type : EventId
 		{
 			OnStart,
 			OnUpdate,
@@ -19,25 +26,14 @@ namespace Pengine
 			OnSetScroll
 		};
 
-		[[nodiscard]] Type GetType() const { return m_Type; }
-
-		[[nodiscard]] void* GetSender() const { return m_Sender; }
-
-		[[nodiscard]] bool GetSendedOnce() const { return m_SendedOnce; }
-
-		Event(const Type type, void* sender, const bool sendedOnce = false)
-			: m_Sender(sender)
-			, m_Type(type)
-			, m_SendedOnce(sendedOnce)
-		{
-		}
-
-		virtual ~Event() = default;
-
-	private:
-		void* m_Sender = nullptr;
-		Type m_Type = Type::OnStart;
-		bool m_SendedOnce = false;
+		static constexpr EventId userId = 64;
+		static constexpr EventId maxId = 256;
 	};
 
-}
\ No newline at end of file
+	template<typename T>
+	concept EventType = requires
+	{
+		{ T::id } -> std::convertible_to<EventId>;
+	} && T::id < Event::maxId;
+
+}
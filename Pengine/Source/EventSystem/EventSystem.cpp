@@ -2,27 +2,37 @@
 
 #include "NextFrameEvent.h"
 
+#include "../Core/Profiler.h"
+
 using namespace Pengine;
 
-void EventSystem::DispatchEvent(std::shared_ptr<Event> event)
+EventSystem::EventSystem()
 {
-	if (event->GetType() == Event::Type::OnNextFrame)
+	for (Arena& arena : m_Arenas)
 	{
-		std::dynamic_pointer_cast<NextFrameEvent>(event)->Run();
-		return;
+		std::unique_ptr<Chunk> chunk = std::make_unique<Chunk>();
+		chunk->data = std::make_unique<uint8_t[]>(chunkSize);
+		chunk->capacity = chunkSize;
+		arena.currentChunk.store(chunk.get());
+		arena.chunks.emplace_back(std::move(chunk));
 	}
 
-	auto range = m_Database.equal_range(event->GetType());
-	for (auto client = range.first; client != range.second; ++client)
+	m_WriteArena.store(&m_Arenas[0]);
+
+	RegisterClient<NextFrameEvent>(this, [](const NextFrameEvent& event)
 	{
-		(*client).second.callback(event);
-	}
+		event.Run();
+	});
 }
 
 EventSystem::~EventSystem()
 {
-	m_Database.clear();
 	ClearEvents();
+
+	for (std::vector<Listener>& listeners : m_Listeners)
+	{
+		listeners.clear();
+	}
 }
 
 EventSystem& EventSystem::GetInstance()
@@ -31,122 +41,269 @@ EventSystem& EventSystem::GetInstance()
 	return eventSystem;
 }
 
-bool EventSystem::AlreadySended(const std::shared_ptr<Event> event)
+bool EventSystem::AlreadyRegistered(const EventId id, const void* client) const
 {
-	const auto foundEvent = std::find_if(m_CurrentEvents.begin(), m_CurrentEvents.end(),
-		[=](const std::shared_ptr<Event> currentEvent)
+	const bool isRegistered = std::any_of(m_Listeners[id].begin(), m_Listeners[id].end(), [client](const Listener& listener)
 	{
-		return event->GetType() == currentEvent->GetType();
+		return listener.client == client;
 	});
 
-	return foundEvent != m_CurrentEvents.end();
+	return isRegistered || std::any_of(m_PendingListeners.begin(), m_PendingListeners.end(), [id, client](const auto& pendingListener)
+	{
+		return pendingListener.first == id && pendingListener.second.client == client;
+	});
 }
 
-bool EventSystem::AlreadyRegistered(const Event::Type type, const void* client)
+void EventSystem::UnregisterClient(const EventId id, const void* client)
 {
-	bool alreadyRegistered = false;
+	std::erase_if(m_PendingListeners, [id, client](const auto& pendingListener)
+	{
+		return pendingListener.first == id && pendingListener.second.client == client;
+	});
 
-	auto range = m_Database.equal_range(type);
+	std::vector<Listener>& listeners = m_Listeners[id];
+	const auto listener = std::find_if(listeners.begin(), listeners.end(), [client](const Listener& listener)
+	{
+		return listener.client == client;
+	});
 
-	for (auto clientInfo = range.first;
-		clientInfo != range.second; ++clientInfo)
+	if (listener == listeners.end())
 	{
-		if ((*clientInfo).second.client == client)
-		{
-			alreadyRegistered = true;
-			break;
-		}
+		return;
+	}
+
+	if (m_DispatchDepth > 0)
+	{
+		listener->client = nullptr;
+		m_HasUnregisteredListeners = true;
+		return;
 	}
 
-	return alreadyRegistered;
+	listeners.erase(listener);
 }
 
-void EventSystem::SetProcessingEventsEnabled(bool enabled)
+void EventSystem::UnregisterAll(const void* client)
 {
-	m_IsProcessingEvents = enabled;
+	std::erase_if(m_PendingListeners, [client](const auto& pendingListener)
+	{
+		return pendingListener.second.client == client;
+	});
+
+	for (std::vector<Listener>& listeners : m_Listeners)
+	{
+		if (m_DispatchDepth > 0)
+		{
+			for (Listener& listener : listeners)
+			{
+				if (listener.client == client)
+				{
+					listener.client = nullptr;
+					m_HasUnregisteredListeners = true;
+				}
+			}
+
+			continue;
+		}
+
+		std::erase_if(listeners, [client](const Listener& listener)
+		{
+			return listener.client == client;
+		});
+	}
 }
 
-void EventSystem::RegisterClient(Event::Type type, const ClientCreateInfo& info)
+void EventSystem::AddListener(const EventId id, Listener&& listener)
 {
-	if (!info.client || AlreadyRegistered(type, info.client))
+	if (m_DispatchDepth > 0)
 	{
+		m_PendingListeners.emplace_back(id, std::move(listener));
 		return;
 	}
 
-	m_Database.insert(std::make_pair(type, info));
+	m_Listeners[id].emplace_back(std::move(listener));
 }
 
-void EventSystem::UnregisterClient(const Event::Type type, const void* client)
+void EventSystem::ApplyPendingListeners()
 {
-	auto range = m_Database.equal_range(type);
-
-	for (auto clientInfo = range.first; clientInfo != range.second; clientInfo++)
+	if (m_HasUnregisteredListeners)
 	{
-		if ((*clientInfo).second.client == client)
+		for (std::vector<Listener>& listeners : m_Listeners)
 		{
-			m_Database.erase(clientInfo);
-			return;
+			std::erase_if(listeners, [](const Listener& listener)
+			{
+				return listener.client == nullptr;
+			});
 		}
+
+		m_HasUnregisteredListeners = false;
 	}
+
+	for (auto& [id, listener] : m_PendingListeners)
+	{
+		m_Listeners[id].emplace_back(std::move(listener));
+	}
+
+	m_PendingListeners.clear();
 }
 
-void EventSystem::UnregisterAll(const void* client)
+void EventSystem::DispatchEvent(const EventId id, const void* event)
 {
-	if (!m_Database.empty())
+	// Callbacks may register and unregister listeners, the array is left as it is until the outermost dispatch is over.
+	struct DispatchScope
 	{
-		auto clientInfo = m_Database.begin();
-		while (clientInfo != m_Database.end())
+		EventSystem& eventSystem;
+
+		explicit DispatchScope(EventSystem& eventSystem) : eventSystem(eventSystem) { eventSystem.m_DispatchDepth++; }
+
+		~DispatchScope()
 		{
-			if ((*clientInfo).second.client == client)
-			{
-				clientInfo = m_Database.erase(clientInfo);
-			}
-			else
+			if (--eventSystem.m_DispatchDepth == 0)
 			{
-				++clientInfo;
+				eventSystem.ApplyPendingListeners();
 			}
 		}
+	} dispatchScope(*this);
+
+	const std::vector<Listener>& listeners = m_Listeners[id];
+	for (const Listener& listener : listeners)
+	{
+		if (listener.client)
+		{
+			listener.callback(event);
+		}
 	}
 }
 
-void EventSystem::SendEvent(std::shared_ptr<Event> event)
+EventSystem::Record* EventSystem::BeginWrite(const size_t eventSize, Arena*& arena)
 {
-	if (m_IsProcessingEvents == false)
+	const size_t recordSize = sizeof(Record) + (eventSize + alignof(Record) - 1) / alignof(Record) * alignof(Record);
+
+	// The arena can be swapped between loading it and registering the write, then the write goes to the new one.
+	while (true)
 	{
-		return;
+		arena = m_WriteArena.load();
+		arena->writerCount.fetch_add(1);
+		if (m_WriteArena.load() == arena)
+		{
+			break;
+		}
+
+		EndWrite(*arena);
 	}
 
-	if (event->GetSendedOnce())
+	Chunk* chunk = arena->currentChunk.load();
+	while (true)
 	{
-		if (AlreadySended(event))
+		const size_t offset = chunk->head.fetch_add(recordSize);
+		if (offset + recordSize <= chunk->capacity)
 		{
-			return;
+			return new (chunk->data.get() + offset) Record{ nullptr, static_cast<uint32_t>(recordSize) };
 		}
+
+		// Only the write that crosses the end of the chunk fills the rest of it, the processing skips it.
+		if (offset < chunk->capacity)
+		{
+			new (chunk->data.get() + offset) Record{ nullptr, static_cast<uint32_t>(chunk->capacity - offset) };
+		}
+
+		chunk = GrowArena(*arena, chunk, recordSize);
 	}
+}
 
-	m_CurrentEvents.push_back(event);
+void EventSystem::EndWrite(Arena& arena)
+{
+	if (arena.writerCount.fetch_sub(1) == 1)
+	{
+		arena.writerCount.notify_all();
+	}
 }
 
-void EventSystem::ProcessEvents()
+EventSystem::Chunk* EventSystem::GrowArena(Arena& arena, Chunk* fullChunk, const size_t recordSize)
 {
-	if (m_IsProcessingEvents == false)
+	std::lock_guard<std::mutex> lock(arena.growMutex);
+
+	// Another write has already moved to the next chunk.
+	Chunk* currentChunk = arena.currentChunk.load();
+	if (currentChunk != fullChunk)
 	{
-		return;
+		return currentChunk;
+	}
+
+	// Chunks of the previous frames are reused, one too small for the record is replaced.
+	const size_t nextChunkIndex = arena.currentChunkIndex + 1;
+	if (nextChunkIndex == arena.chunks.size() || arena.chunks[nextChunkIndex]->capacity < recordSize)
+	{
+		const size_t capacity = std::max(chunkSize, recordSize);
+
+		std::unique_ptr<Chunk> chunk = std::make_unique<Chunk>();
+		chunk->data = std::make_unique<uint8_t[]>(capacity);
+		chunk->capacity = capacity;
+		arena.chunks.insert(arena.chunks.begin() + nextChunkIndex, std::move(chunk));
 	}
 
-	m_IsDispatchingEvents = true;
+	Chunk* nextChunk = arena.chunks[nextChunkIndex].get();
+	nextChunk->head.store(0);
+
+	arena.currentChunkIndex = nextChunkIndex;
+	arena.currentChunk.store(nextChunk);
+
+	return nextChunk;
+}
 
-	while (!m_CurrentEvents.empty())
+EventSystem::Arena* EventSystem::SwapArenas()
+{
+	Arena* arena = m_WriteArena.load();
+	m_WriteArena.store(arena == &m_Arenas[0] ? &m_Arenas[1] : &m_Arenas[0]);
+
+	uint32_t writerCount;
+	while ((writerCount = arena->writerCount.load()) > 0)
+	{
+		arena->writerCount.wait(writerCount);
+	}
+
+	return arena;
+}
+
+void EventSystem::ProcessArena(Arena& arena, const bool dispatch)
+{
+	for (size_t i = 0; i <= arena.currentChunkIndex; i++)
+	{
+		Chunk& chunk = *arena.chunks[i];
+		const size_t end = std::min(chunk.head.load(), chunk.capacity);
+
+		size_t offset = 0;
+		while (offset < end)
+		{
+			Record* record = reinterpret_cast<Record*>(chunk.data.get() + offset);
+			if (record->function)
+			{
+				record->function(dispatch ? this : nullptr, record + 1);
+			}
+
+			offset += record->size;
+		}
+
+		chunk.head.store(0);
+	}
+
+	arena.currentChunkIndex = 0;
+	arena.currentChunk.store(arena.chunks.front().get());
+}
+
+void EventSystem::ProcessEvents()
+{
+	if (!m_IsProcessingEvents.load())
 	{
-		std::shared_ptr<Event> currentEvent = m_CurrentEvents.front();
-		m_CurrentEvents.pop_front();
-		DispatchEvent(currentEvent);
+		return;
 	}
 
-	m_IsDispatchingEvents = false;
+	PROFILER_SCOPE(__FUNCTION__);
+
+	ProcessArena(*SwapArenas(), true);
 }
 
 void EventSystem::ClearEvents()
 {
-	m_CurrentEvents.clear();
+	// The other arena is always empty, it was reset when it was processed.
+	ProcessArena(*SwapArenas(), false);
 }
@@ -3,53 +3,198 @@
 #include "../Core/Core.h"
 #include "Event.h"
 
-#include <deque>
-
 namespace Pengine
 {
+	/**
+	 * Typed event bus. Listeners are kept in an array per event id and queued events are stored by value
+	 * in a per-frame arena, so sending an event doesn't allocate once the arena has grown.
+	 * Events can be sent from any thread, producers only share an atomic offset into the arena.
+	 * Listeners are registered and deferred events are dispatched on the main thread.
+	 * Listeners registered or unregistered by a callback take effect once the dispatch is over.
+	 */
 	class PENGINE_API EventSystem
 	{
 	public:
-		struct ClientCreateInfo
+		enum class Dispatch
 		{
-			void* client;
-			std::function<void(std::shared_ptr<Event> event)> callback;
+			/**
+			 * Queued and dispatched by the next ProcessEvents().
+			 */
+			Deferred,
+
+			/**
+			 * Dispatched right away on the calling thread.
+			 */
+			Immediate
 		};
 
 		static EventSystem& GetInstance();
 
 		EventSystem(const EventSystem&) = delete;
+		EventSystem& operator=(const EventSystem&) = delete;
+
+		template<EventType T>
+		void RegisterClient(const void* client, std::function<void(const T&)> callback)
+		{
+			if (!client || AlreadyRegistered(T::id, client))
+			{
+				return;
+			}
+
+			AddListener(T::id, Listener{ client, [callback = std::move(callback)](const void* event)
+			{
+				callback(*static_cast<const T*>(event));
+			} });
+		}
+
+		template<EventType T>
+		void UnregisterClient(const void* client) { UnregisterClient(T::id, client); }
 
-		bool AlreadySended(const std::shared_ptr<Event> event);
-		
-		bool AlreadyRegistered(Event::Type type, const void* client);
-		
-		void SetProcessingEventsEnabled(bool enabled);
-		
-		void RegisterClient(Event::Type type, const ClientCreateInfo& info);
+		void UnregisterClient(const EventId id, const void* client);
 
-		void UnregisterClient(Event::Type type, const void* client);
-		
 		void UnregisterAll(const void* client);
-		
-		void SendEvent(std::shared_ptr<Event> event);
 
+		[[nodiscard]] bool AlreadyRegistered(const EventId id, const void* client) const;
+
+		void SetProcessingEventsEnabled(bool enabled) { m_IsProcessingEvents.store(enabled); }
+
+		[[nodiscard]] bool IsProcessingEventsEnabled() const { return m_IsProcessingEvents.load(); }
+
+		template<typename T>
+		requires EventType<std::remove_cvref_t<T>>
+		void SendEvent(T&& event, const Dispatch dispatch = Dispatch::Deferred)
+		{
+			using Type = std::remove_cvref_t<T>;
+			static_assert(alignof(Type) <= alignof(Record), "Event alignment is not supported by the arena!");
+
+			if (!m_IsProcessingEvents.load())
+			{
+				return;
+			}
+
+			if (dispatch == Dispatch::Immediate)
+			{
+				DispatchEvent(Type::id, &event);
+				return;
+			}
+
+			Arena* arena;
+			Record* record = BeginWrite(sizeof(Type), arena);
+			try
+			{
+				new (record + 1) Type(std::forward<T>(event));
+			}
+			catch (...)
+			{
+				// The record stays empty and is skipped.
+				EndWrite(*arena);
+				throw;
+			}
+
+			record->function = [](EventSystem* eventSystem, void* event)
+			{
+				Type* typedEvent = static_cast<Type*>(event);
+				if (eventSystem)
+				{
+					eventSystem->DispatchEvent(Type::id, typedEvent);
+				}
+
+				typedEvent->~Type();
+			};
+
+			EndWrite(*arena);
+		}
+
+		/**
+		 * Dispatches the events sent before the call, events sent by the listeners are dispatched on the next call.
+		 */
 		void ProcessEvents();
-		
+
 		void ClearEvents();
 
 	private:
-		EventSystem() = default;
-		EventSystem& operator=(const EventSystem&) { return *this; }
+		/**
+		 * Dispatches and destroys the event that follows the record, only destroys it when the event system is nullptr.
+		 */
+		using RecordFunction = void(*)(EventSystem* eventSystem, void* event);
+
+		struct alignas(16) Record
+		{
+			RecordFunction function = nullptr;
+			uint32_t size = 0;
+		};
+
+		struct Chunk
+		{
+			std::unique_ptr<uint8_t[]> data;
+			size_t capacity = 0;
+			std::atomic<size_t> head = 0;
+		};
+
+		struct Arena
+		{
+			std::vector<std::unique_ptr<Chunk>> chunks;
+			std::atomic<Chunk*> currentChunk = nullptr;
+			size_t currentChunkIndex = 0;
+			alignas(64) std::atomic<uint32_t> writerCount = 0;
+			std::mutex growMutex;
+		};
+
+		struct Listener
+		{
+			const void* client;
+			std::function<void(const void*)> callback;
+		};
+
+		static constexpr size_t chunkSize = 1024 * 1024;
+
+		EventSystem();
 		~EventSystem();
 
-		void DispatchEvent(std::shared_ptr<Event> event);
+		void DispatchEvent(const EventId id, const void* event);
+
+		/**
+		 * Adds the listener right away, or once the dispatch in progress is over.
+		 */
+		void AddListener(const EventId id, Listener&& listener);
+
+		/**
+		 * Erases the listeners unregistered and adds the ones registered during the dispatch.
+		 */
+		void ApplyPendingListeners();
+
+		/**
+		 * Reserves a record followed by eventSize bytes in the current arena,
+		 * the arena can't be processed until EndWrite() is called.
+		 */
+		Record* BeginWrite(const size_t eventSize, Arena*& arena);
+
+		void EndWrite(Arena& arena);
+
+		Chunk* GrowArena(Arena& arena, Chunk* fullChunk, const size_t recordSize);
+
+		/**
+		 * Takes the arena that is written to and waits for the writes in progress,
+		 * new events go to the other arena from then on.
+		 */
+		Arena* SwapArenas();
+
+		void ProcessArena(Arena& arena, const bool dispatch);
+
+		std::array<std::vector<Listener>, Event::maxId> m_Listeners;
+
+		/**
+		 * While a dispatch is in progress the listener arrays are not resized, unregistered listeners
+		 * get a nullptr client and are skipped, registered ones wait here.
+		 */
+		std::vector<std::pair<EventId, Listener>> m_PendingListeners;
+		uint32_t m_DispatchDepth = 0;
+		bool m_HasUnregisteredListeners = false;
 
-		std::multimap<Event::Type, ClientCreateInfo> m_Database;
-		std::deque<std::shared_ptr<Event>> m_CurrentEvents;
+		Arena m_Arenas[2];
+		std::atomic<Arena*> m_WriteArena = nullptr;
 
-		bool m_IsProcessingEvents = true;
-		bool m_IsDispatchingEvents = false;
+		std::atomic<bool> m_IsProcessingEvents = true;
 	};
 
 }
@@ -6,26 +6,23 @@
 namespace Pengine
 {
 
-	class PENGINE_API NextFrameEvent final : public Event
+	/**
+	 * Runs the callback on the main thread when the events are processed at the start of the next frame.
+	 */
+	struct PENGINE_API NextFrameEvent
 	{
-	public:
-		NextFrameEvent(const std::function<void()>& callback, const Type type,
-			void* sender = nullptr, const bool sendedOnce = false)
-			: Event(type, sender, sendedOnce)
-			, m_Callback(callback)
-		{
-		}
+		static constexpr EventId id = static_cast<EventId>(Event::Type::OnNextFrame);
+
+		std::function<void()> callback;
+		void* sender = nullptr;
 
 		void Run() const
 		{
-			if (m_Callback)
+			if (callback)
 			{
-				m_Callback();
+				callback();
 			}
 		}
-
-	private:
-		std::function<void()> m_Callback;
 	};
 
-}
\ No newline at end of file
+}
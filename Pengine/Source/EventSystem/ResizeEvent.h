@@ -6,24 +6,13 @@
 namespace Pengine
 {
 
-	class PENGINE_API ResizeEvent final : public Event
+	struct PENGINE_API ResizeEvent
 	{
-	public:
-		[[nodiscard]] glm::ivec2 GetSize() const { return m_Size; }
+		static constexpr EventId id = static_cast<EventId>(Event::Type::OnResize);
 
-		[[nodiscard]] std::string GetViewportName() const { return m_ViewportName; }
-
-		ResizeEvent(const glm::ivec2& size, std::string viewportName, const Type type,
-			void* sender = nullptr, const bool sendedOnce = false)
-			: Event(type, sender, sendedOnce)
-			, m_Size(size)
-			, m_ViewportName(std::move(viewportName))
-		{
-		}
-
-	private:
-		glm::ivec2 m_Size;
-		std::string m_ViewportName;
+		glm::ivec2 size{};
+		std::string viewportName;
+		void* sender = nullptr;
 	};
 
-}
\ No newline at end of file
+}
@@ -4,6 +4,7 @@
 #include "../Core/Profiler.h"
 #include "../Core/Serializer.h"
 #include "../Core/TextureManager.h"
+#include "../Core/ThreadPool.h"
 #include "../EventSystem/EventSystem.h"
 #include "../EventSystem/NextFrameEvent.h"
 
@@ -11,6 +12,35 @@
 
 using namespace Pengine;
 
+struct BaseMaterial::PipelineJob
+{
+	std::string passName;
+	Pipeline::UniformInfo uniformInfo;
+	std::function<std::shared_ptr<Pipeline>()> create;
+	std::promise<std::shared_ptr<Pipeline>> promise;
+	std::shared_future<std::shared_ptr<Pipeline>> future = promise.get_future().share();
+	std::atomic<bool> isClaimed = false;
+	bool isPublished = false;
+
+	// Whoever claims the job first compiles it, so waiting for a job no worker has started doesn't depend on the pool.
+	void Run()
+	{
+		if (isClaimed.exchange(true))
+		{
+			return;
+		}
+
+		try
+		{
+			promise.set_value(create());
+		}
+		catch (const std::exception&)
+		{
+			promise.set_value(nullptr);
+		}
+	}
+};
+
 std::shared_ptr<BaseMaterial> BaseMaterial::Create(
 	const std::string& name,
 	const std::filesystem::path& filepath,
@@ -44,8 +74,7 @@ void BaseMaterial::Reload(const std::shared_ptr<BaseMaterial>& baseMaterial)
 
 	};
 
-	std::shared_ptr<NextFrameEvent> event = std::make_shared<NextFrameEvent>(callback, Event::Type::OnNextFrame, baseMaterial.get());
-	EventSystem::GetInstance().SendEvent(event);
+	EventSystem::GetInstance().SendEvent(NextFrameEvent{ std::move(callback), baseMaterial.get() });
 }
 
 BaseMaterial::BaseMaterial(
@@ -292,37 +321,128 @@ std::optional<ShaderReflection::ReflectVariable> BaseMaterial::GetUniformValue(
 
 void BaseMaterial::CreateResources(const CreateInfo& createInfo)
 {
+	std::vector<std::shared_ptr<PipelineJob>> pipelineJobs;
+	pipelineJobs.reserve(createInfo.pipelineCreateGraphicsInfos.size() + createInfo.pipelineCreateComputeInfos.size());
+
+	// The create infos are copied, the jobs may outlive the load that passed them in.
 	for (const GraphicsPipeline::CreateGraphicsInfo& pipelineCreateGraphicsInfo : createInfo.pipelineCreateGraphicsInfos)
 	{
-		const std::string passName = pipelineCreateGraphicsInfo.renderPass->GetName();
+		const std::shared_ptr<PipelineJob>& pipelineJob = pipelineJobs.emplace_back(std::make_shared<PipelineJob>());
+		pipelineJob->passName = pipelineCreateGraphicsInfo.renderPass->GetName();
+		pipelineJob->uniformInfo = pipelineCreateGraphicsInfo.uniformInfo;
+		pipelineJob->create = [pipelineCreateGraphicsInfo]()
+		{
+			return GraphicsPipeline::Create(pipelineCreateGraphicsInfo);
+		};
+	}
+
+	for (const ComputePipeline::CreateComputeInfo& pipelineCreateComputeInfo : createInfo.pipelineCreateComputeInfos)
+	{
+		const std::shared_ptr<PipelineJob>& pipelineJob = pipelineJobs.emplace_back(std::make_shared<PipelineJob>());
+		pipelineJob->passName = pipelineCreateComputeInfo.passName;
+		pipelineJob->uniformInfo = pipelineCreateComputeInfo.uniformInfo;
+		pipelineJob->create = [pipelineCreateComputeInfo]()
+		{
+			return ComputePipeline::Create(pipelineCreateComputeInfo);
+		};
+	}
 
-		try
+	{
+		std::lock_guard<std::mutex> lock(m_PipelineJobsMutex);
+		m_PipelineJobs = pipelineJobs;
+		m_IsReady = false;
+	}
+
+	// Pipelines of different passes don't depend on each other, so they are compiled in parallel and published as they finish.
+	// Worker threads can get here too (e.g. materials generated on import), a job queued behind them in the same pool
+	// may never start, so they compile right away.
+	ThreadPool& threadPool = ThreadPool::GetInstance();
+	const bool compileAsync = threadPool.GetThreadCount() > 0 && !threadPool.IsWorkerThread();
+	for (const std::shared_ptr<PipelineJob>& pipelineJob : pipelineJobs)
+	{
+		if (compileAsync)
 		{
-			const std::shared_ptr<Pipeline> pipeline = GraphicsPipeline::Create(pipelineCreateGraphicsInfo);
-			CreatePipelineResources(passName, pipeline, pipelineCreateGraphicsInfo.uniformInfo);
-			m_PipelinesByPass[passName] = pipeline;
+			threadPool.EnqueueAsync([pipelineJob]()
+			{
+				pipelineJob->Run();
+			});
 		}
-		catch (const std::exception&)
+		else
 		{
-			m_PipelinesByPass[passName] = nullptr;
+			pipelineJob->Run();
 		}
 	}
 
-	for (const ComputePipeline::CreateComputeInfo& pipelineCreateComputeInfo : createInfo.pipelineCreateComputeInfos)
+	// Nothing else sees the material while it is created or reloaded, what is already compiled can be published here.
+	PublishPipelines();
+}
+
+bool BaseMaterial::PublishPipelines()
+{
+	if (m_IsReady)
 	{
-		const std::string passName = pipelineCreateComputeInfo.passName;
+		return true;
+	}
 
-		try
+	std::lock_guard<std::mutex> lock(m_PipelineJobsMutex);
+
+	bool isReady = true;
+	for (const std::shared_ptr<PipelineJob>& pipelineJob : m_PipelineJobs)
+	{
+		if (pipelineJob->isPublished)
 		{
-			const std::shared_ptr<Pipeline> pipeline = ComputePipeline::Create(pipelineCreateComputeInfo);
-			CreatePipelineResources(passName, pipeline, pipelineCreateComputeInfo.uniformInfo);
-			m_PipelinesByPass[passName] = pipeline;
+			continue;
 		}
-		catch (const std::exception&)
+
+		if (pipelineJob->future.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+		{
+			isReady = false;
+			continue;
+		}
+
+		pipelineJob->isPublished = true;
+
+		if (const std::shared_ptr<Pipeline> pipeline = pipelineJob->future.get())
 		{
-			m_PipelinesByPass[passName] = nullptr;
+			try
+			{
+				CreatePipelineResources(pipelineJob->passName, pipeline, pipelineJob->uniformInfo);
+				m_PipelinesByPass[pipelineJob->passName] = pipeline;
+				continue;
+			}
+			catch (const std::exception&)
+			{
+			}
 		}
+
+		m_PipelinesByPass[pipelineJob->passName] = nullptr;
+	}
+
+	m_IsReady = isReady;
+
+	return isReady;
+}
+
+std::unordered_map<std::string, std::shared_ptr<Pipeline>> BaseMaterial::WaitForPipelines() const
+{
+	std::vector<std::shared_ptr<PipelineJob>> pipelineJobs;
+	{
+		std::lock_guard<std::mutex> lock(m_PipelineJobsMutex);
+		pipelineJobs = m_PipelineJobs;
+	}
+
+	for (const std::shared_ptr<PipelineJob>& pipelineJob : pipelineJobs)
+	{
+		pipelineJob->Run();
 	}
+
+	std::unordered_map<std::string, std::shared_ptr<Pipeline>> pipelinesByPass;
+	for (const std::shared_ptr<PipelineJob>& pipelineJob : pipelineJobs)
+	{
+		pipelinesByPass[pipelineJob->passName] = pipelineJob->future.get();
+	}
+
+	return pipelinesByPass;
 }
 
 void BaseMaterial::CreatePipelineResources(
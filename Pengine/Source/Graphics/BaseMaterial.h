@@ -39,10 +39,30 @@ namespace Pengine
 		BaseMaterial(const BaseMaterial&) = delete;
 		BaseMaterial& operator=(const BaseMaterial&) = delete;
 
+		/**
+		 * Returns nullptr for a pass whose pipeline failed or is still compiling, draws skip the material until it is published.
+		 */
 		std::shared_ptr<Pipeline> GetPipeline(const std::string& passName) const;
 
+		/**
+		 * Only the published pipelines, see WaitForPipelines.
+		 */
 		std::unordered_map<std::string, std::shared_ptr<Pipeline>> GetPipelinesByPass() const { return m_PipelinesByPass; }
 
+		/**
+		 * Publishes the pipelines that finished compiling together with their uniform writers and buffers,
+		 * called on the main thread by MaterialManager::Update. Returns true once every pipeline is published.
+		 */
+		bool PublishPipelines();
+
+		/**
+		 * Compiles the pipelines no worker has started yet on the calling thread and waits for the rest.
+		 * Returns every pipeline by pass whether it is published or not, failed ones are nullptr.
+		 */
+		std::unordered_map<std::string, std::shared_ptr<Pipeline>> WaitForPipelines() const;
+
+		[[nodiscard]] bool IsReady() const { return m_IsReady.load(); }
+
 		std::shared_ptr<UniformWriter> GetUniformWriter(const std::string& passName) const;
 
 		std::shared_ptr<Buffer> GetBuffer(const std::string& name) const;
@@ -125,6 +145,8 @@ namespace Pengine
 		}
 
 	private:
+		struct PipelineJob;
+
 		void CreateResources(const CreateInfo& createInfo);
 
 		void CreatePipelineResources(
@@ -136,6 +158,10 @@ namespace Pengine
 		std::unordered_map<std::string, std::shared_ptr<UniformWriter>> m_UniformWriterByPass;
 		std::unordered_map<std::string, std::shared_ptr<Buffer>> m_BuffersByName;
 
+		std::vector<std::shared_ptr<PipelineJob>> m_PipelineJobs;
+		mutable std::mutex m_PipelineJobsMutex;
+		std::atomic<bool> m_IsReady = false;
+
 		mutable std::mutex m_UniformCacheMutex;
 		// map<BufferName, map<ValueName, <Size, Offset>>>
 		mutable std::unordered_map<std::string, std::unordered_map<std::string, std::pair<uint32_t, uint32_t>>> m_UniformsCache;
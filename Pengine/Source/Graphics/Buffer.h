@@ -13,7 +13,13 @@ namespace Pengine
 			UNIFORM_BUFFER,
 			VERTEX_BUFFER,
 			INDEX_BUFFER,
-			STORAGE_BUFFER
+			STORAGE_BUFFER,
+
+			/**
+			 * Vertex buffer that compute shaders can also read or write as a storage buffer,
+			 * not multibuffered unless requested.
+			 */
+			STORAGE_VERTEX_BUFFER
 		};
 
 		static std::shared_ptr<Buffer> Create(
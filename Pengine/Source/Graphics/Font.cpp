@@ -0,0 +1,160 @@
+#include "Font.h"
+
+#include "Texture.h"
+
+#include "../Core/Logger.h"
+#include "../Utils/Utils.h"
+
+#include <freetype/include/ft2build.h>
+#include FT_FREETYPE_H
+#include FT_MODULE_H
+
+using namespace Pengine;
+
+Font::Font(const std::filesystem::path& filepath, const uint16_t id)
+	: m_Atlas({ 256, 256 }, 4096, 1)
+	, m_Name(Utils::GetFilename(filepath))
+	, m_Filepath(filepath)
+	, m_Id(id)
+{
+	if (FT_Init_FreeType(&m_Library))
+	{
+		FATAL_ERROR("Failed to initialize font library!");
+	}
+
+	FT_Int spread = sdfSpread;
+	FT_Property_Set(m_Library, "sdf", "spread", &spread);
+	FT_Property_Set(m_Library, "bsdf", "spread", &spread);
+
+	const FT_Error error = FT_New_Face(m_Library, filepath.string().c_str(), 0, &m_Face);
+	if (error)
+	{
+		FT_Done_FreeType(m_Library);
+		m_Library = nullptr;
+
+		if (error == FT_Err_Unknown_File_Format)
+		{
+			FATAL_ERROR("Failed to load font, the file format is not supported!");
+		}
+
+		FATAL_ERROR("Failed to load font!");
+	}
+
+	if (FT_Set_Pixel_Sizes(m_Face, 0, sdfSize))
+	{
+		FT_Done_Face(m_Face);
+		FT_Done_FreeType(m_Library);
+		m_Face = nullptr;
+		m_Library = nullptr;
+
+		FATAL_ERROR("Failed to set pixel sizes!");
+	}
+}
+
+Font::~Font()
+{
+	if (m_Face)
+	{
+		FT_Done_Face(m_Face);
+	}
+
+	if (m_Library)
+	{
+		FT_Done_FreeType(m_Library);
+	}
+}
+
+Font::Glyph Font::GetGlyph(const uint32_t codepoint)
+{
+	std::lock_guard<std::mutex> lock(m_Mutex);
+
+	if (const auto glyphByCodepoint = m_Glyphs.find(codepoint);
+		glyphByCodepoint != m_Glyphs.end())
+	{
+		return glyphByCodepoint->second;
+	}
+
+	const Glyph glyph = RasteriseGlyph(codepoint);
+	m_Glyphs.emplace(codepoint, glyph);
+
+	return glyph;
+}
+
+bool Font::HasGlyph(const uint32_t codepoint) const
+{
+	std::lock_guard<std::mutex> lock(m_Mutex);
+	return FT_Get_Char_Index(m_Face, codepoint) != 0;
+}
+
+size_t Font::GetGlyphCount() const
+{
+	std::lock_guard<std::mutex> lock(m_Mutex);
+	return m_Glyphs.size();
+}
+
+std::shared_ptr<Texture> Font::GetAtlasTexture()
+{
+	std::lock_guard<std::mutex> lock(m_Mutex);
+
+	if (m_AtlasTexture && m_AtlasTextureVersion == m_Atlas.GetVersion())
+	{
+		return m_AtlasTexture;
+	}
+
+	// The previous texture stays alive while it is referenced by recorded draws.
+	Texture::CreateInfo createInfo{};
+	createInfo.aspectMask = Texture::AspectMask::COLOR;
+	createInfo.instanceSize = sizeof(uint8_t);
+	createInfo.filepath = m_Filepath;
+	createInfo.name = m_Name;
+	createInfo.format = Format::R8_UNORM;
+	createInfo.size = m_Atlas.GetSize();
+	createInfo.usage = { Texture::Usage::SAMPLED, Texture::Usage::TRANSFER_DST };
+	createInfo.samplerCreateInfo.addressMode = Texture::SamplerCreateInfo::AddressMode::CLAMP_TO_EDGE;
+	createInfo.data = const_cast<uint8_t*>(m_Atlas.GetPixels().data());
+
+	m_AtlasTexture = Texture::Create(createInfo);
+	m_AtlasTextureVersion = m_Atlas.GetVersion();
+
+	return m_AtlasTexture;
+}
+
+Font::Glyph Font::RasteriseGlyph(const uint32_t codepoint)
+{
+	Glyph glyph{};
+
+	if (FT_Load_Char(m_Face, codepoint, FT_LOAD_DEFAULT))
+	{
+		Logger::Error(m_Name + ": Failed to load glyph " + std::to_string(codepoint) + "!");
+		return glyph;
+	}
+
+	const FT_GlyphSlot slot = m_Face->glyph;
+	glyph.advance = static_cast<int>(slot->advance.x >> 6);
+	glyph.height = static_cast<int>(slot->metrics.horiBearingY >> 6);
+
+	// Whitespace has no outline, only the advance is needed.
+	if (slot->format == FT_GLYPH_FORMAT_OUTLINE && slot->outline.n_points == 0)
+	{
+		return glyph;
+	}
+
+	if (FT_Render_Glyph(slot, FT_RENDER_MODE_SDF))
+	{
+		Logger::Error(m_Name + ": Failed to render glyph " + std::to_string(codepoint) + "!");
+		return glyph;
+	}
+
+	const glm::ivec2 size = { slot->bitmap.width, slot->bitmap.rows };
+	const std::optional<FontAtlas::Rect> rect = m_Atlas.Add(size, slot->bitmap.buffer, slot->bitmap.pitch);
+	if (!rect)
+	{
+		Logger::Error(m_Name + ": Font atlas is full, glyph " + std::to_string(codepoint) + " is skipped!");
+		return glyph;
+	}
+
+	glyph.rect = *rect;
+	glyph.bearing = { slot->bitmap_left, slot->bitmap_top };
+
+	return glyph;
+}
@@ -0,0 +1,101 @@
+#pragma once
+
+#include "../Core/Core.h"
+
+#include "FontAtlas.h"
+
+#include <mutex>
+
+struct FT_LibraryRec_;
+struct FT_FaceRec_;
+
+namespace Pengine
+{
+
+	class Texture;
+
+	/**
+	 * Signed distance field glyphs of one font face in one growable atlas.
+	 * Glyphs are rasterised on first use at sdfSize pixels and drawn at any size by scaling the quads.
+	 * Glyph metrics are in pixels at sdfSize, GetScale() converts them to a font size.
+	 */
+	class PENGINE_API Font
+	{
+	public:
+		struct Glyph
+		{
+			/**
+			 * Bitmap rectangle in the atlas, includes the distance field spread around the outline.
+			 */
+			FontAtlas::Rect rect;
+			glm::ivec2 bearing = { 0, 0 };
+
+			/**
+			 * Height of the outline above the baseline, without the spread.
+			 */
+			int height = 0;
+			int advance = 0;
+		};
+
+		/**
+		 * Pixel size the distance fields are rasterised at.
+		 */
+		static constexpr uint16_t sdfSize = 48;
+
+		/**
+		 * Distance in pixels at sdfSize covered by the field on each side of the outline.
+		 */
+		static constexpr int sdfSpread = 6;
+
+		Font(const std::filesystem::path& filepath, const uint16_t id);
+		~Font();
+		Font(const Font&) = delete;
+		Font& operator=(const Font&) = delete;
+
+		/**
+		 * Rasterises the glyph if it is used for the first time. Code points missing in the face get the .notdef glyph.
+		 */
+		Glyph GetGlyph(const uint32_t codepoint);
+
+		[[nodiscard]] bool HasGlyph(const uint32_t codepoint) const;
+
+		[[nodiscard]] size_t GetGlyphCount() const;
+
+		[[nodiscard]] static float GetScale(const float fontSize) { return fontSize / static_cast<float>(sdfSize); }
+
+		/**
+		 * Creates a new texture if glyphs were added since the last call, so the returned texture matches its own size.
+		 */
+		std::shared_ptr<Texture> GetAtlasTexture();
+
+		/**
+		 * Not synchronized with GetGlyph().
+		 */
+		[[nodiscard]] const FontAtlas& GetAtlas() const { return m_Atlas; }
+
+		[[nodiscard]] const std::string& GetName() const { return m_Name; }
+
+		[[nodiscard]] const std::filesystem::path& GetFilepath() const { return m_Filepath; }
+
+		[[nodiscard]] uint16_t GetId() const { return m_Id; }
+
+	private:
+		Glyph RasteriseGlyph(const uint32_t codepoint);
+
+		FT_LibraryRec_* m_Library = nullptr;
+		FT_FaceRec_* m_Face = nullptr;
+
+		std::unordered_map<uint32_t, Glyph> m_Glyphs;
+		FontAtlas m_Atlas;
+
+		std::shared_ptr<Texture> m_AtlasTexture;
+		uint32_t m_AtlasTextureVersion = 0;
+
+		std::string m_Name;
+		std::filesystem::path m_Filepath;
+		uint16_t m_Id = -1;
+
+		mutable std::mutex m_Mutex;
+	};
+
+}
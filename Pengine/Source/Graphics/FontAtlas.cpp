@@ -0,0 +1,140 @@
+#include "FontAtlas.h"
+
+using namespace Pengine;
+
+FontAtlas::FontAtlas(const glm::ivec2& size, const int maxSize, const int padding)
+	: m_Size(size)
+	, m_MaxSize(maxSize)
+	, m_Padding(padding)
+{
+	m_Pixels.resize(static_cast<size_t>(m_Size.x) * m_Size.y, 0);
+}
+
+std::optional<FontAtlas::Rect> FontAtlas::Add(const glm::ivec2& size, const uint8_t* pixels, const int pitch)
+{
+	if (size.x <= 0 || size.y <= 0)
+	{
+		return Rect{};
+	}
+
+	std::optional<Rect> rect = Pack(size);
+	while (!rect)
+	{
+		if (!Grow())
+		{
+			return std::nullopt;
+		}
+
+		rect = Pack(size);
+	}
+
+	for (int y = 0; y < size.y; y++)
+	{
+		std::memcpy(
+			&m_Pixels[static_cast<size_t>(rect->offset.y + y) * m_Size.x + rect->offset.x],
+			pixels + static_cast<ptrdiff_t>(y) * pitch,
+			size.x);
+	}
+
+	m_PackedArea += static_cast<size_t>(size.x) * size.y;
+	m_Version++;
+
+	return rect;
+}
+
+int FontAtlas::GetUsedHeight() const
+{
+	if (m_Shelves.empty())
+	{
+		return 0;
+	}
+
+	return m_Shelves.back().y + m_Shelves.back().height + m_Padding;
+}
+
+float FontAtlas::GetPackingEfficiency() const
+{
+	size_t shelfArea = 0;
+	for (const Shelf& shelf : m_Shelves)
+	{
+		shelfArea += static_cast<size_t>(shelf.x) * (shelf.height + m_Padding);
+	}
+
+	if (shelfArea == 0)
+	{
+		return 0.0f;
+	}
+
+	return static_cast<float>(m_PackedArea) / static_cast<float>(shelfArea);
+}
+
+std::optional<FontAtlas::Rect> FontAtlas::Pack(const glm::ivec2& size)
+{
+	// The rectangle goes to the shortest shelf it fits in. A new shelf is only opened when no shelf has space,
+	// so short glyphs like punctuation don't get shelves of their own.
+	Shelf* bestShelf = nullptr;
+	for (Shelf& shelf : m_Shelves)
+	{
+		if (shelf.height < size.y || shelf.x + size.x + m_Padding > m_Size.x)
+		{
+			continue;
+		}
+
+		if (!bestShelf || shelf.height < bestShelf->height)
+		{
+			bestShelf = &shelf;
+		}
+	}
+
+	if (!bestShelf)
+	{
+		const int y = m_Shelves.empty() ? m_Padding : GetUsedHeight();
+		if (y + size.y + m_Padding > m_Size.y || m_Padding + size.x + m_Padding > m_Size.x)
+		{
+			return std::nullopt;
+		}
+
+		bestShelf = &m_Shelves.emplace_back(Shelf{ y, size.y, m_Padding });
+	}
+
+	Rect rect{};
+	rect.offset = { bestShelf->x, bestShelf->y };
+	rect.size = size;
+
+	bestShelf->x += size.x + m_Padding;
+
+	return rect;
+}
+
+bool FontAtlas::Grow()
+{
+	glm::ivec2 size = m_Size;
+	if (size.y < size.x && size.y < m_MaxSize)
+	{
+		size.y = glm::min(size.y * 2, m_MaxSize);
+	}
+	else if (size.x < m_MaxSize)
+	{
+		size.x = glm::min(size.x * 2, m_MaxSize);
+	}
+	else if (size.y < m_MaxSize)
+	{
+		size.y = glm::min(size.y * 2, m_MaxSize);
+	}
+	else
+	{
+		return false;
+	}
+
+	std::vector<uint8_t> pixels(static_cast<size_t>(size.x) * size.y, 0);
+	for (int y = 0; y < m_Size.y; y++)
+	{
+		std::memcpy(&pixels[static_cast<size_t>(y) * size.x], &m_Pixels[static_cast<size_t>(y) * m_Size.x], m_Size.x);
+	}
+
+	m_Pixels = std::move(pixels);
+	m_Size = size;
+	m_Version++;
+
+	return true;
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include "../Core/Core.h"
+
+namespace Pengine
+{
+
+	/**
+	 * Single channel glyph atlas on the CPU, rectangles are packed into shelves.
+	 * The atlas doubles in size when a rectangle doesn't fit, packed rectangles keep their offsets.
+	 * Doesn't depend on the graphics api, the font uploads the pixels into a texture.
+	 */
+	class PENGINE_API FontAtlas
+	{
+	public:
+		struct Rect
+		{
+			glm::ivec2 offset = { 0, 0 };
+			glm::ivec2 size = { 0, 0 };
+		};
+
+		FontAtlas(const glm::ivec2& size, const int maxSize, const int padding);
+
+		/**
+		 * Packs the rectangle and copies the pixels into it, rows are pitch bytes apart.
+		 * Returns std::nullopt if the rectangle doesn't fit even at the max size.
+		 */
+		std::optional<Rect> Add(const glm::ivec2& size, const uint8_t* pixels, const int pitch);
+
+		[[nodiscard]] const std::vector<uint8_t>& GetPixels() const { return m_Pixels; }
+
+		[[nodiscard]] glm::ivec2 GetSize() const { return m_Size; }
+
+		/**
+		 * Height of the occupied part of the atlas, the bottom of the last shelf.
+		 */
+		[[nodiscard]] int GetUsedHeight() const;
+
+		/**
+		 * Sum of the areas of the packed rectangles without padding.
+		 */
+		[[nodiscard]] size_t GetPackedArea() const { return m_PackedArea; }
+
+		/**
+		 * Packed area divided by the area taken from the shelves, 1.0 means no space is wasted between the rectangles.
+		 * The free space at the end of the shelves isn't counted, it is filled by the next rectangles.
+		 */
+		[[nodiscard]] float GetPackingEfficiency() const;
+
+		/**
+		 * Changes every time pixels are added, tells the owner that the uploaded copy is stale.
+		 */
+		[[nodiscard]] uint32_t GetVersion() const { return m_Version; }
+
+	private:
+		struct Shelf
+		{
+			int y = 0;
+			int height = 0;
+			int x = 0;
+		};
+
+		std::optional<Rect> Pack(const glm::ivec2& size);
+
+		bool Grow();
+
+		std::vector<uint8_t> m_Pixels;
+		std::vector<Shelf> m_Shelves;
+
+		glm::ivec2 m_Size = { 0, 0 };
+		int m_MaxSize = 0;
+		int m_Padding = 0;
+
+		size_t m_PackedArea = 0;
+		uint32_t m_Version = 0;
+	};
+
+}
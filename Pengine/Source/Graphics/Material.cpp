@@ -73,8 +73,7 @@ void Material::Reload(const std::shared_ptr<Material>& material, bool reloadBase
 		}
 	};
 
-	std::shared_ptr<NextFrameEvent> event = std::make_shared<NextFrameEvent>(callback, Event::Type::OnNextFrame, material.get());
-	EventSystem::GetInstance().SendEvent(event);
+	EventSystem::GetInstance().SendEvent(NextFrameEvent{ std::move(callback), material.get() });
 }
 
 std::shared_ptr<Material> Material::Clone(
@@ -88,8 +87,13 @@ std::shared_ptr<Material> Material::Clone(
 	createInfo.baseMaterial = material->GetBaseMaterial()->GetFilepath();
 	createInfo.optionsByName = material->GetOptionsByName();
 
-	for (const auto& [passName, pipeline] : material->GetBaseMaterial()->GetPipelinesByPass())
+	for (const auto& [passName, pipeline] : material->GetBaseMaterial()->WaitForPipelines())
 	{
+		if (!pipeline)
+		{
+			continue;
+		}
+
 		std::optional<uint32_t> descriptorSetIndex = pipeline->GetDescriptorSetIndexByType(Pipeline::DescriptorSetIndexType::MATERIAL, passName);
 		if (!descriptorSetIndex)
 		{
@@ -211,6 +215,17 @@ bool Material::IsPipelineEnabled(const std::string& passName) const
 	return true;
 }
 
+bool Material::IsOptionEnabled(const std::string& name) const
+{
+	if (const auto foundOption = m_OptionsByName.find(name);
+		foundOption != m_OptionsByName.end())
+	{
+		return foundOption->second.m_IsEnabled;
+	}
+
+	return false;
+}
+
 void Material::SetOption(const std::string& name, bool isEnabled)
 {
 	auto foundOption = m_OptionsByName.find(name);
@@ -265,8 +280,14 @@ void Material::CreateResources(const CreateInfo &createInfo)
 		SetOption(name, option.m_IsEnabled);
 	}
 
-	for (const auto& [passName, pipeline] : m_BaseMaterial->GetPipelinesByPass())
+	// The base material may still be compiling, the material needs the layouts of every pass before its first draw.
+	for (const auto& [passName, pipeline] : m_BaseMaterial->WaitForPipelines())
 	{
+		if (!pipeline)
+		{
+			continue;
+		}
+
 		auto baseMaterialIndex = pipeline->GetDescriptorSetIndexByType(Pipeline::DescriptorSetIndexType::MATERIAL, passName);
 		if (baseMaterialIndex)
 		{
@@ -64,6 +64,11 @@ namespace Pengine
 
 		std::unordered_map<std::string, Option> GetOptionsByName() const { return m_OptionsByName; }
 
+		/**
+		 * False if the material has no such option.
+		 */
+		bool IsOptionEnabled(const std::string& name) const;
+
 		void SetOption(const std::string& name, bool isEnabled);
 
 		template<typename T>
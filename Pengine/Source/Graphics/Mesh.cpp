@@ -2,6 +2,7 @@
 
 #include "../Core/Logger.h"
 #include "../Core/Raycast.h"
+#include "../Core/Serializer.h"
 
 using namespace Pengine;
 
@@ -13,12 +14,6 @@ Mesh::Mesh(const CreateInfo& createInfo)
 
 Mesh::~Mesh()
 {
-	if (m_CreateInfo.vertices)
-	{
-		delete m_CreateInfo.vertices;
-		m_CreateInfo.vertices = nullptr;
-	}
-
 	m_Vertices.clear();
 }
 
@@ -43,7 +38,7 @@ bool Mesh::Raycast(
 	Raycast::Hit& hit,
 	Visualizer& visualizer) const
 {
-	return m_BVH->Raycast(
+	return GetBVH()->Raycast(
 		start,
 		direction,
 		length,
@@ -53,12 +48,6 @@ bool Mesh::Raycast(
 
 void Mesh::Reload(const CreateInfo& createInfo)
 {
-	if (m_CreateInfo.vertices)
-	{
-		delete m_CreateInfo.vertices;
-		m_CreateInfo.vertices = nullptr;
-	}
-
 	// TODO: Maybe need to check whether createInfo is valid!
 	m_CreateInfo = createInfo;
 
@@ -93,13 +82,18 @@ void Mesh::Reload(const CreateInfo& createInfo)
 		}
 	}
 
+	// Skinned vertices are read by the skinning compute shader.
+	const Buffer::Usage vertexBufferUsage = m_CreateInfo.type == Type::SKINNED
+		? Buffer::Usage::STORAGE_VERTEX_BUFFER
+		: Buffer::Usage::VERTEX_BUFFER;
+
 	std::vector<std::shared_ptr<Buffer>> vertices;
 	for (std::vector<uint8_t>& vertexBuffer : vertexBuffers)
 	{
 		vertices.emplace_back(Buffer::Create(
 			sizeof(vertexBuffer[0]),
 			vertexBuffer.size(),
-			Buffer::Usage::VERTEX_BUFFER,
+			vertexBufferUsage,
 			MemoryType::GPU));
 
 		vertices.back()->WriteToBuffer(vertexBuffer.data(), vertexBuffer.size());
@@ -207,5 +201,143 @@ void Mesh::Reload(const CreateInfo& createInfo)
 			};
 	}
 
-	m_BVH = std::make_shared<MeshBVH>(m_CreateInfo.vertices, m_CreateInfo.indices, m_CreateInfo.vertexSize);
+	m_IndexCount = m_CreateInfo.indices.size();
+
+	// The mesh owns the vertices from here on, the create info only keeps the description.
+	std::shared_ptr<CpuData> cpuData = std::make_shared<CpuData>();
+	cpuData->vertices = static_cast<uint8_t*>(m_CreateInfo.vertices);
+	cpuData->indices = std::move(m_CreateInfo.indices);
+	cpuData->vertexStride = m_CreateInfo.vertexSize;
+	m_CreateInfo.vertices = nullptr;
+	m_CreateInfo.indices.clear();
+
+	// The GPU buffers are uploaded and the hierarchy only needs positions, so the rest can go now.
+	cpuData = CompactCpuData(cpuData, m_CreateInfo.vertexCount, m_CreateInfo.cpuResidency);
+
+	std::shared_ptr<MeshBVH> bvh = CreateBVH(cpuData, std::move(m_CreateInfo.bvh));
+	m_CreateInfo.bvh.reset();
+
+	SetCpuData(std::move(cpuData), std::move(bvh), m_CreateInfo.cpuResidency);
+}
+
+std::shared_ptr<MeshBVH> Mesh::GetBVH() const
+{
+	std::lock_guard<std::mutex> lock(m_CpuDataMutex);
+	return m_BVH;
+}
+
+std::shared_ptr<const Mesh::CpuData> Mesh::GetCpuData() const
+{
+	std::lock_guard<std::mutex> lock(m_CpuDataMutex);
+	return m_CpuData;
+}
+
+void Mesh::ReleaseCpuData(const CpuResidency cpuResidency)
+{
+	std::shared_ptr<CpuData> cpuData;
+	std::shared_ptr<MeshBVH> bvh;
+	{
+		std::lock_guard<std::mutex> lock(m_CpuDataMutex);
+		if (cpuResidency >= m_CreateInfo.cpuResidency)
+		{
+			return;
+		}
+
+		cpuData = m_CpuData;
+		bvh = m_BVH;
+	}
+
+	// Positions don't change, so the hierarchy is kept instead of rebuilt.
+	std::optional<MeshBVH::Data> bvhData;
+	if (cpuResidency != CpuResidency::NONE)
+	{
+		bvhData = bvh->GetData();
+	}
+
+	cpuData = CompactCpuData(cpuData, GetVertexCount(), cpuResidency);
+	bvh = CreateBVH(cpuData, std::move(bvhData));
+
+	SetCpuData(std::move(cpuData), std::move(bvh), cpuResidency);
+}
+
+bool Mesh::RestoreCpuData()
+{
+	if (GetCpuResidency() == CpuResidency::ALL)
+	{
+		return true;
+	}
+
+	CreateInfo createInfo = Serializer::DeserializeMesh(GetFilepath());
+	if (createInfo.filepath.empty())
+	{
+		return false;
+	}
+
+	std::shared_ptr<CpuData> cpuData = std::make_shared<CpuData>();
+	cpuData->vertices = static_cast<uint8_t*>(createInfo.vertices);
+	cpuData->indices = std::move(createInfo.indices);
+	cpuData->vertexStride = createInfo.vertexSize;
+
+	std::shared_ptr<MeshBVH> bvh = CreateBVH(cpuData, std::move(createInfo.bvh));
+
+	SetCpuData(std::move(cpuData), std::move(bvh), CpuResidency::ALL);
+
+	return true;
+}
+
+std::shared_ptr<MeshBVH> Mesh::CreateBVH(const std::shared_ptr<CpuData>& cpuData, std::optional<MeshBVH::Data>&& bvhData)
+{
+	if (bvhData)
+	{
+		return std::make_shared<MeshBVH>(cpuData->vertices, cpuData->indices, cpuData->vertexStride, std::move(*bvhData), cpuData);
+	}
+
+	return std::make_shared<MeshBVH>(cpuData->vertices, cpuData->indices, cpuData->vertexStride, 4, cpuData);
+}
+
+void Mesh::SetCpuData(std::shared_ptr<CpuData> cpuData, std::shared_ptr<MeshBVH> bvh, const CpuResidency cpuResidency)
+{
+	std::lock_guard<std::mutex> lock(m_CpuDataMutex);
+	m_CpuData = std::move(cpuData);
+	m_BVH = std::move(bvh);
+	m_CreateInfo.cpuResidency = cpuResidency;
+}
+
+std::shared_ptr<Mesh::CpuData> Mesh::CompactCpuData(
+	const std::shared_ptr<CpuData>& cpuData,
+	const size_t vertexCount,
+	const CpuResidency cpuResidency)
+{
+	switch (cpuResidency)
+	{
+	case CpuResidency::ALL:
+		return cpuData;
+	case CpuResidency::COLLISION:
+	{
+		// Raycasts interpolate the uv of the hit, so it is kept next to the position when the vertices have one.
+		const uint32_t vertexStride = cpuData->vertexStride >= sizeof(VertexPosition) ? sizeof(VertexPosition) : sizeof(glm::vec3);
+		if (!cpuData->vertices || cpuData->vertexStride == vertexStride)
+		{
+			return cpuData;
+		}
+
+		std::shared_ptr<CpuData> collisionData = std::make_shared<CpuData>();
+		collisionData->vertices = new uint8_t[vertexCount * vertexStride];
+		collisionData->vertexStride = vertexStride;
+		collisionData->indices = cpuData->indices;
+		for (size_t i = 0; i < vertexCount; i++)
+		{
+			memcpy(
+				collisionData->vertices + i * vertexStride,
+				cpuData->vertices + i * cpuData->vertexStride,
+				vertexStride);
+		}
+
+		return collisionData;
+	}
+	case CpuResidency::NONE:
+		return std::make_shared<CpuData>();
+	}
+
+	return cpuData;
 }
@@ -21,6 +21,19 @@ namespace Pengine
 			SKINNED
 		};
 
+		/**
+		 * What stays in CPU memory once the GPU buffers and the BVH are created.
+		 * NONE keeps nothing, raycasts miss and collision shapes can't be cooked.
+		 * COLLISION keeps positions, uvs and the indices for the BVH, raycasts and collision shapes.
+		 * ALL keeps every vertex attribute, otherwise serializing reads them back from the mesh file.
+		 */
+		enum class CpuResidency
+		{
+			NONE,
+			COLLISION,
+			ALL
+		};
+
 		struct Lod
 		{
 			size_t indexCount = 0;
@@ -48,6 +61,12 @@ namespace Pengine
 			std::vector<uint32_t> indices;
 			std::optional<BoundingBox> boundingBox;
 			Type type = Type::STATIC;
+			CpuResidency cpuResidency = CpuResidency::ALL;
+
+			/**
+			 * Prebuilt hierarchy read from the mesh file, moved into the MeshBVH on load, empty otherwise.
+			 */
+			std::optional<MeshBVH::Data> bvh;
 
 			std::function<bool(
 				const glm::vec3& start,
@@ -69,13 +88,25 @@ namespace Pengine
 
 		[[nodiscard]] const std::shared_ptr<Buffer>& GetIndexBuffer() const { return m_Indices; };
 
-		[[nodiscard]] const void* GetRawVertices() const { return m_CreateInfo.vertices; }
+		/**
+		 * Interleaved vertices with CpuResidency::ALL, positions and uvs with COLLISION, nullptr with NONE.
+		 * Valid until the CPU data is released or restored, a BVH from GetBVH() keeps its own data alive.
+		 */
+		[[nodiscard]] const void* GetRawVertices() const { return m_CpuData ? m_CpuData->vertices : nullptr; }
+
+		/**
+		 * Distance between two vertices in GetRawVertices(), the position is always first.
+		 */
+		[[nodiscard]] uint32_t GetRawVertexStride() const { return m_CpuData ? m_CpuData->vertexStride : 0; }
 
-		[[nodiscard]] const std::vector<uint32_t>& GetRawIndices() const { return m_CreateInfo.indices; };
+		/**
+		 * Empty with CpuResidency::NONE.
+		 */
+		[[nodiscard]] const std::vector<uint32_t>& GetRawIndices() const { return m_CpuData->indices; };
 
 		[[nodiscard]] size_t GetVertexCount() const { return m_CreateInfo.vertexCount; }
 
-		[[nodiscard]] size_t GetIndexCount() const { return m_CreateInfo.indices.size(); }
+		[[nodiscard]] size_t GetIndexCount() const { return m_IndexCount; }
 
 		[[nodiscard]] uint32_t GetVertexSize() const { return m_CreateInfo.vertexSize; }
 
@@ -91,7 +122,7 @@ namespace Pengine
 
 		[[nodiscard]] const CreateInfo GetCreateInfo() const { return m_CreateInfo; }
 
-		[[nodiscard]] std::shared_ptr<MeshBVH> GetBVH() const { return m_BVH; }
+		[[nodiscard]] std::shared_ptr<MeshBVH> GetBVH() const;
 
 		[[nodiscard]] const std::vector<Lod>& GetLods() const { return m_CreateInfo.lods; }
 
@@ -102,17 +133,81 @@ namespace Pengine
 			Raycast::Hit& hit,
 			Visualizer& visualizer) const;
 
+		[[nodiscard]] bool Raycast(
+			const glm::vec3& start,
+			const glm::vec3& direction,
+			const float length,
+			const bool anyHit,
+			Raycast::Hit& hit) const { return GetBVH()->Raycast(start, direction, length, anyHit, hit); }
+
 		void Reload(const CreateInfo& createInfo);
 
+		[[nodiscard]] CpuResidency GetCpuResidency() const { return m_CreateInfo.cpuResidency; }
+
+		/**
+		 * Drops the CPU data down to the given residency, does nothing if less is already kept.
+		 * Hierarchies returned by GetBVH() before keep working, raw pointers to the old data don't.
+		 */
+		void ReleaseCpuData(const CpuResidency cpuResidency);
+
+		/**
+		 * Reads the full CPU data back from the mesh file if it was released, for tools that need every attribute.
+		 * Returns false if the mesh has no file to read it from.
+		 */
+		bool RestoreCpuData();
+
+		/**
+		 * Owned CPU vertices and indices, shared with the BVH built over them.
+		 */
+		struct CpuData
+		{
+			CpuData() = default;
+			CpuData(const CpuData&) = delete;
+			CpuData& operator=(const CpuData&) = delete;
+			~CpuData() { delete[] vertices; }
+
+			uint8_t* vertices = nullptr;
+			std::vector<uint32_t> indices;
+			uint32_t vertexStride = 0;
+		};
+
+		/**
+		 * The current CPU data, stays valid for as long as it is held even if the mesh releases it.
+		 */
+		[[nodiscard]] std::shared_ptr<const CpuData> GetCpuData() const;
+
+		/**
+		 * Returns the data to keep for the residency, the same data with ALL,
+		 * a position and uv stream with COLLISION and empty data with NONE.
+		 */
+		static std::shared_ptr<CpuData> CompactCpuData(
+			const std::shared_ptr<CpuData>& cpuData,
+			const size_t vertexCount,
+			const CpuResidency cpuResidency);
+
+		/**
+		 * Builds the hierarchy over the data, or reuses bvhData if it was built over the same positions.
+		 */
+		static std::shared_ptr<MeshBVH> CreateBVH(const std::shared_ptr<CpuData>& cpuData, std::optional<MeshBVH::Data>&& bvhData);
+
 	protected:
+		std::shared_ptr<CpuData> m_CpuData;
 		std::shared_ptr<MeshBVH> m_BVH;
 		std::vector<std::shared_ptr<Buffer>> m_Vertices;
 		std::vector<NativeHandle> m_VertexLayoutHandles;
 		std::shared_ptr<Buffer> m_Indices;
 		BoundingBox m_BoundingBox{};
 		CreateInfo m_CreateInfo{};
+		size_t m_IndexCount = 0;
 
 		mutable std::mutex m_VertexBufferAccessMutex;
+
+		/**
+		 * Guards swapping m_CpuData and m_BVH together.
+		 */
+		mutable std::mutex m_CpuDataMutex;
+
+		void SetCpuData(std::shared_ptr<CpuData> cpuData, std::shared_ptr<MeshBVH> bvh, const CpuResidency cpuResidency);
 	};
 
 }
\ No newline at end of file
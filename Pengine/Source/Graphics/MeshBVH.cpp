@@ -2,6 +2,8 @@
 
 #include "Vertex.h"
 
+#include "../Core/Profiler.h"
+#include "../Core/ThreadPool.h"
 #include "../Utils/Utils.h"
 
 using namespace Pengine;
@@ -10,18 +12,71 @@ MeshBVH::MeshBVH(
 	void* vertices,
 	const std::vector<uint32_t>& indices,
 	const uint32_t vertexSize,
-	int leafSize)
-	: m_Vertices(vertices)
+	int leafSize,
+	std::shared_ptr<const void> storage)
+	: m_Storage(std::move(storage))
+	, m_Vertices(vertices)
 	, m_Indices(indices)
 	, m_VertexSize(vertexSize)
 	, m_LeafSize(leafSize)
 {
 	if (indices.empty() || indices.size() % 3 != 0) return;
 
-	std::vector<uint32_t> triangleIndices(indices.size() / 3);
-	std::iota(triangleIndices.begin(), triangleIndices.end(), 0);
+	Build();
+}
+
+MeshBVH::MeshBVH(
+	void* vertices,
+	const std::vector<uint32_t>& indices,
+	const uint32_t vertexSize,
+	Data&& data,
+	std::shared_ptr<const void> storage)
+	: m_Storage(std::move(storage))
+	, m_Vertices(vertices)
+	, m_Indices(indices)
+	, m_VertexSize(vertexSize)
+	, m_LeafSize(4)
+{
+	if (indices.empty() || indices.size() % 3 != 0) return;
+
+	if (!IsValid(data, indices.size() / 3))
+	{
+		Build();
+		return;
+	}
+
+	m_Data = std::move(data);
+	m_Root = 0;
+}
+
+bool MeshBVH::IsValid(const Data& data, const size_t triangleCount)
+{
+	if (data.nodes.empty() || data.triangleIndices.size() != triangleCount)
+	{
+		return false;
+	}
+
+	for (size_t i = 0; i < data.nodes.size(); i++)
+	{
+		const BVHNode& node = data.nodes[i];
+		if (node.IsLeaf())
+		{
+			if (node.offset > data.triangleIndices.size() || node.count > data.triangleIndices.size() - node.offset)
+			{
+				return false;
+			}
+		}
+		// Children are always stored after their parent, anything else could loop.
+		else if (node.left <= i || node.right <= i || node.left >= data.nodes.size() || node.right >= data.nodes.size())
+		{
+			return false;
+		}
+	}
 
-	m_Root = BuildRecursive(triangleIndices);
+	return std::all_of(data.triangleIndices.begin(), data.triangleIndices.end(), [triangleCount](const uint32_t triangle)
+	{
+		return triangle < triangleCount;
+	});
 }
 
 void MeshBVH::Traverse(const std::function<void(const BVHNode&)>& callback) const
@@ -33,7 +88,7 @@ void MeshBVH::Traverse(const std::function<void(const BVHNode&)>& callback) cons
 
 	while (!nodeStack.empty())
 	{
-		const BVHNode& node = m_Nodes[nodeStack.top()];
+		const BVHNode& node = m_Data.nodes[nodeStack.top()];
 		nodeStack.pop();
 
 		callback(node);
@@ -50,174 +105,310 @@ bool MeshBVH::Raycast(
 	Raycast::Hit& hit,
 	Visualizer& visualizer)
 {
+	return Raycast(start, direction, length, false, hit);
+}
+
+bool MeshBVH::Raycast(
+	const glm::vec3& start,
+	const glm::vec3& direction,
+	const float length,
+	const bool anyHit,
+	Raycast::Hit& hit) const
+{
+	struct StackEntry
+	{
+		uint32_t node;
+		float distance;
+	};
+
+	// Reused between calls, ray casts don't allocate once the stack has grown to the tree depth.
+	thread_local std::vector<StackEntry> stack;
+
 	if (m_Root == -1) return false;
 
-	Raycast::Hit closestHit{};
-	bool bHit = false;
-	std::stack<uint32_t> nodeStack;
-	nodeStack.push(m_Root);
+	const glm::vec3 inverseDirection = 1.0f / direction;
+	float maxDistance = length;
+	uint32_t closestTriangle = -1;
+	glm::vec2 closestBarycentrics{};
 
-	while (!nodeStack.empty())
+	float rootDistance;
+	if (Raycast::IntersectRayAABB(start, inverseDirection, m_Data.nodes[m_Root].aabb.min, m_Data.nodes[m_Root].aabb.max, maxDistance, rootDistance))
 	{
-		const BVHNode& node = m_Nodes[nodeStack.top()];
-		nodeStack.pop();
+		stack.push_back({ m_Root, rootDistance });
+	}
+
+	while (!stack.empty())
+	{
+		const StackEntry entry = stack.back();
+		stack.pop_back();
 
-		Raycast::Hit currentHitAABB{};
-		if (!Raycast::IntersectBoxAABB(start, direction, node.aabb.min, node.aabb.max, length, currentHitAABB))
+		if (entry.distance > maxDistance)
 		{
 			continue;
 		}
 
-		//visualizer.DrawBox(node->aabb.min, node->aabb.max, { 1.0f, 1.0f, 0.0f }, glm::mat4(1.0f));
-
-		if (node.isLeaf)
+		const BVHNode& node = m_Data.nodes[entry.node];
+		if (node.IsLeaf())
 		{
-			for (int index : node.triangleIndices)
+			for (uint32_t i = node.offset; i < node.offset + node.count; i++)
 			{
-				const VertexPosition& v0 = *(VertexPosition*)((uint8_t*)m_Vertices + m_Indices[index * 3 + 0] * m_VertexSize);
-				const VertexPosition& v1 = *(VertexPosition*)((uint8_t*)m_Vertices + m_Indices[index * 3 + 1] * m_VertexSize);
-				const VertexPosition& v2 = *(VertexPosition*)((uint8_t*)m_Vertices + m_Indices[index * 3 + 2] * m_VertexSize);
-
-				const glm::vec3 normal = glm::normalize(glm::cross((v1.position - v0.position), (v2.position - v0.position)));
-
-				Raycast::Hit currentHitTriangle{};
-				if (Raycast::IntersectTriangle(start, direction, v0.position, v1.position, v2.position, normal, length, currentHitTriangle))
+				const uint32_t index = m_Data.triangleIndices[i];
+				float distance;
+				glm::vec2 barycentrics;
+				if (Raycast::IntersectRayTriangle(
+					start,
+					direction,
+					GetVertexPosition(index * 3 + 0),
+					GetVertexPosition(index * 3 + 1),
+					GetVertexPosition(index * 3 + 2),
+					maxDistance,
+					distance,
+					barycentrics))
 				{
-					if (currentHitTriangle.distance < closestHit.distance)
+					maxDistance = distance;
+					closestTriangle = index;
+					closestBarycentrics = barycentrics;
+
+					if (anyHit)
 					{
-						const glm::vec3 bary = Utils::ComputeBarycentric(v0.position, v1.position, v2.position, currentHitTriangle.point);
-						float u = bary.x, v = bary.y, w = bary.z;
+						break;
+					}
+				}
+			}
 
-						const float epsilon = 1e-5f;
-						if (u >= -epsilon && v >= -epsilon && w >= -epsilon)
-						{
-							glm::vec2 uv0 = v0.uv;
-							glm::vec2 uv1 = v1.uv;
-							glm::vec2 uv2 = v2.uv;
+			if (anyHit && closestTriangle != -1)
+			{
+				break;
+			}
 
-							currentHitTriangle.uv = u * uv0 + v * uv1 + w * uv2;
-						}
+			continue;
+		}
 
-						closestHit = currentHitTriangle;
-					}
-					bHit = true;
+		float leftDistance, rightDistance;
+		const bool hitLeft = Raycast::IntersectRayAABB(start, inverseDirection, m_Data.nodes[node.left].aabb.min, m_Data.nodes[node.left].aabb.max, maxDistance, leftDistance);
+		const bool hitRight = Raycast::IntersectRayAABB(start, inverseDirection, m_Data.nodes[node.right].aabb.min, m_Data.nodes[node.right].aabb.max, maxDistance, rightDistance);
 
-					/*visualizer.DrawSphere(currentHitTriangle.point, 0.05f, 8, { 1.0f, 0.0f, 1.0f }, 0.0f);
-					visualizer.DrawLine(a, b, { 0.0f, 0.0f, 1.0f }, 0.0f);
-					visualizer.DrawLine(a, c, { 0.0f, 0.0f, 1.0f }, 0.0f);
-					visualizer.DrawLine(c, b, { 0.0f, 0.0f, 1.0f }, 0.0f);*/
-				}
-				else
-				{
-					/*visualizer.DrawLine(a, b, { 1.0f, 1.0f, 1.0f }, 0.0f);
-					visualizer.DrawLine(a, c, { 1.0f, 1.0f, 1.0f }, 0.0f);
-					visualizer.DrawLine(c, b, { 1.0f, 1.0f, 1.0f }, 0.0f);*/
-				}
+		// The nearer child goes on top of the stack.
+		if (hitLeft && hitRight)
+		{
+			if (leftDistance < rightDistance)
+			{
+				stack.push_back({ node.right, rightDistance });
+				stack.push_back({ node.left, leftDistance });
+			}
+			else
+			{
+				stack.push_back({ node.left, leftDistance });
+				stack.push_back({ node.right, rightDistance });
 			}
 		}
-		else
+		else if (hitLeft)
+		{
+			stack.push_back({ node.left, leftDistance });
+		}
+		else if (hitRight)
 		{
-			if (node.right != -1) nodeStack.push(node.right);
-			if (node.left != -1) nodeStack.push(node.left);
+			stack.push_back({ node.right, rightDistance });
 		}
 	}
 
-	hit = closestHit;
+	stack.clear();
+
+	if (closestTriangle == -1)
+	{
+		return false;
+	}
+
+	const glm::vec3& a = GetVertexPosition(closestTriangle * 3 + 0);
+	const glm::vec3& b = GetVertexPosition(closestTriangle * 3 + 1);
+	const glm::vec3& c = GetVertexPosition(closestTriangle * 3 + 2);
+
+	hit.distance = maxDistance;
+	hit.point = start + direction * maxDistance;
+	hit.normal = glm::normalize(glm::cross(b - a, c - a));
+	hit.triangle = closestTriangle;
+	hit.barycentrics = glm::vec3(1.0f - closestBarycentrics.x - closestBarycentrics.y, closestBarycentrics.x, closestBarycentrics.y);
+	hit.uv = hit.barycentrics.x * GetVertexUV(closestTriangle * 3 + 0) +
+		hit.barycentrics.y * GetVertexUV(closestTriangle * 3 + 1) +
+		hit.barycentrics.z * GetVertexUV(closestTriangle * 3 + 2);
 
-	return bHit;
+	return true;
 }
 
-uint32_t MeshBVH::BuildRecursive(
-	std::vector<uint32_t> triangleIndices)
+void MeshBVH::Build()
 {
-	AABB aabb = ComputeBoundingBox(triangleIndices);
+	PROFILER_SCOPE(__FUNCTION__);
 
-	// Create leaf node if below threshold.
-	if (triangleIndices.size() <= m_LeafSize)
+	const uint32_t triangleCount = static_cast<uint32_t>(m_Indices.size() / 3);
+
+	std::vector<BuildTriangle> triangles(triangleCount);
+	ThreadPool::GetInstance().ParallelFor(triangleCount, 4096, [this, &triangles](const size_t begin, const size_t end)
 	{
-		m_Nodes.emplace_back(aabb, std::move(triangleIndices));
-		return m_Nodes.size() - 1;
+		for (size_t i = begin; i < end; i++)
+		{
+			const glm::vec3& a = GetVertexPosition(i * 3 + 0);
+			const glm::vec3& b = GetVertexPosition(i * 3 + 1);
+			const glm::vec3& c = GetVertexPosition(i * 3 + 2);
+
+			triangles[i].aabb = AABB(glm::min(glm::min(a, b), c), glm::max(glm::max(a, b), c));
+			triangles[i].centroid = (a + b + c) / 3.0f;
+		}
+	});
+
+	m_Data.triangleIndices.resize(triangleCount);
+	std::iota(m_Data.triangleIndices.begin(), m_Data.triangleIndices.end(), 0);
+
+	// A binary tree with at least one triangle per leaf never has more nodes than that.
+	m_Data.nodes.resize(2 * triangleCount - 1);
+	m_Data.nodes[0].offset = 0;
+	m_Data.nodes[0].count = triangleCount;
+
+	std::atomic<uint32_t> nodeCount = 1;
+	BuildRecursive(0, triangles, nodeCount);
+
+	m_Data.nodes.resize(nodeCount.load());
+	m_Data.nodes.shrink_to_fit();
+
+	m_Root = 0;
+}
+
+void MeshBVH::BuildRecursive(
+	const uint32_t nodeIndex,
+	const std::vector<BuildTriangle>& triangles,
+	std::atomic<uint32_t>& nodeCount)
+{
+	BVHNode& node = m_Data.nodes[nodeIndex];
+	uint32_t* triangleIndices = m_Data.triangleIndices.data() + node.offset;
+
+	AABB centroidBounds;
+	for (uint32_t i = 0; i < node.count; i++)
+	{
+		const BuildTriangle& triangle = triangles[triangleIndices[i]];
+		node.aabb = node.aabb.Expanded(triangle.aabb);
+		centroidBounds = centroidBounds.Expanded(AABB(triangle.centroid, triangle.centroid));
 	}
 
-	// Determine split axis (longest dimension).
-	glm::vec3 extent =
+	// Create leaf node if below threshold.
+	if (node.count <= m_LeafSize)
 	{
-		aabb.max.x - aabb.min.x,
-		aabb.max.y - aabb.min.y,
-		aabb.max.z - aabb.min.z
-	};
+		return;
+	}
 
+	// Choose split axis (longest).
+	const glm::vec3 extent = centroidBounds.max - centroidBounds.min;
 	int axis = 0;
 	if (extent.y > extent.x) axis = 1;
 	if (extent.z > extent[axis]) axis = 2;
 
-	// Sort triangles by centroid along chosen axis.
-	std::sort(triangleIndices.begin(), triangleIndices.end(),
-		[&, axis](int a, int b)
-		{
-			return GetTriangleCentroid(a)[axis] < GetTriangleCentroid(b)[axis];
-		});
+	uint32_t leftCount = node.count / 2;
 
-	// Split into two halves.
-	auto mid = triangleIndices.begin() + triangleIndices.size() / 2;
-	std::vector<uint32_t> leftIndices(triangleIndices.begin(), mid);
-	std::vector<uint32_t> rightIndices(mid, triangleIndices.end());
+	// All centroids in one point can't be binned, any split is as good as the other.
+	if (extent[axis] > 0.0f)
+	{
+		// Partition using binned SAH.
+		constexpr int BIN_COUNT = 16;
+		struct Bin
+		{
+			AABB bounds;
+			uint32_t count = 0;
+		} bins[BIN_COUNT];
 
-	// Build child nodes.
-	auto left = BuildRecursive(std::move(leftIndices));
-	auto right = BuildRecursive(std::move(rightIndices));
+		const float scale = BIN_COUNT / extent[axis];
+		const float minAxis = centroidBounds.min[axis];
+		auto getBin = [&triangles, axis, scale, minAxis](const uint32_t triangleIndex)
+		{
+			return std::min(BIN_COUNT - 1, static_cast<int>((triangles[triangleIndex].centroid[axis] - minAxis) * scale));
+		};
 
-	// Merge child bounding boxes.
-	aabb = MergeAABBs(m_Nodes[left].aabb, m_Nodes[right].aabb);
+		for (uint32_t i = 0; i < node.count; i++)
+		{
+			Bin& bin = bins[getBin(triangleIndices[i])];
+			bin.count++;
+			bin.bounds = bin.bounds.Expanded(triangles[triangleIndices[i]].aabb);
+		}
 
-	m_Nodes.emplace_back(aabb, left, right);
-	return m_Nodes.size() - 1;
-}
+		// Right -> Left areas, then evaluate the splits while sweeping Left -> Right.
+		float rightAreas[BIN_COUNT];
+		uint32_t rightCounts[BIN_COUNT];
+		AABB currentRight;
+		uint32_t currentRightCount = 0;
+		for (int i = BIN_COUNT - 1; i > 0; i--)
+		{
+			currentRight = currentRight.Expanded(bins[i].bounds);
+			currentRightCount += bins[i].count;
+			rightAreas[i] = currentRightCount > 0 ? currentRight.SurfaceArea() : 0.0f;
+			rightCounts[i] = currentRightCount;
+		}
 
-glm::vec3 MeshBVH::GetTriangleCentroid(uint32_t index) const
-{
-	const glm::vec3& v0 = *(glm::vec3*)((uint8_t*)m_Vertices + m_Indices[index * 3 + 0] * m_VertexSize);
-	const glm::vec3& v1 = *(glm::vec3*)((uint8_t*)m_Vertices + m_Indices[index * 3 + 1] * m_VertexSize);
-	const glm::vec3& v2 = *(glm::vec3*)((uint8_t*)m_Vertices + m_Indices[index * 3 + 2] * m_VertexSize);
-	return (v0 + v1 + v2) / 3.0f;
-}
+		float bestCost = std::numeric_limits<float>::infinity();
+		int bestSplit = -1;
+		AABB currentLeft;
+		uint32_t currentLeftCount = 0;
+		for (int i = 1; i < BIN_COUNT; i++)
+		{
+			currentLeft = currentLeft.Expanded(bins[i - 1].bounds);
+			currentLeftCount += bins[i - 1].count;
+			if (currentLeftCount == 0 || rightCounts[i] == 0) continue;
 
-AABB MeshBVH::ComputeBoundingBox(const std::vector<uint32_t>& triangleIndices)
-{
-	AABB aabb;
+			const float cost = currentLeftCount * currentLeft.SurfaceArea() + rightCounts[i] * rightAreas[i];
+			if (cost < bestCost)
+			{
+				bestCost = cost;
+				bestSplit = i;
+			}
+		}
 
-	for (int index : triangleIndices)
-	{
-		const glm::vec3& v0 = *(glm::vec3*)((uint8_t*)m_Vertices + m_Indices[index * 3 + 0] * m_VertexSize);
-		const glm::vec3& v1 = *(glm::vec3*)((uint8_t*)m_Vertices + m_Indices[index * 3 + 1] * m_VertexSize);
-		const glm::vec3& v2 = *(glm::vec3*)((uint8_t*)m_Vertices + m_Indices[index * 3 + 2] * m_VertexSize);
+		if (bestSplit != -1)
+		{
+			const uint32_t* middle = std::partition(triangleIndices, triangleIndices + node.count, [&getBin, bestSplit](const uint32_t triangleIndex)
+			{
+				return getBin(triangleIndex) < bestSplit;
+			});
 
-		ExpandAABB(aabb, v0);
-		ExpandAABB(aabb, v1);
-		ExpandAABB(aabb, v2);
+			leftCount = static_cast<uint32_t>(middle - triangleIndices);
+		}
 	}
 
-	return aabb;
+	const uint32_t childIndex = nodeCount.fetch_add(2);
+	node.left = childIndex;
+	node.right = childIndex + 1;
+
+	BVHNode& left = m_Data.nodes[node.left];
+	left.offset = node.offset;
+	left.count = leftCount;
+
+	BVHNode& right = m_Data.nodes[node.right];
+	right.offset = node.offset + leftCount;
+	right.count = node.count - leftCount;
+
+	node.count = 0;
+
+	// Both halves sort disjoint ranges of the triangle indices and write their own nodes.
+	if (left.count + right.count >= parallelBuildTriangleCount)
+	{
+		ThreadPool::GetInstance().ParallelFor(2, 1, [this, childIndex, &triangles, &nodeCount](const size_t begin, const size_t end)
+		{
+			BuildRecursive(childIndex + static_cast<uint32_t>(begin), triangles, nodeCount);
+		});
+	}
+	else
+	{
+		BuildRecursive(node.left, triangles, nodeCount);
+		BuildRecursive(node.right, triangles, nodeCount);
+	}
 }
 
-void MeshBVH::ExpandAABB(AABB& aabb, const glm::vec3& point)
+glm::vec2 MeshBVH::GetVertexUV(const uint32_t index) const
 {
-	aabb.min.x = std::min(aabb.min.x, point.x);
-	aabb.min.y = std::min(aabb.min.y, point.y);
-	aabb.min.z = std::min(aabb.min.z, point.z);
-	aabb.max.x = std::max(aabb.max.x, point.x);
-	aabb.max.y = std::max(aabb.max.y, point.y);
-	aabb.max.z = std::max(aabb.max.z, point.z);
+	if (m_VertexSize < sizeof(VertexPosition))
+	{
+		return glm::vec2(0.0f);
+	}
+
+	return ((const VertexPosition*)((const uint8_t*)m_Vertices + m_Indices[index] * m_VertexSize))->uv;
 }
 
-AABB MeshBVH::MergeAABBs(const AABB& a, const AABB& b)
+const glm::vec3& MeshBVH::GetVertexPosition(const uint32_t index) const
 {
-	AABB merged;
-	merged.min.x = std::min(a.min.x, b.min.x);
-	merged.min.y = std::min(a.min.y, b.min.y);
-	merged.min.z = std::min(a.min.z, b.min.z);
-	merged.max.x = std::max(a.max.x, b.max.x);
-	merged.max.y = std::max(a.max.y, b.max.y);
-	merged.max.z = std::max(a.max.z, b.max.z);
-	return merged;
+	return *(const glm::vec3*)((const uint8_t*)m_Vertices + m_Indices[index] * m_VertexSize);
 }
@@ -15,36 +15,61 @@ namespace Pengine
 	{
 	public:
 		
+		/**
+		 * Leaves reference the range [offset, offset + count) of GetTriangleIndices(),
+		 * inner nodes have count 0 and their children are stored next to each other.
+		 */
 		struct BVHNode
 		{
 			AABB aabb;
 			uint32_t left = -1;
 			uint32_t right = -1;
+			uint32_t offset = 0;
+			uint32_t count = 0;
+
+			[[nodiscard]] bool IsLeaf() const { return count > 0; }
+		};
+
+		/**
+		 * Built hierarchy, stored in the mesh file so it is not rebuilt on load. The root is always the first node.
+		 */
+		struct Data
+		{
+			std::vector<BVHNode> nodes;
 			std::vector<uint32_t> triangleIndices;
-			bool isLeaf;
-
-			BVHNode(const AABB& aabb, std::vector<uint32_t>&& indices)
-				: aabb(aabb)
-				, left(-1)
-				, right(-1)
-				, triangleIndices(std::move(indices)), isLeaf(true)
-			{
-			}
-
-			BVHNode(const AABB& aabb, uint32_t left,
-				uint32_t right)
-				: aabb(aabb)
-				, left(left)
-				, right(right)
-				, isLeaf(false)
-			{
-			}
 		};
 
+		/**
+		 * Bumped whenever the layout of Data or the build changes, serialized hierarchies with another version are rebuilt.
+		 */
+		static constexpr uint32_t version = 1;
+
+		/**
+		 * Meshes with more triangles build the upper levels of the hierarchy in parallel on the ThreadPool.
+		 */
+		static constexpr uint32_t parallelBuildTriangleCount = 65536;
+
+		/**
+		 * The vertices and indices are not copied, storage keeps them alive for as long as the hierarchy exists.
+		 * Without storage the caller has to outlive the hierarchy.
+		 */
+		MeshBVH(void* vertices,
+			const std::vector<uint32_t>& indices,
+			const uint32_t vertexSize,
+			int leafSize = 4,
+			std::shared_ptr<const void> storage = nullptr);
+
+		/**
+		 * Uses an already built hierarchy, falls back to building it if the data doesn't match the indices
+		 * or references nodes and triangles out of range.
+		 */
 		MeshBVH(void* vertices,
 			const std::vector<uint32_t>& indices,
 			const uint32_t vertexSize,
-			int leafSize = 4);
+			Data&& data,
+			std::shared_ptr<const void> storage = nullptr);
+
+		[[nodiscard]] const Data& GetData() const { return m_Data; }
 
 		void Traverse(const std::function<void(const BVHNode&)>& callback) const;
 
@@ -55,23 +80,54 @@ namespace Pengine
 			Raycast::Hit& hit,
 			Visualizer& visualizer);
 
+		/**
+		 * Front to back traversal that skips nodes farther than the closest hit so far,
+		 * with anyHit it returns the first triangle hit instead. Doesn't allocate.
+		 * The direction doesn't have to be normalized, the hit distance is in its units.
+		 */
+		bool Raycast(
+			const glm::vec3& start,
+			const glm::vec3& direction,
+			const float length,
+			const bool anyHit,
+			Raycast::Hit& hit) const;
+
 	private:
+		/**
+		 * Triangle bounds and centroids computed once before the build.
+		 */
+		struct BuildTriangle
+		{
+			AABB aabb;
+			glm::vec3 centroid;
+		};
+
+		std::shared_ptr<const void> m_Storage;
 		void* m_Vertices;
 		const std::vector<uint32_t>& m_Indices;
 		const uint32_t m_VertexSize;
 		const int m_LeafSize;
-		std::vector<BVHNode> m_Nodes;
+		Data m_Data;
 		uint32_t m_Root = -1;
 
-		uint32_t BuildRecursive(std::vector<uint32_t> triangleIndices);
+		void Build();
 
-		glm::vec3 GetTriangleCentroid(uint32_t index) const;
+		/**
+		 * Whether every node and triangle index of the data is in range, so traversing it can't read out of bounds.
+		 */
+		static bool IsValid(const Data& data, const size_t triangleCount);
 
-		AABB ComputeBoundingBox(const std::vector<uint32_t>& triangleIndices);
+		void BuildRecursive(
+			const uint32_t nodeIndex,
+			const std::vector<BuildTriangle>& triangles,
+			std::atomic<uint32_t>& nodeCount);
 
-		void ExpandAABB(AABB& aabb, const glm::vec3& point);
+		/**
+		 * Zero if the vertices are only positions.
+		 */
+		glm::vec2 GetVertexUV(const uint32_t index) const;
 
-		AABB MergeAABBs(const AABB& a, const AABB& b);
+		const glm::vec3& GetVertexPosition(const uint32_t index) const;
 	};
 
 }
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "../Core/Core.h"
+#include "../Core/RenderSnapshot.h"
 
 #include "Buffer.h"
 #include "UniformWriter.h"
@@ -34,6 +35,13 @@ namespace Pengine
 				std::shared_ptr<Renderer> renderer;
 				std::shared_ptr<Scene> scene;
 				std::shared_ptr<Entity> camera;
+
+				/**
+				 * The published snapshot of the scene, the passes read entities, lights and cameras from it instead of the registry.
+				 */
+				const RenderSnapshot* snapshot = nullptr;
+				const RenderSnapshot::CameraData* cameraData = nullptr;
+
 				glm::mat4 projection;
 				glm::ivec2 viewportSize;
 				void* frame;
@@ -8,6 +8,7 @@
 
 namespace Pengine
 {
+	const std::string Skinning = "Skinning";
 	const std::string ZPrePass = "ZPrePass";
 	const std::string GBuffer = "GBuffer";
 	const std::string Decals = "Decals";
@@ -15,6 +16,7 @@ namespace Pengine
 	const std::string DefaultReflection = "DefaultReflection";
 	const std::string Atmosphere = "Atmosphere";
 	const std::string Transparent = "Transparent";
+	const std::string TransparentOIT = "TransparentOIT";
 	const std::string SSAO = "SSAO";
 	const std::string SSAOBlur = "SSAOBlur";
 	const std::string SSS = "SSS";
@@ -49,6 +49,7 @@ void Renderer::Update(
 		renderInfo.camera = nullptr;
 		renderInfo.window = window;
 		renderInfo.scene = scene;
+		renderInfo.snapshot = &scene->GetRenderSnapshot();
 		renderInfo.projection = glm::mat4(1.0f);
 		renderInfo.frame = frame;
 		renderInfo.viewportSize = { 0, 0 };
@@ -82,12 +83,22 @@ void Renderer::Update(
 
 		for (const auto& viewport : viewports)
 		{
+			// A camera created after the snapshot was taken is rendered from the next one.
+			renderInfo.cameraData = renderInfo.snapshot->GetCamera(viewport.camera->GetHandle());
+			if (!renderInfo.cameraData)
+			{
+				continue;
+			}
+
 			renderInfo.camera = viewport.camera;
 			renderInfo.projection = viewport.projection;
 			renderInfo.viewportSize = viewport.size;
 			renderInfo.renderView = viewport.renderView;
 
-			RenderPassManager::PrepareUniformsPerViewportBeforeDraw(renderInfo);
+			if (!RenderPassManager::PrepareUniformsPerViewportBeforeDraw(renderInfo))
+			{
+				continue;
+			}
 
 			renderer->BeginCommandLabel("Camera: " + viewport.camera->GetName(), glm::vec3(1.0f, 0.75f, 0.0f), frame);
 
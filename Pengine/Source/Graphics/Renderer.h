@@ -102,6 +102,11 @@ namespace Pengine
 
 		virtual void MemoryBarrierFragmentReadWrite(void* frame) = 0;
 
+		/**
+		 * Makes buffers written by compute shaders visible to the vertex input of the following draws.
+		 */
+		virtual void MemoryBarrierComputeWriteVertexRead(void* frame) = 0;
+
 		virtual void BeginCommandLabel(
 			const std::string& name,
 			const glm::vec3& color,
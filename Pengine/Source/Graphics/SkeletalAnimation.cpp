@@ -3,116 +3,369 @@
 namespace Pengine
 {
 
-	glm::mat4 SkeletalAnimation::Bone::Update(float time) const
+	// Smallest three components of a unit quaternion are in [-1/sqrt(2), 1/sqrt(2)].
+	constexpr float smallestThreeRange = 0.70710678f;
+	// Even, so zero is stored exactly and identity rotations don't drift along long bone chains.
+	constexpr float smallestThreeMax = 32766.0f;
+	constexpr float rangeMax = 65535.0f;
+
+	// Bounds the cost of key reduction for long tracks that are almost linear.
+	constexpr size_t maxSkippedKeys = 1024;
+
+	namespace
+	{
+		float GetScaleFactor(const float lastTime, const float nextTime, const float time)
+		{
+			// Keys at the same time are a jump, the later one holds from that time on.
+			if (nextTime <= lastTime)
+			{
+				return time >= nextTime ? 1.0f : 0.0f;
+			}
+
+			return (time - lastTime) / (nextTime - lastTime);
+		}
+
+		float GetAngle(const glm::quat& a, const glm::quat& b)
+		{
+			return 2.0f * std::acos(glm::min(1.0f, std::abs(glm::dot(a, b))));
+		}
+
+		/**
+		 * Returns the indices of keys that can't be restored by interpolating between the kept neighbours.
+		 */
+		template<typename Key, typename Interpolate, typename Error>
+		std::vector<size_t> ReduceKeys(const std::vector<Key>& keys, const float tolerance, Interpolate interpolate, Error error)
+		{
+			std::vector<size_t> keptIndices;
+			keptIndices.emplace_back(0);
+
+			size_t start = 0;
+			for (size_t end = 2; end < keys.size(); end++)
+			{
+				bool canSkip = end - start <= maxSkippedKeys;
+				for (size_t index = start + 1; index < end && canSkip; index++)
+				{
+					const float scaleFactor = GetScaleFactor(keys[start].time, keys[end].time, keys[index].time);
+					canSkip = error(interpolate(keys[start].value, keys[end].value, scaleFactor), keys[index].value) <= tolerance;
+				}
+
+				if (!canSkip)
+				{
+					start = end - 1;
+					keptIndices.emplace_back(start);
+				}
+			}
+
+			keptIndices.emplace_back(keys.size() - 1);
+
+			return keptIndices;
+		}
+	}
+
+	SkeletalAnimation::SkeletalAnimation(const CreateInfo& createInfo)
+		: Asset(createInfo.name, createInfo.filepath)
+		, m_Duration(createInfo.duration)
+	{
+		m_ChannelsByName.reserve(createInfo.bonesByName.size());
+		for (const auto& [name, bone] : createInfo.bonesByName)
+		{
+			m_ChannelsByName.emplace(name, Channel(bone, createInfo.compressionSettings));
+		}
+	}
+
+	SkeletalAnimation::Channel::Channel(const Bone& bone, const CompressionSettings& compressionSettings)
+	{
+		CompressTrack(bone.positions, compressionSettings.positionTolerance, glm::vec3(0.0f), m_Positions);
+		CompressTrack(bone.rotations, compressionSettings.rotationTolerance, m_Rotations);
+		CompressTrack(bone.scales, compressionSettings.scaleTolerance, glm::vec3(1.0f), m_Scales);
+	}
+
+	glm::mat4 SkeletalAnimation::Channel::Update(float time, Cursor* cursor) const
 	{
 		glm::vec3 position;
 		glm::quat rotation;
 		glm::vec3 scale;
-		Update(time, position, rotation, scale);
+		Update(time, position, rotation, scale, cursor);
 
 		return glm::translate(glm::mat4(1.0f), position) * glm::toMat4(rotation) * glm::scale(glm::mat4(1.0f), scale);
 	}
 
-	void SkeletalAnimation::Bone::Update(float time, glm::vec3& position, glm::quat& rotation, glm::vec3& scale) const
+	void SkeletalAnimation::Channel::Update(float time, glm::vec3& position, glm::quat& rotation, glm::vec3& scale, Cursor* cursor) const
 	{
-		position = InterpolatePosition(time);
-		rotation = InterpolateRotation(time);
-		scale = InterpolateScaling(time);
+		position = Sample(m_Positions, time, cursor ? &cursor->position : nullptr);
+		rotation = Sample(m_Rotations, time, cursor ? &cursor->rotation : nullptr);
+		scale = Sample(m_Scales, time, cursor ? &cursor->scale : nullptr);
 	}
 
-	int SkeletalAnimation::Bone::GetPositionIndex(float animationTime) const
+	SkeletalAnimation::Bone SkeletalAnimation::Channel::Decompress() const
 	{
-		for (int index = 0; index < positions.size() - 1; ++index)
+		Bone bone{};
+
+		auto decompressVec = [](const VecTrack& track, std::vector<KeyVec>& keys)
+		{
+			if (track.times.empty())
+			{
+				keys.emplace_back(KeyVec{ 0.0, track.min });
+				return;
+			}
+
+			for (size_t index = 0; index < track.times.size(); index++)
+			{
+				keys.emplace_back(KeyVec{ track.times[index], Decode(track, index) });
+			}
+		};
+
+		decompressVec(m_Positions, bone.positions);
+		decompressVec(m_Scales, bone.scales);
+
+		if (m_Rotations.times.empty())
+		{
+			bone.rotations.emplace_back(KeyQuat{ 0.0, m_Rotations.constant });
+		}
+		else
 		{
-			if (animationTime < positions[index + 1].time)
+			for (size_t index = 0; index < m_Rotations.times.size(); index++)
 			{
-				return index;
+				bone.rotations.emplace_back(KeyQuat{ m_Rotations.times[index], Decode(m_Rotations, index) });
 			}
 		}
-		assert(0);
+
+		return bone;
+	}
+
+	size_t SkeletalAnimation::Channel::GetMemorySize() const
+	{
+		size_t size = sizeof(Channel);
+		size += (m_Positions.times.size() + m_Rotations.times.size() + m_Scales.times.size()) * sizeof(float);
+		size += (m_Positions.values.size() + m_Rotations.values.size() + m_Scales.values.size()) * sizeof(glm::u16vec3);
+		return size;
 	}
 
-	int SkeletalAnimation::Bone::GetRotationIndex(float animationTime) const
+	void SkeletalAnimation::Channel::CompressTrack(
+		const std::vector<KeyVec>& keys,
+		const float tolerance,
+		const glm::vec3& defaultValue,
+		VecTrack& track)
 	{
-		for (int index = 0; index < rotations.size() - 1; ++index)
+		if (keys.empty())
+		{
+			track.min = defaultValue;
+			return;
+		}
+
+		const bool isConstant = std::all_of(keys.begin(), keys.end(), [&keys, tolerance](const KeyVec& key)
+		{
+			return glm::distance(key.value, keys.front().value) <= tolerance;
+		});
+
+		if (isConstant)
 		{
-			if (animationTime < rotations[index + 1].time)
+			track.min = keys.front().value;
+			return;
+		}
+
+		const std::vector<size_t> keptIndices = ReduceKeys(keys, tolerance,
+			[](const glm::vec3& a, const glm::vec3& b, const float scaleFactor) { return glm::mix(a, b, scaleFactor); },
+			[](const glm::vec3& a, const glm::vec3& b) { return glm::distance(a, b); });
+
+		glm::vec3 min = keys[keptIndices.front()].value;
+		glm::vec3 max = min;
+		for (const size_t index : keptIndices)
+		{
+			min = glm::min(min, keys[index].value);
+			max = glm::max(max, keys[index].value);
+		}
+
+		track.min = min;
+		track.extent = max - min;
+		track.times.reserve(keptIndices.size());
+		track.values.reserve(keptIndices.size());
+
+		for (const size_t index : keptIndices)
+		{
+			glm::vec3 normalized = glm::vec3(0.0f);
+			for (int component = 0; component < 3; component++)
 			{
-				return index;
+				if (track.extent[component] > 0.0f)
+				{
+					normalized[component] = (keys[index].value[component] - min[component]) / track.extent[component];
+				}
 			}
+
+			track.times.emplace_back(keys[index].time);
+			track.values.emplace_back(glm::u16vec3(glm::round(glm::clamp(normalized, 0.0f, 1.0f) * rangeMax)));
 		}
-		assert(0);
 	}
 
-	int SkeletalAnimation::Bone::GetScaleIndex(float animationTime) const
+	void SkeletalAnimation::Channel::CompressTrack(
+		const std::vector<KeyQuat>& keys,
+		const float tolerance,
+		QuatTrack& track)
 	{
-		for (int index = 0; index < scales.size() - 1; ++index)
+		if (keys.empty())
+		{
+			return;
+		}
+
+		const bool isConstant = std::all_of(keys.begin(), keys.end(), [&keys, tolerance](const KeyQuat& key)
 		{
-			if (animationTime < scales[index + 1].time)
+			return GetAngle(key.value, keys.front().value) <= tolerance;
+		});
+
+		if (isConstant)
+		{
+			track.constant = glm::normalize(keys.front().value);
+			return;
+		}
+
+		const std::vector<size_t> keptIndices = ReduceKeys(keys, tolerance,
+			[](const glm::quat& a, const glm::quat& b, const float scaleFactor) { return glm::normalize(glm::slerp(a, b, scaleFactor)); },
+			[](const glm::quat& a, const glm::quat& b) { return GetAngle(a, b); });
+
+		track.times.reserve(keptIndices.size());
+		track.values.reserve(keptIndices.size());
+
+		for (const size_t index : keptIndices)
+		{
+			const glm::quat rotation = glm::normalize(keys[index].value);
+			float components[4] = { rotation.x, rotation.y, rotation.z, rotation.w };
+
+			int largestIndex = 0;
+			for (int component = 1; component < 4; component++)
 			{
-				return index;
+				if (std::abs(components[component]) > std::abs(components[largestIndex]))
+				{
+					largestIndex = component;
+				}
 			}
+
+			// q and -q are the same rotation, keep the largest component positive so it can be restored from the others.
+			const float sign = components[largestIndex] < 0.0f ? -1.0f : 1.0f;
+
+			uint16_t quantized[3]{};
+			for (int component = 0, smallIndex = 0; component < 4; component++)
+			{
+				if (component == largestIndex)
+				{
+					continue;
+				}
+
+				const float normalized = glm::clamp(sign * components[component] / smallestThreeRange * 0.5f + 0.5f, 0.0f, 1.0f);
+				quantized[smallIndex++] = static_cast<uint16_t>(std::round(normalized * smallestThreeMax));
+			}
+
+			// The index of the largest component is kept in the high bits of the first two values.
+			quantized[0] |= (largestIndex & 1) << 15;
+			quantized[1] |= (largestIndex >> 1) << 15;
+
+			track.times.emplace_back(keys[index].time);
+			track.values.emplace_back(quantized[0], quantized[1], quantized[2]);
 		}
-		assert(0);
 	}
 
-	float SkeletalAnimation::Bone::GetScaleFactor(float lastTime, float nextTime, float time) const
+	glm::vec3 SkeletalAnimation::Channel::Decode(const VecTrack& track, const size_t index)
+	{
+		return track.min + track.extent * (glm::vec3(track.values[index]) / rangeMax);
+	}
+
+	glm::quat SkeletalAnimation::Channel::Decode(const QuatTrack& track, const size_t index)
 	{
-		return (time - lastTime) / (nextTime - lastTime);
+		const glm::u16vec3& value = track.values[index];
+		const int largestIndex = (value.x >> 15) | ((value.y >> 15) << 1);
+
+		const float smallComponents[3] =
+		{
+			((value.x & 0x7FFF) / smallestThreeMax * 2.0f - 1.0f) * smallestThreeRange,
+			((value.y & 0x7FFF) / smallestThreeMax * 2.0f - 1.0f) * smallestThreeRange,
+			((value.z & 0x7FFF) / smallestThreeMax * 2.0f - 1.0f) * smallestThreeRange
+		};
+
+		float components[4]{};
+		float lengthSquared = 0.0f;
+		for (int component = 0, smallIndex = 0; component < 4; component++)
+		{
+			if (component != largestIndex)
+			{
+				components[component] = smallComponents[smallIndex++];
+				lengthSquared += components[component] * components[component];
+			}
+		}
+		components[largestIndex] = std::sqrt(glm::max(0.0f, 1.0f - lengthSquared));
+
+		return glm::normalize(glm::quat(components[3], components[0], components[1], components[2]));
 	}
 
-	glm::vec3 SkeletalAnimation::Bone::InterpolatePosition(float time) const
+	glm::vec3 SkeletalAnimation::Channel::Sample(const VecTrack& track, const float time, uint32_t* cursor)
 	{
-		if (positions.empty())
+		if (track.times.empty())
+		{
+			return track.min;
+		}
+
+		if (time <= track.times.front())
 		{
-			return glm::vec3(0.0f);
+			return Decode(track, 0);
 		}
 
-		if (positions.size() == 1)
+		if (time >= track.times.back())
 		{
-			return positions[0].value;
+			return Decode(track, track.times.size() - 1);
 		}
 
-		const int p0Index = GetPositionIndex(time);
-		const int p1Index = p0Index + 1;
-		const float scaleFactor = GetScaleFactor(positions[p0Index].time, positions[p1Index].time, time);
-		return glm::mix(positions[p0Index].value, positions[p1Index].value, scaleFactor);
+		const uint32_t index = FindKey(track.times, time, cursor);
+		const float scaleFactor = GetScaleFactor(track.times[index], track.times[index + 1], time);
+		return glm::mix(Decode(track, index), Decode(track, index + 1), scaleFactor);
 	}
 
-	glm::quat SkeletalAnimation::Bone::InterpolateRotation(float time) const
+	glm::quat SkeletalAnimation::Channel::Sample(const QuatTrack& track, const float time, uint32_t* cursor)
 	{
-		if (rotations.empty())
+		if (track.times.empty())
+		{
+			return track.constant;
+		}
+
+		if (time <= track.times.front())
 		{
-			return glm::quat(glm::vec3(0.0f));
+			return Decode(track, 0);
 		}
 
-		if (rotations.size() == 1)
+		if (time >= track.times.back())
 		{
-			return glm::normalize(rotations[0].value);
+			return Decode(track, track.times.size() - 1);
 		}
 
-		const int p0Index = GetRotationIndex(time);
-		const int p1Index = p0Index + 1;
-		const float scaleFactor = GetScaleFactor(rotations[p0Index].time, rotations[p1Index].time, time);
-		return glm::normalize(glm::slerp(rotations[p0Index].value, rotations[p1Index].value, scaleFactor));
+		const uint32_t index = FindKey(track.times, time, cursor);
+		const float scaleFactor = GetScaleFactor(track.times[index], track.times[index + 1], time);
+		return glm::normalize(glm::slerp(Decode(track, index), Decode(track, index + 1), scaleFactor));
 	}
 
-	glm::vec3 SkeletalAnimation::Bone::InterpolateScaling(float time) const
+	uint32_t SkeletalAnimation::Channel::FindKey(const std::vector<float>& times, const float time, uint32_t* cursor)
 	{
-		if (scales.empty())
+		const uint32_t lastSegment = static_cast<uint32_t>(times.size()) - 2;
+
+		if (cursor && *cursor <= lastSegment && times[*cursor] <= time)
 		{
-			return glm::vec3(1.0f);
+			// Playback moves forward by a few keys per frame at most, otherwise fall back to the binary search.
+			uint32_t index = *cursor;
+			for (uint32_t step = 0; step < 4 && index <= lastSegment; step++, index++)
+			{
+				if (time < times[index + 1])
+				{
+					*cursor = index;
+					return index;
+				}
+			}
 		}
 
-		if (scales.size() == 1)
+		const auto upper = std::upper_bound(times.begin(), times.end(), time);
+		const uint32_t index = glm::min(static_cast<uint32_t>(std::distance(times.begin(), upper)) - 1, lastSegment);
+
+		if (cursor)
 		{
-			return scales[0].value;
+			*cursor = index;
 		}
 
-		const int p0Index = GetScaleIndex(time);
-		const int p1Index = p0Index + 1;
-		const float scaleFactor = GetScaleFactor(scales[p0Index].time, scales[p1Index].time, time);
-		return glm::mix(scales[p0Index].value, scales[p1Index].value, scaleFactor);
+		return index;
 	}
 
 }
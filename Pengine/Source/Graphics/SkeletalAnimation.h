@@ -3,6 +3,8 @@
 #include "../Core/Core.h"
 #include "../Core/Asset.h"
 
+#include "glm/gtc/type_precision.hpp"
+
 namespace Pengine
 {
 
@@ -21,31 +23,95 @@ namespace Pengine
 			glm::quat value;
 		};
 
-		class Bone
+		/**
+		 * Full precision keyframes of one bone as they are imported or written to the file,
+		 * only used to create the compressed channels.
+		 */
+		struct Bone
 		{
-		public:
 			std::vector<KeyVec> positions;
 			std::vector<KeyQuat> rotations;
 			std::vector<KeyVec> scales;
+		};
+
+		/**
+		 * Keys that can be restored by interpolating their neighbours within the tolerance are removed,
+		 * zero tolerances keep every key that is not an exact duplicate.
+		 */
+		struct CompressionSettings
+		{
+			float positionTolerance = 0.0f;
+			float rotationTolerance = 0.0f; // Radians.
+			float scaleTolerance = 0.0f;
+		};
+
+		/**
+		 * Last sampled key of every track, sampling forward in time from it is amortized O(1).
+		 */
+		struct Cursor
+		{
+			uint32_t position = 0;
+			uint32_t rotation = 0;
+			uint32_t scale = 0;
+		};
 
-			glm::mat4 Update(float time) const;
+		/**
+		 * Compressed keyframes of one bone, positions and scales are quantized to 16 bits per component
+		 * in the range of the track and rotations are stored as the smallest three components.
+		 * A track without time keys is constant and keeps only a full precision value.
+		 */
+		class Channel
+		{
+		public:
+			Channel(const Bone& bone, const CompressionSettings& compressionSettings);
 
-			void Update(float time, glm::vec3& position, glm::quat& rotation, glm::vec3& scale) const;
+			glm::mat4 Update(float time, Cursor* cursor = nullptr) const;
 
-			int GetPositionIndex(float animationTime) const;
+			void Update(float time, glm::vec3& position, glm::quat& rotation, glm::vec3& scale, Cursor* cursor = nullptr) const;
 
-			int GetRotationIndex(float animationTime) const;
+			/**
+			 * Restores the keys that are left after compression, used for serialization.
+			 */
+			[[nodiscard]] Bone Decompress() const;
 
-			int GetScaleIndex(float animationTime) const;
+			[[nodiscard]] size_t GetMemorySize() const;
 
 		private:
-			float GetScaleFactor(float lastTime, float nextTime, float time) const;
+			struct VecTrack
+			{
+				std::vector<float> times;
+				std::vector<glm::u16vec3> values;
+				glm::vec3 min = glm::vec3(0.0f);
+				glm::vec3 extent = glm::vec3(0.0f);
+			};
+
+			struct QuatTrack
+			{
+				std::vector<float> times;
+				std::vector<glm::u16vec3> values;
+				glm::quat constant = glm::quat(1.0f, 0.0f, 0.0f, 0.0f);
+			};
+
+			static void CompressTrack(const std::vector<KeyVec>& keys, float tolerance, const glm::vec3& defaultValue, VecTrack& track);
+
+			static void CompressTrack(const std::vector<KeyQuat>& keys, float tolerance, QuatTrack& track);
 
-			glm::vec3 InterpolatePosition(float time) const;
+			static glm::vec3 Decode(const VecTrack& track, size_t index);
 
-			glm::quat InterpolateRotation(float time) const;
+			static glm::quat Decode(const QuatTrack& track, size_t index);
 
-			glm::vec3 InterpolateScaling(float time) const;
+			static glm::vec3 Sample(const VecTrack& track, float time, uint32_t* cursor);
+
+			static glm::quat Sample(const QuatTrack& track, float time, uint32_t* cursor);
+
+			/**
+			 * Returns the index of the key that starts the segment containing the time.
+			 */
+			static uint32_t FindKey(const std::vector<float>& times, float time, uint32_t* cursor);
+
+			VecTrack m_Positions;
+			QuatTrack m_Rotations;
+			VecTrack m_Scales;
 		};
 
 		struct CreateInfo
@@ -54,23 +120,19 @@ namespace Pengine
 			std::filesystem::path filepath;
 			double duration;
 			std::unordered_map<std::string, Bone> bonesByName;
+			CompressionSettings compressionSettings{};
 		};
 
-		SkeletalAnimation(const CreateInfo& createInfo)
-			: Asset(createInfo.name, createInfo.filepath)
-			, m_Duration(createInfo.duration)
-			, m_BonesByName(createInfo.bonesByName)
-		{
-		}
+		SkeletalAnimation(const CreateInfo& createInfo);
 
 		[[nodiscard]] double GetDuration() const { return m_Duration; }
 
-		[[nodiscard]] const std::unordered_map<std::string, Bone>& GetBonesByName() const { return m_BonesByName; }
+		[[nodiscard]] const std::unordered_map<std::string, Channel>& GetChannelsByName() const { return m_ChannelsByName; }
 
 	private:
 		double m_Duration;
 
-		std::unordered_map<std::string, Bone> m_BonesByName;
+		std::unordered_map<std::string, Channel> m_ChannelsByName;
 	};
 
 }
@@ -33,16 +33,65 @@ namespace Pengine
 			, m_RootBoneIds(createInfo.rootBoneIds)
 			, m_Bones(createInfo.bones)
 		{
+			SortBones();
 		}
 
 		[[nodiscard]] const std::vector<uint32_t>& GetRootBoneIds() const { return m_RootBoneIds; }
 
 		[[nodiscard]] const std::vector<Bone>& GetBones() const { return m_Bones; }
 
+		/**
+		 * Bone ids ordered so that every parent goes before its children,
+		 * the whole skeleton can be evaluated in a single linear pass.
+		 */
+		[[nodiscard]] const std::vector<uint32_t>& GetSortedBoneIds() const { return m_SortedBoneIds; }
+
+		/**
+		 * Index of the parent in GetSortedBoneIds() for every sorted bone, -1 for the root bones.
+		 */
+		[[nodiscard]] const std::vector<int32_t>& GetSortedParentIndices() const { return m_SortedParentIndices; }
+
+		/**
+		 * Number of sorted bones whose depth in the hierarchy is not greater than maxDepth, root bones have depth 0.
+		 * Deeper bones always go after them in GetSortedBoneIds().
+		 */
+		[[nodiscard]] size_t GetSortedBoneCount(const uint32_t maxDepth) const
+		{
+			return std::distance(m_SortedBoneDepths.begin(), std::upper_bound(m_SortedBoneDepths.begin(), m_SortedBoneDepths.end(), maxDepth));
+		}
+
 	private:
+		void SortBones()
+		{
+			m_SortedBoneIds.reserve(m_Bones.size());
+			m_SortedParentIndices.reserve(m_Bones.size());
+			m_SortedBoneDepths.reserve(m_Bones.size());
+
+			for (const uint32_t rootBoneId : m_RootBoneIds)
+			{
+				m_SortedBoneIds.emplace_back(rootBoneId);
+				m_SortedParentIndices.emplace_back(-1);
+				m_SortedBoneDepths.emplace_back(0);
+			}
+
+			// Breadth first, children are appended after their parent has been visited.
+			for (size_t i = 0; i < m_SortedBoneIds.size(); i++)
+			{
+				for (const uint32_t childId : m_Bones[m_SortedBoneIds[i]].childIds)
+				{
+					m_SortedBoneIds.emplace_back(childId);
+					m_SortedParentIndices.emplace_back(static_cast<int32_t>(i));
+					m_SortedBoneDepths.emplace_back(m_SortedBoneDepths[i] + 1);
+				}
+			}
+		}
 
 		std::vector<uint32_t> m_RootBoneIds;
 		std::vector<Bone> m_Bones;
+
+		std::vector<uint32_t> m_SortedBoneIds;
+		std::vector<int32_t> m_SortedParentIndices;
+		std::vector<uint32_t> m_SortedBoneDepths;
 	};
 
 }
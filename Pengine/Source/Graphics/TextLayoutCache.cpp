@@ -0,0 +1,137 @@
+#include "TextLayoutCache.h"
+
+#include "Font.h"
+
+#include "../Core/Profiler.h"
+#include "../Utils/Utils.h"
+
+using namespace Pengine;
+
+TextLayoutCache::TextLayoutCache(const size_t capacity)
+	: m_Capacity(capacity)
+{
+	m_EntriesByKey.reserve(capacity);
+}
+
+std::shared_ptr<const TextLayoutCache::Layout> TextLayoutCache::Get(
+	Font& font,
+	const uint16_t fontSize,
+	const uint16_t letterSpacing,
+	const std::string_view text)
+{
+	const Key key = MakeKey(font, fontSize, letterSpacing, text);
+
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		if (const auto entryByKey = m_EntriesByKey.find(key);
+			entryByKey != m_EntriesByKey.end())
+		{
+			m_Entries.splice(m_Entries.begin(), m_Entries, entryByKey->second);
+			m_HitCount++;
+
+			return entryByKey->second->layout;
+		}
+	}
+
+	// Built without the lock, new glyphs are rasterised here.
+	std::shared_ptr<const Layout> layout = std::make_shared<Layout>(Build(font, fontSize, letterSpacing, text));
+
+	std::lock_guard<std::mutex> lock(m_Mutex);
+	m_MissCount++;
+
+	// Another thread could have built the same layout in the meantime.
+	if (const auto entryByKey = m_EntriesByKey.find(key);
+		entryByKey != m_EntriesByKey.end())
+	{
+		return entryByKey->second->layout;
+	}
+
+	if (m_Capacity == 0)
+	{
+		return layout;
+	}
+
+	while (m_Entries.size() >= m_Capacity)
+	{
+		m_EntriesByKey.erase(m_Entries.back().key);
+		m_Entries.pop_back();
+	}
+
+	Entry& entry = m_Entries.emplace_front();
+	entry.text = text;
+	entry.key = key;
+	entry.key.text = entry.text;
+	entry.layout = layout;
+	m_EntriesByKey.emplace(entry.key, m_Entries.begin());
+
+	return layout;
+}
+
+TextLayoutCache::Layout TextLayoutCache::Build(
+	Font& font,
+	const uint16_t fontSize,
+	const uint16_t letterSpacing,
+	const std::string_view text)
+{
+	PROFILER_SCOPE(__FUNCTION__);
+
+	const float scale = Font::GetScale(fontSize);
+
+	Layout layout{};
+	layout.glyphs.reserve(text.size());
+
+	float pen = 0.0f;
+	float width = 0.0f;
+	int height = 0;
+	for (size_t offset = 0; offset < text.size();)
+	{
+		const Font::Glyph glyph = font.GetGlyph(Utils::DecodeUtf8(text, offset));
+
+		if (glyph.rect.size.x > 0 && glyph.rect.size.y > 0)
+		{
+			PositionedGlyph& positionedGlyph = layout.glyphs.emplace_back();
+			positionedGlyph.rect = glyph.rect;
+			positionedGlyph.offset = { pen + glyph.bearing.x * scale, -glyph.bearing.y * scale };
+			positionedGlyph.size = glm::vec2(glyph.rect.size) * scale;
+		}
+
+		width = pen + glyph.advance * scale;
+		pen = width + letterSpacing;
+		height = glm::max(height, glyph.height);
+	}
+
+	layout.size = glm::ivec2(glm::ceil(glm::vec2(width, height * scale)));
+
+	return layout;
+}
+
+void TextLayoutCache::Clear()
+{
+	std::lock_guard<std::mutex> lock(m_Mutex);
+	m_EntriesByKey.clear();
+	m_Entries.clear();
+}
+
+size_t TextLayoutCache::GetSize() const
+{
+	std::lock_guard<std::mutex> lock(m_Mutex);
+	return m_Entries.size();
+}
+
+TextLayoutCache::Key TextLayoutCache::MakeKey(
+	const Font& font,
+	const uint16_t fontSize,
+	const uint16_t letterSpacing,
+	const std::string_view text)
+{
+	Key key{};
+	key.text = text;
+	key.fontId = font.GetId();
+	key.fontSize = fontSize;
+	key.letterSpacing = letterSpacing;
+
+	const uint64_t style = static_cast<uint64_t>(key.fontId) | static_cast<uint64_t>(fontSize) << 16 | static_cast<uint64_t>(letterSpacing) << 32;
+	key.hash = Utils::CombineHash(Utils::HashBytes(text.data(), text.size()), std::hash<uint64_t>{}(style));
+
+	return key;
+}
@@ -0,0 +1,111 @@
+#pragma once
+
+#include "../Core/Core.h"
+
+#include "FontAtlas.h"
+
+#include <atomic>
+#include <list>
+#include <mutex>
+
+namespace Pengine
+{
+
+	class Font;
+
+	/**
+	 * Measured size and positioned glyphs of a string, least recently used layouts are evicted.
+	 * Clay measures every text element on every layout and the UI renderer emits the same strings again,
+	 * both read the layout from here so a string is only walked glyph by glyph when it changes.
+	 */
+	class PENGINE_API TextLayoutCache
+	{
+	public:
+		struct PositionedGlyph
+		{
+			FontAtlas::Rect rect;
+
+			/**
+			 * Top left corner of the quad relative to the start of the baseline.
+			 */
+			glm::vec2 offset = { 0.0f, 0.0f };
+			glm::vec2 size = { 0.0f, 0.0f };
+		};
+
+		struct Layout
+		{
+			/**
+			 * Only glyphs that have a quad, whitespace just moves the pen.
+			 */
+			std::vector<PositionedGlyph> glyphs;
+			glm::ivec2 size = { 0, 0 };
+		};
+
+		explicit TextLayoutCache(const size_t capacity);
+		TextLayoutCache(const TextLayoutCache&) = delete;
+		TextLayoutCache& operator=(const TextLayoutCache&) = delete;
+
+		/**
+		 * Returns the cached layout or builds it, the layout stays valid after it is evicted.
+		 */
+		std::shared_ptr<const Layout> Get(Font& font, const uint16_t fontSize, const uint16_t letterSpacing, const std::string_view text);
+
+		static Layout Build(Font& font, const uint16_t fontSize, const uint16_t letterSpacing, const std::string_view text);
+
+		void Clear();
+
+		[[nodiscard]] size_t GetSize() const;
+
+		[[nodiscard]] size_t GetCapacity() const { return m_Capacity; }
+
+		[[nodiscard]] uint64_t GetHitCount() const { return m_HitCount; }
+
+		[[nodiscard]] uint64_t GetMissCount() const { return m_MissCount; }
+
+	private:
+		/**
+		 * The text points into Entry::text, list nodes don't move so the view stays valid until the entry is evicted.
+		 */
+		struct Key
+		{
+			std::string_view text;
+			size_t hash = 0;
+			uint16_t fontId = 0;
+			uint16_t fontSize = 0;
+			uint16_t letterSpacing = 0;
+
+			bool operator==(const Key& other) const
+			{
+				return hash == other.hash && fontId == other.fontId && fontSize == other.fontSize &&
+					letterSpacing == other.letterSpacing && text == other.text;
+			}
+		};
+
+		struct KeyHash
+		{
+			size_t operator()(const Key& key) const { return key.hash; }
+		};
+
+		struct Entry
+		{
+			std::string text;
+			Key key;
+			std::shared_ptr<const Layout> layout;
+		};
+
+		static Key MakeKey(const Font& font, const uint16_t fontSize, const uint16_t letterSpacing, const std::string_view text);
+
+		/**
+		 * Most recently used first.
+		 */
+		std::list<Entry> m_Entries;
+		std::unordered_map<Key, std::list<Entry>::iterator, KeyHash> m_EntriesByKey;
+
+		size_t m_Capacity = 0;
+		std::atomic<uint64_t> m_HitCount = 0;
+		std::atomic<uint64_t> m_MissCount = 0;
+
+		mutable std::mutex m_Mutex;
+	};
+
+}
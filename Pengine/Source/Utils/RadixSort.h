@@ -0,0 +1,79 @@
+#pragma once
+
+#include "../Core/Core.h"
+
+#include <array>
+
+namespace Pengine::Utils
+{
+
+	struct SortEntry
+	{
+		uint64_t key = 0;
+		uint32_t index = 0;
+	};
+
+	/**
+	 * Stable least significant digit radix sort by key, ascending.
+	 * The histograms of all digits are counted in one pass over the entries and digits that are equal
+	 * for every entry are skipped, so keys that only differ in a few bytes only cost a few scatters.
+	 * The scratch is kept by the caller to not allocate every frame.
+	 */
+	inline void RadixSort(std::vector<SortEntry>& entries, std::vector<SortEntry>& scratch)
+	{
+		constexpr size_t digitBits = 8;
+		constexpr size_t digitCount = sizeof(uint64_t) * 8 / digitBits;
+		constexpr size_t bucketCount = 1 << digitBits;
+		constexpr uint64_t digitMask = bucketCount - 1;
+
+		const size_t entryCount = entries.size();
+		if (entryCount < 2)
+		{
+			return;
+		}
+
+		std::array<std::array<uint32_t, bucketCount>, digitCount> histograms{};
+		for (const SortEntry& entry : entries)
+		{
+			for (size_t digit = 0; digit < digitCount; digit++)
+			{
+				histograms[digit][(entry.key >> (digit * digitBits)) & digitMask]++;
+			}
+		}
+
+		scratch.resize(entryCount);
+
+		SortEntry* source = entries.data();
+		SortEntry* destination = scratch.data();
+		for (size_t digit = 0; digit < digitCount; digit++)
+		{
+			const size_t shift = digit * digitBits;
+			std::array<uint32_t, bucketCount>& histogram = histograms[digit];
+			if (histogram[(source[0].key >> shift) & digitMask] == entryCount)
+			{
+				continue;
+			}
+
+			uint32_t offset = 0;
+			for (uint32_t& count : histogram)
+			{
+				const uint32_t bucketSize = count;
+				count = offset;
+				offset += bucketSize;
+			}
+
+			for (size_t i = 0; i < entryCount; i++)
+			{
+				destination[histogram[(source[i].key >> shift) & digitMask]++] = source[i];
+			}
+
+			std::swap(source, destination);
+		}
+
+		if (source != entries.data())
+		{
+			std::copy(source, source + entryCount, entries.data());
+		}
+	}
+
+}
@@ -184,6 +184,73 @@ namespace Pengine::Utils
 		return *(T*)((char*)data + offset);
 	}
 
+	inline size_t CombineHash(const size_t seed, const size_t hash)
+	{
+		return seed ^ (hash + 0x9e3779b97f4a7c15ull + (seed << 6) + (seed >> 2));
+	}
+
+	inline size_t HashBytes(const void* data, const size_t size)
+	{
+		return std::hash<std::string_view>{}(std::string_view(static_cast<const char*>(data), size));
+	}
+
+	/**
+	 * Decodes the UTF-8 code point at offset and moves offset past it.
+	 * A malformed sequence decodes to U+FFFD and skips one byte.
+	 */
+	inline uint32_t DecodeUtf8(const std::string_view text, size_t& offset)
+	{
+		constexpr uint32_t replacementCharacter = 0xFFFD;
+
+		const uint8_t lead = static_cast<uint8_t>(text[offset++]);
+		if (lead < 0x80)
+		{
+			return lead;
+		}
+
+		size_t continuationCount;
+		uint32_t codepoint;
+		if ((lead & 0xE0) == 0xC0)
+		{
+			continuationCount = 1;
+			codepoint = lead & 0x1F;
+		}
+		else if ((lead & 0xF0) == 0xE0)
+		{
+			continuationCount = 2;
+			codepoint = lead & 0x0F;
+		}
+		else if ((lead & 0xF8) == 0xF0)
+		{
+			continuationCount = 3;
+			codepoint = lead & 0x07;
+		}
+		else
+		{
+			return replacementCharacter;
+		}
+
+		if (offset + continuationCount > text.size())
+		{
+			return replacementCharacter;
+		}
+
+		for (size_t i = 0; i < continuationCount; i++)
+		{
+			const uint8_t continuation = static_cast<uint8_t>(text[offset + i]);
+			if ((continuation & 0xC0) != 0x80)
+			{
+				return replacementCharacter;
+			}
+
+			codepoint = (codepoint << 6) | (continuation & 0x3F);
+		}
+
+		offset += continuationCount;
+
+		return codepoint;
+	}
+
 	inline std::string Replace(const std::string& string, const char what, const char to)
 	{
 		std::string replacedString = string;
@@ -88,7 +88,7 @@ std::shared_ptr<VulkanBuffer> VulkanBuffer::CreateStagingBuffer(
 		false);
 }
 
-VkBufferUsageFlagBits VulkanBuffer::ConvertUsage(const Usage usage)
+VkBufferUsageFlags VulkanBuffer::ConvertUsage(const Usage usage)
 {
 	switch (usage)
 	{
@@ -100,6 +100,8 @@ VkBufferUsageFlagBits VulkanBuffer::ConvertUsage(const Usage usage)
 		return VK_BUFFER_USAGE_INDEX_BUFFER_BIT;
 	case Pengine::Buffer::Usage::STORAGE_BUFFER:
 		return VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
+	case Pengine::Buffer::Usage::STORAGE_VERTEX_BUFFER:
+		return VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
 	}
 
 	FATAL_ERROR("Failed to convert buffer usage!");
@@ -147,7 +149,7 @@ VulkanBuffer::VulkanBuffer(
 		m_Data = new uint8_t[m_BufferSize];
 	}
 
-	m_IsChanged.resize(m_IsMultiBuffered ? swapChainImageCount : 1, false);
+	m_DirtyRanges.resize(m_IsMultiBuffered ? swapChainImageCount : 1);
 	m_BufferDatas.resize(m_IsMultiBuffered ? swapChainImageCount : 1);
 	for (BufferData& bufferData : m_BufferDatas)
 	{
@@ -196,7 +198,19 @@ void VulkanBuffer::WriteToBuffer(void* data, const size_t size, const size_t off
 {
 	if (m_IsMultiBuffered)
 	{
-		m_IsChanged.assign(m_IsChanged.size(), true);
+		for (DirtyRange& dirtyRange : m_DirtyRanges)
+		{
+			if (dirtyRange.begin == dirtyRange.end)
+			{
+				dirtyRange = { offset, offset + size };
+			}
+			else
+			{
+				dirtyRange.begin = std::min(dirtyRange.begin, offset);
+				dirtyRange.end = std::max(dirtyRange.end, offset + size);
+			}
+		}
+
 		memcpy((void*)&m_Data[offset], data, size);
 	}
 	else
@@ -216,7 +230,7 @@ void VulkanBuffer::Copy(
 		Logger::Error("Can't copy buffer, src size is bigger than dst size!");
 	}
 
-	m_IsChanged.assign(m_IsChanged.size(), true);
+	m_DirtyRanges.assign(m_DirtyRanges.size(), DirtyRange{ 0, GetSize() });
 
 	if (m_IsMultiBuffered)
 	{
@@ -240,39 +254,42 @@ void VulkanBuffer::Flush()
 		return;
 	}
 
-	const uint32_t imageIndex = m_IsChanged.size() == 1 ? 0 : swapChainImageIndex;
+	const uint32_t imageIndex = m_DirtyRanges.size() == 1 ? 0 : swapChainImageIndex;
 
-	if (!m_IsChanged[imageIndex])
+	DirtyRange& dirtyRange = m_DirtyRanges[imageIndex];
+	if (dirtyRange.begin == dirtyRange.end)
 	{
 		return;
 	}
 
-	// TODO: can be done more optimal by coping just updated parts of the buffer.
+	// Only the bytes written since this frame's copy was flushed are copied.
+	const size_t size = dirtyRange.end - dirtyRange.begin;
 	if (m_MemoryType == MemoryType::CPU)
 	{
 		vmaCopyMemoryToAllocation(
 			GetVkDevice()->GetVmaAllocator(),
-			m_Data,
+			&m_Data[dirtyRange.begin],
 			m_BufferDatas[imageIndex].m_VmaAllocation,
-			0,
-			GetSize());
+			dirtyRange.begin,
+			size);
 	}
 	else if (m_MemoryType == MemoryType::GPU)
 	{
 		const std::shared_ptr<VulkanBuffer> stagingBuffer = CreateStagingBuffer(
-			GetSize(),
+			size,
 			1);
 
-		stagingBuffer->WriteToBuffer(m_Data, GetSize(), 0);
+		stagingBuffer->WriteToBuffer(&m_Data[dirtyRange.begin], size, 0);
 
 		GetVkDevice()->CopyBuffer(
 			stagingBuffer->m_BufferDatas.begin()->m_Buffer,
 			m_BufferDatas[imageIndex].m_Buffer,
-			GetSize(),
-			0);
+			size,
+			0,
+			dirtyRange.begin);
 	}
 
-	m_IsChanged[imageIndex] = false;
+	dirtyRange = {};
 }
 
 NativeHandle VulkanBuffer::GetNativeHandle() const
@@ -285,8 +302,9 @@ VkDescriptorBufferInfo VulkanBuffer::GetDescriptorInfo(
 	const VkDeviceSize size,
 	const VkDeviceSize offset) const
 {
+	// Buffers that are not multibuffered can be written into multibuffered uniform writers, all frames share the same buffer.
 	return VkDescriptorBufferInfo{
-		m_BufferDatas[imageIndex].m_Buffer,
+		m_BufferDatas[imageIndex * m_IsMultiBuffered].m_Buffer,
 		offset,
 		size,
 	};
@@ -22,7 +22,7 @@ namespace Pengine::Vk
 			VkDeviceSize instanceSize,
 			uint32_t instanceCount);
 
-		static VkBufferUsageFlagBits ConvertUsage(Usage usage);
+		static VkBufferUsageFlags ConvertUsage(Usage usage);
 
 		static Usage ConvertUsage(VkBufferUsageFlagBits usage);
 
@@ -104,7 +104,16 @@ namespace Pengine::Vk
 		VmaMemoryUsage m_MemoryUsage;
 		VmaAllocationCreateFlags m_MemoryFlags;
 
-		std::vector<bool> m_IsChanged;
+		/**
+		 * Bytes of m_Data written since the frame's copy was last flushed, empty when begin == end.
+		 */
+		struct DirtyRange
+		{
+			size_t begin = 0;
+			size_t end = 0;
+		};
+
+		std::vector<DirtyRange> m_DirtyRanges;
 	};
 
 }
\ No newline at end of file
@@ -74,7 +74,7 @@ VulkanComputePipeline::VulkanComputePipeline(const CreateComputeInfo& createComp
 	vkComputePipelineCreateInfo.basePipelineIndex = -1;
 	vkComputePipelineCreateInfo.basePipelineHandle = VK_NULL_HANDLE;
 
-	if (vkCreateComputePipelines(GetVkDevice()->GetDevice(), VK_NULL_HANDLE, 1,
+	if (vkCreateComputePipelines(GetVkDevice()->GetDevice(), GetVkDevice()->GetPipelineCache(), 1,
 		&vkComputePipelineCreateInfo, nullptr, &m_ComputePipeline) != VK_SUCCESS)
 	{
 		FATAL_ERROR("Failed to create graphics pipeline!");
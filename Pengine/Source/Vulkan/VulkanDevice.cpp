@@ -13,6 +13,7 @@
 #include <imgui/backends/imgui_impl_vulkan.h>
 
 #include <cstring>
+#include <fstream>
 #include <iostream>
 #include <set>
 #include <unordered_set>
@@ -20,6 +21,32 @@
 using namespace Pengine;
 using namespace Vk;
 
+namespace
+{
+	constexpr uint32_t pipelineCacheMagic = 0x50504C43; // "PPLC".
+	constexpr uint32_t pipelineCacheVersion = 1;
+
+	/**
+	 * Written in front of the driver blob, so a cache produced by another GPU or driver
+	 * is rejected before it is handed to vkCreatePipelineCache.
+	 */
+	struct PipelineCacheHeader
+	{
+		uint32_t magic = pipelineCacheMagic;
+		uint32_t version = pipelineCacheVersion;
+		uint32_t vendorID = 0;
+		uint32_t deviceID = 0;
+		uint32_t driverVersion = 0;
+		uint8_t pipelineCacheUUID[VK_UUID_SIZE]{};
+		uint64_t dataSize = 0;
+	};
+
+	std::filesystem::path GetPipelineCacheFilepath(const VkPhysicalDeviceProperties& properties)
+	{
+		return std::filesystem::path("Shaders") / "Cache" / std::format("PipelineCache_{:x}_{:x}.bin", properties.vendorID, properties.deviceID);
+	}
+}
+
 static VKAPI_ATTR VkBool32 VKAPI_CALL DebugCallback(
 	VkDebugUtilsMessageSeverityFlagBitsEXT messageSeverity,
 	VkDebugUtilsMessageTypeFlagsEXT messageType,
@@ -326,6 +353,133 @@ void VulkanDevice::CreateVmaAllocator()
 	}
 }
 
+void VulkanDevice::CreatePipelineCache()
+{
+	const std::filesystem::path filepath = GetPipelineCacheFilepath(m_PhysicalDeviceProperties);
+
+	std::vector<char> initialData;
+	if (std::filesystem::exists(filepath))
+	{
+		std::error_code errorCode;
+		const uintmax_t fileSize = std::filesystem::file_size(filepath, errorCode);
+
+		std::ifstream in(filepath, std::ifstream::binary);
+
+		PipelineCacheHeader header{};
+		in.read((char*)&header, sizeof(PipelineCacheHeader));
+
+		const bool isValid = in
+			&& header.magic == pipelineCacheMagic
+			&& header.version == pipelineCacheVersion
+			&& header.vendorID == m_PhysicalDeviceProperties.vendorID
+			&& header.deviceID == m_PhysicalDeviceProperties.deviceID
+			&& header.driverVersion == m_PhysicalDeviceProperties.driverVersion
+			&& memcmp(header.pipelineCacheUUID, m_PhysicalDeviceProperties.pipelineCacheUUID, VK_UUID_SIZE) == 0
+			&& header.dataSize >= sizeof(VkPipelineCacheHeaderVersionOne)
+			&& !errorCode
+			&& header.dataSize <= fileSize - sizeof(PipelineCacheHeader);
+
+		if (isValid)
+		{
+			initialData.resize(header.dataSize);
+			in.read(initialData.data(), header.dataSize);
+
+			// The driver validates the blob as well, but a truncated file or a blob that does not
+			// match its own header is better dropped here than passed to a buggy driver.
+			const VkPipelineCacheHeaderVersionOne* vkHeader = (VkPipelineCacheHeaderVersionOne*)initialData.data();
+			if (!in
+				|| vkHeader->headerVersion != VK_PIPELINE_CACHE_HEADER_VERSION_ONE
+				|| vkHeader->vendorID != m_PhysicalDeviceProperties.vendorID
+				|| vkHeader->deviceID != m_PhysicalDeviceProperties.deviceID
+				|| memcmp(vkHeader->pipelineCacheUUID, m_PhysicalDeviceProperties.pipelineCacheUUID, VK_UUID_SIZE) != 0)
+			{
+				initialData.clear();
+			}
+		}
+
+		in.close();
+
+		if (initialData.empty())
+		{
+			Logger::Warning("Device:<" + GetName() + "> Pipeline cache " + filepath.string() + " is outdated or corrupted, it will be rebuilt!");
+		}
+	}
+
+	VkPipelineCacheCreateInfo createInfo{};
+	createInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+	createInfo.initialDataSize = initialData.size();
+	createInfo.pInitialData = initialData.empty() ? nullptr : initialData.data();
+
+	if (vkCreatePipelineCache(m_Device, &createInfo, nullptr, &m_PipelineCache) != VK_SUCCESS)
+	{
+		// Retry without the initial data, the cache is an optimization and must not prevent startup.
+		createInfo.initialDataSize = 0;
+		createInfo.pInitialData = nullptr;
+
+		if (vkCreatePipelineCache(m_Device, &createInfo, nullptr, &m_PipelineCache) != VK_SUCCESS)
+		{
+			Logger::Warning("Device:<" + GetName() + "> Failed to create pipeline cache!");
+			m_PipelineCache = VK_NULL_HANDLE;
+			return;
+		}
+	}
+
+	if (!initialData.empty())
+	{
+		Logger::Log("Device:<" + GetName() + "> Pipeline cache " + filepath.string() + " has been loaded!", BOLDGREEN);
+	}
+}
+
+void VulkanDevice::SavePipelineCache() const
+{
+	if (m_PipelineCache == VK_NULL_HANDLE)
+	{
+		return;
+	}
+
+	size_t dataSize = 0;
+	if (vkGetPipelineCacheData(m_Device, m_PipelineCache, &dataSize, nullptr) != VK_SUCCESS || dataSize == 0)
+	{
+		return;
+	}
+
+	std::vector<char> data(dataSize);
+	if (vkGetPipelineCacheData(m_Device, m_PipelineCache, &dataSize, data.data()) != VK_SUCCESS)
+	{
+		Logger::Warning("Device:<" + GetName() + "> Failed to get pipeline cache data!");
+		return;
+	}
+
+	const std::filesystem::path filepath = GetPipelineCacheFilepath(m_PhysicalDeviceProperties);
+	if (!std::filesystem::exists(filepath.parent_path()))
+	{
+		std::filesystem::create_directories(filepath.parent_path());
+	}
+
+	PipelineCacheHeader header{};
+	header.vendorID = m_PhysicalDeviceProperties.vendorID;
+	header.deviceID = m_PhysicalDeviceProperties.deviceID;
+	header.driverVersion = m_PhysicalDeviceProperties.driverVersion;
+	header.dataSize = dataSize;
+	memcpy(header.pipelineCacheUUID, m_PhysicalDeviceProperties.pipelineCacheUUID, VK_UUID_SIZE);
+
+	// Write to a temporary file first, so a crash during saving doesn't leave a truncated cache behind.
+	std::filesystem::path temporaryFilepath = filepath;
+	temporaryFilepath.concat(".tmp");
+
+	std::ofstream out(temporaryFilepath, std::ostream::binary);
+	out.write((const char*)&header, sizeof(PipelineCacheHeader));
+	out.write(data.data(), dataSize);
+	out.close();
+
+	std::error_code error;
+	std::filesystem::rename(temporaryFilepath, filepath, error);
+	if (error)
+	{
+		Logger::Warning("Device:<" + GetName() + "> Failed to save pipeline cache " + filepath.string() + ", " + error.message());
+	}
+}
+
 VkSurfaceKHR VulkanDevice::CreateSurface(GLFWwindow* window)
 {
 	VkSurfaceKHR surface;
@@ -609,6 +763,7 @@ VulkanDevice::VulkanDevice(const std::string& applicationName)
 	PickPhysicalDevice();
 	CreateLogicalDevice();
 	CreateVmaAllocator();
+	CreatePipelineCache();
 	m_CommandPool = CreateCommandPool();
 
 	if (!m_DescriptorPool)
@@ -645,6 +800,9 @@ void VulkanDevice::ShutDown()
 	// Deleted via VulkanWindow::~VulkanWindow() -> ImGui_ImplVulkanH_DestroyWindow();
 	//vkDestroySurfaceKHR(m_Instance, m_Surface, nullptr);
 
+	SavePipelineCache();
+	vkDestroyPipelineCache(m_Device, m_PipelineCache, nullptr);
+
 	vmaDestroyAllocator(m_VmaAllocator);
 	vkDestroyCommandPool(m_Device, m_CommandPool, nullptr);
 	vkDestroyDevice(m_Device, nullptr);
@@ -79,6 +79,8 @@ namespace Pengine::Vk
 
 		[[nodiscard]] std::shared_ptr<VulkanDescriptorPool> GetDescriptorPool() const { return m_DescriptorPool; }
 
+		[[nodiscard]] VkPipelineCache GetPipelineCache() const { return m_PipelineCache; }
+
 		void CreateBuffer(
 			VkDeviceSize size,
 			VkBufferUsageFlags bufferUsage,
@@ -210,6 +212,10 @@ namespace Pengine::Vk
 
 		void CreateVmaAllocator();
 
+		void CreatePipelineCache();
+
+		void SavePipelineCache() const;
+
 		bool IsDeviceSuitable(VkPhysicalDevice device);
 
 		[[nodiscard]] std::vector<const char*> GetRequiredExtensions() const;
@@ -240,6 +246,8 @@ namespace Pengine::Vk
 
 		VmaAllocator m_VmaAllocator = VK_NULL_HANDLE;
 
+		VkPipelineCache m_PipelineCache = VK_NULL_HANDLE;
+
 		PFN_vkCmdBeginDebugUtilsLabelEXT m_VkCmdBeginDebugUtilsLabelEXT;
 		PFN_vkCmdEndDebugUtilsLabelEXT m_VkCmdEndDebugUtilsLabelEXT;
 
@@ -121,7 +121,7 @@ VulkanGraphicsPipeline::VulkanGraphicsPipeline(const CreateGraphicsInfo& createG
 	vkPipelineCreateInfo.basePipelineIndex = -1;
 	vkPipelineCreateInfo.basePipelineHandle = VK_NULL_HANDLE;
 
-	if (vkCreateGraphicsPipelines(GetVkDevice()->GetDevice(), VK_NULL_HANDLE, 1,
+	if (vkCreateGraphicsPipelines(GetVkDevice()->GetDevice(), GetVkDevice()->GetPipelineCache(), 1,
 		&vkPipelineCreateInfo, nullptr, &m_GraphicsPipeline) != VK_SUCCESS)
 	{
 		FATAL_ERROR("Failed to create graphics pipeline!");
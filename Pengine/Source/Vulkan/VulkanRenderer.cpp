@@ -94,7 +94,14 @@ void VulkanRenderer::BindPipeline(
 	void* frame)
 {
 	const VulkanFrameInfo* vkFrame = static_cast<VulkanFrameInfo*>(frame);
-	std::static_pointer_cast<VulkanGraphicsPipeline>(pipeline)->Bind(vkFrame->CommandBuffer);
+	if (pipeline->GetType() == Pipeline::Type::GRAPHICS)
+	{
+		std::static_pointer_cast<VulkanGraphicsPipeline>(pipeline)->Bind(vkFrame->CommandBuffer);
+	}
+	else if (pipeline->GetType() == Pipeline::Type::COMPUTE)
+	{
+		std::static_pointer_cast<VulkanComputePipeline>(pipeline)->Bind(vkFrame->CommandBuffer);
+	}
 }
 
 void VulkanRenderer::BindUniformWriters(
@@ -207,6 +214,29 @@ void VulkanRenderer::MemoryBarrierFragmentReadWrite(void* frame)
 		nullptr);
 }
 
+void VulkanRenderer::MemoryBarrierComputeWriteVertexRead(void* frame)
+{
+	PROFILER_SCOPE(__FUNCTION__);
+
+	const VulkanFrameInfo* vkFrame = static_cast<VulkanFrameInfo*>(frame);
+
+	VkMemoryBarrier memoryBarrier{};
+	memoryBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+	memoryBarrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+	memoryBarrier.dstAccessMask = VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT;
+	vkCmdPipelineBarrier(
+		vkFrame->CommandBuffer,
+		VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+		VK_PIPELINE_STAGE_VERTEX_INPUT_BIT,
+		0,
+		1,
+		&memoryBarrier,
+		0,
+		nullptr,
+		0,
+		nullptr);
+}
+
 void VulkanRenderer::BeginCommandLabel(
 	const std::string& name,
 	const glm::vec3& color,
@@ -78,6 +78,8 @@ namespace Pengine::Vk
 
 		virtual void MemoryBarrierFragmentReadWrite(void* frame) override;
 
+		virtual void MemoryBarrierComputeWriteVertexRead(void* frame) override;
+
 		virtual void BeginCommandLabel(
 			const std::string& name,
 			const glm::vec3& color,
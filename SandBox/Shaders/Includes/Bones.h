@@ -1,2 +1 @@
-const int MAX_BONES = 100;
 const int MAX_BONE_INFLUENCE = 4;
\ No newline at end of file
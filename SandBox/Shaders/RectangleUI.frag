@@ -4,51 +4,39 @@ layout(location = 0) out vec4 outColor;
 
 layout(location = 0) in vec2 positionInPixels;
 layout(location = 1) in vec2 uv;
-layout(location = 2) flat in float cornerRadius;
-layout(location = 3) flat in int instanceIndex;
+layout(location = 2) flat in vec4 color;
+layout(location = 3) flat in vec4 quadCenterAndHalfSize;
+layout(location = 4) flat in vec4 cornerRadius;
+layout(location = 5) flat in int isText;
 
 layout(set = 0, binding = 0) uniform sampler2D imageTexture;
 
-struct Instance
-{
-	vec4 color;
-	vec4 quadCenterAndHalfSize;
-
-	/**
-     * { isText, empty, empty. empty }
-     */
-	ivec4 customData;
-};
-
-// Also need to change in Core/UIRenderer.cpp.
-#define MAX_BATCH_QUAD_COUNT 10000
-layout(set = 1, binding = 0) buffer readonly InstanceBuffer
-{
-	Instance instances[MAX_BATCH_QUAD_COUNT];
-};
-
 float RoundedQuadSDF(in vec2 position, in vec2 quadCenter, in vec2 quadHalfSize)
 {
-	vec2 distance = abs(quadCenter - position) - quadHalfSize + vec2(cornerRadius, cornerRadius);
-	return min(max(distance.x, distance.y), 0.0f) + length(max(distance, 0.0f)) - cornerRadius;
+	// { topLeft, topRight, bottomLeft, bottomRight }, y goes down.
+	vec2 side = step(quadCenter, position);
+	float radius = mix(mix(cornerRadius.x, cornerRadius.y, side.x), mix(cornerRadius.z, cornerRadius.w, side.x), side.y);
+
+	vec2 distance = abs(quadCenter - position) - quadHalfSize + vec2(radius, radius);
+	return min(max(distance.x, distance.y), 0.0f) + length(max(distance, 0.0f)) - radius;
 }
 
 void main()
 {
-	Instance instance = instances[instanceIndex];
-
-	float roundFactor = RoundedQuadSDF(positionInPixels, instance.quadCenterAndHalfSize.xy, instance.quadCenterAndHalfSize.zw);
+	float roundFactor = RoundedQuadSDF(positionInPixels, quadCenterAndHalfSize.xy, quadCenterAndHalfSize.zw);
 	roundFactor = smoothstep(0.0f, -1.0f, roundFactor);
 
 	vec4 finalColor;
-	if (instance.customData.x == 1)
+	if (isText == 1)
 	{
-		// For now it is supposed to be only 1 channel texture atlas.
-		finalColor = texture(imageTexture, uv).rrrr * instance.color;
+		// Single channel signed distance field, 0.5 is the outline. The edge is smoothed over one screen pixel at any text size.
+		float distance = texture(imageTexture, uv).r;
+		float edgeWidth = max(fwidth(distance) * 0.5f, 0.0001f);
+		finalColor = vec4(smoothstep(0.5f - edgeWidth, 0.5f + edgeWidth, distance)) * color;
 	}
 	else
 	{
-		finalColor = texture(imageTexture, uv) * instance.color;
+		finalColor = texture(imageTexture, uv) * color;
 	}
 
 	if (roundFactor < 0.01f)
@@ -1,21 +1,34 @@
 #version 450
 
-layout(location = 0) in vec4 positionA;
-layout(location = 1) in vec2 positionInPixelsA;
-layout(location = 2) in vec2 uvA;
-layout(location = 3) in float cornerRadiusA;
-layout(location = 4) in int instanceIndexA;
+layout(location = 0) in vec4 positionAndSizeA;
+layout(location = 1) in vec4 uvMinMaxA;
+layout(location = 2) in vec4 colorA;
+layout(location = 3) in vec4 cornerRadiusA;
+layout(location = 4) in int isTextA;
 
 layout(location = 0) out vec2 positionInPixels;
 layout(location = 1) out vec2 uv;
-layout(location = 2) flat out float cornerRadius;
-layout(location = 3) flat out int instanceIndex;
+layout(location = 2) flat out vec4 color;
+layout(location = 3) flat out vec4 quadCenterAndHalfSize;
+layout(location = 4) flat out vec4 cornerRadius;
+layout(location = 5) flat out int isText;
+
+layout(set = 1, binding = 0) uniform UIBuffer
+{
+	mat4 projection;
+};
 
 void main()
 {
-	gl_Position = positionA;
-	positionInPixels = positionInPixelsA;
-	uv = uvA;
+	// The index buffer is { 0, 1, 2, 2, 3, 1 }, the vertex index is the corner of the quad.
+	vec2 corner = vec2(gl_VertexIndex & 1, gl_VertexIndex >> 1);
+
+	positionInPixels = positionAndSizeA.xy + positionAndSizeA.zw * corner;
+	gl_Position = projection * vec4(positionInPixels, 0.0f, 1.0f);
+
+	uv = mix(uvMinMaxA.xy, uvMinMaxA.zw, corner);
+	color = colorA;
+	quadCenterAndHalfSize = vec4(positionAndSizeA.xy + positionAndSizeA.zw * 0.5f, positionAndSizeA.zw * 0.5f);
 	cornerRadius = cornerRadiusA;
-	instanceIndex = instanceIndexA;
+	isText = isTextA;
 }
@@ -0,0 +1,23 @@
+#version 450
+
+layout(location = 0) out vec4 outAccumulation;
+layout(location = 1) out float outRevealage;
+
+#include "Shaders/Includes/TransparentSurface.h"
+
+void main()
+{
+	vec4 surfaceColor;
+	vec2 surfaceNormal;
+	vec4 surfaceShading;
+	vec4 surfaceEmissive;
+	ShadeTransparentSurface(surfaceColor, surfaceNormal, surfaceShading, surfaceEmissive);
+
+	// Weighted blended order independent transparency (McGuire and Bavoil 2013, equation 7),
+	// closer and more opaque surfaces weigh more in the average.
+	float depth = abs(positionViewSpace.z);
+	float weight = surfaceColor.a * clamp(10.0f / (1e-5f + pow(depth / 5.0f, 2.0f) + pow(depth / 200.0f, 6.0f)), 1e-2f, 3e3f);
+
+	outAccumulation = vec4(surfaceColor.rgb * surfaceColor.a, surfaceColor.a) * weight;
+	outRevealage = surfaceColor.a;
+}
@@ -0,0 +1,36 @@
+#version 450
+
+layout(location = 0) in vec2 uv;
+
+layout(location = 0) out vec4 outColor;
+layout(location = 1) out vec2 outNormal;
+layout(location = 2) out vec4 outShading;
+layout(location = 3) out vec4 outEmissive;
+
+layout(set = 0, binding = 0) uniform sampler2D accumulationTexture;
+layout(set = 0, binding = 1) uniform sampler2D revealageTexture;
+
+void main()
+{
+	// Only the color is blended, the GBuffer attachments keep their values.
+	outNormal = vec2(0.0f);
+	outShading = vec4(0.0f);
+	outEmissive = vec4(0.0f);
+
+	float revealage = texture(revealageTexture, uv).r;
+	if (revealage >= 1.0f)
+	{
+		discard;
+	}
+
+	vec4 accumulation = texture(accumulationTexture, uv);
+
+	// Half floats overflow with many close layers.
+	if (isinf(max(max(abs(accumulation.r), abs(accumulation.g)), abs(accumulation.b))))
+	{
+		accumulation.rgb = vec3(accumulation.a);
+	}
+
+	vec3 averageColor = accumulation.rgb / max(accumulation.a, 1e-5f);
+	outColor = vec4(averageColor, 1.0f - revealage);
+}
@@ -72,7 +72,7 @@ REGISTER_CLAY_SCRIPT(Ammo)
 
 			FirstPersonCharacter& character = entity->GetComponent<FirstPersonCharacter>();
 
-			auto font = Pengine::FontManager::GetInstance().GetFont("Calibri", 72);
+			auto font = Pengine::FontManager::GetInstance().GetFont("Calibri");
 
 			character.ammoUI = std::format("Ammo: {}/{}", character.currentMagazine, character.currentAmmo);
 
@@ -108,8 +108,8 @@ REGISTER_CLAY_SCRIPT(Ammo)
 						ammoClayString,
 						{
 							.textColor = { 1.0f, 1.0f, 1.0f, 1.0f },
-							.fontId = font->id,
-							.fontSize = font->size,
+							.fontId = font->GetId(),
+							.fontSize = 72,
 						}
 						);
 				}
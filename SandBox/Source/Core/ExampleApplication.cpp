@@ -61,7 +61,7 @@ void ExampleApplication::OnStart()
 	{
 		ClayManager::BeginLayout();
 
-		auto font = FontManager::GetInstance().GetFont("Calibri", 72);
+		auto font = FontManager::GetInstance().GetFont("Calibri");
 
 		const int scale = 2;
 
@@ -111,8 +111,8 @@ void ExampleApplication::OnStart()
 					fpsClayString,
 					{
 						.textColor = { 1.0f, 0.965f, 1.0f, 0.953f },
-						.fontId = font->id,
-						.fontSize = font->size,
+						.fontId = font->GetId(),
+						.fontSize = 72,
 						.textAlignment = Clay_TextAlignment::CLAY_TEXT_ALIGN_CENTER,
 					}
 				);
@@ -130,7 +130,7 @@ void ExampleApplication::OnStart()
 	{
 		ClayManager::BeginLayout();
 
-		auto font = FontManager::GetInstance().GetFont("Calibri", 72);
+		auto font = FontManager::GetInstance().GetFont("Calibri");
 
 		struct Item
 		{
@@ -198,8 +198,8 @@ void ExampleApplication::OnStart()
 							item.name,
 							{
 								.textColor = { 1.0f, 1.0f, 0.0f, 1.0f },//{ 1.0f, 0.965f, 1.0f, 0.953f },
-								.fontId = font->id,
-								.fontSize = font->size,
+								.fontId = font->GetId(),
+								.fontSize = 72,
 							}
 						);
 						ClayManager::OpenElement();
@@ -237,7 +237,7 @@ void ExampleApplication::OnStart()
 
 	ClayManager::GetInstance().scriptsByName["Grid"] = [this](Canvas* canvas, std::shared_ptr<Entity> entity)
 	{
-		const auto font = FontManager::GetInstance().GetFont("Calibri", 72);
+		const auto font = FontManager::GetInstance().GetFont("Calibri");
 		const auto viewport = WindowManager::GetInstance().GetWindowByName("Main")->GetViewportManager().GetViewport("Main");
 		const auto mouseRay = viewport->GetMouseRay(viewport->GetMousePosition());
 		auto& input = Input::GetInstance(WindowManager::GetInstance().GetWindowByName("Main").get());
@@ -305,8 +305,8 @@ void ExampleApplication::OnStart()
 								CLAY_STRING("O"),
 								{
 									.textColor = { 1.0f, 1.0f, 1.0f, 1.0f },
-									.fontId = font->id,
-									.fontSize = font->size,
+									.fontId = font->GetId(),
+									.fontSize = 72,
 									.textAlignment = Clay_TextAlignment::CLAY_TEXT_ALIGN_CENTER,
 								}
 							);
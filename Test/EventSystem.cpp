@@ -0,0 +1,315 @@
+#include <gtest/gtest.h>
+
+#include "EventSystem/EventSystem.h"
+#include "Core/ThreadPool.h"
+#include "Core/Logger.h"
+
+#include "TestUtils.h"
+
+#include <deque>
+
+using namespace Pengine;
+
+namespace
+{
+	struct TestEvent
+	{
+		static constexpr EventId id = Event::userId;
+
+		uint32_t value = 0;
+		std::string text;
+	};
+
+	/**
+	 * Bigger than a few records, a frame of them spans several arena chunks.
+	 */
+	struct LargeTestEvent
+	{
+		static constexpr EventId id = Event::userId + 1;
+
+		uint32_t value = 0;
+		std::array<uint8_t, 4000> payload{};
+	};
+
+	struct BenchmarkEvent
+	{
+		static constexpr EventId id = Event::userId + 2;
+
+		uint32_t value = 0;
+	};
+}
+
+TEST(EventSystem, DeferredAndImmediateDispatch)
+{
+	try
+	{
+		EventSystem& eventSystem = EventSystem::GetInstance();
+		const int client = 0;
+
+		std::vector<uint32_t> received;
+		eventSystem.RegisterClient<TestEvent>(&client, [&](const TestEvent& event)
+		{
+			EXPECT_EQ(event.text, std::to_string(event.value));
+			received.emplace_back(event.value);
+
+			// Sent while dispatching, waits for the next processing.
+			if (event.value == 1)
+			{
+				eventSystem.SendEvent(TestEvent{ 100, "100" });
+			}
+		});
+
+		eventSystem.SendEvent(TestEvent{ 1, "1" });
+		eventSystem.SendEvent(TestEvent{ 2, "2" });
+		eventSystem.SendEvent(TestEvent{ 3, "3" }, EventSystem::Dispatch::Immediate);
+		EXPECT_EQ(received, std::vector<uint32_t>({ 3 }));
+
+		eventSystem.ProcessEvents();
+		EXPECT_EQ(received, std::vector<uint32_t>({ 3, 1, 2 }));
+
+		eventSystem.ProcessEvents();
+		EXPECT_EQ(received, std::vector<uint32_t>({ 3, 1, 2, 100 }));
+
+		// Registering twice doesn't dispatch twice.
+		eventSystem.RegisterClient<TestEvent>(&client, [](const TestEvent&) { FAIL(); });
+		eventSystem.UnregisterClient<TestEvent>(&client);
+		eventSystem.SendEvent(TestEvent{ 4, "4" });
+		eventSystem.ProcessEvents();
+		EXPECT_EQ(received.size(), 4);
+	}
+	catch (const std::exception& e)
+	{
+		Logger::Error(e.what());
+		FAIL();
+	}
+}
+
+TEST(EventSystem, RegisterAndUnregisterFromCallback)
+{
+	try
+	{
+		EventSystem& eventSystem = EventSystem::GetInstance();
+		const int first = 0;
+		const int second = 0;
+		const int third = 0;
+		const int added = 0;
+		const std::array<int, 64> addedClients{};
+
+		std::vector<const void*> received;
+		eventSystem.RegisterClient<TestEvent>(&first, [&](const TestEvent& event)
+		{
+			received.emplace_back(&first);
+
+			if (event.value == 1)
+			{
+				// Unregistering itself and the next listener must not skip the one after them.
+				eventSystem.UnregisterClient<TestEvent>(&first);
+				eventSystem.UnregisterAll(&second);
+
+				// Enough listeners to reallocate the array, they are only called from the next event on.
+				for (const int& addedClient : addedClients)
+				{
+					eventSystem.RegisterClient<TestEvent>(&addedClient, [&](const TestEvent&)
+					{
+						received.emplace_back(&added);
+					});
+				}
+			}
+		});
+		eventSystem.RegisterClient<TestEvent>(&second, [&](const TestEvent&)
+		{
+			received.emplace_back(&second);
+		});
+		eventSystem.RegisterClient<TestEvent>(&third, [&](const TestEvent&)
+		{
+			received.emplace_back(&third);
+		});
+
+		eventSystem.SendEvent(TestEvent{ 1, "1" }, EventSystem::Dispatch::Immediate);
+		EXPECT_EQ(received, std::vector<const void*>({ &first, &third }));
+
+		received.clear();
+		eventSystem.SendEvent(TestEvent{ 2, "2" }, EventSystem::Dispatch::Immediate);
+		ASSERT_EQ(received.size(), 65);
+		EXPECT_EQ(received.front(), &third);
+		EXPECT_EQ(std::count(received.begin(), received.end(), &added), 64);
+
+		EXPECT_FALSE(eventSystem.AlreadyRegistered(TestEvent::id, &first));
+		EXPECT_FALSE(eventSystem.AlreadyRegistered(TestEvent::id, &second));
+
+		eventSystem.UnregisterAll(&third);
+		for (const int& addedClient : addedClients)
+		{
+			eventSystem.UnregisterAll(&addedClient);
+		}
+
+		received.clear();
+		eventSystem.SendEvent(TestEvent{ 3, "3" }, EventSystem::Dispatch::Immediate);
+		EXPECT_TRUE(received.empty());
+	}
+	catch (const std::exception& e)
+	{
+		Logger::Error(e.what());
+		FAIL();
+	}
+}
+
+TEST(EventSystem, EventsSpanArenaChunks)
+{
+	try
+	{
+		constexpr uint32_t eventCount = 2000;
+
+		EventSystem& eventSystem = EventSystem::GetInstance();
+		const int client = 0;
+
+		uint32_t nextValue = 0;
+		eventSystem.RegisterClient<LargeTestEvent>(&client, [&](const LargeTestEvent& event)
+		{
+			EXPECT_EQ(event.value, nextValue++);
+			EXPECT_EQ(event.payload.back(), static_cast<uint8_t>(event.value));
+		});
+
+		// Twice, the second frame reuses the chunks of the first one.
+		for (uint32_t frame = 0; frame < 2; frame++)
+		{
+			nextValue = 0;
+			for (uint32_t i = 0; i < eventCount; i++)
+			{
+				LargeTestEvent event{ i };
+				event.payload.back() = static_cast<uint8_t>(i);
+				eventSystem.SendEvent(event);
+			}
+
+			eventSystem.ProcessEvents();
+			EXPECT_EQ(nextValue, eventCount);
+		}
+
+		// Cleared events are destroyed without being dispatched.
+		eventSystem.SendEvent(LargeTestEvent{ eventCount });
+		eventSystem.ClearEvents();
+		eventSystem.ProcessEvents();
+		EXPECT_EQ(nextValue, eventCount);
+
+		eventSystem.UnregisterAll(&client);
+	}
+	catch (const std::exception& e)
+	{
+		Logger::Error(e.what());
+		FAIL();
+	}
+}
+
+TEST(EventSystem, BenchmarkOneMillionEventsPerFrame)
+{
+	try
+	{
+		constexpr uint32_t eventCount = 1000000;
+		constexpr uint32_t frameCount = 5;
+		constexpr uint64_t frameSum = static_cast<uint64_t>(eventCount) * (eventCount - 1) / 2;
+
+		EventSystem& eventSystem = EventSystem::GetInstance();
+		const int client = 0;
+
+		uint64_t sum = 0;
+		eventSystem.RegisterClient<BenchmarkEvent>(&client, [&sum](const BenchmarkEvent& event)
+		{
+			sum += event.value;
+		});
+
+		const double singleProducerTime = TestUtils::Measure([&]()
+		{
+			for (uint32_t frame = 0; frame < frameCount; frame++)
+			{
+				for (uint32_t i = 0; i < eventCount; i++)
+				{
+					eventSystem.SendEvent(BenchmarkEvent{ i });
+				}
+
+				eventSystem.ProcessEvents();
+			}
+		});
+		EXPECT_EQ(sum, frameSum * frameCount);
+
+		const uint32_t threadCount = glm::max(std::thread::hardware_concurrency(), 2u) - 1;
+		ThreadPool threadPool;
+		threadPool.Initialize(threadCount);
+
+		sum = 0;
+		const double multiProducerTime = TestUtils::Measure([&]()
+		{
+			for (uint32_t frame = 0; frame < frameCount; frame++)
+			{
+				threadPool.ParallelFor(eventCount, 4096, [&eventSystem](const size_t begin, const size_t end)
+				{
+					for (size_t i = begin; i < end; i++)
+					{
+						eventSystem.SendEvent(BenchmarkEvent{ static_cast<uint32_t>(i) });
+					}
+				});
+
+				eventSystem.ProcessEvents();
+			}
+		});
+		EXPECT_EQ(sum, frameSum * frameCount);
+
+		threadPool.Shutdown();
+		eventSystem.UnregisterAll(&client);
+
+		// The previous event system: a queue of shared events and a multimap of listeners taking the shared pointer.
+		struct LegacyEvent
+		{
+			virtual ~LegacyEvent() = default;
+
+			EventId id;
+			uint32_t value;
+		};
+
+		std::multimap<EventId, std::function<void(std::shared_ptr<LegacyEvent>)>> legacyListeners;
+		std::deque<std::shared_ptr<LegacyEvent>> legacyEvents;
+		legacyListeners.emplace(BenchmarkEvent::id, [&sum](std::shared_ptr<LegacyEvent> event)
+		{
+			sum += event->value;
+		});
+
+		sum = 0;
+		const double legacyTime = TestUtils::Measure([&]()
+		{
+			for (uint32_t frame = 0; frame < frameCount; frame++)
+			{
+				for (uint32_t i = 0; i < eventCount; i++)
+				{
+					std::shared_ptr<LegacyEvent> event = std::make_shared<LegacyEvent>();
+					event->id = BenchmarkEvent::id;
+					event->value = i;
+					legacyEvents.push_back(event);
+				}
+
+				while (!legacyEvents.empty())
+				{
+					std::shared_ptr<LegacyEvent> event = legacyEvents.front();
+					legacyEvents.pop_front();
+
+					auto range = legacyListeners.equal_range(event->id);
+					for (auto listener = range.first; listener != range.second; ++listener)
+					{
+						listener->second(event);
+					}
+				}
+			}
+		});
+		EXPECT_EQ(sum, frameSum * frameCount);
+
+		Logger::Log("EventSystem: {} events per frame, single producer {:.2f} ms/frame, {} producers {:.2f} ms/frame, shared_ptr queue {:.2f} ms/frame",
+			eventCount,
+			singleProducerTime / frameCount,
+			threadCount + 1,
+			multiProducerTime / frameCount,
+			legacyTime / frameCount);
+	}
+	catch (const std::exception& e)
+	{
+		Logger::Error(e.what());
+		FAIL();
+	}
+}
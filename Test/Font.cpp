@@ -0,0 +1,235 @@
+#include <gtest/gtest.h>
+
+#include "Core/Logger.h"
+#include "Graphics/Font.h"
+#include "Graphics/FontAtlas.h"
+
+#include "TestUtils.h"
+
+#include <random>
+
+using namespace Pengine;
+
+namespace
+{
+	bool Overlap(const FontAtlas::Rect& a, const FontAtlas::Rect& b)
+	{
+		return a.offset.x < b.offset.x + b.size.x && b.offset.x < a.offset.x + a.size.x &&
+			a.offset.y < b.offset.y + b.size.y && b.offset.y < a.offset.y + a.size.y;
+	}
+
+	void ExpectInsideAndDisjoint(const std::vector<FontAtlas::Rect>& rects, const glm::ivec2& atlasSize)
+	{
+		for (size_t i = 0; i < rects.size(); i++)
+		{
+			EXPECT_GE(rects[i].offset.x, 0);
+			EXPECT_GE(rects[i].offset.y, 0);
+			EXPECT_LE(rects[i].offset.x + rects[i].size.x, atlasSize.x);
+			EXPECT_LE(rects[i].offset.y + rects[i].size.y, atlasSize.y);
+
+			for (size_t j = i + 1; j < rects.size(); j++)
+			{
+				ASSERT_FALSE(Overlap(rects[i], rects[j]));
+			}
+		}
+	}
+
+	/**
+	 * Latin, Latin-1 and Cyrillic letters, the face used by the editor covers all of them.
+	 */
+	std::vector<uint32_t> GetCoveredCodepoints()
+	{
+		std::vector<uint32_t> codepoints;
+		for (uint32_t codepoint = 33; codepoint < 127; codepoint++)
+		{
+			codepoints.emplace_back(codepoint);
+		}
+
+		for (uint32_t codepoint = 0xC0; codepoint <= 0xFF; codepoint++)
+		{
+			codepoints.emplace_back(codepoint);
+		}
+
+		for (uint32_t codepoint = 0x410; codepoint <= 0x44F; codepoint++)
+		{
+			codepoints.emplace_back(codepoint);
+		}
+
+		return codepoints;
+	}
+}
+
+TEST(Font, AtlasPacksGlyphSizedRectsTightly)
+{
+	try
+	{
+		std::mt19937 random(5);
+		std::uniform_int_distribution<int> width(8, 44);
+		std::uniform_int_distribution<int> height(36, 54);
+
+		FontAtlas atlas({ 256, 256 }, 4096, 1);
+
+		std::vector<FontAtlas::Rect> rects;
+		std::vector<uint8_t> values;
+		for (int i = 0; i < 2000; i++)
+		{
+			const glm::ivec2 size = { width(random), height(random) };
+			const uint8_t value = static_cast<uint8_t>(i % 255 + 1);
+			const std::vector<uint8_t> pixels(static_cast<size_t>(size.x) * size.y, value);
+
+			const std::optional<FontAtlas::Rect> rect = atlas.Add(size, pixels.data(), size.x);
+			ASSERT_TRUE(rect.has_value());
+			EXPECT_EQ(rect->size, size);
+
+			rects.emplace_back(*rect);
+			values.emplace_back(value);
+		}
+
+		ExpectInsideAndDisjoint(rects, atlas.GetSize());
+
+		// Growing keeps the offsets, the pixels of the first rects are still where they were packed.
+		const std::vector<uint8_t>& pixels = atlas.GetPixels();
+		for (size_t i = 0; i < rects.size(); i++)
+		{
+			const FontAtlas::Rect& rect = rects[i];
+			const glm::ivec2 corner = rect.offset + rect.size - 1;
+			EXPECT_EQ(pixels[static_cast<size_t>(rect.offset.y) * atlas.GetSize().x + rect.offset.x], values[i]);
+			EXPECT_EQ(pixels[static_cast<size_t>(corner.y) * atlas.GetSize().x + corner.x], values[i]);
+		}
+
+		const float occupancy = static_cast<float>(atlas.GetPackedArea()) / static_cast<float>(atlas.GetSize().x * atlas.GetSize().y);
+		EXPECT_GT(atlas.GetPackingEfficiency(), 0.8f);
+		EXPECT_GT(occupancy, 0.35f);
+	}
+	catch (const std::exception& e)
+	{
+		Logger::Error(e.what());
+		FAIL();
+	}
+}
+
+TEST(Font, AtlasStopsGrowingAtMaxSize)
+{
+	try
+	{
+		FontAtlas atlas({ 32, 32 }, 64, 1);
+
+		const std::vector<uint8_t> pixels(30 * 30, 255);
+		for (int i = 0; i < 4; i++)
+		{
+			ASSERT_TRUE(atlas.Add({ 30, 30 }, pixels.data(), 30).has_value());
+		}
+
+		EXPECT_FALSE(atlas.Add({ 30, 30 }, pixels.data(), 30).has_value());
+		EXPECT_EQ(atlas.GetSize(), glm::ivec2(64, 64));
+		EXPECT_EQ(atlas.GetPackedArea(), 4 * 30 * 30);
+
+		// Empty rects take no space and always succeed.
+		EXPECT_TRUE(atlas.Add({ 0, 0 }, nullptr, 0).has_value());
+	}
+	catch (const std::exception& e)
+	{
+		Logger::Error(e.what());
+		FAIL();
+	}
+}
+
+TEST(Font, RasterisesCoveredGlyphsIntoOneAtlas)
+{
+	try
+	{
+		const std::filesystem::path filepath = TestUtils::FindFontFilepath();
+		if (filepath.empty())
+		{
+			GTEST_SKIP() << "Editor/Fonts/Calibri.ttf is not found.";
+		}
+
+		Font font(filepath, 0);
+		EXPECT_EQ(font.GetGlyphCount(), 0);
+
+		const std::vector<uint32_t> codepoints = GetCoveredCodepoints();
+
+		std::vector<FontAtlas::Rect> rects;
+		for (const uint32_t codepoint : codepoints)
+		{
+			ASSERT_TRUE(font.HasGlyph(codepoint)) << codepoint;
+
+			const Font::Glyph glyph = font.GetGlyph(codepoint);
+			EXPECT_GT(glyph.advance, 0) << codepoint;
+			ASSERT_GT(glyph.rect.size.x, 2 * Font::sdfSpread) << codepoint;
+			ASSERT_GT(glyph.rect.size.y, 2 * Font::sdfSpread) << codepoint;
+
+			rects.emplace_back(glyph.rect);
+		}
+
+		const FontAtlas& atlas = font.GetAtlas();
+		ExpectInsideAndDisjoint(rects, atlas.GetSize());
+
+		// Every glyph has a distance field with the inside of the outline above 0.5 and the border outside of it.
+		const std::vector<uint8_t>& pixels = atlas.GetPixels();
+		for (size_t i = 0; i < rects.size(); i++)
+		{
+			const FontAtlas::Rect& rect = rects[i];
+
+			uint8_t maxValue = 0;
+			for (int y = 0; y < rect.size.y; y++)
+			{
+				for (int x = 0; x < rect.size.x; x++)
+				{
+					maxValue = glm::max(maxValue, pixels[static_cast<size_t>(rect.offset.y + y) * atlas.GetSize().x + rect.offset.x + x]);
+				}
+			}
+
+			EXPECT_GT(maxValue, 128) << codepoints[i];
+			EXPECT_LT(pixels[static_cast<size_t>(rect.offset.y) * atlas.GetSize().x + rect.offset.x], 128) << codepoints[i];
+		}
+
+		// Glyphs are rasterised once, the second lookup doesn't touch the atlas.
+		const uint32_t version = atlas.GetVersion();
+		for (const uint32_t codepoint : codepoints)
+		{
+			font.GetGlyph(codepoint);
+		}
+
+		EXPECT_EQ(font.GetGlyphCount(), codepoints.size());
+		EXPECT_EQ(atlas.GetVersion(), version);
+		EXPECT_GT(atlas.GetPackingEfficiency(), 0.75f);
+	}
+	catch (const std::exception& e)
+	{
+		Logger::Error(e.what());
+		FAIL();
+	}
+}
+
+TEST(Font, WhitespaceAndMissingGlyphs)
+{
+	try
+	{
+		const std::filesystem::path filepath = TestUtils::FindFontFilepath();
+		if (filepath.empty())
+		{
+			GTEST_SKIP() << "Editor/Fonts/Calibri.ttf is not found.";
+		}
+
+		Font font(filepath, 0);
+
+		const Font::Glyph space = font.GetGlyph(' ');
+		EXPECT_GT(space.advance, 0);
+		EXPECT_EQ(space.rect.size, glm::ivec2(0, 0));
+		EXPECT_EQ(font.GetAtlas().GetPackedArea(), 0);
+
+		// CJK is not in the face, the .notdef box is drawn instead.
+		constexpr uint32_t missingCodepoint = 0x4E2D;
+		EXPECT_FALSE(font.HasGlyph(missingCodepoint));
+
+		const Font::Glyph missing = font.GetGlyph(missingCodepoint);
+		EXPECT_GT(missing.rect.size.x, 0);
+		EXPECT_GT(missing.advance, 0);
+	}
+	catch (const std::exception& e)
+	{
+		Logger::Error(e.what());
+		FAIL();
+	}
+}
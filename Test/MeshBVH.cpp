@@ -0,0 +1,240 @@
+#include <gtest/gtest.h>
+
+#include "Core/Raycast.h"
+#include "Core/Logger.h"
+#include "Graphics/MeshBVH.h"
+#include "Graphics/Vertex.h"
+
+#include <random>
+
+using namespace Pengine;
+
+namespace
+{
+	struct TriangleSoup
+	{
+		std::vector<VertexPosition> vertices;
+		std::vector<uint32_t> indices;
+	};
+
+	/**
+	 * Random triangles of different sizes in a cube, clustered so the SAH has something to find.
+	 */
+	TriangleSoup CreateTriangleSoup(const uint32_t triangleCount)
+	{
+		std::mt19937 random(7);
+		std::uniform_real_distribution<float> position(-10.0f, 10.0f);
+		std::uniform_real_distribution<float> offset(-0.5f, 0.5f);
+
+		TriangleSoup soup{};
+		for (uint32_t i = 0; i < triangleCount; i++)
+		{
+			const glm::vec3 center = i % 4 == 0
+				? glm::vec3(position(random), position(random), position(random))
+				: glm::vec3(position(random), 0.0f, position(random)) * 0.2f;
+			const float size = i % 16 == 0 ? 8.0f : 1.0f;
+
+			for (uint32_t j = 0; j < 3; j++)
+			{
+				soup.indices.emplace_back(static_cast<uint32_t>(soup.vertices.size()));
+				soup.vertices.emplace_back(VertexPosition{ center + glm::vec3(offset(random), offset(random), offset(random)) * size, {} });
+			}
+		}
+
+		return soup;
+	}
+
+	std::vector<Raycast::Ray> CreateRays(const size_t count)
+	{
+		std::mt19937 random(11);
+		std::uniform_real_distribution<float> position(-15.0f, 15.0f);
+
+		std::vector<Raycast::Ray> rays(count);
+		for (Raycast::Ray& ray : rays)
+		{
+			ray.start = { position(random), position(random), position(random) };
+			const glm::vec3 target = glm::vec3(position(random), position(random), position(random)) * 0.3f;
+			ray.direction = glm::normalize(target - ray.start);
+			ray.length = 100.0f;
+		}
+
+		return rays;
+	}
+
+	bool RaycastBruteForce(const TriangleSoup& soup, const Raycast::Ray& ray, float& closestDistance)
+	{
+		closestDistance = std::numeric_limits<float>::max();
+		bool isHit = false;
+		for (size_t i = 0; i < soup.indices.size(); i += 3)
+		{
+			float distance;
+			glm::vec2 barycentrics;
+			if (Raycast::IntersectRayTriangle(
+				ray.start,
+				ray.direction,
+				soup.vertices[soup.indices[i + 0]].position,
+				soup.vertices[soup.indices[i + 1]].position,
+				soup.vertices[soup.indices[i + 2]].position,
+				ray.length,
+				distance,
+				barycentrics))
+			{
+				closestDistance = std::min(closestDistance, distance);
+				isHit = true;
+			}
+		}
+
+		return isHit;
+	}
+
+	void ExpectSameHits(const MeshBVH& bvh, const TriangleSoup& soup, const std::vector<Raycast::Ray>& rays)
+	{
+		for (const Raycast::Ray& ray : rays)
+		{
+			float closestDistance;
+			const bool isHit = RaycastBruteForce(soup, ray, closestDistance);
+
+			Raycast::Hit hit{};
+			ASSERT_EQ(bvh.Raycast(ray.start, ray.direction, ray.length, false, hit), isHit);
+			if (isHit)
+			{
+				EXPECT_FLOAT_EQ(hit.distance, closestDistance);
+			}
+		}
+	}
+}
+
+TEST(MeshBVH, MatchesBruteForce)
+{
+	try
+	{
+		const TriangleSoup soup = CreateTriangleSoup(4096);
+		MeshBVH bvh((void*)soup.vertices.data(), soup.indices, sizeof(VertexPosition));
+
+		ExpectSameHits(bvh, soup, CreateRays(2048));
+	}
+	catch (const std::exception& e)
+	{
+		Logger::Error(e.what());
+		FAIL();
+	}
+}
+
+TEST(MeshBVH, LeavesCoverEveryTriangleOnce)
+{
+	try
+	{
+		constexpr int leafSize = 4;
+
+		const TriangleSoup soup = CreateTriangleSoup(1000);
+		MeshBVH bvh((void*)soup.vertices.data(), soup.indices, sizeof(VertexPosition), leafSize);
+
+		const MeshBVH::Data& data = bvh.GetData();
+		ASSERT_EQ(data.triangleIndices.size(), 1000);
+
+		std::vector<uint32_t> triangleCounts(1000, 0);
+		bvh.Traverse([&](const MeshBVH::BVHNode& node)
+		{
+			if (!node.IsLeaf())
+			{
+				EXPECT_NE(node.left, -1);
+				EXPECT_NE(node.right, -1);
+				return;
+			}
+
+			EXPECT_LE(node.count, leafSize);
+			for (uint32_t i = node.offset; i < node.offset + node.count; i++)
+			{
+				const uint32_t triangle = data.triangleIndices[i];
+				triangleCounts[triangle]++;
+
+				// Every vertex of a leaf triangle is inside the leaf bounds.
+				for (uint32_t j = 0; j < 3; j++)
+				{
+					const glm::vec3& position = soup.vertices[soup.indices[triangle * 3 + j]].position;
+					EXPECT_TRUE(glm::all(glm::greaterThanEqual(position, node.aabb.min)));
+					EXPECT_TRUE(glm::all(glm::lessThanEqual(position, node.aabb.max)));
+				}
+			}
+		});
+
+		for (const uint32_t triangleCount : triangleCounts)
+		{
+			EXPECT_EQ(triangleCount, 1);
+		}
+	}
+	catch (const std::exception& e)
+	{
+		Logger::Error(e.what());
+		FAIL();
+	}
+}
+
+TEST(MeshBVH, DegenerateCentroids)
+{
+	try
+	{
+		// The same triangle many times, the centroids can't be binned.
+		TriangleSoup soup{};
+		for (uint32_t i = 0; i < 64; i++)
+		{
+			soup.indices.insert(soup.indices.end(), { 0, 1, 2 });
+		}
+		soup.vertices = { { { -1.0f, 0.0f, -1.0f }, {} }, { { 1.0f, 0.0f, -1.0f }, {} }, { { 0.0f, 0.0f, 1.0f }, {} } };
+
+		MeshBVH bvh((void*)soup.vertices.data(), soup.indices, sizeof(VertexPosition));
+
+		Raycast::Hit hit{};
+		ASSERT_TRUE(bvh.Raycast({ 0.0f, 5.0f, 0.0f }, { 0.0f, -1.0f, 0.0f }, 10.0f, false, hit));
+		EXPECT_FLOAT_EQ(hit.distance, 5.0f);
+	}
+	catch (const std::exception& e)
+	{
+		Logger::Error(e.what());
+		FAIL();
+	}
+}
+
+TEST(MeshBVH, SerializedData)
+{
+	try
+	{
+		const TriangleSoup soup = CreateTriangleSoup(2048);
+		const std::vector<Raycast::Ray> rays = CreateRays(1024);
+
+		MeshBVH builtBVH((void*)soup.vertices.data(), soup.indices, sizeof(VertexPosition));
+
+		// As stored in the mesh file.
+		MeshBVH::Data data = builtBVH.GetData();
+		MeshBVH loadedBVH((void*)soup.vertices.data(), soup.indices, sizeof(VertexPosition), std::move(data));
+		EXPECT_EQ(loadedBVH.GetData().nodes.size(), builtBVH.GetData().nodes.size());
+		ExpectSameHits(loadedBVH, soup, rays);
+
+		// Data that doesn't belong to the mesh is rebuilt.
+		MeshBVH::Data staleData = builtBVH.GetData();
+		staleData.triangleIndices.pop_back();
+		MeshBVH rebuiltBVH((void*)soup.vertices.data(), soup.indices, sizeof(VertexPosition), std::move(staleData));
+		EXPECT_EQ(rebuiltBVH.GetData().triangleIndices.size(), soup.indices.size() / 3);
+		ExpectSameHits(rebuiltBVH, soup, rays);
+
+		// Corrupted data with nodes and triangles out of range is rebuilt instead of traversed.
+		MeshBVH::Data corruptedData = builtBVH.GetData();
+		corruptedData.nodes.front().right = static_cast<uint32_t>(corruptedData.nodes.size());
+		corruptedData.triangleIndices.back() = static_cast<uint32_t>(soup.indices.size());
+		MeshBVH repairedBVH((void*)soup.vertices.data(), soup.indices, sizeof(VertexPosition), std::move(corruptedData));
+		EXPECT_LT(repairedBVH.GetData().nodes.front().right, repairedBVH.GetData().nodes.size());
+		ExpectSameHits(repairedBVH, soup, rays);
+
+		MeshBVH::Data cyclicData = builtBVH.GetData();
+		cyclicData.nodes.back().count = 0;
+		cyclicData.nodes.back().left = 0;
+		cyclicData.nodes.back().right = 0;
+		MeshBVH acyclicBVH((void*)soup.vertices.data(), soup.indices, sizeof(VertexPosition), std::move(cyclicData));
+		ExpectSameHits(acyclicBVH, soup, rays);
+	}
+	catch (const std::exception& e)
+	{
+		Logger::Error(e.what());
+		FAIL();
+	}
+}
@@ -0,0 +1,173 @@
+#include <gtest/gtest.h>
+
+#include "Core/Raycast.h"
+#include "Core/Logger.h"
+#include "Graphics/Mesh.h"
+#include "Graphics/Vertex.h"
+
+using namespace Pengine;
+
+namespace
+{
+	/**
+	 * A quad in the XZ plane with uvs from 0 to 1, laid out like the mesh files with every attribute.
+	 */
+	std::shared_ptr<Mesh::CpuData> CreateQuad()
+	{
+		const std::vector<VertexDefault> vertices =
+		{
+			{ { -1.0f, 0.0f, -1.0f }, { 0.0f, 0.0f }, { 0.0f, 1.0f, 0.0f }, {}, 0xFFFFFFFF },
+			{ {  1.0f, 0.0f, -1.0f }, { 1.0f, 0.0f }, { 0.0f, 1.0f, 0.0f }, {}, 0xFFFFFFFF },
+			{ {  1.0f, 0.0f,  1.0f }, { 1.0f, 1.0f }, { 0.0f, 1.0f, 0.0f }, {}, 0xFFFFFFFF },
+			{ { -1.0f, 0.0f,  1.0f }, { 0.0f, 1.0f }, { 0.0f, 1.0f, 0.0f }, {}, 0xFFFFFFFF },
+		};
+
+		std::shared_ptr<Mesh::CpuData> cpuData = std::make_shared<Mesh::CpuData>();
+		cpuData->vertices = new uint8_t[vertices.size() * sizeof(VertexDefault)];
+		memcpy(cpuData->vertices, vertices.data(), vertices.size() * sizeof(VertexDefault));
+		cpuData->indices = { 0, 2, 1, 0, 3, 2 };
+		cpuData->vertexStride = sizeof(VertexDefault);
+
+		return cpuData;
+	}
+
+	constexpr size_t quadVertexCount = 4;
+
+	bool RaycastQuad(MeshBVH& bvh, Raycast::Hit& hit)
+	{
+		return bvh.Raycast({ 0.5f, 1.0f, 0.25f }, { 0.0f, -1.0f, 0.0f }, 10.0f, false, hit);
+	}
+}
+
+TEST(MeshCpuResidency, CompactsToTheResidency)
+{
+	try
+	{
+		const std::shared_ptr<Mesh::CpuData> all = CreateQuad();
+
+		EXPECT_EQ(Mesh::CompactCpuData(all, quadVertexCount, Mesh::CpuResidency::ALL), all);
+
+		const std::shared_ptr<Mesh::CpuData> collision = Mesh::CompactCpuData(all, quadVertexCount, Mesh::CpuResidency::COLLISION);
+		ASSERT_NE(collision, all);
+		ASSERT_EQ(collision->vertexStride, sizeof(VertexPosition));
+		EXPECT_EQ(collision->indices, all->indices);
+		for (size_t i = 0; i < quadVertexCount; i++)
+		{
+			const VertexDefault& source = *reinterpret_cast<const VertexDefault*>(all->vertices + i * sizeof(VertexDefault));
+			const VertexPosition& compacted = *reinterpret_cast<const VertexPosition*>(collision->vertices + i * sizeof(VertexPosition));
+			EXPECT_EQ(compacted.position, source.position);
+			EXPECT_EQ(compacted.uv, source.uv);
+		}
+
+		// Already compact, nothing to copy.
+		EXPECT_EQ(Mesh::CompactCpuData(collision, quadVertexCount, Mesh::CpuResidency::COLLISION), collision);
+
+		const std::shared_ptr<Mesh::CpuData> none = Mesh::CompactCpuData(all, quadVertexCount, Mesh::CpuResidency::NONE);
+		EXPECT_EQ(none->vertices, nullptr);
+		EXPECT_TRUE(none->indices.empty());
+		EXPECT_EQ(none->vertexStride, 0);
+	}
+	catch (const std::exception& e)
+	{
+		Logger::Error(e.what());
+		FAIL();
+	}
+}
+
+TEST(MeshCpuResidency, RaycastAfterCollisionRelease)
+{
+	try
+	{
+		std::shared_ptr<Mesh::CpuData> all = CreateQuad();
+		std::shared_ptr<MeshBVH> allBVH = Mesh::CreateBVH(all, std::nullopt);
+
+		Raycast::Hit allHit{};
+		ASSERT_TRUE(RaycastQuad(*allBVH, allHit));
+
+		// Same as Mesh::ReleaseCpuData, the hierarchy is reused over the compacted positions.
+		std::shared_ptr<Mesh::CpuData> collision = Mesh::CompactCpuData(all, quadVertexCount, Mesh::CpuResidency::COLLISION);
+		std::shared_ptr<MeshBVH> collisionBVH = Mesh::CreateBVH(collision, allBVH->GetData());
+
+		// The mesh drops its full data, the hierarchy handed out before still owns it.
+		all.reset();
+		collision.reset();
+
+		Raycast::Hit oldHit{};
+		ASSERT_TRUE(RaycastQuad(*allBVH, oldHit));
+		EXPECT_FLOAT_EQ(oldHit.distance, allHit.distance);
+
+		Raycast::Hit collisionHit{};
+		ASSERT_TRUE(RaycastQuad(*collisionBVH, collisionHit));
+		EXPECT_FLOAT_EQ(collisionHit.distance, 1.0f);
+		EXPECT_EQ(collisionHit.triangle, allHit.triangle);
+		EXPECT_NEAR(collisionHit.uv.x, 0.75f, 1e-5f);
+		EXPECT_NEAR(collisionHit.uv.y, 0.625f, 1e-5f);
+		EXPECT_NEAR(collisionHit.uv.x, allHit.uv.x, 1e-5f);
+		EXPECT_NEAR(collisionHit.uv.y, allHit.uv.y, 1e-5f);
+		EXPECT_NEAR(collisionHit.normal.y, allHit.normal.y, 1e-5f);
+	}
+	catch (const std::exception& e)
+	{
+		Logger::Error(e.what());
+		FAIL();
+	}
+}
+
+TEST(MeshCpuResidency, PositionsOnlyHaveNoUV)
+{
+	try
+	{
+		const std::vector<glm::vec3> positions =
+		{
+			{ -1.0f, 0.0f, -1.0f },
+			{  1.0f, 0.0f, -1.0f },
+			{  1.0f, 0.0f,  1.0f },
+			{ -1.0f, 0.0f,  1.0f },
+		};
+
+		std::shared_ptr<Mesh::CpuData> cpuData = std::make_shared<Mesh::CpuData>();
+		cpuData->vertices = new uint8_t[positions.size() * sizeof(glm::vec3)];
+		memcpy(cpuData->vertices, positions.data(), positions.size() * sizeof(glm::vec3));
+		cpuData->indices = { 0, 2, 1, 0, 3, 2 };
+		cpuData->vertexStride = sizeof(glm::vec3);
+
+		EXPECT_EQ(Mesh::CompactCpuData(cpuData, positions.size(), Mesh::CpuResidency::COLLISION), cpuData);
+
+		// The last vertex is read without going past the end of the positions.
+		std::shared_ptr<MeshBVH> bvh = Mesh::CreateBVH(cpuData, std::nullopt);
+		Raycast::Hit hit{};
+		ASSERT_TRUE(bvh->Raycast({ -0.9f, 1.0f, 0.9f }, { 0.0f, -1.0f, 0.0f }, 10.0f, false, hit));
+		EXPECT_EQ(hit.uv, glm::vec2(0.0f));
+	}
+	catch (const std::exception& e)
+	{
+		Logger::Error(e.what());
+		FAIL();
+	}
+}
+
+TEST(MeshCpuResidency, RestoreAfterNoneRelease)
+{
+	try
+	{
+		std::shared_ptr<Mesh::CpuData> all = CreateQuad();
+		const MeshBVH::Data bvhData = Mesh::CreateBVH(all, std::nullopt)->GetData();
+
+		const std::shared_ptr<Mesh::CpuData> none = Mesh::CompactCpuData(all, quadVertexCount, Mesh::CpuResidency::NONE);
+		std::shared_ptr<MeshBVH> noneBVH = Mesh::CreateBVH(none, std::nullopt);
+
+		Raycast::Hit hit{};
+		EXPECT_FALSE(RaycastQuad(*noneBVH, hit));
+
+		// Same as Mesh::RestoreCpuData, the full data and the hierarchy come back from the file.
+		std::shared_ptr<MeshBVH> restoredBVH = Mesh::CreateBVH(CreateQuad(), MeshBVH::Data(bvhData));
+		ASSERT_TRUE(RaycastQuad(*restoredBVH, hit));
+		EXPECT_FLOAT_EQ(hit.distance, 1.0f);
+		EXPECT_NEAR(hit.uv.x, 0.75f, 1e-5f);
+	}
+	catch (const std::exception& e)
+	{
+		Logger::Error(e.what());
+		FAIL();
+	}
+}
@@ -0,0 +1,370 @@
+#include <gtest/gtest.h>
+
+#include "Core/SceneManager.h"
+#include "Components/Transform.h"
+#include "Components/RigidBody.h"
+#include "ComponentSystems/PhysicsSystem.h"
+#include "ComponentSystems/PhysicsJobSystem.h"
+#include "Core/ThreadPool.h"
+#include "Core/Logger.h"
+
+#include "TestUtils.h"
+
+#include <Jolt/Core/JobSystemThreadPool.h>
+
+using namespace Pengine;
+
+namespace
+{
+	constexpr uint64_t stepCount = 128;
+
+	// Powers of two, so the frame times add up to whole steps without rounding.
+	constexpr float fixedTimeStep = 1.0f / 64.0f;
+
+	std::shared_ptr<Entity> CreateBody(std::shared_ptr<Scene> scene, const glm::vec3& position, const bool isStatic)
+	{
+		std::shared_ptr<Entity> entity = scene->CreateEntity("Body");
+		entity->AddComponent<Transform>(entity, position);
+
+		RigidBody& rigidBody = entity->AddComponent<RigidBody>();
+		rigidBody.isStatic = isStatic;
+		if (!isStatic)
+		{
+			rigidBody.type = RigidBody::Type::Sphere;
+			rigidBody.shape.sphere.radius = 0.5f;
+		}
+
+		return entity;
+	}
+
+	/**
+	 * Drops a few spheres on a static box with the given frame time and returns their positions after stepCount steps.
+	 */
+	std::vector<glm::vec3> Simulate(const float deltaTime)
+	{
+		std::shared_ptr<Scene> scene = SceneManager::GetInstance().Create("Scene", "Main");
+		CreateBody(scene, glm::vec3(0.0f), true);
+
+		std::vector<std::shared_ptr<Entity>> spheres;
+		for (int i = 0; i < 4; i++)
+		{
+			spheres.emplace_back(CreateBody(scene, glm::vec3(i * 0.3f, 2.0f + i * 1.1f, i * -0.2f), false));
+		}
+
+		std::shared_ptr<PhysicsSystem> physicsSystem = scene->GetPhysicsSystem();
+		physicsSystem->SetFixedTimeStep(fixedTimeStep);
+		while (physicsSystem->GetStepCount() < stepCount)
+		{
+			physicsSystem->OnUpdate(deltaTime, scene);
+		}
+		EXPECT_EQ(physicsSystem->GetStepCount(), stepCount);
+
+		std::vector<glm::vec3> positions;
+		for (const std::shared_ptr<Entity>& sphere : spheres)
+		{
+			const JPH::BodyID id = sphere->GetComponent<RigidBody>().id;
+			positions.emplace_back(JoltVec3ToGlmVec3(physicsSystem->GetInstance().GetBodyInterface().GetPosition(id)));
+		}
+
+		SceneManager::GetInstance().Delete(scene);
+
+		return positions;
+	}
+
+	/**
+	 * Simulates a pile of spheres with the given job system and returns the average step time in milliseconds.
+	 */
+	double BenchmarkJobSystem(std::shared_ptr<JPH::JobSystem> jobSystem, const size_t bodyCount, const size_t frameCount)
+	{
+		std::shared_ptr<Scene> scene = SceneManager::GetInstance().Create("Scene", "Main");
+
+		std::shared_ptr<PhysicsSystem> physicsSystem = scene->GetPhysicsSystem();
+		physicsSystem->SetJobSystem(jobSystem);
+
+		PhysicsSystem::Settings settings = physicsSystem->GetSettings();
+		settings.maxBodyCount = bodyCount * 2;
+		settings.maxBodyPairCount = bodyCount * 8;
+		settings.maxContactConstraintCount = bodyCount * 8;
+		physicsSystem->SetSettings(settings, scene);
+
+		std::shared_ptr<Entity> ground = CreateBody(scene, glm::vec3(0.0f), true);
+		ground->GetComponent<RigidBody>().shape.box.halfExtents = glm::vec3(100.0f, 1.0f, 100.0f);
+
+		const size_t side = static_cast<size_t>(std::ceil(std::sqrt(bodyCount / 10.0)));
+		for (size_t i = 0; i < bodyCount; i++)
+		{
+			const size_t x = i % side;
+			const size_t z = (i / side) % side;
+			const size_t y = i / (side * side);
+			CreateBody(scene, glm::vec3(x * 1.1f - side * 0.55f, 2.0f + y * 1.1f, z * 1.1f - side * 0.55f), false);
+		}
+
+		// Bodies are created on the first update.
+		physicsSystem->OnUpdate(physicsSystem->GetFixedTimeStep(), scene);
+
+		const double time = TestUtils::Measure([&]()
+		{
+			for (size_t frame = 0; frame < frameCount; frame++)
+			{
+				physicsSystem->OnUpdate(physicsSystem->GetFixedTimeStep(), scene);
+			}
+		});
+
+		SceneManager::GetInstance().Delete(scene);
+
+		return time / frameCount;
+	}
+}
+
+TEST(Physics, DeterministicFixedStep)
+{
+	try
+	{
+		// None of the frame times exceeds the maximum steps per frame.
+		const std::vector<glm::vec3> reference = Simulate(fixedTimeStep);
+		for (const float deltaTime : { fixedTimeStep * 2.0f, fixedTimeStep * 0.5f, fixedTimeStep * 4.0f })
+		{
+			const std::vector<glm::vec3> positions = Simulate(deltaTime);
+			ASSERT_EQ(positions.size(), reference.size());
+			for (size_t i = 0; i < positions.size(); i++)
+			{
+				EXPECT_EQ(positions[i], reference[i]);
+			}
+		}
+
+		// The spheres must have actually fallen.
+		EXPECT_LT(reference.front().y, 2.0f);
+	}
+	catch (const std::exception& e)
+	{
+		Logger::Error(e.what());
+		FAIL();
+	}
+}
+
+TEST(Physics, MaxStepsPerFrame)
+{
+	try
+	{
+		std::shared_ptr<Scene> scene = SceneManager::GetInstance().Create("Scene", "Main");
+		CreateBody(scene, glm::vec3(0.0f, 2.0f, 0.0f), false);
+
+		std::shared_ptr<PhysicsSystem> physicsSystem = scene->GetPhysicsSystem();
+
+		// A long hitch is clamped instead of being caught up on.
+		physicsSystem->OnUpdate(1.0f, scene);
+		EXPECT_EQ(physicsSystem->GetStepCount(), physicsSystem->GetMaxStepsPerFrame());
+		EXPECT_GE(physicsSystem->GetInterpolationFactor(), 0.0f);
+		EXPECT_LT(physicsSystem->GetInterpolationFactor(), 1.0f);
+
+		SceneManager::GetInstance().Delete(scene);
+	}
+	catch (const std::exception& e)
+	{
+		Logger::Error(e.what());
+		FAIL();
+	}
+}
+
+TEST(Physics, SleepingBodySnapsToSimulatedPose)
+{
+	try
+	{
+		std::shared_ptr<Scene> scene = SceneManager::GetInstance().Create("Scene", "Main");
+		CreateBody(scene, glm::vec3(0.0f), true);
+		std::shared_ptr<Entity> sphere = CreateBody(scene, glm::vec3(0.0f, 2.0f, 0.0f), false);
+
+		std::shared_ptr<PhysicsSystem> physicsSystem = scene->GetPhysicsSystem();
+		physicsSystem->SetFixedTimeStep(fixedTimeStep);
+
+		// The frame ends between two steps, so the shown pose is interpolated.
+		JPH::BodyInterface& bodyInterface = physicsSystem->GetInstance().GetBodyInterface();
+		physicsSystem->OnUpdate(fixedTimeStep * 1.5f, scene);
+		physicsSystem->OnUpdate(fixedTimeStep * 1.5f, scene);
+		const JPH::BodyID id = sphere->GetComponent<RigidBody>().id;
+		ASSERT_TRUE(bodyInterface.IsActive(id));
+
+		// Put to sleep while still falling, the next frame doesn't step.
+		bodyInterface.DeactivateBody(id);
+		physicsSystem->OnUpdate(fixedTimeStep * 0.25f, scene);
+		ASSERT_FALSE(bodyInterface.IsActive(id));
+
+		const Transform& transform = sphere->GetComponent<Transform>();
+		EXPECT_EQ(transform.GetPosition(), JoltVec3ToGlmVec3(bodyInterface.GetPosition(id)));
+		EXPECT_NEAR(std::abs(glm::dot(transform.GetRotationQuat(), JoltQuatToGlmQuat(bodyInterface.GetRotation(id)))), 1.0f, 1e-6f);
+
+		SceneManager::GetInstance().Delete(scene);
+	}
+	catch (const std::exception& e)
+	{
+		Logger::Error(e.what());
+		FAIL();
+	}
+}
+
+TEST(Physics, DefaultLayerFollowsStaticFlag)
+{
+	try
+	{
+		std::shared_ptr<Scene> scene = SceneManager::GetInstance().Create("Scene", "Main");
+		std::shared_ptr<Entity> ground = CreateBody(scene, glm::vec3(0.0f), true);
+		std::shared_ptr<Entity> sphere = CreateBody(scene, glm::vec3(0.0f, 2.0f, 0.0f), false);
+		std::shared_ptr<Entity> debris = CreateBody(scene, glm::vec3(0.0f, 4.0f, 0.0f), false);
+		debris->GetComponent<RigidBody>().layer = ObjectLayers::DEBRIS;
+
+		std::shared_ptr<PhysicsSystem> physicsSystem = scene->GetPhysicsSystem();
+		physicsSystem->UpdateBodies(scene);
+
+		const JPH::BodyInterface& bodyInterface = physicsSystem->GetInstance().GetBodyInterface();
+		EXPECT_EQ(bodyInterface.GetObjectLayer(ground->GetComponent<RigidBody>().id), ObjectLayers::STATIC);
+		EXPECT_EQ(bodyInterface.GetObjectLayer(sphere->GetComponent<RigidBody>().id), ObjectLayers::DYNAMIC);
+		EXPECT_EQ(bodyInterface.GetObjectLayer(debris->GetComponent<RigidBody>().id), ObjectLayers::DEBRIS);
+
+		// The default layer keeps following the flag, a layer that has been set doesn't.
+		for (const std::shared_ptr<Entity>& entity : { ground, debris })
+		{
+			RigidBody& rigidBody = entity->GetComponent<RigidBody>();
+			rigidBody.isStatic = !rigidBody.isStatic;
+			rigidBody.isValid = false;
+		}
+		physicsSystem->UpdateBodies(scene);
+
+		EXPECT_EQ(bodyInterface.GetObjectLayer(ground->GetComponent<RigidBody>().id), ObjectLayers::DYNAMIC);
+		EXPECT_EQ(bodyInterface.GetObjectLayer(debris->GetComponent<RigidBody>().id), ObjectLayers::DEBRIS);
+
+		SceneManager::GetInstance().Delete(scene);
+	}
+	catch (const std::exception& e)
+	{
+		Logger::Error(e.what());
+		FAIL();
+	}
+}
+
+TEST(Physics, BodyCountGrowsOnUpdate)
+{
+	try
+	{
+		constexpr size_t bodyCount = 10;
+
+		std::shared_ptr<Scene> scene = SceneManager::GetInstance().Create("Scene", "Main");
+		std::shared_ptr<PhysicsSystem> physicsSystem = scene->GetPhysicsSystem();
+
+		PhysicsSystem::Settings settings = physicsSystem->GetSettings();
+		settings.maxBodyCount = 2;
+		settings.allowGrowth = true;
+		physicsSystem->SetSettings(settings, scene);
+
+		std::vector<std::shared_ptr<Entity>> bodies;
+		for (size_t i = 0; i < bodyCount; i++)
+		{
+			bodies.emplace_back(CreateBody(scene, glm::vec3(i * 2.0f, 2.0f, 0.0f), false));
+		}
+
+		// Only grows the limit once, the world is rebuilt by the next update.
+		physicsSystem->UpdateBodies(scene);
+		EXPECT_EQ(physicsSystem->GetSettings().maxBodyCount, 4);
+
+		physicsSystem->OnUpdate(physicsSystem->GetFixedTimeStep(), scene);
+		EXPECT_EQ(physicsSystem->GetSettings().maxBodyCount, 16);
+		for (const std::shared_ptr<Entity>& body : bodies)
+		{
+			EXPECT_TRUE(body->GetComponent<RigidBody>().isValid);
+			EXPECT_FALSE(body->GetComponent<RigidBody>().id.IsInvalid());
+		}
+
+		SceneManager::GetInstance().Delete(scene);
+	}
+	catch (const std::exception& e)
+	{
+		Logger::Error(e.what());
+		FAIL();
+	}
+}
+
+TEST(Physics, JobSystemAfterPoolShutdown)
+{
+	try
+	{
+		JPH::RegisterDefaultAllocator();
+
+		ThreadPool threadPool;
+		threadPool.Initialize(2);
+
+		{
+			PhysicsJobSystem jobSystem(JPH::cMaxPhysicsJobs, JPH::cMaxPhysicsBarriers, threadPool);
+
+			threadPool.Shutdown();
+			EXPECT_EQ(threadPool.GetThreadCount(), 0);
+
+			constexpr int jobCount = 8;
+			std::atomic<int> executedCount = 0;
+
+			JPH::JobSystem::Barrier* barrier = jobSystem.CreateBarrier();
+			for (int i = 0; i < jobCount; i++)
+			{
+				JPH::JobHandle job = jobSystem.CreateJob("Test", JPH::Color::sGreen, [&executedCount]()
+				{
+					executedCount++;
+				});
+				barrier->AddJob(job);
+			}
+
+			jobSystem.WaitForJobs(barrier);
+			jobSystem.DestroyBarrier(barrier);
+
+			EXPECT_EQ(executedCount.load(), jobCount);
+
+			// Nothing is left in the pool for the destructor to wait on.
+		}
+
+		bool isExecuted = false;
+		threadPool.EnqueueAsync([&isExecuted]()
+		{
+			isExecuted = true;
+		});
+		EXPECT_TRUE(isExecuted);
+	}
+	catch (const std::exception& e)
+	{
+		Logger::Error(e.what());
+		FAIL();
+	}
+}
+
+TEST(Physics, BenchmarkJobSystem5000Bodies)
+{
+	try
+	{
+		constexpr size_t bodyCount = 5000;
+		constexpr size_t frameCount = 120;
+		const uint32_t threadCount = glm::max(std::thread::hardware_concurrency(), 2u) - 1;
+
+		// The job systems are created before any physics system registers the allocator they are made with.
+		JPH::RegisterDefaultAllocator();
+
+		// Separate threads for Jolt, as before.
+		const double joltThreadPoolTime = BenchmarkJobSystem(
+			std::make_shared<JPH::JobSystemThreadPool>(JPH::cMaxPhysicsJobs, JPH::cMaxPhysicsBarriers, threadCount),
+			bodyCount,
+			frameCount);
+
+		ThreadPool threadPool;
+		threadPool.Initialize(threadCount);
+
+		const double engineThreadPoolTime = BenchmarkJobSystem(
+			std::make_shared<PhysicsJobSystem>(JPH::cMaxPhysicsJobs, JPH::cMaxPhysicsBarriers, threadPool),
+			bodyCount,
+			frameCount);
+
+		threadPool.Shutdown();
+
+		Logger::Log("Physics: {} bodies, {} threads, JobSystemThreadPool {:.3f} ms, PhysicsJobSystem {:.3f} ms per step, {:.2f}x",
+			bodyCount, threadCount, joltThreadPoolTime, engineThreadPoolTime, engineThreadPoolTime / joltThreadPoolTime);
+	}
+	catch (const std::exception& e)
+	{
+		Logger::Error(e.what());
+		FAIL();
+	}
+}
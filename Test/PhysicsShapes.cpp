@@ -0,0 +1,260 @@
+#include <gtest/gtest.h>
+
+#include "Core/SceneManager.h"
+#include "Core/FileFormatNames.h"
+#include "Core/Serializer.h"
+#include "Components/Transform.h"
+#include "Components/RigidBody.h"
+#include "ComponentSystems/PhysicsSystem.h"
+#include "Core/Logger.h"
+#include "Utils/Utils.h"
+
+#include <Jolt/Physics/Collision/Shape/CompoundShape.h>
+
+#include <fstream>
+
+using namespace Pengine;
+
+namespace
+{
+	/**
+	 * Position followed by an uv like the collision vertices of a mesh, so the stride is not just the position.
+	 */
+	struct Vertex
+	{
+		glm::vec3 position;
+		glm::vec2 uv;
+	};
+
+	struct CubeMesh
+	{
+		std::vector<Vertex> vertices;
+		std::vector<uint32_t> indices;
+	};
+
+	/**
+	 * Cube from -1 to 1, the first two triangles are the bottom face.
+	 */
+	CubeMesh CreateCube()
+	{
+		CubeMesh cube;
+		for (int i = 0; i < 8; i++)
+		{
+			cube.vertices.emplace_back(Vertex{ glm::vec3(i & 1 ? 1.0f : -1.0f, i & 2 ? 1.0f : -1.0f, i & 4 ? 1.0f : -1.0f), glm::vec2(0.0f) });
+		}
+
+		cube.indices =
+		{
+			0, 1, 5, 0, 5, 4, // Bottom.
+			2, 7, 3, 2, 6, 7, // Top.
+			0, 2, 3, 0, 3, 1, // Back.
+			4, 5, 7, 4, 7, 6, // Front.
+			0, 4, 6, 0, 6, 2, // Left.
+			1, 3, 7, 1, 7, 5, // Right.
+		};
+
+		return cube;
+	}
+
+	JPH::ShapeSettings::ShapeResult CookCube(const CubeMesh& cube, const size_t indexCount, const bool isConvex)
+	{
+		return PhysicsSystem::CookMeshShape(
+			reinterpret_cast<const uint8_t*>(cube.vertices.data()),
+			sizeof(Vertex),
+			cube.vertices.size(),
+			cube.indices,
+			0,
+			indexCount,
+			isConvex);
+	}
+
+	std::shared_ptr<Entity> CreateBody(std::shared_ptr<Scene> scene, const glm::vec3& position, const RigidBody::Type type)
+	{
+		std::shared_ptr<Entity> entity = scene->CreateEntity("Body");
+		entity->AddComponent<Transform>(entity, position);
+
+		RigidBody& rigidBody = entity->AddComponent<RigidBody>();
+		rigidBody.type = type;
+
+		return entity;
+	}
+
+	const JPH::Shape* GetShape(std::shared_ptr<PhysicsSystem> physicsSystem, const std::shared_ptr<Entity>& entity)
+	{
+		return physicsSystem->GetInstance().GetBodyInterface().GetShape(entity->GetComponent<RigidBody>().id).GetPtr();
+	}
+}
+
+TEST(PhysicsShapes, CooksMeshAndConvexHull)
+{
+	try
+	{
+		// Registers the Jolt types the shapes are made of.
+		const PhysicsSystem physicsSystem;
+
+		const CubeMesh cube = CreateCube();
+
+		const JPH::ShapeSettings::ShapeResult mesh = CookCube(cube, cube.indices.size(), false);
+		ASSERT_TRUE(mesh.IsValid()) << mesh.GetError();
+		EXPECT_EQ(mesh.Get()->GetSubType(), JPH::EShapeSubType::Mesh);
+		EXPECT_TRUE(mesh.Get()->GetLocalBounds().mMin.IsClose(JPH::Vec3(-1.0f, -1.0f, -1.0f)));
+		EXPECT_TRUE(mesh.Get()->GetLocalBounds().mMax.IsClose(JPH::Vec3(1.0f, 1.0f, 1.0f)));
+
+		const JPH::ShapeSettings::ShapeResult convexHull = CookCube(cube, cube.indices.size(), true);
+		ASSERT_TRUE(convexHull.IsValid()) << convexHull.GetError();
+		EXPECT_EQ(convexHull.Get()->GetSubType(), JPH::EShapeSubType::ConvexHull);
+		EXPECT_NEAR(convexHull.Get()->GetVolume(), 8.0f, 0.1f);
+
+		// Only the triangles of the index range, like a lod.
+		const JPH::ShapeSettings::ShapeResult bottom = CookCube(cube, 6, false);
+		ASSERT_TRUE(bottom.IsValid()) << bottom.GetError();
+		EXPECT_NEAR(bottom.Get()->GetLocalBounds().mMax.GetY(), -1.0f, 1e-5f);
+	}
+	catch (const std::exception& e)
+	{
+		Logger::Error(e.what());
+		FAIL();
+	}
+}
+
+TEST(PhysicsShapes, CompoundOfChildBodies)
+{
+	try
+	{
+		std::shared_ptr<Scene> scene = SceneManager::GetInstance().Create("Scene", "Main");
+
+		std::shared_ptr<Entity> compound = CreateBody(scene, glm::vec3(0.0f, 5.0f, 0.0f), RigidBody::Type::Compound);
+
+		std::shared_ptr<Entity> box = CreateBody(scene, glm::vec3(-2.0f, 0.0f, 0.0f), RigidBody::Type::Box);
+		std::shared_ptr<Entity> sphere = CreateBody(scene, glm::vec3(2.0f, 0.0f, 0.0f), RigidBody::Type::Sphere);
+		sphere->GetComponent<RigidBody>().shape.sphere.radius = 0.5f;
+		compound->AddChild(box);
+		compound->AddChild(sphere);
+
+		// Nested compounds are skipped.
+		std::shared_ptr<Entity> nested = CreateBody(scene, glm::vec3(0.0f), RigidBody::Type::Compound);
+		compound->AddChild(nested);
+
+		std::shared_ptr<PhysicsSystem> physicsSystem = scene->GetPhysicsSystem();
+		physicsSystem->UpdateBodies(scene);
+
+		// The parts don't get bodies of their own.
+		ASSERT_FALSE(compound->GetComponent<RigidBody>().id.IsInvalid());
+		EXPECT_TRUE(box->GetComponent<RigidBody>().id.IsInvalid());
+		EXPECT_TRUE(sphere->GetComponent<RigidBody>().id.IsInvalid());
+
+		const JPH::Shape* shape = GetShape(physicsSystem, compound);
+		ASSERT_EQ(shape->GetSubType(), JPH::EShapeSubType::StaticCompound);
+		EXPECT_EQ(static_cast<const JPH::CompoundShape*>(shape)->GetNumSubShapes(), 2);
+
+		// From the left side of the box to the right side of the sphere, the bounds are around the center of mass.
+		EXPECT_NEAR(shape->GetLocalBounds().GetSize().GetX(), 5.5f, 1e-4f);
+
+		// A changed part rebuilds the compound.
+		RigidBody& boxRigidBody = box->GetComponent<RigidBody>();
+		boxRigidBody.shape.box.halfExtents = glm::vec3(2.0f);
+		boxRigidBody.isValid = false;
+		physicsSystem->UpdateBodies(scene);
+
+		shape = GetShape(physicsSystem, compound);
+		EXPECT_NEAR(shape->GetLocalBounds().GetSize().GetX(), 6.5f, 1e-4f);
+
+		SceneManager::GetInstance().Delete(scene);
+	}
+	catch (const std::exception& e)
+	{
+		Logger::Error(e.what());
+		FAIL();
+	}
+}
+
+TEST(PhysicsShapes, SharedBetweenEqualColliders)
+{
+	try
+	{
+		std::shared_ptr<Scene> scene = SceneManager::GetInstance().Create("Scene", "Main");
+
+		std::shared_ptr<Entity> first = CreateBody(scene, glm::vec3(0.0f), RigidBody::Type::Box);
+		std::shared_ptr<Entity> second = CreateBody(scene, glm::vec3(5.0f, 0.0f, 0.0f), RigidBody::Type::Box);
+		std::shared_ptr<Entity> larger = CreateBody(scene, glm::vec3(10.0f, 0.0f, 0.0f), RigidBody::Type::Box);
+		larger->GetComponent<RigidBody>().shape.box.halfExtents = glm::vec3(2.0f);
+		std::shared_ptr<Entity> sphere = CreateBody(scene, glm::vec3(15.0f, 0.0f, 0.0f), RigidBody::Type::Sphere);
+
+		std::shared_ptr<PhysicsSystem> physicsSystem = scene->GetPhysicsSystem();
+		physicsSystem->UpdateBodies(scene);
+
+		EXPECT_EQ(GetShape(physicsSystem, first), GetShape(physicsSystem, second));
+		EXPECT_NE(GetShape(physicsSystem, first), GetShape(physicsSystem, larger));
+		EXPECT_NE(GetShape(physicsSystem, first), GetShape(physicsSystem, sphere));
+
+		// The new world reuses the cached shapes.
+		const JPH::Shape* shape = GetShape(physicsSystem, first);
+		const JPH::Shape* largerShape = GetShape(physicsSystem, larger);
+		physicsSystem->SetSettings(physicsSystem->GetSettings(), scene);
+
+		EXPECT_EQ(GetShape(physicsSystem, first), shape);
+		EXPECT_EQ(GetShape(physicsSystem, second), shape);
+		EXPECT_EQ(GetShape(physicsSystem, larger), largerShape);
+		EXPECT_NE(GetShape(physicsSystem, first), GetShape(physicsSystem, larger));
+
+		SceneManager::GetInstance().Delete(scene);
+	}
+	catch (const std::exception& e)
+	{
+		Logger::Error(e.what());
+		FAIL();
+	}
+}
+
+TEST(PhysicsShapes, ShapeCacheInvalidation)
+{
+	try
+	{
+		const std::filesystem::path meshFilepath = std::filesystem::temp_directory_path() / "PhysicsShapesCube.mesh";
+		{
+			std::ofstream out(meshFilepath, std::ostream::binary);
+			out << "Cube";
+		}
+
+		const UUID uuid;
+		Utils::SetUUID(uuid, meshFilepath);
+
+		const PhysicsSystem physicsSystem;
+
+		const CubeMesh cube = CreateCube();
+		const JPH::ShapeSettings::ShapeResult convexHull = CookCube(cube, cube.indices.size(), true);
+		ASSERT_TRUE(convexHull.IsValid()) << convexHull.GetError();
+
+		constexpr size_t settingsHash = 1;
+		const std::string data = PhysicsSystem::SaveShape(*convexHull.Get());
+		Serializer::SerializePhysicsShapeCache(meshFilepath, settingsHash, data);
+
+		const std::string cachedData = Serializer::DeserializePhysicsShapeCache(meshFilepath, settingsHash);
+		EXPECT_EQ(cachedData, data);
+
+		const JPH::ShapeSettings::ShapeResult restored = PhysicsSystem::RestoreShape(cachedData);
+		ASSERT_TRUE(restored.IsValid()) << restored.GetError();
+		EXPECT_EQ(restored.Get()->GetSubType(), JPH::EShapeSubType::ConvexHull);
+		EXPECT_FLOAT_EQ(restored.Get()->GetVolume(), convexHull.Get()->GetVolume());
+
+		// Cooked with other settings.
+		EXPECT_TRUE(Serializer::DeserializePhysicsShapeCache(meshFilepath, settingsHash + 1).empty());
+
+		// Meshes created at runtime have no uuid.
+		EXPECT_TRUE(Serializer::DeserializePhysicsShapeCache(std::filesystem::temp_directory_path() / "PhysicsShapesRuntime.mesh", settingsHash).empty());
+
+		// The mesh has changed since it was cooked.
+		std::filesystem::last_write_time(meshFilepath, std::filesystem::last_write_time(meshFilepath) + std::chrono::seconds(1));
+		EXPECT_TRUE(Serializer::DeserializePhysicsShapeCache(meshFilepath, settingsHash).empty());
+
+		std::filesystem::path cacheFilepath = std::filesystem::path("Physics") / "Cache" / (uuid.ToString() + "_" + std::to_string(settingsHash));
+		cacheFilepath.concat(FileFormats::PhysicsShape());
+		std::filesystem::remove(cacheFilepath);
+		std::filesystem::remove(meshFilepath);
+	}
+	catch (const std::exception& e)
+	{
+		Logger::Error(e.what());
+		FAIL();
+	}
+}
@@ -0,0 +1,143 @@
+#include <gtest/gtest.h>
+
+#include "Core/Logger.h"
+#include "Utils/RadixSort.h"
+
+#include "TestUtils.h"
+
+#include <algorithm>
+#include <random>
+
+using namespace Pengine;
+
+namespace
+{
+	std::vector<Utils::SortEntry> MakeEntries(const size_t count, const uint64_t keyMask, const uint32_t seed)
+	{
+		std::mt19937_64 random(seed);
+
+		std::vector<Utils::SortEntry> entries(count);
+		for (size_t i = 0; i < count; i++)
+		{
+			entries[i].key = random() & keyMask;
+			entries[i].index = static_cast<uint32_t>(i);
+		}
+
+		return entries;
+	}
+
+	void ExpectStableSorted(const std::vector<Utils::SortEntry>& sorted, std::vector<Utils::SortEntry> entries)
+	{
+		std::stable_sort(entries.begin(), entries.end(), [](const Utils::SortEntry& a, const Utils::SortEntry& b)
+		{
+			return a.key < b.key;
+		});
+
+		ASSERT_EQ(sorted.size(), entries.size());
+		for (size_t i = 0; i < entries.size(); i++)
+		{
+			EXPECT_EQ(sorted[i].key, entries[i].key);
+			EXPECT_EQ(sorted[i].index, entries[i].index);
+		}
+	}
+}
+
+TEST(RadixSort, SortsLikeStableSort)
+{
+	try
+	{
+		const std::vector<Utils::SortEntry> entries = MakeEntries(10000, ~0ull, 1);
+
+		std::vector<Utils::SortEntry> sorted = entries;
+		std::vector<Utils::SortEntry> scratch;
+		Utils::RadixSort(sorted, scratch);
+
+		ExpectStableSorted(sorted, entries);
+	}
+	catch (const std::exception& e)
+	{
+		Logger::Error(e.what());
+		FAIL();
+	}
+}
+
+TEST(RadixSort, KeepsTheOrderOfEqualKeys)
+{
+	try
+	{
+		// Only the top and the bottom byte differ, the skipped digits in between must not break stability.
+		const std::vector<Utils::SortEntry> entries = MakeEntries(5000, 0xF000000000000003ull, 2);
+
+		std::vector<Utils::SortEntry> sorted = entries;
+		std::vector<Utils::SortEntry> scratch;
+		Utils::RadixSort(sorted, scratch);
+
+		ExpectStableSorted(sorted, entries);
+
+		// Equal keys only, nothing is moved.
+		std::vector<Utils::SortEntry> equal = MakeEntries(100, 0, 3);
+		Utils::RadixSort(equal, scratch);
+		for (size_t i = 0; i < equal.size(); i++)
+		{
+			EXPECT_EQ(equal[i].index, i);
+		}
+
+		std::vector<Utils::SortEntry> empty;
+		Utils::RadixSort(empty, scratch);
+		EXPECT_TRUE(empty.empty());
+	}
+	catch (const std::exception& e)
+	{
+		Logger::Error(e.what());
+		FAIL();
+	}
+}
+
+TEST(RadixSort, BenchmarkTransparentSortKeys)
+{
+	try
+	{
+		constexpr size_t entryCount = 100000;
+		constexpr int frameCount = 20;
+
+		// Rendering order, distance bucket, batch and fine distance like the Transparent pass keys.
+		const std::vector<Utils::SortEntry> entries = MakeEntries(entryCount, 0x3FFFFFFFFFFFFFFFull, 4);
+
+		std::vector<Utils::SortEntry> sorted;
+		std::vector<Utils::SortEntry> scratch;
+
+		const double stdSortTime = TestUtils::Measure([&]()
+		{
+			for (int frame = 0; frame < frameCount; frame++)
+			{
+				sorted = entries;
+				std::sort(sorted.begin(), sorted.end(), [](const Utils::SortEntry& a, const Utils::SortEntry& b)
+				{
+					return a.key < b.key;
+				});
+			}
+		}) / frameCount;
+
+		const double radixSortTime = TestUtils::Measure([&]()
+		{
+			for (int frame = 0; frame < frameCount; frame++)
+			{
+				sorted = entries;
+				Utils::RadixSort(sorted, scratch);
+			}
+		}) / frameCount;
+
+		EXPECT_TRUE(std::is_sorted(sorted.begin(), sorted.end(), [](const Utils::SortEntry& a, const Utils::SortEntry& b)
+		{
+			return a.key < b.key;
+		}));
+
+		Logger::Log("RadixSort: {} entries, std::sort {:.3f} ms, radix sort {:.3f} ms",
+			entryCount, stdSortTime, radixSortTime);
+	}
+	catch (const std::exception& e)
+	{
+		Logger::Error(e.what());
+		FAIL();
+	}
+}
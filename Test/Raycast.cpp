@@ -0,0 +1,190 @@
+#include <gtest/gtest.h>
+
+#include "Core/Raycast.h"
+#include "Core/ThreadPool.h"
+#include "Core/Logger.h"
+#include "Graphics/MeshBVH.h"
+#include "Graphics/Vertex.h"
+
+#include "TestUtils.h"
+
+#include <random>
+
+using namespace Pengine;
+
+namespace
+{
+	struct GridMesh
+	{
+		std::vector<VertexPosition> vertices;
+		std::vector<uint32_t> indices;
+	};
+
+	/**
+	 * Wavy height field of size x size quads in [0, size] on xz.
+	 */
+	GridMesh CreateGridMesh(const uint32_t size)
+	{
+		GridMesh mesh{};
+		mesh.vertices.reserve((size + 1) * (size + 1));
+		mesh.indices.reserve(size * size * 6);
+
+		for (uint32_t z = 0; z <= size; z++)
+		{
+			for (uint32_t x = 0; x <= size; x++)
+			{
+				const float height = glm::sin(x * 0.3f) * glm::cos(z * 0.2f);
+				mesh.vertices.emplace_back(VertexPosition{ { (float)x, height, (float)z }, { (float)x / size, (float)z / size } });
+			}
+		}
+
+		for (uint32_t z = 0; z < size; z++)
+		{
+			for (uint32_t x = 0; x < size; x++)
+			{
+				const uint32_t i = z * (size + 1) + x;
+				mesh.indices.insert(mesh.indices.end(), { i, i + size + 1, i + 1, i + 1, i + size + 1, i + size + 2 });
+			}
+		}
+
+		return mesh;
+	}
+
+	/**
+	 * Rays cast down from above the middle of the grid, tilted at most so they can't leave it.
+	 */
+	std::vector<Raycast::Ray> CreateRays(const size_t count, const float size)
+	{
+		std::mt19937 random(42);
+		std::uniform_real_distribution<float> position(size * 0.2f, size * 0.8f);
+		std::uniform_real_distribution<float> tilt(-0.5f, 0.5f);
+
+		std::vector<Raycast::Ray> rays(count);
+		for (Raycast::Ray& ray : rays)
+		{
+			ray.start = { position(random), 10.0f, position(random) };
+			ray.direction = glm::normalize(glm::vec3(tilt(random), -1.0f, tilt(random)));
+			ray.length = 100.0f;
+		}
+
+		return rays;
+	}
+}
+
+TEST(Raycast, MeshBVHClosestHit)
+{
+	try
+	{
+		const GridMesh grid = CreateGridMesh(32);
+		MeshBVH bvh((void*)grid.vertices.data(), grid.indices, sizeof(VertexPosition));
+
+		for (const Raycast::Ray& ray : CreateRays(256, 32.0f))
+		{
+			// Brute force over all triangles.
+			float closestDistance = std::numeric_limits<float>::max();
+			uint32_t closestTriangle = -1;
+			for (uint32_t i = 0; i < grid.indices.size() / 3; i++)
+			{
+				float distance;
+				glm::vec2 barycentrics;
+				if (Raycast::IntersectRayTriangle(
+					ray.start,
+					ray.direction,
+					grid.vertices[grid.indices[i * 3 + 0]].position,
+					grid.vertices[grid.indices[i * 3 + 1]].position,
+					grid.vertices[grid.indices[i * 3 + 2]].position,
+					ray.length,
+					distance,
+					barycentrics) && distance < closestDistance)
+				{
+					closestDistance = distance;
+					closestTriangle = i;
+				}
+			}
+
+			Raycast::Hit closestHit{};
+			const bool isClosestHit = bvh.Raycast(ray.start, ray.direction, ray.length, false, closestHit);
+			EXPECT_EQ(isClosestHit, closestTriangle != -1);
+
+			Raycast::Hit anyHit{};
+			EXPECT_EQ(bvh.Raycast(ray.start, ray.direction, ray.length, true, anyHit), isClosestHit);
+
+			if (!isClosestHit)
+			{
+				continue;
+			}
+
+			EXPECT_FLOAT_EQ(closestHit.distance, closestDistance);
+			EXPECT_GE(anyHit.distance, closestHit.distance);
+
+			const glm::vec3 a = grid.vertices[grid.indices[closestHit.triangle * 3 + 0]].position;
+			const glm::vec3 b = grid.vertices[grid.indices[closestHit.triangle * 3 + 1]].position;
+			const glm::vec3 c = grid.vertices[grid.indices[closestHit.triangle * 3 + 2]].position;
+			const glm::vec3 point = closestHit.barycentrics.x * a + closestHit.barycentrics.y * b + closestHit.barycentrics.z * c;
+			EXPECT_LT(glm::distance(point, closestHit.point), 1e-3f);
+		}
+	}
+	catch (const std::exception& e)
+	{
+		Logger::Error(e.what());
+		FAIL();
+	}
+}
+
+TEST(Raycast, BenchmarkMeshBVH)
+{
+	try
+	{
+		constexpr uint32_t gridSize = 256;
+		constexpr size_t rayCount = 200000;
+		constexpr size_t packetSize = 64;
+
+		const GridMesh grid = CreateGridMesh(gridSize);
+		MeshBVH bvh((void*)grid.vertices.data(), grid.indices, sizeof(VertexPosition));
+
+		const std::vector<Raycast::Ray> rays = CreateRays(rayCount, (float)gridSize);
+		std::vector<Raycast::Hit> hits(rayCount);
+
+		auto castRays = [&](const bool anyHit, const size_t begin, const size_t end)
+		{
+			for (size_t i = begin; i < end; i++)
+			{
+				bvh.Raycast(rays[i].start, rays[i].direction, rays[i].length, anyHit, hits[i]);
+			}
+		};
+
+		const double closestTime = TestUtils::Measure([&]() { castRays(false, 0, rayCount); });
+		const double anyTime = TestUtils::Measure([&]() { castRays(true, 0, rayCount); });
+
+		const uint32_t threadCount = glm::max(std::thread::hardware_concurrency(), 2u) - 1;
+		ThreadPool threadPool;
+		threadPool.Initialize(threadCount);
+
+		const double batchedTime = TestUtils::Measure([&]()
+		{
+			threadPool.ParallelFor(rayCount, packetSize, [&](const size_t begin, const size_t end)
+			{
+				castRays(false, begin, end);
+			});
+		});
+
+		threadPool.Shutdown();
+
+		for (const Raycast::Hit& hit : hits)
+		{
+			EXPECT_NE(hit.triangle, -1);
+		}
+
+		Logger::Log("Raycast: {} rays, {} triangles, closest {:.2f} Mrays/s, any {:.2f} Mrays/s, closest batched on {} threads {:.2f} Mrays/s",
+			rayCount, grid.indices.size() / 3,
+			rayCount / closestTime / 1e3,
+			rayCount / anyTime / 1e3,
+			threadCount + 1,
+			rayCount / batchedTime / 1e3);
+	}
+	catch (const std::exception& e)
+	{
+		Logger::Error(e.what());
+		FAIL();
+	}
+}
@@ -0,0 +1,251 @@
+#include <gtest/gtest.h>
+
+#include "Core/Logger.h"
+#include "Core/ReflectionSystem.h"
+#include "Core/Serializer.h"
+
+#include "TestUtils.h"
+
+using namespace Pengine;
+
+struct ReflectionTestItem
+{
+public: PROPERTY(int, count, 1);
+public: PROPERTY(std::string, name, "Item");
+};
+REGISTER_STRUCT(ReflectionTestItem)
+
+struct ReflectionTestComponent
+{
+public: PROPERTY(float, speed, 1.0f);
+public: PROPERTY(glm::vec3, direction, glm::vec3(0.0f, 0.0f, 1.0f));
+public: PROPERTY(std::vector<int>, ids, {});
+public: PROPERTY(ReflectionTestItem, item, {});
+public: PROPERTY(std::vector<ReflectionTestItem>, items, {});
+};
+REGISTER_CLASS(ReflectionTestComponent)
+
+/**
+ * Parents after a padding base, so they are not at offset 0 of the classes that inherit them.
+ */
+struct ReflectionTestPadding
+{
+	double padding[4]{};
+};
+
+struct ReflectionTestOuterPadding
+{
+	double outerPadding[4]{};
+};
+
+struct ReflectionTestBase
+{
+public: PROPERTY(int, baseValue, 0);
+};
+REGISTER_CLASS(ReflectionTestBase)
+
+struct ReflectionTestMiddle : public ReflectionTestPadding, public ReflectionTestBase
+{
+	REGISTER_PARENT_CLASS(ReflectionTestBase)
+
+public: PROPERTY(int, middleValue, 0);
+};
+REGISTER_CLASS(ReflectionTestMiddle)
+
+struct ReflectionTestDerived : public ReflectionTestOuterPadding, public ReflectionTestMiddle
+{
+	REGISTER_PARENT_CLASS(ReflectionTestMiddle)
+
+public: PROPERTY(int, derivedValue, 0);
+
+public:
+	void CopyProperties(const ReflectionTestDerived& other)
+	{
+		COPY_PROPERTIES(other)
+	}
+};
+REGISTER_CLASS(ReflectionTestDerived)
+
+namespace
+{
+	const ReflectionSystem::RegisteredClass& GetTestClass()
+	{
+		// Properties are added when the first instance is constructed.
+		ReflectionTestComponent component;
+
+		const ReflectionSystem::RegisteredClass* registeredClass = ReflectionSystem::GetInstance().FindClass(GetTypeHash<ReflectionTestComponent>());
+		if (!registeredClass)
+		{
+			throw std::runtime_error("ReflectionTestComponent is not registered!");
+		}
+
+		return *registeredClass;
+	}
+}
+
+TEST(Reflection, PropertiesAreKeyedByTypeHash)
+{
+	try
+	{
+		const ReflectionSystem::RegisteredClass& registeredClass = GetTestClass();
+		ASSERT_EQ(registeredClass.m_Properties.size(), 5);
+
+		// Declaration order, registered once however many instances are constructed.
+		ReflectionTestComponent other;
+		EXPECT_EQ(registeredClass.m_Properties.size(), 5);
+		EXPECT_EQ(registeredClass.m_Properties[0].m_Name, "speed");
+		EXPECT_EQ(registeredClass.m_Properties[4].m_Name, "items");
+
+		const ReflectionSystem::Property* speed = registeredClass.FindProperty("speed");
+		ASSERT_NE(speed, nullptr);
+		EXPECT_TRUE(speed->IsValue<float>());
+		EXPECT_FALSE(speed->IsValue<double>());
+		EXPECT_EQ(speed->m_Type, &ReflectionSystem::GetOrCreateType<float>());
+
+		const ReflectionSystem::Property* ids = registeredClass.FindProperty("ids");
+		ASSERT_NE(ids, nullptr);
+		EXPECT_TRUE(ids->IsVector());
+		EXPECT_EQ(ids->m_Type->elementType, &ReflectionSystem::GetOrCreateType<int>());
+
+		const ReflectionSystem::Property* items = registeredClass.FindProperty("items");
+		ASSERT_NE(items, nullptr);
+		EXPECT_EQ(items->m_Type->elementType->id, GetTypeHash<ReflectionTestItem>());
+		EXPECT_NE(ReflectionSystem::GetInstance().FindClass(GetTypeHash<ReflectionTestItem>()), nullptr);
+
+		// Structs are only used as properties, they can't be added to an entity.
+		EXPECT_FALSE(ReflectionSystem::GetInstance().FindClass(GetTypeHash<ReflectionTestItem>())->m_CreateCallback);
+		EXPECT_TRUE(registeredClass.m_CreateCallback);
+
+		ReflectionTestComponent component;
+		ReflectionSystem::SetValue(2.5f, &component, GetTypeHash<ReflectionTestComponent>(), "speed");
+		EXPECT_EQ(component.speed, 2.5f);
+		EXPECT_EQ(ReflectionSystem::GetValue<float>(&component, GetTypeHash<ReflectionTestComponent>(), "speed"), 2.5f);
+
+		// The type has to match, a double isn't written into a float.
+		ReflectionSystem::SetValue(5.0, &component, GetTypeHash<ReflectionTestComponent>(), "speed");
+		EXPECT_EQ(component.speed, 2.5f);
+
+		component.items.resize(3);
+		EXPECT_EQ(items->m_Type->getSize(items->GetPointer(&component, 0)), 3);
+		EXPECT_EQ(items->m_Type->getElement(items->GetPointer(&component, 0), 2), &component.items[2]);
+	}
+	catch (const std::exception& e)
+	{
+		Logger::Error(e.what());
+		FAIL();
+	}
+}
+
+TEST(Reflection, CopiesPropertiesOfNestedParents)
+{
+	try
+	{
+		ReflectionTestDerived source;
+		source.baseValue = 1;
+		source.middleValue = 2;
+		source.derivedValue = 3;
+
+		// The base is a parent of a parent, its offset is the sum of both.
+		ReflectionTestDerived destination;
+		destination.CopyProperties(source);
+		EXPECT_EQ(destination.baseValue, 1);
+		EXPECT_EQ(destination.middleValue, 2);
+		EXPECT_EQ(destination.derivedValue, 3);
+		for (size_t i = 0; i < 4; i++)
+		{
+			EXPECT_EQ(destination.padding[i], 0.0);
+			EXPECT_EQ(destination.outerPadding[i], 0.0);
+		}
+	}
+	catch (const std::exception& e)
+	{
+		Logger::Error(e.what());
+		FAIL();
+	}
+}
+
+TEST(Reflection, SerializesContainersAndNestedStructs)
+{
+	try
+	{
+		GetTestClass();
+
+		ReflectionTestComponent component;
+		component.speed = 4.0f;
+		component.direction = { 1.0f, 2.0f, 3.0f };
+		component.ids = { 7, 8, 9 };
+		component.item.count = 5;
+		component.item.name = "Key";
+		component.items.resize(2);
+		component.items[1].count = 12;
+		component.items[1].name = "Arrow";
+
+		YAML::Emitter out;
+		out << YAML::BeginMap;
+		Serializer::SerializeReflectedClass(out, &component, GetTypeHash<ReflectionTestComponent>());
+		out << YAML::EndMap;
+		ASSERT_TRUE(out.good());
+
+		ReflectionTestComponent loaded;
+		Serializer::DeserializeReflectedClass(YAML::LoadMesh(out.c_str()), &loaded, GetTypeHash<ReflectionTestComponent>());
+
+		EXPECT_EQ(loaded.speed, component.speed);
+		EXPECT_EQ(loaded.direction, component.direction);
+		EXPECT_EQ(loaded.ids, component.ids);
+		EXPECT_EQ(loaded.item.count, 5);
+		EXPECT_EQ(loaded.item.name, "Key");
+		ASSERT_EQ(loaded.items.size(), 2);
+		EXPECT_EQ(loaded.items[0].count, 1);
+		EXPECT_EQ(loaded.items[1].count, 12);
+		EXPECT_EQ(loaded.items[1].name, "Arrow");
+	}
+	catch (const std::exception& e)
+	{
+		Logger::Error(e.what());
+		FAIL();
+	}
+}
+
+TEST(Reflection, BenchmarkSerializeTenThousandComponents)
+{
+	try
+	{
+		GetTestClass();
+
+		constexpr size_t componentCount = 10000;
+
+		std::vector<ReflectionTestComponent> components(componentCount);
+		for (size_t i = 0; i < componentCount; i++)
+		{
+			components[i].speed = static_cast<float>(i);
+			components[i].ids = { static_cast<int>(i), static_cast<int>(i * 2) };
+		}
+
+		YAML::Emitter out;
+		const double time = TestUtils::Measure([&]()
+		{
+			out << YAML::BeginSeq;
+			for (ReflectionTestComponent& component : components)
+			{
+				out << YAML::BeginMap;
+				Serializer::SerializeReflectedClass(out, &component, GetTypeHash<ReflectionTestComponent>());
+				out << YAML::EndMap;
+			}
+			out << YAML::EndSeq;
+		});
+
+		ASSERT_TRUE(out.good());
+
+		const YAML::Node data = YAML::LoadMesh(out.c_str());
+		ASSERT_EQ(data.size(), componentCount);
+		EXPECT_EQ(data[componentCount - 1]["speed"]["Value"].as<float>(), static_cast<float>(componentCount - 1));
+
+		Logger::Log("Reflection: serialized {} components in {:.3f} ms, {:.3f} us per component",
+			componentCount, time, time * 1000.0 / componentCount);
+	}
+	catch (const std::exception& e)
+	{
+		Logger::Error(e.what());
+		FAIL();
+	}
+}
@@ -2,6 +2,11 @@
 
 #include "Core/SceneManager.h"
 #include "Core/Logger.h"
+#include "Core/RenderSnapshot.h"
+#include "Components/Canvas.h"
+#include "Components/Transform.h"
+
+#include "TestUtils.h"
 
 using namespace Pengine;
 
@@ -27,3 +32,196 @@ TEST(Scene, Create)
 		FAIL();
 	}
 }
+
+namespace
+{
+	/**
+	 * Root with the given number of children, all with a transform.
+	 */
+	std::shared_ptr<Entity> CreatePrefab(const std::shared_ptr<Scene>& scene, const size_t childCount)
+	{
+		std::shared_ptr<Entity> prefab = scene->CreateEntity("Prefab");
+		prefab->AddComponent<Transform>(prefab);
+
+		for (size_t i = 0; i < childCount; i++)
+		{
+			std::shared_ptr<Entity> child = scene->CreateEntity("Child");
+			child->AddComponent<Transform>(child, glm::vec3(0.0f, 1.0f, 0.0f));
+			prefab->AddChild(child, false);
+		}
+
+		return prefab;
+	}
+}
+
+TEST(Scene, Instantiate)
+{
+	try
+	{
+		constexpr size_t count = 8;
+
+		std::shared_ptr<Scene> scene = SceneManager::GetInstance().Create("Scene", "Main");
+		std::shared_ptr<Entity> prefab = CreatePrefab(scene, 1);
+
+		std::vector<glm::mat4> transforms;
+		for (size_t i = 0; i < count; i++)
+		{
+			transforms.emplace_back(glm::translate(glm::mat4(1.0f), glm::vec3((float)i, 0.0f, 0.0f)));
+		}
+
+		std::vector<std::shared_ptr<Entity>> roots = scene->Instantiate(prefab, count, transforms);
+		ASSERT_EQ(roots.size(), count);
+		EXPECT_EQ(scene->GetEntities().size(), 2 + count * 2);
+
+		for (size_t i = 0; i < count; i++)
+		{
+			const std::shared_ptr<Entity>& root = roots[i];
+			EXPECT_EQ(root->GetName(), "Prefab");
+			EXPECT_EQ(root->GetComponent<Transform>().GetEntity(), root);
+			EXPECT_EQ(root->GetComponent<Transform>().GetPosition(), glm::vec3((float)i, 0.0f, 0.0f));
+
+			ASSERT_EQ(root->GetChilds().size(), 1);
+			const std::shared_ptr<Entity> child = root->GetChilds().front().lock();
+			EXPECT_EQ(child->GetName(), "Child");
+			EXPECT_EQ(child->GetParent(), root);
+			EXPECT_EQ(child->GetComponent<Transform>().GetEntity(), child);
+			EXPECT_EQ(child->GetComponent<Transform>().GetPosition(), glm::vec3((float)i, 1.0f, 0.0f));
+		}
+
+		// The deleted entities are erased on flush and the rest keep their order.
+		const std::vector<std::shared_ptr<Entity>> entitiesBeforeDelete = scene->GetEntities();
+		std::shared_ptr<Entity> deleted = roots[3];
+		const std::shared_ptr<Entity> deletedChild = deleted->GetChilds().front().lock();
+		scene->DeleteEntity(roots[3]);
+		EXPECT_FALSE(scene->FindEntityByUUID(deleted->GetUUID()));
+		scene->FlushDeletionQueue();
+		EXPECT_EQ(scene->GetEntities().size(), 2 + (count - 1) * 2);
+
+		std::vector<std::shared_ptr<Entity>> expectedEntities;
+		for (const std::shared_ptr<Entity>& entity : entitiesBeforeDelete)
+		{
+			if (entity != deleted && entity != deletedChild)
+			{
+				expectedEntities.emplace_back(entity);
+			}
+		}
+		EXPECT_EQ(scene->GetEntities(), expectedEntities);
+
+		for (const std::shared_ptr<Entity>& entity : scene->GetEntities())
+		{
+			EXPECT_TRUE(entity->IsValid());
+			EXPECT_EQ(scene->FindEntityByUUID(entity->GetUUID()), entity);
+		}
+
+		scene->SetNameIndexEnabled(true);
+		std::shared_ptr<Entity> renamed = roots[5];
+		EXPECT_TRUE(scene->FindEntityByName("Child"));
+		renamed->SetName("Renamed");
+		EXPECT_EQ(scene->FindEntityByName("Renamed"), renamed);
+		scene->DeleteEntity(renamed);
+		EXPECT_FALSE(scene->FindEntityByName("Renamed"));
+
+		SceneManager::GetInstance().Delete(scene);
+	}
+	catch (const std::exception& e)
+	{
+		Logger::Error(e.what());
+		FAIL();
+	}
+}
+
+TEST(Scene, BenchmarkSpawnAndDestroy)
+{
+	try
+	{
+		constexpr size_t childCount = 3;
+		constexpr size_t count = 25000;
+
+		std::shared_ptr<Scene> scene = SceneManager::GetInstance().Create("Scene", "Main");
+		std::shared_ptr<Entity> prefab = CreatePrefab(scene, childCount);
+
+		std::vector<std::shared_ptr<Entity>> roots;
+		const double spawnTime = TestUtils::Measure([&]()
+		{
+			roots = scene->Instantiate(prefab, count);
+		});
+		EXPECT_EQ(scene->GetEntities().size(), (count + 1) * (childCount + 1));
+
+		const double destroyTime = TestUtils::Measure([&]()
+		{
+			for (std::shared_ptr<Entity>& root : roots)
+			{
+				scene->DeleteEntity(root);
+			}
+
+			scene->FlushDeletionQueue();
+		});
+		EXPECT_EQ(scene->GetEntities().size(), childCount + 1);
+
+		// Milliseconds, not seconds, with room for debug builds.
+		EXPECT_LT(spawnTime, 1000.0);
+		EXPECT_LT(destroyTime, 1000.0);
+
+		Logger::Log("Scene: {} entities, spawn {:.2f} ms, destroy {:.2f} ms",
+			count * (childCount + 1),
+			spawnTime,
+			destroyTime);
+
+		SceneManager::GetInstance().Delete(scene);
+	}
+	catch (const std::exception& e)
+	{
+		Logger::Error(e.what());
+		FAIL();
+	}
+}
+
+TEST(Scene, RenderSnapshotCopiesCanvasCommands)
+{
+	try
+	{
+		std::shared_ptr<Scene> scene = SceneManager::GetInstance().Create("Scene", "Main");
+
+		std::shared_ptr<Entity> entity = scene->CreateEntity("Canvas");
+		entity->AddComponent<Transform>(entity);
+		Canvas& canvas = entity->AddComponent<Canvas>();
+		canvas.size = { 640, 480 };
+
+		// Stands in for the Clay arena and the text of the script, both are overwritten by the next layout.
+		std::string text = "Health: 100";
+		std::vector<Clay_RenderCommand> arena(2);
+		arena[0].commandType = CLAY_RENDER_COMMAND_TYPE_RECTANGLE;
+		arena[0].boundingBox = { 1.0f, 2.0f, 3.0f, 4.0f };
+		arena[1].commandType = CLAY_RENDER_COMMAND_TYPE_TEXT;
+		arena[1].renderData.text.stringContents = { static_cast<int32_t>(text.size()), text.data(), text.data() };
+
+		canvas.commands.emplace_back(Clay_RenderCommandArray{ static_cast<int32_t>(arena.size()), static_cast<int32_t>(arena.size()), arena.data() });
+
+		RenderSnapshot snapshot;
+		snapshot.Extract(*scene);
+
+		std::fill(text.begin(), text.end(), 'x');
+		arena[0].boundingBox = {};
+		canvas.commands.clear();
+
+		ASSERT_EQ(snapshot.GetCanvases().size(), 1);
+		const RenderSnapshot::CanvasData& canvasData = snapshot.GetCanvases().front();
+		EXPECT_EQ(canvasData.entity, entity->GetHandle());
+		EXPECT_EQ(canvasData.size, glm::ivec2(640, 480));
+		EXPECT_FALSE(canvasData.drawInMainViewport);
+
+		const Clay_RenderCommandArray commands = snapshot.GetCanvasCommands(canvasData);
+		ASSERT_EQ(commands.length, 2);
+		EXPECT_EQ(commands.internalArray[0].boundingBox.width, 3.0f);
+
+		const Clay_StringSlice& copiedText = commands.internalArray[1].renderData.text.stringContents;
+		EXPECT_EQ(std::string_view(copiedText.chars, copiedText.length), "Health: 100");
+
+		SceneManager::GetInstance().Delete(scene);
+	}
+	catch (const std::exception& e)
+	{
+		Logger::Error(e.what());
+		FAIL();
+	}
+}
@@ -0,0 +1,192 @@
+#include <gtest/gtest.h>
+
+#include "Graphics/SkeletalAnimation.h"
+#include "Core/Logger.h"
+
+using namespace Pengine;
+
+namespace
+{
+	constexpr size_t keyCount = 3000;
+	constexpr float keyTime = 1.0f / 30.0f;
+
+	SkeletalAnimation::Bone CreateMocapBone()
+	{
+		SkeletalAnimation::Bone bone{};
+		for (size_t key = 0; key < keyCount; key++)
+		{
+			const float time = key * keyTime;
+			bone.positions.emplace_back(SkeletalAnimation::KeyVec{ time, glm::vec3(std::sin(time), std::cos(time * 0.5f) * 2.0f, time * 0.1f) });
+			bone.rotations.emplace_back(SkeletalAnimation::KeyQuat{ time, glm::normalize(glm::angleAxis(time * 0.7f, glm::normalize(glm::vec3(1.0f, std::sin(time), 0.5f)))) });
+			bone.scales.emplace_back(SkeletalAnimation::KeyVec{ time, glm::vec3(1.0f) });
+		}
+
+		return bone;
+	}
+
+	template<typename Key>
+	size_t FindReferenceKey(const std::vector<Key>& keys, const float time)
+	{
+		size_t index = 0;
+		while (index + 2 < keys.size() && time >= keys[index + 1].time)
+		{
+			index++;
+		}
+
+		return index;
+	}
+
+	glm::vec3 SampleReference(const std::vector<SkeletalAnimation::KeyVec>& keys, const float time)
+	{
+		const size_t index = FindReferenceKey(keys, time);
+		const float scaleFactor = glm::clamp<float>((time - keys[index].time) / (keys[index + 1].time - keys[index].time), 0.0f, 1.0f);
+		return glm::mix(keys[index].value, keys[index + 1].value, scaleFactor);
+	}
+
+	glm::quat SampleReference(const std::vector<SkeletalAnimation::KeyQuat>& keys, const float time)
+	{
+		const size_t index = FindReferenceKey(keys, time);
+		const float scaleFactor = glm::clamp<float>((time - keys[index].time) / (keys[index + 1].time - keys[index].time), 0.0f, 1.0f);
+		return glm::normalize(glm::slerp(keys[index].value, keys[index + 1].value, scaleFactor));
+	}
+
+	size_t GetUncompressedSize(const SkeletalAnimation::Bone& bone)
+	{
+		return bone.positions.size() * sizeof(SkeletalAnimation::KeyVec)
+			+ bone.rotations.size() * sizeof(SkeletalAnimation::KeyQuat)
+			+ bone.scales.size() * sizeof(SkeletalAnimation::KeyVec);
+	}
+}
+
+TEST(SkeletalAnimation, CompressionErrorBound)
+{
+	try
+	{
+		SkeletalAnimation::CompressionSettings compressionSettings{};
+		compressionSettings.positionTolerance = 0.001f;
+		compressionSettings.rotationTolerance = 0.001f;
+		compressionSettings.scaleTolerance = 0.001f;
+
+		const SkeletalAnimation::Bone bone = CreateMocapBone();
+		const SkeletalAnimation::Channel channel(bone, compressionSettings);
+
+		// Tolerance plus the quantization step of the track range.
+		const float maxPositionError = compressionSettings.positionTolerance + 0.001f;
+		const float maxRotationError = compressionSettings.rotationTolerance + 0.001f;
+
+		SkeletalAnimation::Cursor cursor{};
+		const float duration = (keyCount - 1) * keyTime;
+		for (float time = 0.0f; time < duration; time += keyTime * 0.37f)
+		{
+			glm::vec3 position;
+			glm::quat rotation;
+			glm::vec3 scale;
+			channel.Update(time, position, rotation, scale, &cursor);
+
+			EXPECT_LE(glm::distance(position, SampleReference(bone.positions, time)), maxPositionError);
+
+			const glm::quat referenceRotation = SampleReference(bone.rotations, time);
+			EXPECT_LE(2.0f * std::acos(glm::min(1.0f, std::abs(glm::dot(rotation, referenceRotation)))), maxRotationError);
+
+			EXPECT_EQ(scale, glm::vec3(1.0f));
+
+			// The cursor is only a hint, the result must be the same as without it.
+			EXPECT_EQ(channel.Update(time, &cursor), channel.Update(time));
+		}
+
+		const size_t compressedSize = channel.GetMemorySize();
+		const size_t uncompressedSize = GetUncompressedSize(bone);
+		Logger::Log("SkeletalAnimation: {} keys compressed from {} to {} bytes", keyCount * 3, uncompressedSize, compressedSize);
+		EXPECT_LT(compressedSize, uncompressedSize / 4);
+	}
+	catch (const std::exception& e)
+	{
+		Logger::Error(e.what());
+		FAIL();
+	}
+}
+
+TEST(SkeletalAnimation, ConstantTracks)
+{
+	try
+	{
+		SkeletalAnimation::Bone bone{};
+		for (size_t key = 0; key < 100; key++)
+		{
+			bone.positions.emplace_back(SkeletalAnimation::KeyVec{ key * keyTime, glm::vec3(1.0f, 2.0f, 3.0f) });
+			bone.rotations.emplace_back(SkeletalAnimation::KeyQuat{ key * keyTime, glm::angleAxis(0.5f, glm::vec3(0.0f, 1.0f, 0.0f)) });
+		}
+
+		const SkeletalAnimation::Channel channel(bone, {});
+		const SkeletalAnimation::Bone decompressedBone = channel.Decompress();
+
+		EXPECT_EQ(decompressedBone.positions.size(), 1);
+		EXPECT_EQ(decompressedBone.rotations.size(), 1);
+		EXPECT_EQ(decompressedBone.scales.size(), 1);
+
+		glm::vec3 position;
+		glm::quat rotation;
+		glm::vec3 scale;
+		channel.Update(1.0f, position, rotation, scale);
+
+		EXPECT_EQ(position, glm::vec3(1.0f, 2.0f, 3.0f));
+		EXPECT_NEAR(glm::dot(rotation, glm::angleAxis(0.5f, glm::vec3(0.0f, 1.0f, 0.0f))), 1.0f, 1e-6f);
+		EXPECT_EQ(scale, glm::vec3(1.0f));
+	}
+	catch (const std::exception& e)
+	{
+		Logger::Error(e.what());
+		FAIL();
+	}
+}
+
+TEST(SkeletalAnimation, KeysAtTheSameTime)
+{
+	try
+	{
+		// The position jumps at one second, the rotation has a duplicated key in the middle of a turn.
+		SkeletalAnimation::Bone bone{};
+		bone.positions =
+		{
+			{ 0.0f, glm::vec3(0.0f) },
+			{ 1.0f, glm::vec3(0.0f) },
+			{ 1.0f, glm::vec3(1.0f, 0.0f, 0.0f) },
+			{ 1.0f, glm::vec3(1.0f, 0.0f, 0.0f) },
+			{ 2.0f, glm::vec3(1.0f, 0.0f, 0.0f) },
+		};
+		bone.rotations =
+		{
+			{ 0.0f, glm::angleAxis(0.0f, glm::vec3(0.0f, 1.0f, 0.0f)) },
+			{ 1.0f, glm::angleAxis(0.5f, glm::vec3(0.0f, 1.0f, 0.0f)) },
+			{ 1.0f, glm::angleAxis(0.5f, glm::vec3(0.0f, 1.0f, 0.0f)) },
+			{ 2.0f, glm::angleAxis(1.0f, glm::vec3(0.0f, 1.0f, 0.0f)) },
+		};
+
+		const SkeletalAnimation::Channel channel(bone, {});
+
+		// The repeated key after the jump is restored by the jump itself.
+		const SkeletalAnimation::Bone decompressedBone = channel.Decompress();
+		ASSERT_EQ(decompressedBone.positions.size(), 4);
+		EXPECT_EQ(decompressedBone.positions[1].time, 1.0f);
+		EXPECT_EQ(decompressedBone.positions[2].time, 1.0f);
+
+		for (float time = 0.0f; time <= 2.0f; time += 0.125f)
+		{
+			glm::vec3 position;
+			glm::quat rotation;
+			glm::vec3 scale;
+			channel.Update(time, position, rotation, scale);
+
+			ASSERT_FALSE(glm::any(glm::isnan(position))) << time;
+			ASSERT_FALSE(glm::any(glm::isnan(glm::vec4(rotation.x, rotation.y, rotation.z, rotation.w)))) << time;
+
+			EXPECT_NEAR(position.x, time < 1.0f ? 0.0f : 1.0f, 1e-3f) << time;
+			EXPECT_NEAR(glm::angle(rotation), time * 0.5f, 1e-3f) << time;
+		}
+	}
+	catch (const std::exception& e)
+	{
+		Logger::Error(e.what());
+		FAIL();
+	}
+}
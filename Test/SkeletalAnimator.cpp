@@ -0,0 +1,451 @@
+#include <gtest/gtest.h>
+
+#include "Core/SceneManager.h"
+#include "Components/SkeletalAnimator.h"
+#include "Components/Transform.h"
+#include "ComponentSystems/SkeletalAnimatorSystem.h"
+#include "Graphics/SkeletalAnimation.h"
+#include "Graphics/Skeleton.h"
+#include "Core/Logger.h"
+
+#include "TestUtils.h"
+
+using namespace Pengine;
+
+namespace
+{
+	constexpr uint32_t boneCount = 64;
+	constexpr uint32_t keyCount = 32;
+
+	std::shared_ptr<Skeleton> CreateChainSkeleton()
+	{
+		Skeleton::CreateInfo createInfo{};
+		createInfo.name = "Skeleton";
+		createInfo.filepath = "Skeleton";
+		createInfo.rootBoneIds = { 0 };
+
+		for (uint32_t i = 0; i < boneCount; i++)
+		{
+			Skeleton::Bone& bone = createInfo.bones.emplace_back();
+			bone.name = "Bone" + std::to_string(i);
+			bone.transform = glm::mat4(1.0f);
+			bone.offset = glm::mat4(1.0f);
+			bone.id = i;
+			bone.parentId = i == 0 ? -1 : i - 1;
+			if (i + 1 < boneCount)
+			{
+				bone.childIds.emplace_back(i + 1);
+			}
+		}
+
+		return std::make_shared<Skeleton>(createInfo);
+	}
+
+	std::shared_ptr<SkeletalAnimation> CreateAnimation()
+	{
+		SkeletalAnimation::CreateInfo createInfo{};
+		createInfo.name = "Animation";
+		createInfo.filepath = "Animation";
+		createInfo.duration = keyCount - 1;
+
+		for (uint32_t i = 0; i < boneCount; i++)
+		{
+			SkeletalAnimation::Bone& bone = createInfo.bonesByName["Bone" + std::to_string(i)];
+			for (uint32_t key = 0; key < keyCount; key++)
+			{
+				bone.positions.emplace_back(SkeletalAnimation::KeyVec{ (double)key, glm::vec3(0.0f, 1.0f, 0.0f) });
+				bone.rotations.emplace_back(SkeletalAnimation::KeyQuat{ (double)key, glm::angleAxis(0.01f * key, glm::vec3(0.0f, 0.0f, 1.0f)) });
+				bone.scales.emplace_back(SkeletalAnimation::KeyVec{ (double)key, glm::vec3(1.0f) });
+			}
+		}
+
+		return std::make_shared<SkeletalAnimation>(createInfo);
+	}
+
+	std::shared_ptr<Entity> CreateCharacter(const std::shared_ptr<Scene>& scene)
+	{
+		std::shared_ptr<Entity> root = scene->CreateEntity("Character");
+		root->AddComponent<Transform>(root);
+
+		std::shared_ptr<Entity> parent = root;
+		for (uint32_t i = 0; i < boneCount; i++)
+		{
+			std::shared_ptr<Entity> boneEntity = scene->CreateEntity("Bone" + std::to_string(i));
+			boneEntity->AddComponent<Transform>(boneEntity);
+			parent->AddChild(boneEntity);
+			parent = boneEntity;
+		}
+
+		return root;
+	}
+
+	/**
+	 * The evaluation before the bones were resolved once: a recursive walk that looks the channel and the entity up by name
+	 * for every node and moves the entity with Translate, Rotate and Scale, which mark every bone below it.
+	 */
+	void EvaluateReference(
+		const std::shared_ptr<Entity>& entity,
+		const Skeleton& skeleton,
+		const SkeletalAnimation& skeletalAnimation,
+		const float time,
+		const uint32_t boneId,
+		const glm::mat4& parentTransform,
+		std::vector<glm::mat4>& boneMatrices)
+	{
+		const Skeleton::Bone& node = skeleton.GetBones()[boneId];
+
+		glm::vec3 position = glm::vec3(0.0f);
+		glm::quat rotation = glm::quat(glm::vec3(0.0f));
+		glm::vec3 scale = glm::vec3(1.0f);
+		if (skeletalAnimation.GetChannelsByName().contains(node.name))
+		{
+			skeletalAnimation.GetChannelsByName().at(node.name).Update(time, position, rotation, scale);
+		}
+
+		const glm::mat4 globalTransform = parentTransform * glm::translate(glm::mat4(1.0f), position) * glm::toMat4(rotation) * glm::scale(glm::mat4(1.0f), scale);
+		if (node.id < boneMatrices.size())
+		{
+			boneMatrices[node.id] = globalTransform * node.offset;
+		}
+
+		if (const std::shared_ptr<Entity> boneEntity = entity->FindEntityInHierarchy(node.name))
+		{
+			Transform& boneEntityTransform = boneEntity->GetComponent<Transform>();
+			boneEntityTransform.Translate(position);
+			boneEntityTransform.Rotate(glm::eulerAngles(rotation));
+			boneEntityTransform.Scale(scale);
+		}
+
+		for (const uint32_t childId : node.childIds)
+		{
+			EvaluateReference(entity, skeleton, skeletalAnimation, time, childId, globalTransform, boneMatrices);
+		}
+	}
+}
+
+TEST(SkeletalAnimator, ChainTransforms)
+{
+	try
+	{
+		std::shared_ptr<Scene> scene = SceneManager::GetInstance().Create("Scene", "Main");
+		std::shared_ptr<Entity> character = CreateCharacter(scene);
+
+		SkeletalAnimator skeletalAnimator;
+		skeletalAnimator.SetSkeleton(CreateChainSkeleton());
+		skeletalAnimator.SetSkeletalAnimation(CreateAnimation());
+		skeletalAnimator.SetSpeed(1.0f);
+		skeletalAnimator.UpdateAnimation(character, 0.0f, glm::mat4(1.0f));
+
+		// Every bone is translated by one unit up relative to its parent with no rotation at time 0.
+		for (uint32_t i = 0; i < boneCount && i < skeletalAnimator.GetFinalBoneMatrices().size(); i++)
+		{
+			const glm::vec3 position = skeletalAnimator.GetFinalBoneMatrices()[i][3];
+			EXPECT_NEAR(position.y, (float)(i + 1), 1e-4f);
+		}
+
+		EXPECT_TRUE(character->FindEntityInHierarchy("Bone3")->GetComponent<Transform>().GetPosition(Transform::System::LOCAL) == glm::vec3(0.0f, 1.0f, 0.0f));
+
+		SceneManager::GetInstance().Delete(scene);
+	}
+	catch (const std::exception& e)
+	{
+		Logger::Error(e.what());
+		FAIL();
+	}
+}
+
+TEST(SkeletalAnimator, LodFollowsScreenSize)
+{
+	try
+	{
+		std::shared_ptr<Scene> scene = SceneManager::GetInstance().Create("Scene", "Main");
+
+		SkeletalAnimatorSystem skeletalAnimatorSystem;
+		skeletalAnimatorSystem.SetLods(
+		{
+			{ 0.5f, 1 },
+			{ 0.2f, 2, 8 },
+			{ 0.0f, 4, 3 }
+		});
+		skeletalAnimatorSystem.SetInvisibleLod({ 0.0f, 8, 2 });
+
+		struct Expected
+		{
+			float screenSize;
+			bool lodEnabled;
+			uint32_t updateInterval;
+			uint32_t maxBoneDepth;
+		};
+
+		const std::vector<Expected> expected =
+		{
+			{ 0.6f, true, 1, std::numeric_limits<uint32_t>::max() },
+			{ 0.5f, true, 1, std::numeric_limits<uint32_t>::max() },
+			{ 0.3f, true, 2, 8 },
+			{ 0.1f, true, 4, 3 },
+			{ 0.0f, true, 8, 2 },
+			{ 0.0f, false, 1, std::numeric_limits<uint32_t>::max() },
+		};
+
+		std::vector<std::shared_ptr<Entity>> entities;
+		for (const Expected& lod : expected)
+		{
+			std::shared_ptr<Entity> entity = scene->CreateEntity("Character");
+			entity->AddComponent<Transform>(entity);
+			SkeletalAnimator& skeletalAnimator = entity->AddComponent<SkeletalAnimator>();
+			skeletalAnimator.SetScreenSize(lod.screenSize);
+			skeletalAnimator.SetLodEnabled(lod.lodEnabled);
+			entities.emplace_back(entity);
+		}
+
+		skeletalAnimatorSystem.OnUpdate(1.0f / 60.0f, scene);
+
+		for (size_t i = 0; i < expected.size(); i++)
+		{
+			const SkeletalAnimator& skeletalAnimator = entities[i]->GetComponent<SkeletalAnimator>();
+			EXPECT_EQ(skeletalAnimator.GetUpdateInterval(), expected[i].updateInterval) << "screen size " << expected[i].screenSize;
+			EXPECT_EQ(skeletalAnimator.GetMaxBoneDepth(), expected[i].maxBoneDepth) << "screen size " << expected[i].screenSize;
+			EXPECT_EQ(skeletalAnimator.GetScreenSize(), 0.0f);
+		}
+
+		// Not marked by the renderer again, so every animator with lods enabled is invisible now.
+		skeletalAnimatorSystem.OnUpdate(1.0f / 60.0f, scene);
+
+		for (size_t i = 0; i < expected.size(); i++)
+		{
+			const SkeletalAnimator& skeletalAnimator = entities[i]->GetComponent<SkeletalAnimator>();
+			EXPECT_EQ(skeletalAnimator.GetUpdateInterval(), expected[i].lodEnabled ? 8 : 1);
+		}
+
+		SceneManager::GetInstance().Delete(scene);
+	}
+	catch (const std::exception& e)
+	{
+		Logger::Error(e.what());
+		FAIL();
+	}
+}
+
+TEST(SkeletalAnimator, ReducedUpdateRateReachesFullRatePose)
+{
+	try
+	{
+		constexpr uint32_t updateInterval = 4;
+		constexpr float deltaTime = 0.25f;
+
+		std::shared_ptr<Scene> scene = SceneManager::GetInstance().Create("Scene", "Main");
+		std::shared_ptr<Entity> fullRateCharacter = CreateCharacter(scene);
+		std::shared_ptr<Entity> reducedRateCharacter = CreateCharacter(scene);
+
+		const std::shared_ptr<Skeleton> skeleton = CreateChainSkeleton();
+		const std::shared_ptr<SkeletalAnimation> skeletalAnimation = CreateAnimation();
+
+		SkeletalAnimator fullRate;
+		SkeletalAnimator reducedRate;
+		for (SkeletalAnimator* skeletalAnimator : { &fullRate, &reducedRate })
+		{
+			skeletalAnimator->SetSkeleton(skeleton);
+			skeletalAnimator->SetSkeletalAnimation(skeletalAnimation);
+			skeletalAnimator->SetSpeed(1.0f);
+		}
+		reducedRate.SetLod(updateInterval, std::numeric_limits<uint32_t>::max());
+		ASSERT_EQ(reducedRate.GetUpdateInterval(), updateInterval);
+
+		glm::vec3 previousReducedRateTip = glm::vec3(0.0f);
+		for (uint32_t frame = 1; frame <= updateInterval * 3; frame++)
+		{
+			fullRate.UpdateAnimation(fullRateCharacter, deltaTime, glm::mat4(1.0f));
+			reducedRate.UpdateAnimation(reducedRateCharacter, deltaTime, glm::mat4(1.0f));
+
+			const glm::vec3 fullRateTip = fullRate.GetFinalBoneMatrices()[boneCount - 1][3];
+			const glm::vec3 reducedRateTip = reducedRate.GetFinalBoneMatrices()[boneCount - 1][3];
+
+			// At the end of every interval the pose is the evaluated one, in between it is interpolated instead of held.
+			if (frame % updateInterval == 0)
+			{
+				EXPECT_NEAR(reducedRateTip.x, fullRateTip.x, 1e-4f) << "frame " << frame;
+				EXPECT_NEAR(reducedRateTip.y, fullRateTip.y, 1e-4f) << "frame " << frame;
+			}
+			else
+			{
+				EXPECT_NE(reducedRateTip, previousReducedRateTip) << "frame " << frame;
+			}
+			previousReducedRateTip = reducedRateTip;
+		}
+
+		SceneManager::GetInstance().Delete(scene);
+	}
+	catch (const std::exception& e)
+	{
+		Logger::Error(e.what());
+		FAIL();
+	}
+}
+
+TEST(SkeletalAnimator, ReducedUpdateRateBoneEntitiesFollowPalette)
+{
+	try
+	{
+		std::shared_ptr<Scene> scene = SceneManager::GetInstance().Create("Scene", "Main");
+		std::shared_ptr<Entity> character = CreateCharacter(scene);
+		const std::shared_ptr<Entity> tip = character->FindEntityInHierarchy("Bone" + std::to_string(boneCount - 1));
+
+		SkeletalAnimator skeletalAnimator;
+		skeletalAnimator.SetSkeleton(CreateChainSkeleton());
+		skeletalAnimator.SetSkeletalAnimation(CreateAnimation());
+		skeletalAnimator.SetSpeed(1.0f);
+		skeletalAnimator.SetLod(4, std::numeric_limits<uint32_t>::max());
+
+		// The bone offsets are identity, so the palette is the global transform the tip entity should have.
+		for (uint32_t frame = 1; frame <= 8; frame++)
+		{
+			skeletalAnimator.UpdateAnimation(character, 0.25f, glm::mat4(1.0f));
+
+			const glm::vec3 palettePosition = skeletalAnimator.GetFinalBoneMatrices()[boneCount - 1][3];
+			const glm::vec3 entityPosition = tip->GetComponent<Transform>().GetPosition();
+			EXPECT_NEAR(entityPosition.x, palettePosition.x, 1e-3f) << "frame " << frame;
+			EXPECT_NEAR(entityPosition.y, palettePosition.y, 1e-3f) << "frame " << frame;
+		}
+
+		SceneManager::GetInstance().Delete(scene);
+	}
+	catch (const std::exception& e)
+	{
+		Logger::Error(e.what());
+		FAIL();
+	}
+}
+
+TEST(SkeletalAnimator, BoneEntitiesMatchReference)
+{
+	try
+	{
+		constexpr float time = 5.5f;
+
+		std::shared_ptr<Scene> scene = SceneManager::GetInstance().Create("Scene", "Main");
+		std::shared_ptr<Entity> character = CreateCharacter(scene);
+		std::shared_ptr<Entity> referenceCharacter = CreateCharacter(scene);
+
+		const std::shared_ptr<Skeleton> skeleton = CreateChainSkeleton();
+		const std::shared_ptr<SkeletalAnimation> skeletalAnimation = CreateAnimation();
+
+		// Not a bone, it has to follow the bone it is attached to.
+		std::vector<std::shared_ptr<Entity>> weapons;
+		for (const std::shared_ptr<Entity>& entity : { character, referenceCharacter })
+		{
+			std::shared_ptr<Entity> weapon = scene->CreateEntity("Weapon");
+			weapon->AddComponent<Transform>(weapon, glm::vec3(1.0f, 0.0f, 0.0f));
+			entity->FindEntityInHierarchy("Bone10")->AddChild(weapon);
+			weapons.emplace_back(weapon);
+			EXPECT_NEAR(weapon->GetComponent<Transform>().GetPosition().x, 1.0f, 1e-4f);
+		}
+
+		SkeletalAnimator skeletalAnimator;
+		skeletalAnimator.SetSkeleton(skeleton);
+		skeletalAnimator.SetSkeletalAnimation(skeletalAnimation);
+		skeletalAnimator.SetSpeed(1.0f);
+		skeletalAnimator.UpdateAnimation(character, time, glm::mat4(1.0f));
+
+		std::vector<glm::mat4> referenceBoneMatrices(skeletalAnimator.GetMaxBones(), glm::mat4(1.0f));
+		EvaluateReference(referenceCharacter, *skeleton, *skeletalAnimation, time, 0, glm::mat4(1.0f), referenceBoneMatrices);
+
+		for (uint32_t i = 0; i < boneCount; i++)
+		{
+			const std::string name = "Bone" + std::to_string(i);
+			const glm::vec3 position = character->FindEntityInHierarchy(name)->GetComponent<Transform>().GetPosition();
+			const glm::vec3 referencePosition = referenceCharacter->FindEntityInHierarchy(name)->GetComponent<Transform>().GetPosition();
+			EXPECT_NEAR(glm::distance(position, referencePosition), 0.0f, 1e-3f) << name;
+
+			if (i < referenceBoneMatrices.size())
+			{
+				EXPECT_NEAR(glm::distance(glm::vec3(skeletalAnimator.GetFinalBoneMatrices()[i][3]), glm::vec3(referenceBoneMatrices[i][3])), 0.0f, 1e-3f) << name;
+			}
+		}
+
+		EXPECT_NEAR(glm::distance(weapons[0]->GetComponent<Transform>().GetPosition(), weapons[1]->GetComponent<Transform>().GetPosition()), 0.0f, 1e-3f);
+
+		SceneManager::GetInstance().Delete(scene);
+	}
+	catch (const std::exception& e)
+	{
+		Logger::Error(e.what());
+		FAIL();
+	}
+}
+
+TEST(SkeletalAnimator, RejectsZeroMaxBones)
+{
+	try
+	{
+		SkeletalAnimator skeletalAnimator;
+		skeletalAnimator.SetMaxBones(0);
+		EXPECT_EQ(skeletalAnimator.GetMaxBones(), SkeletalAnimator::defaultMaxBones);
+		EXPECT_EQ(skeletalAnimator.GetFinalBoneMatrices().size(), SkeletalAnimator::defaultMaxBones);
+
+		skeletalAnimator.SetMaxBones(8);
+		EXPECT_EQ(skeletalAnimator.GetMaxBones(), 8);
+	}
+	catch (const std::exception& e)
+	{
+		Logger::Error(e.what());
+		FAIL();
+	}
+}
+
+TEST(SkeletalAnimator, Benchmark500Characters)
+{
+	try
+	{
+		constexpr size_t characterCount = 500;
+		constexpr size_t frameCount = 10;
+
+		std::shared_ptr<Scene> scene = SceneManager::GetInstance().Create("Scene", "Main");
+		const std::shared_ptr<Skeleton> skeleton = CreateChainSkeleton();
+		const std::shared_ptr<SkeletalAnimation> skeletalAnimation = CreateAnimation();
+
+		std::vector<std::shared_ptr<Entity>> characters;
+		std::vector<std::shared_ptr<Entity>> referenceCharacters;
+		std::vector<SkeletalAnimator> skeletalAnimators(characterCount);
+		for (size_t i = 0; i < characterCount; i++)
+		{
+			characters.emplace_back(CreateCharacter(scene));
+			referenceCharacters.emplace_back(CreateCharacter(scene));
+			skeletalAnimators[i].SetSkeleton(skeleton);
+			skeletalAnimators[i].SetSkeletalAnimation(skeletalAnimation);
+			skeletalAnimators[i].SetSpeed(1.0f);
+		}
+
+		const double milliseconds = TestUtils::Measure([&]()
+		{
+			for (size_t frame = 0; frame < frameCount; frame++)
+			{
+				for (size_t i = 0; i < characterCount; i++)
+				{
+					skeletalAnimators[i].UpdateAnimation(characters[i], 1.0f / 60.0f, glm::mat4(1.0f));
+				}
+			}
+		}) / frameCount;
+
+		std::vector<glm::mat4> referenceBoneMatrices(SkeletalAnimator::defaultMaxBones, glm::mat4(1.0f));
+		const double referenceMilliseconds = TestUtils::Measure([&]()
+		{
+			for (size_t frame = 0; frame < frameCount; frame++)
+			{
+				for (size_t i = 0; i < characterCount; i++)
+				{
+					EvaluateReference(referenceCharacters[i], *skeleton, *skeletalAnimation, frame / 60.0f, 0, glm::mat4(1.0f), referenceBoneMatrices);
+				}
+			}
+		}) / frameCount;
+
+		Logger::Log("SkeletalAnimator: {} characters, {} bones, {:.3f} ms per frame, reference {:.3f} ms per frame, {:.1f}x",
+			characterCount, boneCount, milliseconds, referenceMilliseconds, referenceMilliseconds / milliseconds);
+
+		SceneManager::GetInstance().Delete(scene);
+	}
+	catch (const std::exception& e)
+	{
+		Logger::Error(e.what());
+		FAIL();
+	}
+}
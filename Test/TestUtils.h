@@ -0,0 +1,46 @@
+#pragma once
+
+#include <chrono>
+#include <filesystem>
+#include <functional>
+
+namespace TestUtils
+{
+
+	/**
+	 * Wall time of the function in milliseconds.
+	 */
+	inline double Measure(const std::function<void()>& function)
+	{
+		const auto start = std::chrono::high_resolution_clock::now();
+		function();
+		const auto end = std::chrono::high_resolution_clock::now();
+		return std::chrono::duration<double, std::milli>(end - start).count();
+	}
+
+	/**
+	 * Tests run from the build directory or from SandBox, the font is searched in the parent directories.
+	 */
+	inline std::filesystem::path FindFontFilepath()
+	{
+		const std::filesystem::path relativeFilepath = std::filesystem::path("Editor") / "Fonts" / "Calibri.ttf";
+		if (std::filesystem::exists(relativeFilepath))
+		{
+			return relativeFilepath;
+		}
+
+		for (std::filesystem::path directory = std::filesystem::current_path();
+			directory != directory.parent_path();
+			directory = directory.parent_path())
+		{
+			const std::filesystem::path filepath = directory / "SandBox" / relativeFilepath;
+			if (std::filesystem::exists(filepath))
+			{
+				return filepath;
+			}
+		}
+
+		return {};
+	}
+
+}
@@ -0,0 +1,208 @@
+#include <gtest/gtest.h>
+
+#include "Core/Logger.h"
+#include "Graphics/Font.h"
+#include "Graphics/TextLayoutCache.h"
+
+#include "TestUtils.h"
+
+using namespace Pengine;
+
+namespace
+{
+	void ExpectSameLayout(const TextLayoutCache::Layout& a, const TextLayoutCache::Layout& b)
+	{
+		EXPECT_EQ(a.size, b.size);
+		ASSERT_EQ(a.glyphs.size(), b.glyphs.size());
+		for (size_t i = 0; i < a.glyphs.size(); i++)
+		{
+			EXPECT_EQ(a.glyphs[i].rect.offset, b.glyphs[i].rect.offset);
+			EXPECT_EQ(a.glyphs[i].rect.size, b.glyphs[i].rect.size);
+			EXPECT_EQ(a.glyphs[i].offset, b.glyphs[i].offset);
+			EXPECT_EQ(a.glyphs[i].size, b.glyphs[i].size);
+		}
+	}
+}
+
+TEST(TextLayoutCache, ReusesLayoutsPerStyle)
+{
+	try
+	{
+		const std::filesystem::path filepath = TestUtils::FindFontFilepath();
+		if (filepath.empty())
+		{
+			GTEST_SKIP() << "Editor/Fonts/Calibri.ttf is not found.";
+		}
+
+		Font font(filepath, 0);
+		TextLayoutCache cache(16);
+
+		const std::shared_ptr<const TextLayoutCache::Layout> layout = cache.Get(font, 24, 0, "Inventory");
+		ExpectSameLayout(*layout, TextLayoutCache::Build(font, 24, 0, "Inventory"));
+		EXPECT_EQ(cache.GetMissCount(), 1);
+
+		// The same string in a different buffer hits the cache.
+		const std::string copy = "Inventory";
+		EXPECT_EQ(cache.Get(font, 24, 0, copy), layout);
+		EXPECT_EQ(cache.GetHitCount(), 1);
+
+		const std::shared_ptr<const TextLayoutCache::Layout> larger = cache.Get(font, 48, 0, "Inventory");
+		const std::shared_ptr<const TextLayoutCache::Layout> spaced = cache.Get(font, 24, 10, "Inventory");
+		EXPECT_NE(larger, layout);
+		EXPECT_NE(spaced, layout);
+		EXPECT_EQ(cache.GetSize(), 3);
+
+		// 9 letters, the spacing is only between them.
+		EXPECT_NEAR(larger->size.x, layout->size.x * 2, 2);
+		EXPECT_NEAR(spaced->size.x, layout->size.x + 8 * 10, 1);
+	}
+	catch (const std::exception& e)
+	{
+		Logger::Error(e.what());
+		FAIL();
+	}
+}
+
+TEST(TextLayoutCache, EvictsLeastRecentlyUsed)
+{
+	try
+	{
+		const std::filesystem::path filepath = TestUtils::FindFontFilepath();
+		if (filepath.empty())
+		{
+			GTEST_SKIP() << "Editor/Fonts/Calibri.ttf is not found.";
+		}
+
+		Font font(filepath, 0);
+		TextLayoutCache cache(2);
+
+		const std::shared_ptr<const TextLayoutCache::Layout> a = cache.Get(font, 24, 0, "A");
+		const std::shared_ptr<const TextLayoutCache::Layout> b = cache.Get(font, 24, 0, "B");
+		EXPECT_EQ(cache.Get(font, 24, 0, "A"), a);
+		cache.Get(font, 24, 0, "C");
+
+		EXPECT_EQ(cache.GetSize(), 2);
+		EXPECT_EQ(cache.Get(font, 24, 0, "A"), a);
+		EXPECT_EQ(cache.GetMissCount(), 3);
+
+		// B was the least recently used, it is laid out again. The evicted layout stays valid for its holders.
+		EXPECT_NE(cache.Get(font, 24, 0, "B"), b);
+		EXPECT_EQ(cache.GetMissCount(), 4);
+		EXPECT_EQ(b->glyphs.size(), 1);
+	}
+	catch (const std::exception& e)
+	{
+		Logger::Error(e.what());
+		FAIL();
+	}
+}
+
+TEST(TextLayoutCache, PositionsGlyphsAlongTheBaseline)
+{
+	try
+	{
+		const std::filesystem::path filepath = TestUtils::FindFontFilepath();
+		if (filepath.empty())
+		{
+			GTEST_SKIP() << "Editor/Fonts/Calibri.ttf is not found.";
+		}
+
+		Font font(filepath, 0);
+
+		// Whitespace only moves the pen, multi byte characters are one glyph each.
+		const TextLayoutCache::Layout words = TextLayoutCache::Build(font, 24, 0, "a b");
+		ASSERT_EQ(words.glyphs.size(), 2);
+		EXPECT_GT(words.glyphs[1].offset.x, words.glyphs[0].offset.x + words.glyphs[0].size.x - 2.0f * Font::sdfSpread);
+
+		const TextLayoutCache::Layout cyrillic = TextLayoutCache::Build(font, 24, 0, "\xD0\x9F\xD1\x80\xD0\xB8\xD0\xB2\xD0\xB5\xD1\x82");
+		EXPECT_EQ(cyrillic.glyphs.size(), 6);
+
+		for (const TextLayoutCache::PositionedGlyph& glyph : cyrillic.glyphs)
+		{
+			// Quads start above the baseline and include the spread below it.
+			EXPECT_LT(glyph.offset.y, 0.0f);
+			EXPECT_GT(glyph.offset.y + glyph.size.y, 0.0f);
+		}
+	}
+	catch (const std::exception& e)
+	{
+		Logger::Error(e.what());
+		FAIL();
+	}
+}
+
+TEST(TextLayoutCache, BenchmarkThousandLabels)
+{
+	try
+	{
+		const std::filesystem::path filepath = TestUtils::FindFontFilepath();
+		if (filepath.empty())
+		{
+			GTEST_SKIP() << "Editor/Fonts/Calibri.ttf is not found.";
+		}
+
+		constexpr size_t labelCount = 1000;
+		constexpr int frameCount = 60;
+
+		const std::vector<std::string> names = { "Iron Sword", "Health Potion", "Arrow", "Leather Armor", "Gold Coin", "Torch" };
+		std::vector<std::string> labels;
+		for (size_t i = 0; i < labelCount; i++)
+		{
+			labels.emplace_back(std::format("{} x{} ({:.1f} kg)", names[i % names.size()], i, i * 0.1f));
+		}
+
+		Font font(filepath, 0);
+		TextLayoutCache cache(4096);
+
+		// Every frame each label is measured by the layout and walked again to emit its quads.
+		float checksum = 0.0f;
+		auto emit = [&checksum](const TextLayoutCache::Layout& layout)
+		{
+			for (const TextLayoutCache::PositionedGlyph& glyph : layout.glyphs)
+			{
+				checksum += glyph.offset.x + glyph.size.x;
+			}
+		};
+
+		// Glyphs are rasterised outside of the measured frames.
+		for (const std::string& label : labels)
+		{
+			TextLayoutCache::Build(font, 24, 0, label);
+		}
+
+		const double uncachedTime = TestUtils::Measure([&]()
+		{
+			for (int frame = 0; frame < frameCount; frame++)
+			{
+				for (const std::string& label : labels)
+				{
+					checksum += TextLayoutCache::Build(font, 24, 0, label).size.x;
+					emit(TextLayoutCache::Build(font, 24, 0, label));
+				}
+			}
+		}) / frameCount;
+
+		const double cachedTime = TestUtils::Measure([&]()
+		{
+			for (int frame = 0; frame < frameCount; frame++)
+			{
+				for (const std::string& label : labels)
+				{
+					checksum += cache.Get(font, 24, 0, label)->size.x;
+					emit(*cache.Get(font, 24, 0, label));
+				}
+			}
+		}) / frameCount;
+
+		EXPECT_GT(checksum, 0.0f);
+		EXPECT_EQ(cache.GetMissCount(), labelCount);
+
+		Logger::Log("TextLayoutCache: {} labels, uncached {:.3f} ms/frame, cached {:.3f} ms/frame",
+			labelCount, uncachedTime, cachedTime);
+	}
+	catch (const std::exception& e)
+	{
+		Logger::Error(e.what());
+		FAIL();
+	}
+}
@@ -1,8 +1,14 @@
 #include <gtest/gtest.h>
 
 #include "Core/UUID.h"
+#include "Core/RandomGenerator.h"
+#include "Core/ThreadPool.h"
 #include "Core/Logger.h"
 
+#include "TestUtils.h"
+
+#include <unordered_set>
+
 using namespace Pengine;
 
 TEST(UUID, UUID)
@@ -20,3 +26,171 @@ TEST(UUID, UUID)
 		FAIL();
 	}
 }
+
+TEST(UUID, ToString)
+{
+	try
+	{
+		const UUID uuid(0x0123456789abcdefull, 0xfedcba9876543210ull);
+		EXPECT_EQ(uuid.ToString(), "0x0123456789abcdeffedcba9876543210");
+		EXPECT_EQ(UUID::FromString("0x0123456789ABCDEFFEDCBA9876543210"), uuid);
+		EXPECT_EQ(UUID::FromString(UUID(1, 2).ToString()), UUID(1, 2));
+
+		EXPECT_THROW(UUID::FromString("0x0123456789abcdefgedcba9876543210"), std::runtime_error);
+
+		const UUID timeOrdered = UUID::GenerateTimeOrdered();
+		EXPECT_EQ(UUID::FromString(timeOrdered.ToString()), timeOrdered);
+	}
+	catch (const std::exception& e)
+	{
+		Logger::Error(e.what());
+		FAIL();
+	}
+}
+
+TEST(UUID, Unique)
+{
+	try
+	{
+		constexpr size_t count = 1000000;
+
+		const uint32_t threadCount = glm::max(std::thread::hardware_concurrency(), 2u) - 1;
+		ThreadPool threadPool;
+		threadPool.Initialize(threadCount);
+
+		std::vector<UUID> uuids(count, UUID(0, 0));
+		std::vector<UUID> timeOrderedUuids(count, UUID(0, 0));
+		threadPool.ParallelFor(count, 4096, [&](const size_t begin, const size_t end)
+		{
+			for (size_t i = begin; i < end; i++)
+			{
+				uuids[i] = UUID();
+				timeOrderedUuids[i] = UUID::GenerateTimeOrdered();
+			}
+		});
+
+		threadPool.Shutdown();
+
+		std::unordered_set<UUID, uuid_hash> uniqueUuids;
+		uniqueUuids.reserve(count * 2);
+		for (size_t i = 0; i < count; i++)
+		{
+			EXPECT_TRUE(uuids[i].IsValid());
+			EXPECT_TRUE(timeOrderedUuids[i].IsValid());
+			uniqueUuids.emplace(uuids[i]);
+			uniqueUuids.emplace(timeOrderedUuids[i]);
+		}
+
+		EXPECT_EQ(uniqueUuids.size(), count * 2);
+
+		// Version and variant bits, the time never goes back within a batch of one thread.
+		for (size_t i = 0; i < count; i++)
+		{
+			EXPECT_EQ((timeOrderedUuids[i].GetUpper() >> 12) & 0x0F, 7);
+			EXPECT_EQ(timeOrderedUuids[i].GetLower() >> 62, 2);
+
+			if (i % 4096 != 0)
+			{
+				EXPECT_LE(timeOrderedUuids[i - 1].GetUpper() >> 16, timeOrderedUuids[i].GetUpper() >> 16);
+			}
+		}
+	}
+	catch (const std::exception& e)
+	{
+		Logger::Error(e.what());
+		FAIL();
+	}
+}
+
+TEST(UUID, BenchmarkGenerate)
+{
+	try
+	{
+		constexpr size_t count = 4000000;
+
+		uint64_t checksum = 0;
+		const double singleThreadTime = TestUtils::Measure([&]()
+		{
+			for (size_t i = 0; i < count; i++)
+			{
+				checksum ^= UUID().GetLower();
+			}
+		});
+
+		const uint32_t threadCount = glm::max(std::thread::hardware_concurrency(), 2u) - 1;
+		ThreadPool threadPool;
+		threadPool.Initialize(threadCount);
+
+		std::atomic<uint64_t> sharedChecksum = 0;
+		auto generate = [&](const std::function<UUID()>& create)
+		{
+			threadPool.ParallelFor(count, 16384, [&](const size_t begin, const size_t end)
+			{
+				uint64_t localChecksum = 0;
+				for (size_t i = begin; i < end; i++)
+				{
+					localChecksum ^= create().GetLower();
+				}
+
+				sharedChecksum ^= localChecksum;
+			});
+		};
+
+		const double multiThreadTime = TestUtils::Measure([&]() { generate([]() { return UUID(); }); });
+		const double timeOrderedTime = TestUtils::Measure([&]() { generate([]() { return UUID::GenerateTimeOrdered(); }); });
+
+		// The previous generation: a nibble per call to the shared generator behind its mutex.
+		const double legacyTime = TestUtils::Measure([&]()
+		{
+			generate([]()
+			{
+				uint64_t halves[2] = {};
+				for (uint64_t& half : halves)
+				{
+					for (size_t i = 0; i < 16; i++)
+					{
+						half |= static_cast<uint64_t>(RandomGenerator::GetInstance().Get<short>(0, 15)) << (60 - i * 4);
+					}
+				}
+
+				return UUID(halves[0], halves[1]);
+			});
+		});
+
+		threadPool.Shutdown();
+
+		std::vector<std::string> strings(count);
+		const double toStringTime = TestUtils::Measure([&]()
+		{
+			for (size_t i = 0; i < count; i++)
+			{
+				strings[i] = UUID(i + 1, i + 1).ToString();
+			}
+		});
+
+		const double fromStringTime = TestUtils::Measure([&]()
+		{
+			for (size_t i = 0; i < count; i++)
+			{
+				checksum ^= UUID::FromString(strings[i]).GetLower();
+			}
+		});
+
+		EXPECT_NE(checksum ^ sharedChecksum.load(), 0);
+
+		Logger::Log("UUID: {} ids, 1 thread {:.1f} M/s, {} threads {:.1f} M/s, time ordered {:.1f} M/s, locked generator {:.1f} M/s, to string {:.1f} M/s, from string {:.1f} M/s",
+			count,
+			count / singleThreadTime / 1e3,
+			threadCount + 1,
+			count / multiThreadTime / 1e3,
+			count / timeOrderedTime / 1e3,
+			count / legacyTime / 1e3,
+			count / toStringTime / 1e3,
+			count / fromStringTime / 1e3);
+	}
+	catch (const std::exception& e)
+	{
+		Logger::Error(e.what());
+		FAIL();
+	}
+}